@@ -0,0 +1,658 @@
+#include "CompressedTexture.h"
+#include "GLExtensions.h"
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <algorithm>
+
+// reads little endian numbers out of a file's bytes (both file formats are little endian)
+static unsigned int ReadUInt32(const std::vector<unsigned char>& file, size_t offset)
+{
+	if (offset + 4 > file.size())
+		throw std::exception("Compressed texture file is cut off");
+	return file[offset] | (file[offset + 1] << 8) | (file[offset + 2] << 16) | ((unsigned int)file[offset + 3] << 24);
+}
+
+static unsigned long long ReadUInt64(const std::vector<unsigned char>& file, size_t offset)
+{
+	return ReadUInt32(file, offset) | ((unsigned long long)ReadUInt32(file, offset + 4) << 32);
+}
+
+// 4 character codes used by DDS
+static unsigned int FourCC(const char* code)
+{
+	return code[0] | (code[1] << 8) | (code[2] << 16) | ((unsigned int)code[3] << 24);
+}
+
+// first 12 bytes of every KTX2 file
+static const unsigned char ktx2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+bool CompressedTexture::IsContainer(const unsigned char* data, size_t size)
+{
+	if (size >= 4 && memcmp(data, "DDS ", 4) == 0)
+		return true;
+	if (size >= 12 && memcmp(data, ktx2Identifier, 12) == 0)
+		return true;
+	return false;
+}
+
+CompressedTexture::Image CompressedTexture::ReadFile(const char* filePath)
+{
+	std::ifstream fileStream(filePath, std::ios::binary);
+	if (!fileStream)
+		throw std::exception("Failed to open compressed texture file");
+	std::vector<unsigned char> file((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+
+	if (file.size() >= 4 && memcmp(file.data(), "DDS ", 4) == 0)
+		return ReadDDS(file);
+	if (file.size() >= 12 && memcmp(file.data(), ktx2Identifier, 12) == 0)
+		return ReadKTX2(file);
+
+	throw std::exception("File isn't a DDS or KTX2 file");
+}
+
+void CompressedTexture::Upload(const Image& image, Texture2D& texture)
+{
+	bool supported = IsSupported(image.format);
+	int levelCount = (int)image.levels.size();
+
+	texture.width = image.levels[0].width;
+	texture.height = image.levels[0].height;
+	// what format it is on the cpu side matters for transparency
+	texture.internalFormat = HasAlpha(image.format) ? GL_RGBA : GL_RGB;
+	texture.imageFormat = texture.internalFormat;
+	// the file has mipmaps so use them
+	if (levelCount > 1)
+		texture.filterMin = GL_LINEAR_MIPMAP_LINEAR;
+	// flip it upside down if its rows go top to bottom
+	if (image.topDown)
+		texture.uvRect = glm::vec4(0.0f, 1.0f, 1.0f, -1.0f);
+
+	glBindTexture(GL_TEXTURE_2D, texture.ID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture.wrapS);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture.wrapT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.filterMin);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.filterMax);
+	// the file might not go all the way down to 1x1
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+	if (!supported)
+		std::cout << "Compressed texture " << texture.name << " uses a format the gpu doesn't support, decoding it on the cpu instead" << std::endl;
+
+	for (int i = 0; i < levelCount; i++)
+	{
+		const Level& level = image.levels[i];
+		if (supported)
+			// straight to the gpu, no decoding
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, GetGLFormat(image.format), level.width, level.height, 0, (GLsizei)level.data.size(), level.data.data());
+		else
+		{
+			std::vector<unsigned char> pixels = Decode(level, image.format);
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool CompressedTexture::IsSupported(Format format)
+{
+	switch (format)
+	{
+	case BC1:
+	case BC2:
+	case BC3:
+		return GLExtensions::hasS3TC;
+	case BC4:
+	case BC5:
+		// rgtc is core in 3.0
+		return true;
+	case BC7:
+		return GLExtensions::hasBPTC;
+	case ETC2_RGB:
+	case ETC2_RGBA:
+		return GLExtensions::hasETC2;
+	}
+	return false;
+}
+
+int CompressedTexture::GetBlockSize(Format format)
+{
+	switch (format)
+	{
+	case BC1:
+	case BC4:
+	case ETC2_RGB:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+bool CompressedTexture::HasAlpha(Format format)
+{
+	return format == BC2 || format == BC3 || format == BC7 || format == ETC2_RGBA;
+}
+
+std::vector<unsigned char> CompressedTexture::Decode(const Level& level, Format format)
+{
+	if (format == BC7)
+		throw std::exception("BC7 textures can't be decoded on the cpu, the gpu has to support them");
+
+	int blockSize = GetBlockSize(format);
+	int blocksWide = (level.width + 3) / 4;
+	int blocksHigh = (level.height + 3) / 4;
+
+	if (level.data.size() < (size_t)blocksWide * blocksHigh * blockSize)
+		throw std::exception("Compressed texture level is too small for its size");
+
+	std::vector<unsigned char> pixels((size_t)level.width * level.height * 4);
+	unsigned char blockPixels[16 * 4];
+
+	for (int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			DecodeBlock(format, &level.data[((size_t)blockY * blocksWide + blockX) * blockSize], blockPixels);
+
+			// copy it into the image, blocks on the right/top edge can hang off the end if the size isn't a multiple of 4
+			for (int y = 0; y < 4 && blockY * 4 + y < level.height; y++)
+				for (int x = 0; x < 4 && blockX * 4 + x < level.width; x++)
+					memcpy(&pixels[(((size_t)blockY * 4 + y) * level.width + blockX * 4 + x) * 4], &blockPixels[(y * 4 + x) * 4], 4);
+		}
+	}
+
+	return pixels;
+}
+
+CompressedTexture::Image CompressedTexture::ReadDDS(const std::vector<unsigned char>& file)
+{
+	// 4 byte "DDS " then a 124 byte header
+	if (file.size() < 128 || ReadUInt32(file, 4) != 124)
+		throw std::exception("DDS file has a bad header");
+
+	int height = (int)ReadUInt32(file, 12);
+	int width = (int)ReadUInt32(file, 16);
+	// the mip count is only filled in if the header flags say so (DDSD_MIPMAPCOUNT), some writers leave garbage in it otherwise
+	unsigned int headerFlags = ReadUInt32(file, 8);
+	int mipCount = (headerFlags & 0x20000) ? std::max(1, (int)ReadUInt32(file, 28)) : 1;
+	// pixel format flags and four character code
+	unsigned int pixelFormatFlags = ReadUInt32(file, 80);
+	unsigned int fourCC = ReadUInt32(file, 84);
+	size_t dataOffset = 128;
+
+	// only the four cc version of the pixel format is compressed
+	if (!(pixelFormatFlags & 0x4))
+		throw std::exception("DDS file isn't block compressed");
+
+	Image image;
+	if (fourCC == FourCC("DXT1"))
+		image.format = BC1;
+	else if (fourCC == FourCC("DXT3"))
+		image.format = BC2;
+	else if (fourCC == FourCC("DXT5"))
+		image.format = BC3;
+	else if (fourCC == FourCC("ATI1") || fourCC == FourCC("BC4U"))
+		image.format = BC4;
+	else if (fourCC == FourCC("ATI2") || fourCC == FourCC("BC5U"))
+		image.format = BC5;
+	else if (fourCC == FourCC("DX10"))
+	{
+		// newer files have a second header with a DXGI format. sRGB versions are loaded the same, the renderer doesn't do sRGB
+		unsigned int dxgiFormat = ReadUInt32(file, 128);
+		dataOffset = 148;
+		switch (dxgiFormat)
+		{
+		case 71: case 72: image.format = BC1; break;
+		case 74: case 75: image.format = BC2; break;
+		case 77: case 78: image.format = BC3; break;
+		case 80: image.format = BC4; break;
+		case 83: image.format = BC5; break;
+		case 98: case 99: image.format = BC7; break;
+		default: throw std::exception("DDS file uses a DXGI format that can't be loaded");
+		}
+	}
+	else
+		throw std::exception("DDS file uses a format that can't be loaded");
+
+	// the levels are one after the other, biggest first. If it's an array or cube map the first image's levels come first so just read those
+	size_t offset = dataOffset;
+	for (int i = 0; i < mipCount; i++)
+	{
+		Level level;
+		level.width = std::max(1, width >> i);
+		level.height = std::max(1, height >> i);
+		size_t size = GetLevelSize(image.format, level.width, level.height);
+		if (offset + size > file.size())
+			throw std::exception("DDS file is cut off");
+		level.data.assign(file.begin() + offset, file.begin() + offset + size);
+		image.levels.push_back(level);
+		offset += size;
+	}
+
+	// DDS is always top to bottom
+	image.topDown = true;
+	return image;
+}
+
+CompressedTexture::Image CompressedTexture::ReadKTX2(const std::vector<unsigned char>& file)
+{
+	if (file.size() < 80)
+		throw std::exception("KTX2 file has a bad header");
+
+	unsigned int vkFormat = ReadUInt32(file, 12);
+	int width = (int)ReadUInt32(file, 20);
+	int height = (int)ReadUInt32(file, 24);
+	// 0 means the loader should make the mipmaps, just use the one level
+	int levelCount = std::max(1, (int)ReadUInt32(file, 40));
+	unsigned int supercompressionScheme = ReadUInt32(file, 44);
+	unsigned int keyValueOffset = ReadUInt32(file, 56);
+	unsigned int keyValueLength = ReadUInt32(file, 60);
+
+	if (supercompressionScheme != 0)
+		throw std::exception("KTX2 file is supercompressed (BasisLZ/zstd), which can't be loaded");
+
+	// vulkan format numbers. sRGB versions are loaded the same, the renderer doesn't do sRGB
+	Image image;
+	switch (vkFormat)
+	{
+	case 131: case 132: case 133: case 134: image.format = BC1; break;
+	case 135: case 136: image.format = BC2; break;
+	case 137: case 138: image.format = BC3; break;
+	case 139: image.format = BC4; break;
+	case 141: image.format = BC5; break;
+	case 145: case 146: image.format = BC7; break;
+	case 147: case 148: image.format = ETC2_RGB; break;
+	case 151: case 152: image.format = ETC2_RGBA; break;
+	default: throw std::exception("KTX2 file uses a format that can't be loaded");
+	}
+
+	// the level index comes straight after the header, level 0 first
+	for (int i = 0; i < levelCount; i++)
+	{
+		size_t indexOffset = 80 + (size_t)i * 24;
+		unsigned long long byteOffset = ReadUInt64(file, indexOffset);
+
+		Level level;
+		level.width = std::max(1, width >> i);
+		level.height = std::max(1, height >> i);
+		// arrays and cube maps have every layer/face in the level, the first one is at the start
+		size_t size = GetLevelSize(image.format, level.width, level.height);
+		if (byteOffset + size > file.size())
+			throw std::exception("KTX2 file is cut off");
+		level.data.assign(file.begin() + (size_t)byteOffset, file.begin() + (size_t)byteOffset + size);
+		image.levels.push_back(level);
+	}
+
+	// -- look for the orientation in the key/value data, it's top down unless it says the y axis goes up --
+	image.topDown = true;
+	size_t keyValueEnd = std::min((size_t)keyValueOffset + keyValueLength, file.size());
+	for (size_t offset = keyValueOffset; keyValueLength > 0 && offset + 4 <= keyValueEnd;)
+	{
+		unsigned int entryLength = ReadUInt32(file, offset);
+		const char* entry = (const char*)&file[offset + 4];
+		if (offset + 4 + entryLength > keyValueEnd)
+			break;
+
+		// key then a null then the value. The value is something like "rd" (x goes right, y goes down)
+		std::string key(entry, strnlen(entry, entryLength));
+		if (key == "KTXorientation" && key.size() + 2 < entryLength)
+			image.topDown = entry[key.size() + 2] != 'u';
+
+		// entries are padded to 4 bytes
+		offset += 4 + ((entryLength + 3) & ~3u);
+	}
+
+	return image;
+}
+
+size_t CompressedTexture::GetLevelSize(Format format, int width, int height)
+{
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+GLenum CompressedTexture::GetGLFormat(Format format)
+{
+	switch (format)
+	{
+	case BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	case BC2: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+	case BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case BC4: return GL_COMPRESSED_RED_RGTC1;
+	case BC5: return GL_COMPRESSED_RG_RGTC2;
+	case BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	case ETC2_RGB: return GL_COMPRESSED_RGB8_ETC2;
+	case ETC2_RGBA: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+	}
+	return 0;
+}
+
+void CompressedTexture::DecodeBlock(Format format, const unsigned char* block, unsigned char* pixels)
+{
+	switch (format)
+	{
+	case BC1:
+		DecodeBC1Colour(block, pixels, false);
+		break;
+	case BC2:
+		DecodeBC1Colour(block + 8, pixels, true);
+		// 4 bits of alpha for each pixel, stretched to 8 bits
+		for (int i = 0; i < 16; i++)
+		{
+			int alpha = (block[i / 2] >> ((i % 2) * 4)) & 0xF;
+			pixels[i * 4 + 3] = (unsigned char)(alpha * 17);
+		}
+		break;
+	case BC3:
+		DecodeBC1Colour(block + 8, pixels, true);
+		DecodeBC4Channel(block, pixels + 3, 4);
+		break;
+	case BC4:
+		// red only, like gl gives back when sampling it
+		for (int i = 0; i < 16; i++)
+		{
+			pixels[i * 4 + 1] = 0;
+			pixels[i * 4 + 2] = 0;
+			pixels[i * 4 + 3] = 255;
+		}
+		DecodeBC4Channel(block, pixels, 4);
+		break;
+	case BC5:
+		for (int i = 0; i < 16; i++)
+		{
+			pixels[i * 4 + 2] = 0;
+			pixels[i * 4 + 3] = 255;
+		}
+		DecodeBC4Channel(block, pixels, 4);
+		DecodeBC4Channel(block + 8, pixels + 1, 4);
+		break;
+	case ETC2_RGB:
+		DecodeETC2Colour(block, pixels);
+		break;
+	case ETC2_RGBA:
+		DecodeETC2Colour(block + 8, pixels);
+		DecodeEACChannel(block, pixels + 3, 4);
+		break;
+	default:
+		throw std::exception("Can't decode this compressed texture format on the cpu");
+	}
+}
+
+void CompressedTexture::DecodeBC1Colour(const unsigned char* block, unsigned char* pixels, bool alwaysFourColours)
+{
+	/*
+	* Two 16 bit colours (5 bits red, 6 green, 5 blue) and a 2 bit index for each pixel.
+	* The index picks one of the two colours or one of two colours blended between them (a third and two thirds of the way).
+	* If the first colour is smaller than the second (and it's not BC2/3) there's only one blend in the middle and the last index is see through black
+	*/
+	unsigned int colour0 = block[0] | (block[1] << 8);
+	unsigned int colour1 = block[2] | (block[3] << 8);
+	unsigned int indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((unsigned int)block[7] << 24);
+
+	unsigned char palette[4][4];
+	unsigned int colours[2] = { colour0, colour1 };
+	for (int i = 0; i < 2; i++)
+	{
+		// stretch each channel to 8 bits by copying its top bits into the empty bottom ones
+		int red = (colours[i] >> 11) & 31;
+		int green = (colours[i] >> 5) & 63;
+		int blue = colours[i] & 31;
+		palette[i][0] = (unsigned char)((red << 3) | (red >> 2));
+		palette[i][1] = (unsigned char)((green << 2) | (green >> 4));
+		palette[i][2] = (unsigned char)((blue << 3) | (blue >> 2));
+		palette[i][3] = 255;
+	}
+
+	for (int channel = 0; channel < 3; channel++)
+	{
+		if (colour0 > colour1 || alwaysFourColours)
+		{
+			palette[2][channel] = (unsigned char)((2 * palette[0][channel] + palette[1][channel]) / 3);
+			palette[3][channel] = (unsigned char)((palette[0][channel] + 2 * palette[1][channel]) / 3);
+		}
+		else
+		{
+			palette[2][channel] = (unsigned char)((palette[0][channel] + palette[1][channel]) / 2);
+			palette[3][channel] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = (colour0 > colour1 || alwaysFourColours) ? 255 : 0;
+
+	for (int i = 0; i < 16; i++)
+		memcpy(&pixels[i * 4], palette[(indices >> (i * 2)) & 3], 4);
+}
+
+void CompressedTexture::DecodeBC4Channel(const unsigned char* block, unsigned char* pixels, int stride)
+{
+	// two end values and a 3 bit index for each pixel, picking an end value or one of 6 (or 4 + 0 and 255) values between them
+	int value0 = block[0];
+	int value1 = block[1];
+	unsigned long long indices = 0;
+	for (int i = 0; i < 6; i++)
+		indices |= (unsigned long long)block[2 + i] << (8 * i);
+
+	int palette[8] = { value0, value1 };
+	if (value0 > value1)
+	{
+		for (int i = 1; i <= 6; i++)
+			palette[i + 1] = ((7 - i) * value0 + i * value1) / 7;
+	}
+	else
+	{
+		for (int i = 1; i <= 4; i++)
+			palette[i + 1] = ((5 - i) * value0 + i * value1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	for (int i = 0; i < 16; i++)
+		pixels[i * stride] = (unsigned char)palette[(indices >> (i * 3)) & 7];
+}
+
+// ETC stretches 4, 5, 6 and 7 bit values to 8 bits the same way as BC1
+static int ExtendBits(int value, int bits)
+{
+	return (value << (8 - bits)) | (value >> (2 * bits - 8));
+}
+
+static unsigned char ClampToByte(int value)
+{
+	return (unsigned char)std::min(std::max(value, 0), 255);
+}
+
+void CompressedTexture::DecodeETC2Colour(const unsigned char* block, unsigned char* pixels)
+{
+	/*
+	* ETC splits the block in half (side by side or on top of each other, the flip bit says which) and gives each half a base colour.
+	* Each pixel then adds or takes away a brightness amount from a table to its half's colour.
+	* ETC2 adds 3 more modes (T, H and planar) that are hidden in base colours that would overflow in the normal differential mode.
+	* Pixel indices go down the columns, so pixel i is at x = i / 4, y = i % 4.
+	*/
+	static const int modifierTable[8][2] = { {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183} };
+	static const int distanceTable[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+	// the 2 bit index of each pixel, top bit from the first 16 bits and bottom bit from the next 16
+	unsigned int msbs = (block[4] << 8) | block[5];
+	unsigned int lsbs = (block[6] << 8) | block[7];
+
+	// writes pixel i (column order) into the row order output
+	auto setPixel = [pixels](int i, int red, int green, int blue)
+	{
+		int x = i / 4;
+		int y = i % 4;
+		unsigned char* pixel = &pixels[(y * 4 + x) * 4];
+		pixel[0] = ClampToByte(red);
+		pixel[1] = ClampToByte(green);
+		pixel[2] = ClampToByte(blue);
+		pixel[3] = 255;
+	};
+
+	bool differential = (block[3] & 2) != 0;
+
+	int baseColours[2][3];
+	if (differential)
+	{
+		// 5 bit base colour and a 3 bit signed difference to get the second one
+		int base[3], delta[3];
+		for (int channel = 0; channel < 3; channel++)
+		{
+			base[channel] = block[channel] >> 3;
+			delta[channel] = block[channel] & 7;
+			if (delta[channel] >= 4)
+				delta[channel] -= 8;
+		}
+
+		if (base[0] + delta[0] < 0 || base[0] + delta[0] > 31)
+		{
+			// -- T mode: one colour and a second colour with + and - a distance --
+			int colour0[3] = {
+				ExtendBits(((block[0] & 0x18) >> 1) | (block[0] & 0x3), 4),
+				ExtendBits(block[1] >> 4, 4),
+				ExtendBits(block[1] & 0xF, 4) };
+			int colour1[3] = { ExtendBits(block[2] >> 4, 4), ExtendBits(block[2] & 0xF, 4), ExtendBits(block[3] >> 4, 4) };
+			int distance = distanceTable[((block[3] >> 1) & 0x6) | (block[3] & 0x1)];
+
+			int paint[4][3];
+			for (int channel = 0; channel < 3; channel++)
+			{
+				paint[0][channel] = colour0[channel];
+				paint[1][channel] = colour1[channel] + distance;
+				paint[2][channel] = colour1[channel];
+				paint[3][channel] = colour1[channel] - distance;
+			}
+			for (int i = 0; i < 16; i++)
+			{
+				int index = (((msbs >> i) & 1) << 1) | ((lsbs >> i) & 1);
+				setPixel(i, paint[index][0], paint[index][1], paint[index][2]);
+			}
+			return;
+		}
+
+		if (base[1] + delta[1] < 0 || base[1] + delta[1] > 31)
+		{
+			// -- H mode: two colours each with + and - a distance --
+			int colour0Bits[3] = {
+				(block[0] >> 3) & 0xF,
+				((block[0] << 1) & 0xE) | ((block[1] >> 4) & 0x1),
+				(block[1] & 0x8) | ((block[1] << 1) & 0x6) | (block[2] >> 7) };
+			int colour1Bits[3] = { (block[2] >> 3) & 0xF, ((block[2] << 1) & 0xE) | (block[3] >> 7), (block[3] >> 3) & 0xF };
+
+			// the last bit of the distance index is which colour is bigger
+			int value0 = (colour0Bits[0] << 8) | (colour0Bits[1] << 4) | colour0Bits[2];
+			int value1 = (colour1Bits[0] << 8) | (colour1Bits[1] << 4) | colour1Bits[2];
+			int distance = distanceTable[(block[3] & 0x4) | ((block[3] << 1) & 0x2) | (value0 >= value1 ? 1 : 0)];
+
+			int paint[4][3];
+			for (int channel = 0; channel < 3; channel++)
+			{
+				int colour0 = ExtendBits(colour0Bits[channel], 4);
+				int colour1 = ExtendBits(colour1Bits[channel], 4);
+				paint[0][channel] = colour0 + distance;
+				paint[1][channel] = colour0 - distance;
+				paint[2][channel] = colour1 + distance;
+				paint[3][channel] = colour1 - distance;
+			}
+			for (int i = 0; i < 16; i++)
+			{
+				int index = (((msbs >> i) & 1) << 1) | ((lsbs >> i) & 1);
+				setPixel(i, paint[index][0], paint[index][1], paint[index][2]);
+			}
+			return;
+		}
+
+		if (base[2] + delta[2] < 0 || base[2] + delta[2] > 31)
+		{
+			// -- planar mode: a colour at the origin, one at the right and one at the top (well, bottom in row order) blended across the block --
+			int origin[3] = {
+				ExtendBits((block[0] >> 1) & 0x3F, 6),
+				ExtendBits(((block[0] & 0x1) << 6) | ((block[1] >> 1) & 0x3F), 7),
+				ExtendBits(((block[1] & 0x1) << 5) | (block[2] & 0x18) | ((block[2] << 1) & 0x6) | ((block[3] >> 7) & 0x1), 6) };
+			int horizontal[3] = {
+				ExtendBits(((block[3] >> 1) & 0x3E) | (block[3] & 0x1), 6),
+				ExtendBits((block[4] >> 1) & 0x7F, 7),
+				ExtendBits(((block[4] << 5) & 0x20) | ((block[5] >> 3) & 0x1F), 6) };
+			int vertical[3] = {
+				ExtendBits(((block[5] << 3) & 0x38) | ((block[6] >> 5) & 0x7), 6),
+				ExtendBits(((block[6] << 2) & 0x7C) | ((block[7] >> 6) & 0x3), 7),
+				ExtendBits(block[7] & 0x3F, 6) };
+
+			for (int y = 0; y < 4; y++)
+			{
+				for (int x = 0; x < 4; x++)
+				{
+					int colour[3];
+					for (int channel = 0; channel < 3; channel++)
+						colour[channel] = (x * (horizontal[channel] - origin[channel]) + y * (vertical[channel] - origin[channel]) + 4 * origin[channel] + 2) >> 2;
+					setPixel(x * 4 + y, colour[0], colour[1], colour[2]);
+				}
+			}
+			return;
+		}
+
+		// -- normal differential mode --
+		for (int channel = 0; channel < 3; channel++)
+		{
+			baseColours[0][channel] = ExtendBits(base[channel], 5);
+			baseColours[1][channel] = ExtendBits(base[channel] + delta[channel], 5);
+		}
+	}
+	else
+	{
+		// -- individual mode: two 4 bit colours --
+		for (int channel = 0; channel < 3; channel++)
+		{
+			baseColours[0][channel] = ExtendBits(block[channel] >> 4, 4);
+			baseColours[1][channel] = ExtendBits(block[channel] & 0xF, 4);
+		}
+	}
+
+	// which table each half uses
+	int tables[2] = { block[3] >> 5, (block[3] >> 2) & 7 };
+	bool flip = (block[3] & 1) != 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		int x = i / 4;
+		int y = i % 4;
+		// side by side halves unless flipped
+		int half = flip ? (y >= 2) : (x >= 2);
+
+		// index 0 and 1 add the small/big amount, 2 and 3 take them away
+		int index = (((msbs >> i) & 1) << 1) | ((lsbs >> i) & 1);
+		int modifier = modifierTable[tables[half]][index & 1];
+		if (index & 2)
+			modifier = -modifier;
+
+		setPixel(i, baseColours[half][0] + modifier, baseColours[half][1] + modifier, baseColours[half][2] + modifier);
+	}
+}
+
+void CompressedTexture::DecodeEACChannel(const unsigned char* block, unsigned char* pixels, int stride)
+{
+	// base value, a multiplier and which row of modifiers to use. Each pixel has a 3 bit index into the row
+	static const int modifierTable[16][8] = {
+		{-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12}, {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+		{-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10}, {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+		{-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9}, {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+		{-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9}, {-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8}
+	};
+
+	int base = block[0];
+	int multiplier = block[1] >> 4;
+	const int* modifiers = modifierTable[block[1] & 0xF];
+
+	// 48 bits of indices, big endian, first pixel in the top bits
+	unsigned long long indices = 0;
+	for (int i = 2; i < 8; i++)
+		indices = (indices << 8) | block[i];
+
+	for (int i = 0; i < 16; i++)
+	{
+		int index = (int)((indices >> (45 - i * 3)) & 7);
+		// pixels go down the columns like ETC
+		int x = i / 4;
+		int y = i % 4;
+		pixels[(y * 4 + x) * stride] = ClampToByte(base + modifiers[index] * multiplier);
+	}
+}
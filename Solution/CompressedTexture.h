@@ -0,0 +1,98 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include "Texture2D.h"
+
+// Loads block compressed textures from KTX2 and DDS files. The gpu reads block compressed data as is, so there's nothing to decode
+// when loading and it takes 4 to 8 times less video memory than plain rgb(a). The files already have their mipmaps in them too.
+// If the gpu can't use a format the blocks are decoded into rgba on the cpu instead so the texture still works (just without the savings).
+// ResourceManager::LoadTexture uses this by itself when the file starts with a KTX2 or DDS header. Make the files with Tools/TextureConverter.cpp
+// Static class like the resource manager
+class CompressedTexture
+{
+public:
+	// block compressed formats that can be loaded. Every one works on 4x4 pixel blocks
+	enum Format {
+		// rgb (8 bytes a block). DXT1
+		BC1,
+		// rgb + sharp 4 bit alpha (16 bytes). DXT3
+		BC2,
+		// rgb + smooth alpha (16 bytes). DXT5
+		BC3,
+		// one channel (8 bytes). RGTC1
+		BC4,
+		// two channels (16 bytes). RGTC2
+		BC5,
+		// high quality rgba (16 bytes). BPTC. Can't be decoded on the cpu
+		BC7,
+		// rgb (8 bytes), mostly used on mobile
+		ETC2_RGB,
+		// rgba (16 bytes), ETC2 colour + EAC alpha
+		ETC2_RGBA
+	};
+
+	// one mipmap level
+	struct Level {
+		int width = 0;
+		int height = 0;
+		// the blocks, left to right then top to bottom (in the file's row order)
+		std::vector<unsigned char> data;
+	};
+
+	// everything read out of a file
+	struct Image {
+		Format format = BC1;
+		// level 0 first
+		std::vector<Level> levels;
+		// whether the first row is the top of the image. Both formats are top down unless a KTX2 file says otherwise.
+		// The renderer is bottom up (like stb_image with flipping on) so these textures are flipped with their uv rect instead of moving blocks around
+		bool topDown = true;
+	};
+
+	// whether data (the start of a file, at least 12 bytes) is a DDS or KTX2 file
+	static bool IsContainer(const unsigned char* data, size_t size);
+
+	// reads a DDS or KTX2 file. Throws if it isn't one or uses a format that isn't listed above
+	static Image ReadFile(const char* filePath);
+
+	// Puts image into texture (which already has its ID from its constructor), compressed if the gpu supports the format or decoded if it doesn't
+	static void Upload(const Image& image, Texture2D& texture);
+
+	// whether the gpu can use format without decoding it. Needs GLExtensions loaded
+	static bool IsSupported(Format format);
+
+	// how many bytes each 4x4 block takes up
+	static int GetBlockSize(Format format);
+
+	// whether the format has an alpha channel
+	static bool HasAlpha(Format format);
+
+	// decodes a level into rgba (4 bytes a pixel). Throws for BC7
+	static std::vector<unsigned char> Decode(const Level& level, Format format);
+
+private:
+	// private constructor, only static functions
+	CompressedTexture();
+
+	static Image ReadDDS(const std::vector<unsigned char>& file);
+	static Image ReadKTX2(const std::vector<unsigned char>& file);
+
+	// size in bytes of a width x height level
+	static size_t GetLevelSize(Format format, int width, int height);
+
+	// the GL enum to upload format with
+	static GLenum GetGLFormat(Format format);
+
+	// -- block decoders, each one writes a 4x4 block of rgba into pixels (16 pixels, left to right then top to bottom) --
+	// BC1 colour. In BC2 and BC3 the colour is always the 4 colour version
+	static void DecodeBC1Colour(const unsigned char* block, unsigned char* pixels, bool alwaysFourColours);
+	// BC3 alpha / BC4 channel. Writes one channel, every stride bytes
+	static void DecodeBC4Channel(const unsigned char* block, unsigned char* pixels, int stride);
+	// ETC2 rgb (not the punchthrough alpha version)
+	static void DecodeETC2Colour(const unsigned char* block, unsigned char* pixels);
+	// EAC alpha, one channel every stride bytes
+	static void DecodeEACChannel(const unsigned char* block, unsigned char* pixels, int stride);
+	static void DecodeBlock(Format format, const unsigned char* block, unsigned char* pixels);
+};
+
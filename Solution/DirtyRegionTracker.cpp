@@ -0,0 +1,180 @@
+#include "DirtyRegionTracker.h"
+#include <algorithm>
+
+bool DirtyRegionTracker::Rect::IsEmpty() const
+{
+	return width <= 0 || height <= 0;
+}
+
+int DirtyRegionTracker::Rect::Area() const
+{
+	return IsEmpty() ? 0 : width * height;
+}
+
+bool DirtyRegionTracker::Rect::Overlaps(const Rect& other) const
+{
+	if (IsEmpty() || other.IsEmpty())
+		return false;
+	// overlapping on both axis
+	return x < other.x + other.width && other.x < x + width && y < other.y + other.height && other.y < y + height;
+}
+
+DirtyRegionTracker::Rect DirtyRegionTracker::Rect::Union(const Rect& other) const
+{
+	if (IsEmpty())
+		return other;
+	if (other.IsEmpty())
+		return *this;
+
+	Rect result;
+	result.x = std::min(x, other.x);
+	result.y = std::min(y, other.y);
+	result.width = std::max(x + width, other.x + other.width) - result.x;
+	result.height = std::max(y + height, other.y + other.height) - result.y;
+	return result;
+}
+
+void DirtyRegionTracker::BeginFrame(int viewportWidth, int viewportHeight, size_t frameHash)
+{
+	_frame++;
+	_regions.clear();
+
+	// first frame, resized or the camera/background changed
+	_fullRedraw = (_frame == 1 || viewportWidth != _viewportWidth || viewportHeight != _viewportHeight || frameHash != _frameHash);
+
+	_viewportWidth = viewportWidth;
+	_viewportHeight = viewportHeight;
+	_frameHash = frameHash;
+}
+
+void DirtyRegionTracker::MarkAllDirty()
+{
+	_fullRedraw = true;
+}
+
+void DirtyRegionTracker::TrackEntity(Entity* entity, Rect bounds, size_t stateHash)
+{
+	std::unordered_map<Entity*, EntityRecord>::iterator recordIterator = _entities.find(entity);
+
+	// new entity, only where it is now is dirty
+	if (recordIterator == _entities.end())
+	{
+		AddRegion(bounds);
+		_entities[entity] = EntityRecord{ bounds, stateHash, _frame };
+		return;
+	}
+
+	EntityRecord& record = recordIterator->second;
+	// something changed so where it was and where it is now both need redrawing
+	if (record.stateHash != stateHash || record.bounds.x != bounds.x || record.bounds.y != bounds.y 
+		|| record.bounds.width != bounds.width || record.bounds.height != bounds.height)
+	{
+		AddRegion(record.bounds);
+		AddRegion(bounds);
+	}
+
+	record.bounds = bounds;
+	record.stateHash = stateHash;
+	record.lastTrackedFrame = _frame;
+}
+
+void DirtyRegionTracker::EndTracking()
+{
+	// -- anything not tracked this frame isn't in the scene anymore --
+	for (std::unordered_map<Entity*, EntityRecord>::iterator recordIterator = _entities.begin(); recordIterator != _entities.end();)
+	{
+		if (recordIterator->second.lastTrackedFrame != _frame)
+		{
+			AddRegion(recordIterator->second.bounds);
+			recordIterator = _entities.erase(recordIterator);
+		}
+		else
+			recordIterator++;
+	}
+
+	int screenArea = std::max(_viewportWidth * _viewportHeight, 1);
+
+	if (_fullRedraw)
+	{
+		_redrawnFraction = 1.0f;
+		return;
+	}
+
+	// -- merge overlapping rects until none overlap --
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+		for (size_t i = 0; i < _regions.size() && !merged; i++)
+			for (size_t j = i + 1; j < _regions.size(); j++)
+				if (_regions[i].Overlaps(_regions[j]))
+				{
+					_regions[i] = _regions[i].Union(_regions[j]);
+					_regions.erase(_regions.begin() + j);
+					merged = true;
+					break;
+				}
+	}
+
+	// too many passes, just do one big one
+	if (_regions.size() > maxRegions)
+	{
+		Rect everything;
+		for (const Rect& region : _regions)
+			everything = everything.Union(region);
+		_regions.clear();
+		_regions.push_back(everything);
+	}
+
+	int dirtyArea = 0;
+	for (const Rect& region : _regions)
+		dirtyArea += region.Area();
+
+	_redrawnFraction = (float)dirtyArea / (float)screenArea;
+
+	// most of the screen changed anyway
+	if (_redrawnFraction > fullRedrawThreshold)
+	{
+		_fullRedraw = true;
+		_redrawnFraction = 1.0f;
+	}
+}
+
+bool DirtyRegionTracker::IsFullRedraw()
+{
+	return _fullRedraw;
+}
+
+const std::vector<DirtyRegionTracker::Rect>& DirtyRegionTracker::GetRegions()
+{
+	return _regions;
+}
+
+DirtyRegionTracker::Rect DirtyRegionTracker::GetBounds(Entity* entity)
+{
+	std::unordered_map<Entity*, EntityRecord>::iterator recordIterator = _entities.find(entity);
+	if (recordIterator == _entities.end())
+		return Rect();
+	return recordIterator->second.bounds;
+}
+
+float DirtyRegionTracker::GetRedrawnFraction()
+{
+	return _redrawnFraction;
+}
+
+void DirtyRegionTracker::AddRegion(Rect rect)
+{
+	// clip to the viewport
+	int left = std::max(rect.x, 0);
+	int bottom = std::max(rect.y, 0);
+	int right = std::min(rect.x + rect.width, _viewportWidth);
+	int top = std::min(rect.y + rect.height, _viewportHeight);
+
+	Rect clipped{ left, bottom, right - left, top - bottom };
+	// off screen
+	if (clipped.IsEmpty())
+		return;
+
+	_regions.push_back(clipped);
+}
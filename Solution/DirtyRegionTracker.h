@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// forward declare entity
+class Entity;
+
+// Keeps track of which parts of the screen changed since the last frame, for the scene's partial redraw mode.
+// Each frame the scene tells it the screen bounds and state hash of every entity. Anything that changed (moved, recoloured, added, removed etc.)
+// marks both its old and new bounds as dirty. The dirty rects are then merged so the scene can redraw just those parts of the screen with glScissor.
+// If the camera, viewport or background changes everything is dirty
+class DirtyRegionTracker
+{
+public:
+	// a rectangle in screen pixels, (0,0) is the bottom left
+	struct Rect {
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+
+		bool IsEmpty() const;
+		int Area() const;
+		bool Overlaps(const Rect& other) const;
+		// smallest rect that covers both
+		Rect Union(const Rect& other) const;
+	};
+
+	// If there are more dirty rects than this after merging they all become one. Every rect is a separate pass over the entities so don't make this too big
+	unsigned int maxRegions = 8;
+
+	// if the dirty area is more than this fraction of the screen it is cheaper to just redraw everything
+	float fullRedrawThreshold = 0.6f;
+
+	// Start tracking a frame. frameHash is a hash of anything that changes every pixel (camera, background colour), a change means a full redraw
+	void BeginFrame(int viewportWidth, int viewportHeight, size_t frameHash);
+
+	// makes this frame a full redraw
+	void MarkAllDirty();
+
+	// give the entity's current screen bounds and state. Call for every entity in the scene, every frame
+	void TrackEntity(Entity* entity, Rect bounds, size_t stateHash);
+
+	// Call after every entity has been tracked. Anything not tracked this frame was removed so its old bounds become dirty. Then the dirty rects are merged
+	void EndTracking();
+
+	// whether the whole screen needs redrawing this frame
+	bool IsFullRedraw();
+
+	// the merged dirty rects for this frame. Only valid if not a full redraw
+	const std::vector<Rect>& GetRegions();
+
+	// bounds of an entity this frame, empty if it isn't tracked
+	Rect GetBounds(Entity* entity);
+
+	// fraction of the screen that was redrawn last frame (0 to 1). Handy to see how much partial redraw is actually saving
+	float GetRedrawnFraction();
+
+private:
+	// what an entity looked like last time it was tracked
+	struct EntityRecord {
+		Rect bounds;
+		size_t stateHash = 0;
+		// frame it was last tracked in, used to find removed entities
+		unsigned int lastTrackedFrame = 0;
+	};
+
+	std::unordered_map<Entity*, EntityRecord> _entities;
+	std::vector<Rect> _regions;
+
+	unsigned int _frame = 0;
+	int _viewportWidth = 0;
+	int _viewportHeight = 0;
+	size_t _frameHash = 0;
+	bool _fullRedraw = true;
+	float _redrawnFraction = 1.0f;
+
+	// adds a dirty rect (clipped to the viewport)
+	void AddRegion(Rect rect);
+};
+
@@ -0,0 +1,216 @@
+#include "DrawBatcher.h"
+#include "GLExtensions.h"
+#include <cstring>
+
+bool DrawBatcher::DrawState::operator==(const DrawState& other) const
+{
+	return program == other.program && layout == other.layout && textureTarget == other.textureTarget && texture == other.texture
+		&& depthWrite == other.depthWrite;
+}
+
+bool DrawBatcher::MeshRange::operator==(const MeshRange& other) const
+{
+	return indexCount == other.indexCount && firstIndex == other.firstIndex && baseVertex == other.baseVertex;
+}
+
+float DrawBatcher::Stats::DrawsPerSubmission()
+{
+	// avoid dividing by 0 on an empty frame
+	if (submissions == 0)
+		return 0.0f;
+	return (float)commands / (float)submissions;
+}
+
+DrawBatcher::DrawBatcher(StreamBuffer* streamBuffer)
+{
+	_streamBuffer = streamBuffer;
+}
+
+void DrawBatcher::Begin(std::shared_ptr<OrthoCamera> camera)
+{
+	// the camera doesn't change often during a frame so only calculate these once
+	_view = camera->GetViewMatrix();
+	_projection = camera->GetProjectionMatrix();
+
+	// start a new frame of stats
+	_frameStats = Stats();
+}
+
+void DrawBatcher::SetCamera(std::shared_ptr<OrthoCamera> camera)
+{
+	// anything already added was meant for the old camera
+	Submit();
+
+	_view = camera->GetViewMatrix();
+	_projection = camera->GetProjectionMatrix();
+}
+
+void DrawBatcher::AddInstance(const DrawState& state, const MeshRange& mesh, const void* instanceData)
+{
+	// copy the instance data in
+	memcpy(AddInstances(state, mesh, 1), instanceData, state.layout->stride);
+}
+
+void* DrawBatcher::AddInstances(const DrawState& state, const MeshRange& mesh, unsigned int count)
+{
+	if (state.program == nullptr || state.layout == nullptr)
+		throw std::exception("Tried to add a draw to the batcher without a program or layout");
+
+	// anything with different GL state can't go in the same submission
+	if (!(state == _state))
+	{
+		Submit();
+		_state = state;
+	}
+
+	// if the last command draws the same part of the mesh then just make it draw more instances
+	if (!_commands.empty() && _commands.back().mesh == mesh)
+		_commands.back().instanceCount += count;
+	else
+		// otherwise it needs a new command, whose instances start after everything already in the submission
+		_commands.push_back(Command{ mesh, count, _instanceCount });
+
+	// make room for the instance data
+	GLsizei stride = state.layout->stride;
+	size_t oldSize = _instanceData.size();
+	_instanceData.resize(oldSize + (size_t)stride * count);
+	_instanceCount += count;
+	return _instanceData.data() + oldSize;
+}
+
+void DrawBatcher::Flush()
+{
+	Submit();
+}
+
+void DrawBatcher::End()
+{
+	Submit();
+	_lastFrameStats = _frameStats;
+}
+
+DrawBatcher::Stats DrawBatcher::GetStats()
+{
+	return _lastFrameStats;
+}
+
+glm::mat4 DrawBatcher::GetViewMatrix()
+{
+	return _view;
+}
+
+glm::mat4 DrawBatcher::GetProjectionMatrix()
+{
+	return _projection;
+}
+
+void DrawBatcher::Submit()
+{
+	// nothing to draw
+	if (_commands.empty())
+		return;
+
+	InstanceLayout* layout = _state.layout;
+	GLsizei stride = layout->stride;
+
+	// -- put the instance data in the stream buffer --
+	// aligned to the stride so that the offset is a whole number of instances
+	StreamBuffer::Allocation instanceAllocation = _streamBuffer->Allocate(_instanceData.size(), stride);
+
+	// only draw if there was room in the stream buffer, if not it will have grown by next frame
+	if (instanceAllocation.data != nullptr)
+	{
+		memcpy(instanceAllocation.data, _instanceData.data(), _instanceData.size());
+		// which instance (counting from the start of the stream buffer) this submission's data starts at
+		GLuint firstInstance = (GLuint)(instanceAllocation.offset / stride);
+
+		// -- set up state --
+		_state.program->Use();
+		_state.program->SetMatrix4("view", _view);
+		_state.program->SetMatrix4("projection", _projection);
+
+		if (_state.texture != 0)
+		{
+			// bind texture onto corresponding texture unit
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(_state.textureTarget, _state.texture);
+		}
+
+		if (!_state.depthWrite)
+			glDepthMask(GL_FALSE);
+
+		_frameStats.submissions++;
+		_frameStats.commands += (unsigned int)_commands.size();
+		_frameStats.instances += _instanceCount;
+
+		// -- try to draw everything with one multi draw indirect --
+		bool drewIndirect = false;
+		if (useMultiDrawIndirect && GLExtensions::hasMultiDrawIndirect && _commands.size() > 1)
+		{
+			StreamBuffer::Allocation commandAllocation = _streamBuffer->Allocate(_commands.size() * sizeof(DrawElementsIndirectCommand), sizeof(GLuint));
+			if (commandAllocation.data != nullptr)
+			{
+				DrawElementsIndirectCommand* indirectCommands = (DrawElementsIndirectCommand*)commandAllocation.data;
+				for (size_t i = 0; i < _commands.size(); i++)
+				{
+					const Command& command = _commands[i];
+					indirectCommands[i].count = command.mesh.indexCount;
+					indirectCommands[i].instanceCount = command.instanceCount;
+					indirectCommands[i].firstIndex = command.mesh.firstIndex;
+					indirectCommands[i].baseVertex = command.mesh.baseVertex;
+					indirectCommands[i].baseInstance = firstInstance + command.baseInstance;
+				}
+				_streamBuffer->Flush();
+
+				// base instance does the offsetting so the instance data is pointed at the start of the buffer
+				layout->BindInstanceData(_streamBuffer->ID, _streamBuffer->GetGeneration(), 0);
+				// the indirect commands come from the stream buffer as well
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _streamBuffer->ID);
+				GLExtensions::MultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)commandAllocation.offset, (GLsizei)_commands.size(), 0);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+				_frameStats.drawCalls++;
+				drewIndirect = true;
+			}
+		}
+
+		// -- fallback, one instanced draw per command --
+		if (!drewIndirect)
+		{
+			_streamBuffer->Flush();
+
+			for (const Command& command : _commands)
+			{
+				GLuint baseInstance = firstInstance + command.baseInstance;
+				// byte offset into the element buffer of the first index
+				void* indexOffset = (void*)(command.mesh.firstIndex * sizeof(GLuint));
+
+				if (GLExtensions::hasBaseInstance)
+				{
+					// attributes point at the start of the buffer and the draw picks the base instance
+					layout->BindInstanceData(_streamBuffer->ID, _streamBuffer->GetGeneration(), 0);
+					GLExtensions::DrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.mesh.indexCount, GL_UNSIGNED_INT, indexOffset,
+						command.instanceCount, command.mesh.baseVertex, baseInstance);
+				}
+				else
+				{
+					// GL 3.3 has no base instance so point the attributes straight at this command's instance data instead
+					layout->BindInstanceData(_streamBuffer->ID, _streamBuffer->GetGeneration(), (GLintptr)baseInstance * stride);
+					glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.mesh.indexCount, GL_UNSIGNED_INT, indexOffset,
+						command.instanceCount, command.mesh.baseVertex);
+				}
+
+				_frameStats.drawCalls++;
+			}
+		}
+
+		glBindVertexArray(0);
+		if (!_state.depthWrite)
+			glDepthMask(GL_TRUE);
+	}
+
+	// start a new empty submission
+	_commands.clear();
+	_instanceData.clear();
+	_instanceCount = 0;
+}
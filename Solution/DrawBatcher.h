@@ -0,0 +1,139 @@
+#pragma once
+#include <glad/glad.h>
+#include <memory>
+#include <vector>
+#include "ShaderProgram.h"
+#include "InstanceLayout.h"
+#include "StreamBuffer.h"
+#include "OrthoCamera.h"
+
+// Renderers don't draw straight away anymore, they hand their per-instance data to the scene's draw batcher instead.
+// Consecutive draws that share the same GL state (program, mesh layout and texture) become one submission:
+//  - draws of the same part of a mesh are merged into one instanced draw command
+//  - draws of different parts of the mesh (e.g. different base vertex) are separate commands in that submission
+// A submission with more than one command is drawn with a single glMultiDrawElementsIndirect when the driver supports it,
+// otherwise it falls back to a loop of instanced draws (GL 3.3).
+// Submission order is the same as the order draws were added in, so back to front sorting of transparent entities still works
+class DrawBatcher
+{
+public:
+	// GL state that has to be the same for draws to end up in one submission
+	struct DrawState {
+		// program to draw with
+		ShaderProgram* program = nullptr;
+		// mesh + instance data layout
+		InstanceLayout* layout = nullptr;
+		// what kind of texture is bound (GL_TEXTURE_2D etc.)
+		unsigned int textureTarget = GL_TEXTURE_2D;
+		// texture bound to texture unit 0, 0 for none
+		unsigned int texture = 0;
+		// Whether the draw writes to the depth buffer. Off for things like particles that overlap each other at the same depth,
+		// otherwise whichever is drawn first hides the rest instead of them blending
+		bool depthWrite = true;
+
+		bool operator==(const DrawState& other) const;
+	};
+
+	// which part of a layout's mesh to draw
+	struct MeshRange {
+		// how many indices to draw
+		GLsizei indexCount = 0;
+		// which index in the element buffer to start from
+		GLuint firstIndex = 0;
+		// value added to every index before fetching a vertex
+		GLint baseVertex = 0;
+
+		bool operator==(const MeshRange& other) const;
+	};
+
+	// How much drawing happened in a frame
+	struct Stats {
+		// how many times GL state was set up for a group of draws
+		unsigned int submissions = 0;
+		// how many actual GL draw calls were made
+		unsigned int drawCalls = 0;
+		// how many draw commands there were. An instanced draw of 100 rects is 1 command
+		unsigned int commands = 0;
+		// how many instances were drawn in total
+		unsigned int instances = 0;
+
+		// average amount of draw commands that each submission contained
+		float DrawsPerSubmission();
+	};
+
+	// create a draw batcher which puts all of its instance data and indirect commands in streamBuffer
+	DrawBatcher(StreamBuffer* streamBuffer);
+
+	// whether to use multi draw indirect when it is supported. Turn off to compare against the fallback loop
+	bool useMultiDrawIndirect = true;
+
+	// Call at the start of drawing a frame, with the camera that everything is being drawn from
+	void Begin(std::shared_ptr<OrthoCamera> camera);
+
+	// Draws anything waiting and then draws everything after this from a different camera (e.g. when drawing into a render layer)
+	void SetCamera(std::shared_ptr<OrthoCamera> camera);
+
+	// Adds one instance of the given mesh range to be drawn. instanceData must be state.layout->stride bytes and is copied straight away
+	void AddInstance(const DrawState& state, const MeshRange& mesh, const void* instanceData);
+
+	// Adds count instances of the given mesh range and returns where to write their data (count * state.layout->stride bytes).
+	// For renderers with lots of instances (e.g. particles) so they can be written in one go. Only valid until the next call to the batcher
+	void* AddInstances(const DrawState& state, const MeshRange& mesh, unsigned int count);
+
+	// Draws anything that is still waiting. Call this before doing any GL drawing that doesn't go through the batcher
+	void Flush();
+
+	// Call once everything in the frame has been added. Flushes and saves the frame's stats
+	void End();
+
+	// returns stats for the last frame that was finished with End()
+	Stats GetStats();
+
+	// view and projection matrices of the camera being drawn from, for renderers that draw themselves after a Flush
+	glm::mat4 GetViewMatrix();
+	glm::mat4 GetProjectionMatrix();
+
+private:
+	// one command in a submission
+	struct Command {
+		// part of the mesh to draw
+		MeshRange mesh;
+		// how many instances
+		GLuint instanceCount;
+		// index of the first instance, relative to the start of the submission's instance data
+		GLuint baseInstance;
+	};
+
+	// the layout glMultiDrawElementsIndirect expects each command in the buffer to be in
+	struct DrawElementsIndirectCommand {
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// where instance data and indirect commands are written
+	StreamBuffer* _streamBuffer;
+
+	// view and projection matrices of the camera for the current frame
+	glm::mat4 _view = glm::mat4(1.0f);
+	glm::mat4 _projection = glm::mat4(1.0f);
+
+	// state of the submission currently being built
+	DrawState _state;
+	// commands in the submission currently being built
+	std::vector<Command> _commands;
+	// instance data of every command in the current submission, one after the other
+	std::vector<unsigned char> _instanceData;
+	// how many instances are in the current submission
+	GLuint _instanceCount = 0;
+
+	// stats for the frame being drawn and the last finished frame
+	Stats _frameStats;
+	Stats _lastFrameStats;
+
+	// draws the current submission and starts a new empty one
+	void Submit();
+};
+
@@ -3,43 +3,42 @@
 #include "ShaderProgram.h"
 #include "OrthoCamera.h"
 
-// An ellipse renderer is used to render, well ellipses. It is essentially the same as a rectangle renderer, the only difference being it has a circle shader
+// An ellipse renderer is used to render, well ellipses. It is drawn the same way as a rectangle renderer, the shape shader just works out the ellipse instead
 // I stick to using a transform and not radiusX/radiusY because it fits well with the other components
 class EllipseRenderer :
     public Component
 {
 public:
     // Setup a new ellipse renderer using given shader program and colour 
-    // NOTE: If shader program is set to nullptr it will use a default shader
+    // NOTE: If shader program is set to nullptr it will use the default shape shader. A custom shader has to take the same per-instance attributes as ShapeDefault.vert
     EllipseRenderer(glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
-    ~EllipseRenderer();
 
     // colour of the ellipse
     glm::vec3 color;
 
+    // colour of the border
+    glm::vec3 borderColor = glm::vec3(0.0f);
+
+    // width of the border (global coords) drawn inside the edge of the ellipse. 0 for no border
+    float borderWidth = 0.0f;
+
     // get the alpha (transparency) value of this ellipse
     float GetAlpha();
 
     // set the alpha (transparency) value of this ellipse. 
     void SetAlpha(float newAlpha);
 
-    // draw an ellipse using reference to scene camera and parent entity's transform
+    // draw an ellipse using reference to scene camera and parent entity's transform.
+    // The ellipse is added to the scene's draw batcher so it gets drawn along with every other shape that uses the same program
     void Draw(std::shared_ptr<OrthoCamera> camera);
 
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing
+    size_t GetStateHash();
+
 private:
     // the alpha channel (transparency) of the current sprite
     float _alpha = 1.0f;
     // shader program that the renderer uses
     ShaderProgram* shaderProgram;
-    // default vertex sahader
-    const char* defaultVertPath = "VertexShaders/EllipseDefault.vert";
-    // default frag sahader
-    const char* defaultFragPath = "FragmentShaders/EllipseDefault.frag";
-    // vretex array object ID for the sprite's rect
-    unsigned int rectVAO;
-    unsigned int rectVBO;
-    unsigned int rectEBO;
-    // Initializes and configures the rects's buffer and vertex attributes
-    void InitRenderData();
 };
 
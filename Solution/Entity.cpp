@@ -1,5 +1,7 @@
 #include "Entity.h"
 #include "Scene.h"
+#include "SpriteAnimator.h"
+#include "SpriteRenderer.h"
 
 Entity::Entity(Transform transform)
 {
@@ -30,6 +32,23 @@ void Entity::SetHasTransparency(bool newTransparency)
         _hasTransparency = newTransparency;
 }
 
+bool Entity::GetIsStatic()
+{
+    return _isStatic;
+}
+
+void Entity::SetIsStatic(bool newIsStatic)
+{
+    // nothing changed
+    if (newIsStatic == _isStatic)
+        return;
+
+    _isStatic = newIsStatic;
+    // if entity is attached to a scene it has to start/stop keeping track of it for baking. Otherwise it's handled when the entity is added to a scene
+    if (parentScene != nullptr)
+        parentScene->UpdateEntityStatic(this);
+}
+
 std::string Entity::GetName()
 {
     // return the entity's name
@@ -68,8 +87,15 @@ void Entity::AddComponent(ComponentType type, std::shared_ptr<Component> compone
         // insert the new component
         _components.insert(std::pair<ComponentType, std::shared_ptr<Component>>(type, component));
     else
+    {
         // can't specify what type of component enum tried to add because that requires a switch case and I should just get it right first time yknow
         std::cout << "ERROR: Tried to add component to entity " << _name << " which already exists" << std::endl;
+        return;
+    }
+
+    // sprite animators show frames on the sprite renderer, hook them up now instead of the animator looking for it every update
+    if (type == SpriteAnimator || type == SpriteRenderer)
+        LinkSpriteAnimator();
 }
 
 
@@ -84,10 +110,23 @@ void Entity::RemoveComponent(ComponentType type)
 
         // remove component from map
         _components.erase(type);
+
+        // the animator can't keep showing frames on a renderer that's gone, or on this entity's renderer once it's gone itself
+        if (type == SpriteRenderer)
+            LinkSpriteAnimator();
+        else if (type == SpriteAnimator)
+            std::static_pointer_cast<::SpriteAnimator>(compToRemove)->SetSpriteRenderer(nullptr);
     }
 
 }
 
+void Entity::LinkSpriteAnimator()
+{
+    std::shared_ptr<::SpriteAnimator> animator = GetComponent<::SpriteAnimator>(SpriteAnimator);
+    if (animator != nullptr)
+        animator->SetSpriteRenderer(GetComponent<::SpriteRenderer>(SpriteRenderer).get());
+}
+
 std::map<Entity::ComponentType, std::shared_ptr<Component>>& Entity::GetComponents()
 {
     return _components;
@@ -22,11 +22,22 @@ public:
 		SpriteRenderer,
 		RectangleRenderer,
 		EllipseRenderer,
-		LineRenderer
+		LineRenderer,
+		PolylineRenderer,
+		TextRenderer,
+		ParticleSystem,
+		GPUParticleSystem,
+		TilemapRenderer,
+		PolygonRenderer,
+		SpriteAnimator,
+		PathRenderer
 	} ;
 	// whether or not the entity is active in scene. Dictates whether components are called each frame
 	bool isActive = true;
 
+	// Tag of the render layer the entity belongs to (see RenderLayer). Empty means it isn't in a tagged layer
+	std::string layerTag = "";
+
 	
 
 	// transformation of entity
@@ -38,6 +49,13 @@ public:
 	// sets the transparency of the current entity
 	void SetHasTransparency(bool newTransparency);
 
+	// returns whether the entity is static (see SetIsStatic)
+	bool GetIsStatic();
+
+	// Static entities are meant to never move after they're loaded. The scene bakes their opaque rects, sprites and lines into combined vertex buffers
+	// so they're drawn a whole batch at a time instead of one by one (see Scene::BakeStatic). Changing one still works, it just makes its batch get baked again
+	void SetIsStatic(bool newIsStatic);
+
 	// returns the name of the entity, DOES NOT RETURN POINTER TO ENTITY NAME
 	std::string GetName();
 
@@ -76,10 +94,14 @@ protected:
 	
 	// Whether the entity has any transparency (if opaque then false)
 	bool _hasTransparency = false;
+	// whether the entity is static
+	bool _isStatic = false;
 	// Returns whether or not an entity contains a component of type
 	bool ComponentExists(ComponentType type);
 	// function that returns base component using type
 	std::shared_ptr<Component> GetBaseComponent(ComponentType type);
+	// gives the sprite animator (if there is one) the entity's sprite renderer, called when either is added or removed
+	void LinkSpriteAnimator();
 
 	// list of all components under the entity (stored as unique pointers), indexed by type
 	std::map<ComponentType,  std::shared_ptr<Component>> _components;
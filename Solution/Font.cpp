@@ -0,0 +1,996 @@
+#include "Font.h"
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// start of every baked font file, bump the version if the layout changes
+static const char bakedMagic[4] = { 'G', 'R', 'S', 'F' };
+static const unsigned int bakedVersion = 1;
+
+// Decodes the next character of a utf-8 string and moves index past it. Broken bytes come out as the replacement character
+static unsigned int NextCodepoint(const std::string& text, size_t& index)
+{
+	unsigned char first = (unsigned char)text[index++];
+	if (first < 0x80)
+		return first;
+
+	// how many bytes follow is in the top bits of the first one
+	int extraBytes;
+	unsigned int codepoint;
+	if ((first & 0xE0) == 0xC0)
+	{
+		extraBytes = 1;
+		codepoint = first & 0x1F;
+	}
+	else if ((first & 0xF0) == 0xE0)
+	{
+		extraBytes = 2;
+		codepoint = first & 0x0F;
+	}
+	else if ((first & 0xF8) == 0xF0)
+	{
+		extraBytes = 3;
+		codepoint = first & 0x07;
+	}
+	else
+		return 0xFFFD;
+
+	for (int i = 0; i < extraBytes; i++)
+	{
+		if (index >= text.size() || ((unsigned char)text[index] & 0xC0) != 0x80)
+			return 0xFFFD;
+		codepoint = (codepoint << 6) | ((unsigned char)text[index++] & 0x3F);
+	}
+	return codepoint;
+}
+
+// squared distance from point to the line segment a to b
+static float SegmentDistanceSquared(glm::vec2 point, glm::vec2 a, glm::vec2 b)
+{
+	glm::vec2 segment = b - a;
+	float lengthSquared = glm::dot(segment, segment);
+	float t = lengthSquared > 0.0f ? glm::clamp(glm::dot(point - a, segment) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+	glm::vec2 difference = point - (a + segment * t);
+	return glm::dot(difference, difference);
+}
+
+template <typename T>
+static void WriteValue(std::ofstream& file, T value)
+{
+	file.write((const char*)&value, sizeof(T));
+}
+
+template <typename T>
+static T ReadValue(std::ifstream& file)
+{
+	T value{};
+	file.read((char*)&value, sizeof(T));
+	return value;
+}
+
+Font::Font(std::string name)
+	: name(name)
+{
+}
+
+bool Font::IsBakedFile(const unsigned char* data, size_t size)
+{
+	return size >= 4 && memcmp(data, bakedMagic, 4) == 0;
+}
+
+void Font::LoadTTF(const char* filePath)
+{
+	std::ifstream fileStream(filePath, std::ios::binary);
+	if (!fileStream)
+		throw std::exception("Failed to open font file");
+	_fontData = std::vector<unsigned char>((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+
+	// -- find the tables --
+	// 0x00010000 is TrueType outlines, "OTTO" would be CFF which isn't supported
+	if (ReadU32(0) != 0x00010000 && ReadU32(0) != 0x74727565)
+		throw std::exception("Font file isn't a TrueType font");
+	size_t headOffset = 0, hheaOffset = 0, maxpOffset = 0, kernOffset = 0;
+	unsigned int tableCount = ReadU16(4);
+	for (unsigned int i = 0; i < tableCount; i++)
+	{
+		size_t record = 12 + 16 * (size_t)i;
+		if (record + 16 > _fontData.size())
+			throw std::exception("Font file is cut off");
+		const char* tag = (const char*)&_fontData[record];
+		size_t tableOffset = ReadU32(record + 8);
+		if (memcmp(tag, "head", 4) == 0) headOffset = tableOffset;
+		else if (memcmp(tag, "hhea", 4) == 0) hheaOffset = tableOffset;
+		else if (memcmp(tag, "maxp", 4) == 0) maxpOffset = tableOffset;
+		else if (memcmp(tag, "cmap", 4) == 0) _cmapOffset = tableOffset;
+		else if (memcmp(tag, "loca", 4) == 0) _locaOffset = tableOffset;
+		else if (memcmp(tag, "glyf", 4) == 0) _glyfOffset = tableOffset;
+		else if (memcmp(tag, "hmtx", 4) == 0) _hmtxOffset = tableOffset;
+		else if (memcmp(tag, "kern", 4) == 0) kernOffset = tableOffset;
+	}
+	if (!headOffset || !hheaOffset || !maxpOffset || !_cmapOffset || !_locaOffset || !_glyfOffset || !_hmtxOffset)
+		throw std::exception("Font file is missing a table it needs");
+
+	// -- metrics --
+	_unitsPerEm = ReadU16(headOffset + 18);
+	if (_unitsPerEm == 0)
+		throw std::exception("Font file has a bad head table");
+	_indexToLocFormat = ReadI16(headOffset + 50);
+	_glyphCount = ReadU16(maxpOffset + 4);
+	ascender = ReadI16(hheaOffset + 4) / (float)_unitsPerEm;
+	descender = ReadI16(hheaOffset + 6) / (float)_unitsPerEm;
+	lineGap = ReadI16(hheaOffset + 8) / (float)_unitsPerEm;
+	_numberOfHMetrics = ReadU16(hheaOffset + 34);
+	if (_numberOfHMetrics == 0)
+		throw std::exception("Font file has a bad hhea table");
+
+	// -- pick the unicode character map, full unicode (format 12) if it's there otherwise the basic plane (format 4) --
+	unsigned int cmapTableCount = ReadU16(_cmapOffset + 2);
+	for (unsigned int i = 0; i < cmapTableCount; i++)
+	{
+		size_t record = _cmapOffset + 4 + 8 * (size_t)i;
+		unsigned int platformID = ReadU16(record);
+		unsigned int encodingID = ReadU16(record + 2);
+		size_t subtableOffset = _cmapOffset + ReadU32(record + 4);
+		unsigned int format = ReadU16(subtableOffset);
+		// platform 0 is unicode, platform 3 is windows where 1 is the basic plane and 10 is full unicode
+		bool isUnicode = platformID == 0 || (platformID == 3 && (encodingID == 1 || encodingID == 10));
+		if (!isUnicode)
+			continue;
+		if (format == 12 || (format == 4 && _cmapFormat != 12))
+		{
+			_cmapSubtableOffset = subtableOffset;
+			_cmapFormat = format;
+		}
+	}
+	if (_cmapFormat == 0)
+		throw std::exception("Font file has no unicode character map");
+
+	if (kernOffset)
+		ReadKerning(kernOffset);
+
+	// -- make the atlas and the glyphs that'll nearly always be needed --
+	CreateAtlas(atlasSize, atlasSize);
+	std::string printableAscii;
+	for (char character = 32; character < 127; character++)
+		printableAscii += character;
+	AddGlyphs(printableAscii);
+}
+
+void Font::LoadBaked(const char* filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file)
+		throw std::exception("Failed to open baked font file");
+
+	char magic[4] = {};
+	file.read(magic, 4);
+	if (!IsBakedFile((const unsigned char*)magic, (size_t)file.gcount()) || ReadValue<unsigned int>(file) != bakedVersion)
+		throw std::exception("File isn't a baked font or was baked by a different version");
+
+	ascender = ReadValue<float>(file);
+	descender = ReadValue<float>(file);
+	lineGap = ReadValue<float>(file);
+	sdfGlyphSize = ReadValue<int>(file);
+	sdfSpread = ReadValue<int>(file);
+	int width = ReadValue<int>(file);
+	int height = ReadValue<int>(file);
+
+	_fontData.clear();
+	_glyphs.clear();
+	_codepointKerning.clear();
+	_layouts.clear();
+
+	unsigned int glyphCount = ReadValue<unsigned int>(file);
+	for (unsigned int i = 0; i < glyphCount && file; i++)
+	{
+		Glyph glyph;
+		glyph.codepoint = ReadValue<unsigned int>(file);
+		glyph.advance = ReadValue<float>(file);
+		glyph.offset.x = ReadValue<float>(file);
+		glyph.offset.y = ReadValue<float>(file);
+		glyph.size.x = ReadValue<float>(file);
+		glyph.size.y = ReadValue<float>(file);
+		glyph.atlasX = ReadValue<int>(file);
+		glyph.atlasY = ReadValue<int>(file);
+		glyph.atlasWidth = ReadValue<int>(file);
+		glyph.atlasHeight = ReadValue<int>(file);
+		glyph.hasImage = glyph.atlasWidth > 0 && glyph.atlasHeight > 0;
+		_glyphs[glyph.codepoint] = glyph;
+	}
+
+	unsigned int kerningCount = ReadValue<unsigned int>(file);
+	for (unsigned int i = 0; i < kerningCount && file; i++)
+	{
+		unsigned long long left = ReadValue<unsigned int>(file);
+		unsigned long long right = ReadValue<unsigned int>(file);
+		_codepointKerning[(left << 32) | right] = ReadValue<float>(file);
+	}
+
+	if (width <= 0 || height <= 0)
+		throw std::exception("Baked font file has a bad atlas size");
+	std::vector<unsigned char> pixels((size_t)width * height);
+	file.read((char*)pixels.data(), pixels.size());
+	if (!file)
+		throw std::exception("Baked font file is cut off");
+
+	CreateAtlas(width, height);
+	_atlasPixels = std::move(pixels);
+	glBindTexture(GL_TEXTURE_2D, _textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _atlasWidth, _atlasHeight, GL_RED, GL_UNSIGNED_BYTE, _atlasPixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	for (auto& pair : _glyphs)
+		UpdateUVRect(pair.second);
+	_revision++;
+}
+
+void Font::SaveBaked(const char* filePath)
+{
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		throw std::exception("Failed to open baked font file for writing");
+
+	file.write(bakedMagic, 4);
+	WriteValue(file, bakedVersion);
+	WriteValue(file, ascender);
+	WriteValue(file, descender);
+	WriteValue(file, lineGap);
+	WriteValue(file, sdfGlyphSize);
+	WriteValue(file, sdfSpread);
+	WriteValue(file, _atlasWidth);
+	WriteValue(file, _atlasHeight);
+
+	WriteValue(file, (unsigned int)_glyphs.size());
+	for (auto& pair : _glyphs)
+	{
+		const Glyph& glyph = pair.second;
+		WriteValue(file, glyph.codepoint);
+		WriteValue(file, glyph.advance);
+		WriteValue(file, glyph.offset.x);
+		WriteValue(file, glyph.offset.y);
+		WriteValue(file, glyph.size.x);
+		WriteValue(file, glyph.size.y);
+		WriteValue(file, glyph.atlasX);
+		WriteValue(file, glyph.atlasY);
+		WriteValue(file, glyph.atlasWidth);
+		WriteValue(file, glyph.atlasHeight);
+	}
+
+	// the kerning of every pair of baked glyphs, the glyph indices it's stored under in the ttf won't exist anymore
+	std::vector<std::pair<unsigned long long, float>> kerning;
+	for (auto& left : _glyphs)
+	{
+		for (auto& right : _glyphs)
+		{
+			float amount = GetKerning(left.first, right.first);
+			if (amount != 0.0f)
+				kerning.push_back({ ((unsigned long long)left.first << 32) | right.first, amount });
+		}
+	}
+	WriteValue(file, (unsigned int)kerning.size());
+	for (auto& pair : kerning)
+	{
+		WriteValue(file, (unsigned int)(pair.first >> 32));
+		WriteValue(file, (unsigned int)(pair.first & 0xFFFFFFFF));
+		WriteValue(file, pair.second);
+	}
+
+	file.write((const char*)_atlasPixels.data(), _atlasPixels.size());
+	if (!file)
+		throw std::exception("Failed to write baked font file");
+}
+
+void Font::AddGlyphs(const std::string& text)
+{
+	for (size_t index = 0; index < text.size();)
+	{
+		unsigned int codepoint = NextCodepoint(text, index);
+		if (codepoint != '\n' && codepoint != '\r')
+			GetGlyph(codepoint);
+	}
+}
+
+const Font::Glyph* Font::GetGlyph(unsigned int codepoint)
+{
+	auto iterator = _glyphs.find(codepoint);
+	if (iterator != _glyphs.end())
+		return &iterator->second;
+
+	// baked fonts can't make new glyphs
+	if (_fontData.empty())
+		return codepoint != '?' ? GetGlyph('?') : nullptr;
+
+	// characters the font doesn't have all share its missing glyph, stored under 0, instead of each getting a copy in the atlas
+	if (codepoint != 0 && GetGlyphIndex(codepoint) == 0)
+		return GetGlyph(0);
+
+	Glyph glyph = MakeGlyph(codepoint);
+	_revision++;
+	// unordered_map never moves its elements so this pointer stays valid while more glyphs are added
+	return &_glyphs.emplace(codepoint, glyph).first->second;
+}
+
+float Font::GetKerning(unsigned int leftCodepoint, unsigned int rightCodepoint)
+{
+	if (!_fontData.empty())
+	{
+		if (_glyphKerning.empty())
+			return 0.0f;
+		unsigned int key = (GetGlyphIndex(leftCodepoint) << 16) | GetGlyphIndex(rightCodepoint);
+		auto iterator = _glyphKerning.find(key);
+		return iterator != _glyphKerning.end() ? iterator->second / (float)_unitsPerEm : 0.0f;
+	}
+
+	auto iterator = _codepointKerning.find(((unsigned long long)leftCodepoint << 32) | rightCodepoint);
+	return iterator != _codepointKerning.end() ? iterator->second : 0.0f;
+}
+
+std::shared_ptr<const Font::Layout> Font::GetLayout(const std::string& text, float fontSize, Alignment alignment, float wrapWidth)
+{
+	// the key is the text followed by the raw bytes of everything else
+	std::string key = text;
+	key.push_back('\0');
+	key.append((const char*)&fontSize, sizeof(fontSize));
+	key.append((const char*)&alignment, sizeof(alignment));
+	key.append((const char*)&wrapWidth, sizeof(wrapWidth));
+
+	auto iterator = _layouts.find(key);
+	if (iterator != _layouts.end())
+	{
+		layoutCacheHits++;
+		return iterator->second;
+	}
+	layoutCacheMisses++;
+
+	// full, throw away the ones only the cache is holding on to
+	if (_layouts.size() >= maxCachedLayouts)
+	{
+		for (auto cached = _layouts.begin(); cached != _layouts.end();)
+		{
+			if (cached->second.use_count() == 1)
+				cached = _layouts.erase(cached);
+			else
+				++cached;
+		}
+	}
+
+	std::shared_ptr<Layout> layout = std::make_shared<Layout>();
+	std::vector<GlyphQuad>& quads = layout->quads;
+
+	// -- place the glyphs along each line, y is relative to the line's baseline for now --
+	struct Line {
+		// first quad on the line
+		size_t firstQuad;
+		float width;
+	};
+	std::vector<Line> lines = { { 0, 0.0f } };
+	float penX = 0.0f;
+	unsigned int previousCodepoint = 0;
+	// the word being laid out, which moves down a line if it goes past wrapWidth. Only once there's been a space on the line
+	bool lineHasSpace = false;
+	size_t wordFirstQuad = 0;
+	float wordStartX = 0.0f;
+	// how wide the line is up to the last space, which is how wide it'll be if the word moves down
+	float widthBeforeWord = 0.0f;
+
+	for (size_t index = 0; index < text.size();)
+	{
+		unsigned int codepoint = NextCodepoint(text, index);
+		if (codepoint == '\r')
+			continue;
+		if (codepoint == '\n')
+		{
+			lines.back().width = penX;
+			lines.push_back({ quads.size(), 0.0f });
+			penX = 0.0f;
+			previousCodepoint = 0;
+			lineHasSpace = false;
+			continue;
+		}
+
+		const Glyph* glyph = GetGlyph(codepoint);
+		if (!glyph)
+			continue;
+		if (previousCodepoint)
+			penX += GetKerning(previousCodepoint, codepoint) * fontSize;
+		previousCodepoint = codepoint;
+
+		if (codepoint == ' ')
+		{
+			widthBeforeWord = penX;
+			penX += glyph->advance * fontSize;
+			lineHasSpace = true;
+			wordFirstQuad = quads.size();
+			wordStartX = penX;
+			continue;
+		}
+
+		// too long, move the word down to a new line
+		if (wrapWidth > 0.0f && lineHasSpace && penX + glyph->advance * fontSize > wrapWidth)
+		{
+			lines.back().width = widthBeforeWord;
+			for (size_t i = wordFirstQuad; i < quads.size(); i++)
+				quads[i].position.x -= wordStartX;
+			penX -= wordStartX;
+			lines.push_back({ wordFirstQuad, 0.0f });
+			lineHasSpace = false;
+		}
+
+		if (glyph->hasImage)
+			quads.push_back({ glyph, glm::vec2(penX, 0.0f) + glyph->offset * fontSize, glyph->size * fontSize });
+		penX += glyph->advance * fontSize;
+	}
+	lines.back().width = penX;
+
+	// -- line up the lines and move them down from the top --
+	float widestLine = 0.0f;
+	for (const Line& line : lines)
+		widestLine = std::max(widestLine, line.width);
+	// wrapped text lines up within the wrap width, otherwise within the widest line
+	float boxWidth = wrapWidth > 0.0f ? std::max(wrapWidth, widestLine) : widestLine;
+	float lineHeight = GetLineHeight(fontSize);
+	float boxHeight = (lines.size() - 1) * lineHeight + (ascender - descender) * fontSize;
+
+	for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++)
+	{
+		const Line& line = lines[lineIndex];
+		float shiftX = 0.0f;
+		if (alignment == Center)
+			shiftX = (boxWidth - line.width) * 0.5f;
+		else if (alignment == Right)
+			shiftX = boxWidth - line.width;
+		// y goes up, so the first line's baseline is an ascender down from the top
+		float baseline = boxHeight - ascender * fontSize - lineIndex * lineHeight;
+
+		size_t endQuad = lineIndex + 1 < lines.size() ? lines[lineIndex + 1].firstQuad : quads.size();
+		for (size_t i = line.firstQuad; i < endQuad; i++)
+			quads[i].position += glm::vec2(shiftX, baseline);
+	}
+
+	layout->size = glm::vec2(boxWidth, boxHeight);
+	layout->lineCount = (unsigned int)lines.size();
+	_layouts.emplace(key, layout);
+	return layout;
+}
+
+void Font::ClearLayoutCache()
+{
+	for (auto cached = _layouts.begin(); cached != _layouts.end();)
+	{
+		if (cached->second.use_count() == 1)
+			cached = _layouts.erase(cached);
+		else
+			++cached;
+	}
+}
+
+float Font::GetLineHeight(float fontSize)
+{
+	return (ascender - descender + lineGap) * fontSize;
+}
+
+unsigned int Font::GetTextureID()
+{
+	return _textureID;
+}
+
+unsigned int Font::GetRevision()
+{
+	return _revision;
+}
+
+void Font::CreateAtlas(int width, int height)
+{
+	if (_textureID == 0)
+		glGenTextures(1, &_textureID);
+	_atlasWidth = width;
+	_atlasHeight = height;
+	_atlasPixels.assign((size_t)width * height, 0);
+	_shelfX = 0;
+	_shelfY = 0;
+	_shelfHeight = 0;
+
+	glBindTexture(GL_TEXTURE_2D, _textureID);
+	// one channel is all a distance field needs
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, _atlasPixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	// linear filtering is what makes the distance field work, the shader finds the edge between texels
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool Font::PackGlyph(int width, int height, int& x, int& y)
+{
+	if (width > _atlasWidth)
+		return false;
+
+	// doesn't fit on this shelf, start a new one above it. Glyphs are a pixel apart so filtering doesn't mix them
+	if (_shelfX + width > _atlasWidth)
+	{
+		_shelfY += _shelfHeight + 1;
+		_shelfX = 0;
+		_shelfHeight = 0;
+	}
+	while (_shelfY + height > _atlasHeight)
+	{
+		if (!GrowAtlas())
+			return false;
+	}
+
+	x = _shelfX;
+	y = _shelfY;
+	_shelfX += width + 1;
+	_shelfHeight = std::max(_shelfHeight, height);
+	return true;
+}
+
+bool Font::GrowAtlas()
+{
+	GLint maxSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+	if (_atlasHeight * 2 > maxSize)
+		return false;
+
+	// rows go bottom up so the new rows just go on the end and everything already there stays where it is
+	_atlasHeight *= 2;
+	_atlasPixels.resize((size_t)_atlasWidth * _atlasHeight, 0);
+	glBindTexture(GL_TEXTURE_2D, _textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, _atlasWidth, _atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, _atlasPixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// same pixels but the uvs are all halved
+	for (auto& pair : _glyphs)
+		UpdateUVRect(pair.second);
+	_revision++;
+	return true;
+}
+
+void Font::UpdateUVRect(Glyph& glyph)
+{
+	glyph.uvRect = glm::vec4(
+		glyph.atlasX / (float)_atlasWidth,
+		glyph.atlasY / (float)_atlasHeight,
+		glyph.atlasWidth / (float)_atlasWidth,
+		glyph.atlasHeight / (float)_atlasHeight
+	);
+}
+
+unsigned int Font::ReadU16(size_t offset)
+{
+	if (offset + 2 > _fontData.size())
+		throw std::exception("Font file is cut off");
+	return (_fontData[offset] << 8) | _fontData[offset + 1];
+}
+
+short Font::ReadI16(size_t offset)
+{
+	return (short)ReadU16(offset);
+}
+
+unsigned int Font::ReadU32(size_t offset)
+{
+	return (ReadU16(offset) << 16) | ReadU16(offset + 2);
+}
+
+unsigned int Font::GetGlyphIndex(unsigned int codepoint)
+{
+	size_t table = _cmapSubtableOffset;
+	if (_cmapFormat == 12)
+	{
+		// groups of characters that map to glyphs one after the other, sorted so they can be binary searched
+		unsigned int groupCount = ReadU32(table + 12);
+		unsigned int low = 0, high = groupCount;
+		while (low < high)
+		{
+			unsigned int middle = (low + high) / 2;
+			size_t group = table + 16 + 12 * (size_t)middle;
+			unsigned int startCode = ReadU32(group);
+			unsigned int endCode = ReadU32(group + 4);
+			if (codepoint < startCode)
+				high = middle;
+			else if (codepoint > endCode)
+				low = middle + 1;
+			else
+				return ReadU32(group + 8) + (codepoint - startCode);
+		}
+		return 0;
+	}
+
+	// format 4, segments of characters, each either offset by a delta or looked up in an array
+	if (codepoint > 0xFFFF)
+		return 0;
+	unsigned int segmentCount = ReadU16(table + 6) / 2;
+	size_t endCodes = table + 14;
+	size_t startCodes = endCodes + segmentCount * 2 + 2;
+	size_t idDeltas = startCodes + segmentCount * 2;
+	size_t idRangeOffsets = idDeltas + segmentCount * 2;
+	for (unsigned int i = 0; i < segmentCount; i++)
+	{
+		if (codepoint > ReadU16(endCodes + i * 2))
+			continue;
+		unsigned int startCode = ReadU16(startCodes + i * 2);
+		if (codepoint < startCode)
+			return 0;
+		unsigned int idDelta = ReadU16(idDeltas + i * 2);
+		unsigned int idRangeOffset = ReadU16(idRangeOffsets + i * 2);
+		if (idRangeOffset == 0)
+			return (codepoint + idDelta) & 0xFFFF;
+		// the offset is from where it's stored to the glyph index array
+		unsigned int glyphIndex = ReadU16(idRangeOffsets + i * 2 + idRangeOffset + (codepoint - startCode) * 2);
+		return glyphIndex == 0 ? 0 : (glyphIndex + idDelta) & 0xFFFF;
+	}
+	return 0;
+}
+
+void Font::ReadKerning(size_t kernOffset)
+{
+	// only version 0 (windows) kern tables with format 0 subtables, which is what most fonts that have one use
+	if (ReadU16(kernOffset) != 0)
+		return;
+	unsigned int subtableCount = ReadU16(kernOffset + 2);
+	size_t subtable = kernOffset + 4;
+	for (unsigned int i = 0; i < subtableCount; i++)
+	{
+		unsigned int length = ReadU16(subtable + 2);
+		unsigned int coverage = ReadU16(subtable + 4);
+		// format 0, horizontal, not minimum values or cross stream
+		if ((coverage >> 8) == 0 && (coverage & 0x7) == 0x1)
+		{
+			unsigned int pairCount = ReadU16(subtable + 6);
+			for (unsigned int pair = 0; pair < pairCount; pair++)
+			{
+				size_t record = subtable + 14 + 6 * (size_t)pair;
+				_glyphKerning[(ReadU16(record) << 16) | ReadU16(record + 2)] = ReadI16(record + 4);
+			}
+		}
+		if (length == 0)
+			break;
+		subtable += length;
+	}
+}
+
+const Font::OutlinePoint* Font::FindOutlinePoint(const std::vector<std::vector<OutlinePoint>>& contours, unsigned int pointIndex)
+{
+	for (const std::vector<OutlinePoint>& contour : contours)
+	{
+		if (pointIndex < contour.size())
+			return &contour[pointIndex];
+		pointIndex -= (unsigned int)contour.size();
+	}
+	return nullptr;
+}
+
+void Font::GetOutline(unsigned int glyphIndex, std::vector<std::vector<OutlinePoint>>& contours, const glm::mat2& matrix, glm::vec2 offset, int depth)
+{
+	// composite glyphs can point at each other, stop if they go round in circles
+	if (glyphIndex >= _glyphCount || depth > 8)
+		return;
+
+	size_t start, end;
+	if (_indexToLocFormat == 0)
+	{
+		start = ReadU16(_locaOffset + glyphIndex * 2) * 2;
+		end = ReadU16(_locaOffset + glyphIndex * 2 + 2) * 2;
+	}
+	else
+	{
+		start = ReadU32(_locaOffset + glyphIndex * 4);
+		end = ReadU32(_locaOffset + glyphIndex * 4 + 4);
+	}
+	// nothing to draw, e.g. a space
+	if (end <= start)
+		return;
+	size_t glyph = _glyfOffset + start;
+	int contourCount = ReadI16(glyph);
+
+	if (contourCount >= 0)
+	{
+		// -- simple glyph: end point of each contour, instructions (skipped), flags, then x and y coordinates --
+		size_t endPoints = glyph + 10;
+		if (contourCount == 0)
+			return;
+		unsigned int pointCount = ReadU16(endPoints + (contourCount - 1) * 2) + 1;
+		unsigned int instructionLength = ReadU16(endPoints + contourCount * 2);
+		size_t position = endPoints + contourCount * 2 + 2 + instructionLength;
+
+		// flags can say they repeat for the next few points
+		std::vector<unsigned char> flags(pointCount);
+		for (unsigned int i = 0; i < pointCount;)
+		{
+			if (position >= _fontData.size())
+				throw std::exception("Font file is cut off");
+			unsigned char flag = _fontData[position++];
+			flags[i++] = flag;
+			if (flag & 0x08)
+			{
+				if (position >= _fontData.size())
+					throw std::exception("Font file is cut off");
+				unsigned int repeatCount = _fontData[position++];
+				for (unsigned int repeat = 0; repeat < repeatCount && i < pointCount; repeat++)
+					flags[i++] = flag;
+			}
+		}
+
+		// coordinates are deltas from the last point, either a byte with the sign in the flags, the same as the last one, or a short
+		std::vector<glm::vec2> points(pointCount);
+		for (int axis = 0; axis < 2; axis++)
+		{
+			unsigned char shortFlag = axis == 0 ? 0x02 : 0x04;
+			unsigned char sameFlag = axis == 0 ? 0x10 : 0x20;
+			int value = 0;
+			for (unsigned int i = 0; i < pointCount; i++)
+			{
+				if (flags[i] & shortFlag)
+				{
+					if (position >= _fontData.size())
+						throw std::exception("Font file is cut off");
+					int delta = _fontData[position++];
+					value += (flags[i] & sameFlag) ? delta : -delta;
+				}
+				else if (!(flags[i] & sameFlag))
+				{
+					value += ReadI16(position);
+					position += 2;
+				}
+				points[i][axis] = (float)value;
+			}
+		}
+
+		unsigned int firstPoint = 0;
+		for (int contour = 0; contour < contourCount; contour++)
+		{
+			unsigned int lastPoint = std::min(ReadU16(endPoints + contour * 2), pointCount - 1);
+			std::vector<OutlinePoint> outline;
+			for (unsigned int i = firstPoint; i <= lastPoint; i++)
+			{
+				glm::vec2 point = matrix * points[i] + offset;
+				outline.push_back({ point.x, point.y, (flags[i] & 0x01) != 0 });
+			}
+			// kept even if it's a single point, composite glyphs count every point to line components up (see below)
+			contours.push_back(outline);
+			firstPoint = lastPoint + 1;
+		}
+		return;
+	}
+
+	// -- composite glyph: other glyphs each moved and possibly scaled --
+	// It's built in the composite's own coords first, so a component lined up by point numbers can find the points before it
+	std::vector<std::vector<OutlinePoint>> composite;
+	size_t position = glyph + 10;
+	unsigned int flags;
+	do
+	{
+		flags = ReadU16(position);
+		unsigned int componentIndex = ReadU16(position + 2);
+		position += 4;
+
+		// two arguments, either an x,y offset (signed) or point numbers to line up (unsigned). Shorts or bytes depending on the flags
+		bool isOffset = (flags & 0x0002) != 0;
+		int argument1, argument2;
+		if (flags & 0x0001)
+		{
+			argument1 = isOffset ? ReadI16(position) : (int)ReadU16(position);
+			argument2 = isOffset ? ReadI16(position + 2) : (int)ReadU16(position + 2);
+			position += 4;
+		}
+		else
+		{
+			unsigned int bytes = ReadU16(position);
+			argument1 = isOffset ? (signed char)(bytes >> 8) : (int)(bytes >> 8);
+			argument2 = isOffset ? (signed char)(bytes & 0xFF) : (int)(bytes & 0xFF);
+			position += 2;
+		}
+
+		// scales are 2.14 fixed point
+		glm::mat2 componentMatrix(1.0f);
+		if (flags & 0x0008)
+		{
+			float scale = ReadI16(position) / 16384.0f;
+			componentMatrix = glm::mat2(scale);
+			position += 2;
+		}
+		else if (flags & 0x0040)
+		{
+			componentMatrix = glm::mat2(ReadI16(position) / 16384.0f, 0.0f, 0.0f, ReadI16(position + 2) / 16384.0f);
+			position += 4;
+		}
+		else if (flags & 0x0080)
+		{
+			componentMatrix = glm::mat2(ReadI16(position) / 16384.0f, ReadI16(position + 2) / 16384.0f,
+				ReadI16(position + 4) / 16384.0f, ReadI16(position + 6) / 16384.0f);
+			position += 8;
+		}
+
+		std::vector<std::vector<OutlinePoint>> component;
+		GetOutline(componentIndex, component, componentMatrix, glm::vec2(0.0f), depth + 1);
+
+		glm::vec2 componentOffset((float)argument1, (float)argument2);
+		if (!isOffset)
+		{
+			// Move the component so its point argument2 is on the composite's point argument1. Points are numbered across every contour,
+			// the composite's counting everything from the components before this one
+			const OutlinePoint* parentPoint = FindOutlinePoint(composite, (unsigned int)argument1);
+			const OutlinePoint* childPoint = FindOutlinePoint(component, (unsigned int)argument2);
+			if (parentPoint == nullptr || childPoint == nullptr)
+				throw std::exception("Font has a composite glyph that lines up points that don't exist");
+			componentOffset = glm::vec2(parentPoint->x - childPoint->x, parentPoint->y - childPoint->y);
+		}
+
+		for (std::vector<OutlinePoint>& contour : component)
+		{
+			for (OutlinePoint& point : contour)
+			{
+				point.x += componentOffset.x;
+				point.y += componentOffset.y;
+			}
+			composite.push_back(contour);
+		}
+	} while (flags & 0x0020);
+
+	// into the coords of whatever asked for it
+	for (std::vector<OutlinePoint>& contour : composite)
+	{
+		for (OutlinePoint& point : contour)
+		{
+			glm::vec2 transformed = matrix * glm::vec2(point.x, point.y) + offset;
+			point.x = transformed.x;
+			point.y = transformed.y;
+		}
+		contours.push_back(contour);
+	}
+}
+
+Font::Glyph Font::MakeGlyph(unsigned int codepoint)
+{
+	Glyph glyph;
+	glyph.codepoint = codepoint;
+
+	unsigned int glyphIndex = GetGlyphIndex(codepoint);
+	// glyphs past the last horizontal metric use its advance
+	unsigned int metricIndex = std::min(glyphIndex, _numberOfHMetrics - 1);
+	glyph.advance = ReadU16(_hmtxOffset + metricIndex * 4) / (float)_unitsPerEm;
+
+	std::vector<std::vector<OutlinePoint>> contours;
+	GetOutline(glyphIndex, contours, glm::mat2(1.0f), glm::vec2(0.0f), 0);
+	// single points are only there for lining composite glyphs up, they don't have an outline
+	contours.erase(std::remove_if(contours.begin(), contours.end(), [](const std::vector<OutlinePoint>& contour) { return contour.size() < 2; }), contours.end());
+
+	// -- flatten the outline into line segments, in atlas pixels from the pen --
+	float scale = sdfGlyphSize / (float)_unitsPerEm;
+	// start and end of each segment
+	std::vector<glm::vec4> segments;
+	auto addLine = [&](glm::vec2 a, glm::vec2 b) {
+		segments.push_back(glm::vec4(a, b));
+	};
+	// roughly one segment every 2 pixels is plenty for the curves of a glyph
+	auto addCurve = [&](glm::vec2 a, glm::vec2 control, glm::vec2 b) {
+		int steps = glm::clamp((int)std::ceil((glm::length(control - a) + glm::length(b - control)) / 2.0f), 1, 16);
+		glm::vec2 previous = a;
+		for (int step = 1; step <= steps; step++)
+		{
+			float t = step / (float)steps;
+			glm::vec2 point = (1.0f - t) * (1.0f - t) * a + 2.0f * (1.0f - t) * t * control + t * t * b;
+			addLine(previous, point);
+			previous = point;
+		}
+	};
+
+	for (std::vector<OutlinePoint>& contour : contours)
+	{
+		// start on a point that's on the curve. If every point is off it, the middle of the first two is on it
+		auto firstOnCurve = std::find_if(contour.begin(), contour.end(), [](const OutlinePoint& point) { return point.onCurve; });
+		if (firstOnCurve != contour.end())
+			std::rotate(contour.begin(), firstOnCurve, contour.end());
+		else
+			contour.insert(contour.begin(), { (contour[0].x + contour[1].x) * 0.5f, (contour[0].y + contour[1].y) * 0.5f, true });
+
+		// quadratic curves, two off curve points in a row have an on curve point between them that isn't stored
+		glm::vec2 current = glm::vec2(contour[0].x, contour[0].y) * scale;
+		glm::vec2 control;
+		bool hasControl = false;
+		// goes one past the end to close the contour back at its first point
+		for (size_t i = 1; i <= contour.size(); i++)
+		{
+			const OutlinePoint& outlinePoint = contour[i % contour.size()];
+			glm::vec2 point = glm::vec2(outlinePoint.x, outlinePoint.y) * scale;
+			if (outlinePoint.onCurve)
+			{
+				if (hasControl)
+					addCurve(current, control, point);
+				else
+					addLine(current, point);
+				current = point;
+				hasControl = false;
+			}
+			else
+			{
+				if (hasControl)
+				{
+					glm::vec2 middle = (control + point) * 0.5f;
+					addCurve(current, control, middle);
+					current = middle;
+				}
+				control = point;
+				hasControl = true;
+			}
+		}
+	}
+
+	if (segments.empty())
+		return glyph;
+
+	// -- image bounds, the outline plus the spread on every side --
+	glm::vec2 minimum(segments[0].x, segments[0].y);
+	glm::vec2 maximum = minimum;
+	for (const glm::vec4& segment : segments)
+	{
+		minimum = glm::min(minimum, glm::min(glm::vec2(segment.x, segment.y), glm::vec2(segment.z, segment.w)));
+		maximum = glm::max(maximum, glm::max(glm::vec2(segment.x, segment.y), glm::vec2(segment.z, segment.w)));
+	}
+	int left = (int)std::floor(minimum.x) - sdfSpread;
+	int bottom = (int)std::floor(minimum.y) - sdfSpread;
+	int width = (int)std::ceil(maximum.x) - (int)std::floor(minimum.x) + sdfSpread * 2;
+	int height = (int)std::ceil(maximum.y) - (int)std::floor(minimum.y) + sdfSpread * 2;
+
+	// -- distance field: distance to the nearest segment, positive inside (nonzero winding, like TrueType fills) --
+	std::vector<unsigned char> pixels((size_t)width * height);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			glm::vec2 point(left + x + 0.5f, bottom + y + 0.5f);
+			float nearestSquared = 1e30f;
+			int winding = 0;
+			for (const glm::vec4& segment : segments)
+			{
+				glm::vec2 a(segment.x, segment.y);
+				glm::vec2 b(segment.z, segment.w);
+				nearestSquared = std::min(nearestSquared, SegmentDistanceSquared(point, a, b));
+				// count the segments a ray going right from the point crosses, up one way and down the other
+				if ((a.y <= point.y) != (b.y <= point.y))
+				{
+					float crossX = a.x + (point.y - a.y) / (b.y - a.y) * (b.x - a.x);
+					if (crossX > point.x)
+						winding += b.y > a.y ? 1 : -1;
+				}
+			}
+			float distance = std::sqrt(nearestSquared);
+			if (winding == 0)
+				distance = -distance;
+			float value = glm::clamp(0.5f + distance / (2.0f * sdfSpread), 0.0f, 1.0f);
+			pixels[(size_t)y * width + x] = (unsigned char)(value * 255.0f + 0.5f);
+		}
+	}
+
+	// -- put it in the atlas --
+	int atlasX, atlasY;
+	if (!PackGlyph(width, height, atlasX, atlasY))
+		throw std::exception("Font atlas is full and can't grow any bigger");
+	for (int y = 0; y < height; y++)
+		memcpy(&_atlasPixels[(size_t)(atlasY + y) * _atlasWidth + atlasX], &pixels[(size_t)y * width], width);
+	glBindTexture(GL_TEXTURE_2D, _textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, atlasX, atlasY, width, height, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glyph.hasImage = true;
+	glyph.offset = glm::vec2(left, bottom) / (float)sdfGlyphSize;
+	glyph.size = glm::vec2(width, height) / (float)sdfGlyphSize;
+	glyph.atlasX = atlasX;
+	glyph.atlasY = atlasY;
+	glyph.atlasWidth = width;
+	glyph.atlasHeight = height;
+	UpdateUVRect(glyph);
+	return glyph;
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+// A font whose glyphs are drawn into a signed distance field (SDF) atlas texture, used by TextRenderer.
+// Each pixel of a glyph's image stores how far it is from the glyph's outline (0.5 on the edge, more inside, less outside) instead of
+// how covered it is. The shader turns that back into a sharp edge at whatever size it's drawn, so one small image per glyph stays crisp
+// at any font size or camera zoom.
+// Fonts can be loaded from a TrueType (.ttf) file, whose outlines are turned into SDFs here when a glyph is first used, or from a baked
+// file (made with SaveBaked) that already has the atlas and metrics in it and needs no rasterising at all.
+// Layouts (where each glyph of a string goes) are cached per string, size, alignment and wrap width so labels that don't change cost nothing.
+// Load them thru ResourceManager::LoadFont
+class Font
+{
+public:
+	// how lines line up with each other
+	enum Alignment {
+		Left,
+		Center,
+		Right
+	};
+
+	// one character's image in the atlas and how far it moves the pen
+	struct Glyph {
+		unsigned int codepoint = 0;
+		// how far the pen moves after this glyph, in ems (1 em = the font size)
+		float advance = 0.0f;
+		// bottom left of the image relative to the pen on the baseline, in ems. Includes the SDF's padding
+		glm::vec2 offset = glm::vec2(0.0f);
+		// size of the image, in ems
+		glm::vec2 size = glm::vec2(0.0f);
+		// part of the atlas the image is in. xy: uv of the bottom left corner, zw: uv size
+		glm::vec4 uvRect = glm::vec4(0.0f);
+		// false for glyphs with nothing to draw, like spaces
+		bool hasImage = false;
+		// pixel rect in the atlas, the uv rect is worked out from it again if the atlas grows
+		int atlasX = 0;
+		int atlasY = 0;
+		int atlasWidth = 0;
+		int atlasHeight = 0;
+	};
+
+	// one glyph placed in a layout
+	struct GlyphQuad {
+		// glyphs don't move in memory once they're made so this stays valid, even if the atlas grows
+		const Glyph* glyph;
+		// bottom left corner, relative to the bottom left of the text, in global units
+		glm::vec2 position;
+		// size in global units
+		glm::vec2 size;
+	};
+
+	// where every glyph of a string goes
+	struct Layout {
+		std::vector<GlyphQuad> quads;
+		// width and height of the whole block of text
+		glm::vec2 size = glm::vec2(0.0f);
+		unsigned int lineCount = 0;
+	};
+
+	// makes an empty font, load it with LoadTTF or LoadBaked
+	Font(std::string name);
+
+	// the layout cache points at this font's glyphs so it can't be copied
+	Font(const Font&) = delete;
+	Font& operator=(const Font&) = delete;
+
+	// name of the font as referenced by the resource manager
+	std::string name;
+
+	// -- settings, change them before loading --
+	// pixels per em of each glyph's image in the atlas. Bigger keeps sharper corners but uses more atlas space
+	int sdfGlyphSize = 48;
+	// how many pixels of distance are stored each side of the edge. Also how far effects like outlines could reach
+	int sdfSpread = 6;
+	// width of the atlas texture. It starts this tall too and gets taller when it fills up
+	int atlasSize = 512;
+	// once there are this many layouts cached, ones that no text renderer is using are thrown away
+	size_t maxCachedLayouts = 4096;
+
+	// how many GetLayout calls were cached and how many had to be laid out
+	unsigned int layoutCacheHits = 0;
+	unsigned int layoutCacheMisses = 0;
+
+	// whether data (the start of a file, at least 4 bytes) is a baked font
+	static bool IsBakedFile(const unsigned char* data, size_t size);
+
+	// Loads a TrueType font (glyf outlines, not CFF/OpenType .otf). Printable ascii is rasterised straight away, anything else when it's
+	// first used. Only kerning from the old "kern" table is used. Throws if the file can't be read
+	void LoadTTF(const char* filePath);
+	// loads a font baked with SaveBaked. It can only draw the glyphs that were baked into it
+	void LoadBaked(const char* filePath);
+	// Saves the atlas, metrics and kerning of every glyph made so far (call AddGlyphs first for anything beyond ascii) so it can be loaded
+	// without the ttf or any rasterising
+	void SaveBaked(const char* filePath);
+
+	// makes sure every character in text (utf-8) has a glyph in the atlas
+	void AddGlyphs(const std::string& text);
+
+	// returns the glyph for a character, rasterising it if it hasn't been yet. Characters the font doesn't have use its missing glyph (or '?'),
+	// nullptr if there isn't one of those either
+	const Glyph* GetGlyph(unsigned int codepoint);
+
+	// how much closer (negative) or further apart two characters should be, in ems
+	float GetKerning(unsigned int leftCodepoint, unsigned int rightCodepoint);
+
+	// Lays out text (utf-8, '\n' starts a new line) at fontSize (global units per em). Lines longer than wrapWidth are broken at spaces,
+	// 0 means they never are. Cached, so calling it every frame with the same values is just a lookup
+	std::shared_ptr<const Layout> GetLayout(const std::string& text, float fontSize, Alignment alignment = Left, float wrapWidth = 0.0f);
+
+	// throws away every cached layout that isn't being used
+	void ClearLayoutCache();
+
+	// distance from one baseline to the next at fontSize
+	float GetLineHeight(float fontSize);
+
+	// the atlas texture, single channel (red)
+	unsigned int GetTextureID();
+
+	// goes up by one whenever glyphs are added or the atlas changes, so things drawn with the font can tell
+	unsigned int GetRevision();
+
+	// metrics in ems. Ascender is how far above the baseline the tallest glyphs go, descender how far below (negative)
+	float ascender = 0.0f;
+	float descender = 0.0f;
+	// extra space between lines
+	float lineGap = 0.0f;
+
+private:
+	// -- TrueType data, empty for baked fonts --
+	std::vector<unsigned char> _fontData;
+	unsigned int _unitsPerEm = 1000;
+	int _indexToLocFormat = 0;
+	unsigned int _glyphCount = 0;
+	unsigned int _numberOfHMetrics = 0;
+	// byte offsets of the tables that are used (0 if missing)
+	size_t _cmapOffset = 0;
+	size_t _locaOffset = 0;
+	size_t _glyfOffset = 0;
+	size_t _hmtxOffset = 0;
+	// the cmap subtable that maps characters to glyph indices and its format (4 or 12)
+	size_t _cmapSubtableOffset = 0;
+	unsigned int _cmapFormat = 0;
+	// kerning between glyph indices, (left << 16) | right to font units
+	std::unordered_map<unsigned int, short> _glyphKerning;
+
+	// kerning between characters for baked fonts, (left << 32) | right to ems
+	std::unordered_map<unsigned long long, float> _codepointKerning;
+
+	// every glyph made so far
+	std::unordered_map<unsigned int, Glyph> _glyphs;
+
+	// -- atlas --
+	unsigned int _textureID = 0;
+	// copy of the atlas so it can be uploaded again when it grows (and saved)
+	std::vector<unsigned char> _atlasPixels;
+	int _atlasWidth = 0;
+	int _atlasHeight = 0;
+	// glyphs are packed in rows (shelves) from the bottom up
+	int _shelfX = 0;
+	int _shelfY = 0;
+	int _shelfHeight = 0;
+	unsigned int _revision = 0;
+
+	// cached layouts, the key is made from every GetLayout parameter
+	std::unordered_map<std::string, std::shared_ptr<Layout>> _layouts;
+
+	// makes the atlas texture at its starting size
+	void CreateAtlas(int width, int height);
+	// finds space for a width x height image in the atlas, growing it if it's full. Returns false if it can't grow any more
+	bool PackGlyph(int width, int height, int& x, int& y);
+	// makes the atlas twice as tall, keeping everything in it
+	bool GrowAtlas();
+	// works out a glyph's uv rect from its pixel rect
+	void UpdateUVRect(Glyph& glyph);
+
+	// -- TrueType parsing --
+	unsigned int ReadU16(size_t offset);
+	short ReadI16(size_t offset);
+	unsigned int ReadU32(size_t offset);
+	// glyph index of a character, 0 (the missing glyph) if the font doesn't have it
+	unsigned int GetGlyphIndex(unsigned int codepoint);
+	// reads the kern table, if there is one
+	void ReadKerning(size_t kernOffset);
+	// one point of a glyph outline, in font units
+	struct OutlinePoint {
+		float x;
+		float y;
+		bool onCurve;
+	};
+	// returns the pointIndex'th point counting across every contour, nullptr if there aren't that many
+	static const OutlinePoint* FindOutlinePoint(const std::vector<std::vector<OutlinePoint>>& contours, unsigned int pointIndex);
+	// Appends the outline of a glyph as contours of points, transformed by the 2x2 matrix and offset (for composite glyphs).
+	// Components of a composite glyph that are lined up by point numbers are moved so the points meet
+	void GetOutline(unsigned int glyphIndex, std::vector<std::vector<OutlinePoint>>& contours, const glm::mat2& matrix, glm::vec2 offset, int depth);
+	// rasterises a TrueType glyph's SDF into the atlas
+	Glyph MakeGlyph(unsigned int codepoint);
+};
+
@@ -0,0 +1,157 @@
+#version 330 core
+// FXAA (fast approximate anti aliasing), based on Timothy Lottes' FXAA 3.11 quality version.
+// It finds pixels on an edge from how sharply the brightness changes around them, works out which way the edge goes and how far along it
+// the pixel is, then samples the texture a bit over the edge so the linear filter blends the two sides together
+out vec4 FragColor;
+
+in vec2 texCoord;
+
+uniform sampler2D screenTexture;
+// size of one texel
+uniform vec2 inverseScreenSize;
+
+// darkest edge that gets smoothed, stops dark areas from being blurred for no reason
+const float edgeThresholdMin = 0.0312;
+// how much the brightness has to change compared to the brightest pixel around it to be an edge
+const float edgeThreshold = 0.125;
+// how much pixels on thin (1 pixel) features get blended with the ones around them
+const float subpixelQuality = 0.75;
+// how many steps it looks along an edge for its ends, and how many texels each step goes (bigger steps further out)
+const int searchSteps = 12;
+const float stepSizes[searchSteps] = float[](1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 2.0, 4.0, 8.0);
+
+// perceived brightness, square root so it's closer to how the eye sees it
+float Luma(vec3 color)
+{
+	return sqrt(dot(color, vec3(0.299, 0.587, 0.114)));
+}
+
+float LumaAt(vec2 uv)
+{
+	return Luma(texture(screenTexture, uv).rgb);
+}
+
+void main()
+{
+	vec3 colorCentre = texture(screenTexture, texCoord).rgb;
+
+	// -- brightness of this pixel and the 4 next to it --
+	float lumaCentre = Luma(colorCentre);
+	float lumaDown = Luma(textureOffset(screenTexture, texCoord, ivec2(0, -1)).rgb);
+	float lumaUp = Luma(textureOffset(screenTexture, texCoord, ivec2(0, 1)).rgb);
+	float lumaLeft = Luma(textureOffset(screenTexture, texCoord, ivec2(-1, 0)).rgb);
+	float lumaRight = Luma(textureOffset(screenTexture, texCoord, ivec2(1, 0)).rgb);
+
+	float lumaMin = min(lumaCentre, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+	float lumaMax = max(lumaCentre, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+	float lumaRange = lumaMax - lumaMin;
+
+	// not on an edge (most pixels), leave it alone
+	if (lumaRange < max(edgeThresholdMin, lumaMax * edgeThreshold))
+	{
+		FragColor = vec4(colorCentre, 1.0);
+		return;
+	}
+
+	// -- corners, to tell which way the edge goes --
+	float lumaDownLeft = Luma(textureOffset(screenTexture, texCoord, ivec2(-1, -1)).rgb);
+	float lumaUpRight = Luma(textureOffset(screenTexture, texCoord, ivec2(1, 1)).rgb);
+	float lumaUpLeft = Luma(textureOffset(screenTexture, texCoord, ivec2(-1, 1)).rgb);
+	float lumaDownRight = Luma(textureOffset(screenTexture, texCoord, ivec2(1, -1)).rgb);
+
+	float lumaDownUp = lumaDown + lumaUp;
+	float lumaLeftRight = lumaLeft + lumaRight;
+	float lumaLeftCorners = lumaDownLeft + lumaUpLeft;
+	float lumaDownCorners = lumaDownLeft + lumaDownRight;
+	float lumaRightCorners = lumaDownRight + lumaUpRight;
+	float lumaUpCorners = lumaUpRight + lumaUpLeft;
+
+	// how much the brightness changes going up/down compared to left/right. A horizontal edge changes the most going up/down
+	float edgeHorizontal = abs(-2.0 * lumaLeft + lumaLeftCorners) + abs(-2.0 * lumaCentre + lumaDownUp) * 2.0 + abs(-2.0 * lumaRight + lumaRightCorners);
+	float edgeVertical = abs(-2.0 * lumaUp + lumaUpCorners) + abs(-2.0 * lumaCentre + lumaLeftRight) * 2.0 + abs(-2.0 * lumaDown + lumaDownCorners);
+	bool isHorizontal = edgeHorizontal >= edgeVertical;
+
+	// -- which side of the pixel the edge is on --
+	float luma1 = isHorizontal ? lumaDown : lumaLeft;
+	float luma2 = isHorizontal ? lumaUp : lumaRight;
+	float gradient1 = luma1 - lumaCentre;
+	float gradient2 = luma2 - lumaCentre;
+	bool is1Steepest = abs(gradient1) >= abs(gradient2);
+	// how much the brightness has to change along the edge to count as its end
+	float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+	// one texel across the edge, towards the side it's on
+	float stepLength = isHorizontal ? inverseScreenSize.y : inverseScreenSize.x;
+	float lumaLocalAverage;
+	if (is1Steepest)
+	{
+		stepLength = -stepLength;
+		lumaLocalAverage = 0.5 * (luma1 + lumaCentre);
+	}
+	else
+		lumaLocalAverage = 0.5 * (luma2 + lumaCentre);
+
+	// start halfway between this pixel and the one over the edge
+	vec2 currentUv = texCoord;
+	if (isHorizontal)
+		currentUv.y += stepLength * 0.5;
+	else
+		currentUv.x += stepLength * 0.5;
+
+	// -- walk both ways along the edge until the brightness stops matching it --
+	vec2 offset = isHorizontal ? vec2(inverseScreenSize.x, 0.0) : vec2(0.0, inverseScreenSize.y);
+	vec2 uv1 = currentUv - offset;
+	vec2 uv2 = currentUv + offset;
+
+	float lumaEnd1 = LumaAt(uv1) - lumaLocalAverage;
+	float lumaEnd2 = LumaAt(uv2) - lumaLocalAverage;
+	bool reached1 = abs(lumaEnd1) >= gradientScaled;
+	bool reached2 = abs(lumaEnd2) >= gradientScaled;
+
+	if (!reached1)
+		uv1 -= offset;
+	if (!reached2)
+		uv2 += offset;
+
+	for (int i = 2; i < searchSteps && !(reached1 && reached2); i++)
+	{
+		if (!reached1)
+			lumaEnd1 = LumaAt(uv1) - lumaLocalAverage;
+		if (!reached2)
+			lumaEnd2 = LumaAt(uv2) - lumaLocalAverage;
+		reached1 = abs(lumaEnd1) >= gradientScaled;
+		reached2 = abs(lumaEnd2) >= gradientScaled;
+
+		if (!reached1)
+			uv1 -= offset * stepSizes[i];
+		if (!reached2)
+			uv2 += offset * stepSizes[i];
+	}
+
+	// -- how far over the edge to sample, from how close the pixel is to the nearest end --
+	float distance1 = isHorizontal ? (texCoord.x - uv1.x) : (texCoord.y - uv1.y);
+	float distance2 = isHorizontal ? (uv2.x - texCoord.x) : (uv2.y - texCoord.y);
+	bool isDirection1 = distance1 < distance2;
+	float distanceFinal = min(distance1, distance2);
+	float edgeLength = distance1 + distance2;
+	float pixelOffset = -distanceFinal / edgeLength + 0.5;
+
+	// only move if the end that's closest goes the right way, otherwise it's the far side of a corner
+	bool isLumaCentreSmaller = lumaCentre < lumaLocalAverage;
+	bool correctVariation = ((isDirection1 ? lumaEnd1 : lumaEnd2) < 0.0) != isLumaCentreSmaller;
+	float finalOffset = correctVariation ? pixelOffset : 0.0;
+
+	// -- thin features that the edge search misses get blended by how different they are to the average around them --
+	float lumaAverage = (1.0 / 12.0) * (2.0 * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners);
+	float subPixelOffset1 = clamp(abs(lumaAverage - lumaCentre) / lumaRange, 0.0, 1.0);
+	float subPixelOffset2 = (-2.0 * subPixelOffset1 + 3.0) * subPixelOffset1 * subPixelOffset1;
+	finalOffset = max(finalOffset, subPixelOffset2 * subPixelOffset2 * subpixelQuality);
+
+	vec2 finalUv = texCoord;
+	if (isHorizontal)
+		finalUv.y += finalOffset * stepLength;
+	else
+		finalUv.x += finalOffset * stepLength;
+
+	FragColor = vec4(texture(screenTexture, finalUv).rgb, 1.0);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 texCoord;
+
+// what was drawn into the layer. The colour is already multiplied by alpha
+uniform sampler2D layerTexture;
+
+void main()
+{
+	FragColor = texture(layerTexture, texCoord);
+}
\ No newline at end of file
@@ -1,9 +0,0 @@
-#version 330 core
-out vec4 FragColor;
-
-uniform vec4 lineColor;
-
-void main()
-{
-	FragColor = lineColor; // set to lineColor
-} 
\ No newline at end of file
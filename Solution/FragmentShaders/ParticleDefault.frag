@@ -0,0 +1,16 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 corner;
+in vec4 particleColor;
+
+void main()
+{
+	// round particle, the edge is smoothed over about a pixel however big it is
+	float distance = length(corner);
+	float smoothing = fwidth(distance);
+	float alpha = (1.0 - smoothstep(1.0 - smoothing, 1.0, distance)) * particleColor.a;
+	if (alpha < 0.01)
+		discard;
+	FragColor = vec4(particleColor.rgb, alpha);
+}
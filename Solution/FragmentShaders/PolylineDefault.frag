@@ -0,0 +1,9 @@
+#version 330 core
+out vec4 FragColor;
+
+flat in vec4 lineColor;
+
+void main()
+{
+	FragColor = lineColor;
+}
@@ -0,0 +1,11 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 texCoord;
+
+uniform sampler2D screenTexture;
+
+void main()
+{
+	FragColor = vec4(texture(screenTexture, texCoord).rgb, 1.0);
+}
\ No newline at end of file
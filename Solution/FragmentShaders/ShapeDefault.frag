@@ -0,0 +1,88 @@
+#version 330 core
+out vec4 FragColor;
+
+// these come from the vertex shader because each shape instance has its own
+flat in vec4 fillColor;
+flat in vec4 strokeColor;
+flat in int shapeType; // 0 rectangle, 1 rounded rectangle, 2 ellipse, 3 line
+flat in float shapeParam; // corner radius for rounded rects, 1 for round caps on lines
+flat in float borderWidth; // 0 for no border
+flat in vec2 halfSize;
+in vec2 shapePos; // position of the pixel on the shape, (0,0) is the centre
+
+/*
+	Every shape is worked out with a signed distance function (SDF). It returns how far a point is from the edge of the shape, negative inside and positive outside.
+	That one number is all that's needed for everything:
+		- outside edge: inside if distance < 0
+		- border: inside the fill if distance < -borderWidth, otherwise it's in the border
+		- smoothing: fwidth(distance) is how much the distance changes between this pixel and the next one, so blending over that
+		  distance gives a 1 pixel soft edge no matter how big the shape is or how zoomed in the camera is
+	The box and rounded box functions are from https://iquilezles.org/articles/distfunctions2d/
+	
+	I don't discard any fragments, outside just gets 0 alpha (same as the old ellipse shader)
+*/
+
+// rectangle centred on (0,0)
+float BoxDistance(vec2 position, vec2 halfSize)
+{
+	vec2 distanceToEdges = abs(position) - halfSize;
+	// outside distance (corner is the length to the corner) + inside distance (closest edge)
+	return length(max(distanceToEdges, 0.0)) + min(max(distanceToEdges.x, distanceToEdges.y), 0.0);
+}
+
+// rectangle with rounded corners. Just a smaller rectangle with radius added on to every side
+float RoundedBoxDistance(vec2 position, vec2 halfSize, float radius)
+{
+	// radius can't be more than half the smallest side
+	radius = min(radius, min(halfSize.x, halfSize.y));
+	return BoxDistance(position, halfSize - radius) - radius;
+}
+
+// Ellipse centred on (0,0). An ellipse doesn't have a simple exact distance so this uses the usual approximation:
+// the ellipse equation (x^2/a^2 + y^2/b^2 - 1) divided by how fast it changes (its gradient) which is close to the distance near the edge
+float EllipseDistance(vec2 position, vec2 radii)
+{
+	vec2 normalisedPosition = position / radii;
+	float ellipseEquation = dot(normalisedPosition, normalisedPosition) - 1.0;
+	vec2 gradient = 2.0 * position / (radii * radii);
+	return ellipseEquation / max(length(gradient), 0.0001);
+}
+
+// line with round caps, distance to the segment down the middle minus half the thickness
+float CapsuleDistance(vec2 position, vec2 halfSize)
+{
+	// the caps stick out half the thickness past each end
+	float segmentHalfLength = max(halfSize.x - halfSize.y, 0.0);
+	vec2 closestOnSegment = vec2(clamp(position.x, -segmentHalfLength, segmentHalfLength), 0.0);
+	return length(position - closestOnSegment) - halfSize.y;
+}
+
+float ShapeDistance()
+{
+	if (shapeType == 1)
+		return RoundedBoxDistance(shapePos, halfSize, shapeParam);
+	if (shapeType == 2)
+		return EllipseDistance(shapePos, halfSize);
+	if (shapeType == 3 && shapeParam > 0.5)
+		return CapsuleDistance(shapePos, halfSize);
+	// rectangles and flat capped lines
+	return BoxDistance(shapePos, halfSize);
+}
+
+void main()
+{
+	float distance = ShapeDistance();
+	// how much the distance changes per pixel, for smoothing
+	float pixelSize = max(fwidth(distance), 0.0001);
+
+	// Plain rectangles and flat capped lines fill the whole quad so their outside edge isn't smoothed. That way they stay fully opaque like they used to be
+	bool fillsQuad = (shapeType == 0) || (shapeType == 3 && shapeParam <= 0.5);
+	// how much of the pixel is inside the shape (0 to 1)
+	float coverage = fillsQuad ? 1.0 : clamp(0.5 - distance / pixelSize, 0.0, 1.0);
+
+	// how much of the pixel is inside the border
+	float fillCoverage = (borderWidth > 0.0) ? clamp(0.5 - (distance + borderWidth) / pixelSize, 0.0, 1.0) : 1.0;
+
+	vec4 color = mix(strokeColor, fillColor, fillCoverage);
+	FragColor = vec4(color.rgb, color.a * coverage);
+}
\ No newline at end of file
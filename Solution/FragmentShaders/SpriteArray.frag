@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 spriteColor;
+in vec2 texCoord;
+flat in float layer;
+
+uniform sampler2DArray texture1;
+
+void main()
+{
+	// the third coord picks the layer
+	FragColor = spriteColor * texture(texture1, vec3(texCoord, layer)); // set to texture mixed with spriteColor
+}
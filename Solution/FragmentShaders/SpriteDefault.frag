@@ -1,7 +1,7 @@
 #version 330 core
 out vec4 FragColor;
 
-uniform vec4 spriteColor;
+in vec4 spriteColor;
 uniform sampler2D texture1;
 
 in vec2 texCoord;
@@ -0,0 +1,10 @@
+#version 330 core
+out vec4 FragColor;
+
+// baked shapes are opaque rects without rounded corners, so there's nothing to smooth and it's just the colour
+in vec4 spriteColor;
+
+void main()
+{
+	FragColor = spriteColor;
+}
@@ -0,0 +1,19 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 texCoord;
+in vec4 textColor;
+// signed distance field atlas, 0.5 is the edge of a glyph
+uniform sampler2D fontAtlas;
+
+void main()
+{
+	float distance = texture(fontAtlas, texCoord).r;
+	// how much the distance changes over one pixel on screen, so the edge is always about a pixel wide however big the text is drawn
+	float smoothing = max(fwidth(distance), 0.0001) * 0.75;
+	float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance) * textColor.a;
+	// the quads overlap their neighbours a bit, don't let the empty parts write depth over them
+	if (alpha < 0.01)
+		discard;
+	FragColor = vec4(textColor.rgb, alpha);
+}
@@ -0,0 +1,86 @@
+#include "GLExtensions.h"
+#include <glfw3.h>
+#include <iostream>
+
+bool GLExtensions::isLoaded = false;
+bool GLExtensions::hasBufferStorage = false;
+PFNGLBUFFERSTORAGEPROC GLExtensions::BufferStorage = nullptr;
+bool GLExtensions::hasBaseInstance = false;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC GLExtensions::DrawElementsInstancedBaseVertexBaseInstance = nullptr;
+bool GLExtensions::hasMultiDrawIndirect = false;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC GLExtensions::MultiDrawElementsIndirect = nullptr;
+bool GLExtensions::hasS3TC = false;
+bool GLExtensions::hasBPTC = false;
+bool GLExtensions::hasETC2 = false;
+bool GLExtensions::hasProgramBinary = false;
+PFNGLGETPROGRAMBINARYPROC GLExtensions::GetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC GLExtensions::ProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC GLExtensions::ProgramParameteri = nullptr;
+bool GLExtensions::hasParallelShaderCompile = false;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC GLExtensions::MaxShaderCompilerThreads = nullptr;
+
+void GLExtensions::Load()
+{
+	// -- buffer storage --
+	// either the context is new enough to have it in core or the driver exposes the extension
+	if (VersionAtLeast(4, 4) || glfwExtensionSupported("GL_ARB_buffer_storage"))
+		BufferStorage = (PFNGLBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+	// only count it as supported if the function actually loaded
+	hasBufferStorage = (BufferStorage != nullptr);
+
+	// -- base instance --
+	if (VersionAtLeast(4, 2) || glfwExtensionSupported("GL_ARB_base_instance"))
+		DrawElementsInstancedBaseVertexBaseInstance = (PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)glfwGetProcAddress("glDrawElementsInstancedBaseVertexBaseInstance");
+	hasBaseInstance = (DrawElementsInstancedBaseVertexBaseInstance != nullptr);
+
+	// -- multi draw indirect --
+	// the extension builds on top of ARB_draw_indirect so both are needed if it isn't core
+	if (VersionAtLeast(4, 3) || (glfwExtensionSupported("GL_ARB_multi_draw_indirect") && glfwExtensionSupported("GL_ARB_draw_indirect")))
+		MultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)glfwGetProcAddress("glMultiDrawElementsIndirect");
+	hasMultiDrawIndirect = (MultiDrawElementsIndirect != nullptr && hasBaseInstance);
+
+	// -- compressed texture formats, no functions to load just whether the formats are allowed --
+	hasS3TC = glfwExtensionSupported("GL_EXT_texture_compression_s3tc") == GLFW_TRUE;
+	hasBPTC = VersionAtLeast(4, 2) || glfwExtensionSupported("GL_ARB_texture_compression_bptc");
+	hasETC2 = VersionAtLeast(4, 3) || glfwExtensionSupported("GL_ARB_ES3_compatibility");
+
+	// -- program binaries --
+	if (VersionAtLeast(4, 1) || glfwExtensionSupported("GL_ARB_get_program_binary"))
+	{
+		GetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)glfwGetProcAddress("glGetProgramBinary");
+		ProgramBinary = (PFNGLPROGRAMBINARYPROC)glfwGetProcAddress("glProgramBinary");
+		ProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)glfwGetProcAddress("glProgramParameteri");
+	}
+	GLint binaryFormatCount = 0;
+	if (GetProgramBinary != nullptr)
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+	hasProgramBinary = (GetProgramBinary != nullptr && ProgramBinary != nullptr && ProgramParameteri != nullptr && binaryFormatCount > 0);
+
+	// -- parallel shader compile --
+	// the KHR and ARB versions are the same apart from the function's name
+	if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+		MaxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+	else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+		MaxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+	hasParallelShaderCompile = (MaxShaderCompilerThreads != nullptr);
+	// 0xFFFFFFFF means the driver decides how many threads to use
+	if (hasParallelShaderCompile)
+		MaxShaderCompilerThreads(0xFFFFFFFF);
+
+	isLoaded = true;
+
+	std::cout << "GL extensions: buffer storage " << (hasBufferStorage ? "yes" : "no") 
+		<< ", base instance " << (hasBaseInstance ? "yes" : "no")
+		<< ", multi draw indirect " << (hasMultiDrawIndirect ? "yes" : "no")
+		<< ", s3tc " << (hasS3TC ? "yes" : "no")
+		<< ", bptc " << (hasBPTC ? "yes" : "no")
+		<< ", etc2 " << (hasETC2 ? "yes" : "no")
+		<< ", program binary " << (hasProgramBinary ? "yes" : "no")
+		<< ", parallel shader compile " << (hasParallelShaderCompile ? "yes" : "no") << std::endl;
+}
+
+bool GLExtensions::VersionAtLeast(int major, int minor)
+{
+	// GLVersion is filled in by glad when it loads
+	return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
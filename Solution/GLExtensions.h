@@ -0,0 +1,129 @@
+#pragma once
+#include <glad/glad.h>
+
+// glad was generated for core openGL 3.3 with no extensions, so anything newer than that has to be loaded by hand.
+// This header has the enums and function pointer types for those newer functions and GLExtensions loads them at runtime.
+
+// -- ARB_buffer_storage (core in 4.4) --
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// -- ARB_base_instance (core in 4.2) --
+typedef void (APIENTRYP PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance);
+
+// -- ARB_multi_draw_indirect (core in 4.3) --
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+// -- compressed texture formats --
+// EXT_texture_compression_s3tc (BC1 to BC3, not core but every desktop driver has it)
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+// ARB_texture_compression_bptc (BC7, core in 4.2)
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+// ARB_ES3_compatibility (ETC2, core in 4.3)
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
+// -- ARB_get_program_binary (core in 4.1) --
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_PROGRAM_BINARY_FORMATS
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+// -- KHR_parallel_shader_compile / ARB_parallel_shader_compile --
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+// Checks which extensions the current openGL context supports and loads their functions.
+// Like the resource manager it is a static class so it can be used from anywhere
+class GLExtensions
+{
+public:
+    // Checks for and loads every extension. Call this once after glad has been loaded (needs a current context)
+    static void Load();
+
+    // whether Load() has been called yet
+    static bool isLoaded;
+
+    // whether buffers can be given immutable storage and stay mapped while the gpu reads them (persistent mapping)
+    static bool hasBufferStorage;
+    // glBufferStorage, nullptr if not supported
+    static PFNGLBUFFERSTORAGEPROC BufferStorage;
+
+    // whether instanced draws can start from an instance other than 0 (base instance)
+    static bool hasBaseInstance;
+    // glDrawElementsInstancedBaseVertexBaseInstance, nullptr if not supported
+    static PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC DrawElementsInstancedBaseVertexBaseInstance;
+
+    // whether many indexed draws can be submitted from a buffer of commands in one call. Only counted as supported if base instance is too,
+    // because the commands need their base instance to find their instance data
+    static bool hasMultiDrawIndirect;
+    // glMultiDrawElementsIndirect, nullptr if not supported
+    static PFNGLMULTIDRAWELEMENTSINDIRECTPROC MultiDrawElementsIndirect;
+
+    // whether BC1 to BC3 (DXT1/3/5) textures can be uploaded compressed. BC4 and BC5 (RGTC) are core in 3.0 so they always can
+    static bool hasS3TC;
+    // whether BC7 textures can be uploaded compressed
+    static bool hasBPTC;
+    // whether ETC2 textures can be uploaded compressed
+    static bool hasETC2;
+
+    // whether linked programs can be saved as a driver specific binary and loaded back later, see ProgramBinaryCache.
+    // Also needs the driver to have at least one binary format (some don't, even with the extension)
+    static bool hasProgramBinary;
+    // glGetProgramBinary, glProgramBinary and glProgramParameteri, nullptr if not supported
+    static PFNGLGETPROGRAMBINARYPROC GetProgramBinary;
+    static PFNGLPROGRAMBINARYPROC ProgramBinary;
+    static PFNGLPROGRAMPARAMETERIPROC ProgramParameteri;
+
+    // whether the driver compiles shaders on its own threads and can be asked if a shader/program is done without waiting for it
+    // (GL_COMPLETION_STATUS_KHR). Load() lets the driver use as many threads as it likes
+    static bool hasParallelShaderCompile;
+    // glMaxShaderCompilerThreadsKHR (or the ARB version), nullptr if not supported
+    static PFNGLMAXSHADERCOMPILERTHREADSKHRPROC MaxShaderCompilerThreads;
+
+private:
+    // private constructor, there should never be any GLExtensions objects
+    GLExtensions();
+
+    // returns whether the context's version is at least major.minor
+    static bool VersionAtLeast(int major, int minor);
+};
+
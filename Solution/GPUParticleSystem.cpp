@@ -0,0 +1,350 @@
+#include "GPUParticleSystem.h"
+#include "Entity.h"
+#include "ResourceManager.h"
+#include "Scene.h"
+#include "Hash.h"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+unsigned int GPUParticleSystem::quadVBO = 0;
+unsigned int GPUParticleSystem::quadEBO = 0;
+
+GPUParticleSystem::GPUParticleSystem(size_t maxParticles)
+{
+	if (maxParticles == 0)
+		throw std::exception("Tried to make a gpu particle system with no particles");
+
+	// every gpu particle system shares the same two programs, load them if this is the first one
+	_simulateProgram = ResourceManager::GetShader(simulateProgramName);
+	if (_simulateProgram == nullptr)
+		_simulateProgram = ResourceManager::LoadFeedbackShaderProgram(simulateProgramName, simulateVertPath, { "positionVelocity", "life" });
+	_drawProgram = ResourceManager::GetShader(defaultProgramName);
+	if (_drawProgram == nullptr)
+		_drawProgram = ResourceManager::LoadShaderProgram(defaultProgramName, defaultVertPath, defaultFragPath);
+
+	this->type = Entity::GPUParticleSystem;
+	// particles have soft edges and fade out
+	this->hasTransprency = true;
+	_maxParticles = maxParticles;
+
+	// initialise the shared quad if this is the first gpu particle system
+	if (quadVBO == 0)
+		InitRenderData();
+
+	// -- both particle buffers start out with every particle dead (all zeros) --
+	std::vector<ParticleData> deadParticles(maxParticles, ParticleData{ glm::vec4(0.0f), glm::vec4(0.0f) });
+	glGenBuffers(2, _particleVBOs);
+	glGenVertexArrays(2, _simulateVAOs);
+	glGenVertexArrays(2, _drawVAOs);
+	for (int i = 0; i < 2; i++)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, _particleVBOs[i]);
+		// written by the gpu and read by the gpu, the cpu never touches it
+		glBufferData(GL_ARRAY_BUFFER, maxParticles * sizeof(ParticleData), deadParticles.data(), GL_DYNAMIC_COPY);
+
+		// simulating reads one particle per vertex
+		glBindVertexArray(_simulateVAOs[i]);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (void*)offsetof(ParticleData, positionVelocity));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (void*)offsetof(ParticleData, life));
+		glEnableVertexAttribArray(1);
+
+		// drawing reads the quad per vertex and one particle per instance
+		glBindVertexArray(_drawVAOs[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+		// corner at location 0, 2 floats
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, _particleVBOs[i]);
+		// position and velocity at location 1
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (void*)offsetof(ParticleData, positionVelocity));
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+		// life, size and colour at location 2
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (void*)offsetof(ParticleData, life));
+		glEnableVertexAttribArray(2);
+		glVertexAttribDivisor(2, 1);
+	}
+	// unbind
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glGenQueries(2, _timerQueries);
+}
+
+GPUParticleSystem::~GPUParticleSystem()
+{
+	glDeleteQueries(2, _timerQueries);
+	glDeleteVertexArrays(2, _drawVAOs);
+	glDeleteVertexArrays(2, _simulateVAOs);
+	glDeleteBuffers(2, _particleVBOs);
+}
+
+void GPUParticleSystem::Emit(size_t count)
+{
+	_pendingBurst += count;
+}
+
+void GPUParticleSystem::Clear()
+{
+	// zero life is dead
+	std::vector<ParticleData> deadParticles(_maxParticles, ParticleData{ glm::vec4(0.0f), glm::vec4(0.0f) });
+	glBindBuffer(GL_ARRAY_BUFFER, _particleVBOs[_current]);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, _maxParticles * sizeof(ParticleData), deadParticles.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_pendingBurst = 0;
+	_emitRecords.clear();
+	_liveSlots = 0;
+	_revision++;
+}
+
+size_t GPUParticleSystem::GetMaxParticles()
+{
+	return _maxParticles;
+}
+
+size_t GPUParticleSystem::GetLiveSlotCount()
+{
+	return _liveSlots;
+}
+
+size_t GPUParticleSystem::GetDroppedCount()
+{
+	return _droppedCount;
+}
+
+double GPUParticleSystem::GetLastUpdateTime()
+{
+	return _lastUpdateTime;
+}
+
+void GPUParticleSystem::Update(float deltaTime)
+{
+	// -- free the slots of particles that were spawned longer ago than they can live --
+	_time += deltaTime;
+	// an update late, so rounding on the gpu can't leave one alive in a slot that's been freed
+	while (!_emitRecords.empty() && _time > _emitRecords.front().expireTime + deltaTime)
+	{
+		_liveSlots -= _emitRecords.front().count;
+		_emitRecords.pop_front();
+	}
+
+	// -- work out how many to spawn --
+	size_t emitCount = _pendingBurst;
+	_pendingBurst = 0;
+	if (emitter.isActive && emitter.rate > 0.0f)
+	{
+		float toSpawn = emitter.rate * deltaTime + _emitCarry;
+		size_t count = (size_t)toSpawn;
+		_emitCarry = toSpawn - (float)count;
+		emitCount += count;
+	}
+	else
+		_emitCarry = 0.0f;
+	// only spawn into slots that are free, the rest are dropped instead of replacing particles that are still alive
+	size_t freeSlots = _maxParticles - _liveSlots;
+	if (emitCount > freeSlots)
+	{
+		_droppedCount += emitCount - freeSlots;
+		emitCount = freeSlots;
+	}
+
+	// everything is dead and nothing's being spawned. Leave the revision alone so cached layers stay cached
+	if (_liveSlots == 0 && emitCount == 0)
+	{
+		_lastUpdateTime = 0.0;
+		return;
+	}
+
+	// -- read the query from a couple of updates ago, if it's done --
+	if (_isQueryWaiting[_queryIndex])
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(_timerQueries[_queryIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_TRUE)
+		{
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(_timerQueries[_queryIndex], GL_QUERY_RESULT, &nanoseconds);
+			_lastUpdateTime = (double)nanoseconds / 1e9;
+		}
+	}
+
+	// -- uniforms --
+	_simulateProgram->Use();
+	_simulateProgram->SetFloat("deltaTime", deltaTime);
+	_simulateProgram->SetFloat("dragFactor", std::exp(-drag * deltaTime));
+	_simulateProgram->SetVector2f("gravityStep", gravity * deltaTime);
+	_simulateProgram->SetInt("capacity", (int)_maxParticles);
+	_simulateProgram->SetInt("emitStart", (int)_emitCursor);
+	_simulateProgram->SetInt("emitCount", (int)emitCount);
+	// xorshift so every update gets a different seed
+	_seed ^= _seed << 13;
+	_seed ^= _seed >> 17;
+	_seed ^= _seed << 5;
+	_simulateProgram->SetInt("seed", (int)_seed);
+	_simulateProgram->SetVector2f("emitPosition", emitter.position);
+	_simulateProgram->SetVector2f("emitArea", emitter.area);
+	_simulateProgram->SetFloat("direction", glm::radians(emitter.direction));
+	_simulateProgram->SetFloat("spread", glm::radians(emitter.spread));
+	_simulateProgram->SetVector2f("speedRange", glm::vec2(emitter.minSpeed, emitter.maxSpeed));
+	_simulateProgram->SetVector2f("lifetimeRange", glm::vec2(emitter.minLifetime, emitter.maxLifetime));
+	_simulateProgram->SetVector2f("sizeRange", glm::vec2(emitter.minSize, emitter.maxSize));
+
+	// the new particles go in the free slots straight after the live ones
+	if (emitCount > 0)
+	{
+		_emitRecords.push_back({ emitCount, _time + std::max(emitter.minLifetime, emitter.maxLifetime) });
+		_liveSlots += emitCount;
+		_emitCursor = (_emitCursor + emitCount) % _maxParticles;
+	}
+
+	// -- step the live slots from the current buffer into the same slots of the other one --
+	// Slots outside them are left with old data in the other buffer, nothing reads them until they're spawned into again
+	int next = 1 - _current;
+	size_t runStarts[2];
+	size_t runCounts[2];
+	int runCount = GetSlotRuns(_liveSlots, runStarts, runCounts);
+
+	glBeginQuery(GL_TIME_ELAPSED, _timerQueries[_queryIndex]);
+	// nothing gets drawn, the vertex shader's outputs are all that's wanted
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(_simulateVAOs[_current]);
+	for (int i = 0; i < runCount; i++)
+	{
+		// feedback writes from the start of the bound range, so bind just the slots being read
+		glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _particleVBOs[next], runStarts[i] * sizeof(ParticleData), runCounts[i] * sizeof(ParticleData));
+		glBeginTransformFeedback(GL_POINTS);
+		glDrawArrays(GL_POINTS, (GLint)runStarts[i], (GLsizei)runCounts[i]);
+		glEndTransformFeedback();
+	}
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glBindVertexArray(0);
+	glDisable(GL_RASTERIZER_DISCARD);
+	glEndQuery(GL_TIME_ELAPSED);
+
+	_isQueryWaiting[_queryIndex] = true;
+	_queryIndex = 1 - _queryIndex;
+	_current = next;
+	_revision++;
+}
+
+void GPUParticleSystem::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw a gpu particle system which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a gpu particle system which isn't in a scene");
+
+	// everything is dead (see Update)
+	if (_liveSlots == 0)
+		return;
+
+	// anything added to the batcher before this has to be drawn first to keep the order right
+	DrawBatcher& drawBatcher = parentEntity->parentScene->drawBatcher;
+	drawBatcher.Flush();
+
+	// same as ParticleSystem::Draw, just worked out in the shader
+	Transform& transform = parentEntity->transform;
+
+	_drawProgram->Use();
+	_drawProgram->SetMatrix4("view", drawBatcher.GetViewMatrix());
+	_drawProgram->SetMatrix4("projection", drawBatcher.GetProjectionMatrix());
+	glm::vec3 size = transform.GetGlobalSize(camera);
+	_drawProgram->SetVector2f("origin", transform.GetGlobalPosition(camera) * 2.0f - glm::vec2(size));
+	_drawProgram->SetFloat("scale", size.x);
+	// the depth of the entity's zIndex
+	_drawProgram->SetFloat("depth", transform.ToMatrix(camera)[3][2]);
+	_drawProgram->SetVector4f("minColor", emitter.minColor);
+	_drawProgram->SetVector4f("maxColor", emitter.maxColor);
+	_drawProgram->SetBool("fadeOut", fadeOut);
+
+	// particles are all at the same depth so they'd hide each other instead of blending. Whatever it was is put back after
+	GLboolean depthWriteMask = GL_TRUE;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWriteMask);
+	glDepthMask(GL_FALSE);
+	glBindVertexArray(_drawVAOs[_current]);
+	glBindBuffer(GL_ARRAY_BUFFER, _particleVBOs[_current]);
+	// only the live slots, instances always start from the attribute's offset so it's pointed at the start of each run (GL 3.3 has no base instance)
+	size_t runStarts[2];
+	size_t runCounts[2];
+	int runCount = GetSlotRuns(_liveSlots, runStarts, runCounts);
+	for (int i = 0; i < runCount; i++)
+	{
+		size_t runOffset = runStarts[i] * sizeof(ParticleData);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (void*)(runOffset + offsetof(ParticleData, positionVelocity)));
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (void*)(runOffset + offsetof(ParticleData, life)));
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)runCounts[i]);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glDepthMask(depthWriteMask);
+}
+
+size_t GPUParticleSystem::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, _revision);
+	Hash::Add(hash, fadeOut);
+	Hash::Add(hash, emitter.minColor);
+	Hash::Add(hash, emitter.maxColor);
+	Hash::Add(hash, boundsMin);
+	Hash::Add(hash, boundsMax);
+	return hash;
+}
+
+void GPUParticleSystem::GetLocalBounds(glm::vec2& min, glm::vec2& max)
+{
+	// a point p is at local coord (p - 1) * 2 (see ParticleSystem::Draw)
+	min = (boundsMin - 1.0f) * 2.0f;
+	max = (boundsMax - 1.0f) * 2.0f;
+}
+
+int GPUParticleSystem::GetSlotRuns(size_t count, size_t starts[2], size_t counts[2])
+{
+	if (count == 0)
+		return 0;
+
+	size_t start = (_emitCursor + _maxParticles - count) % _maxParticles;
+	starts[0] = start;
+	counts[0] = std::min(count, _maxParticles - start);
+	if (counts[0] == count)
+		return 1;
+
+	// wrapped around, the rest is at the start of the buffer
+	starts[1] = 0;
+	counts[1] = count - counts[0];
+	return 2;
+}
+
+void GPUParticleSystem::InitRenderData()
+{
+	// corners from -1 to 1, the shader scales them by each particle's radius
+	float vertices[] = {
+		1.0f,   1.0f, // top right
+		1.0f,  -1.0f, // bottom right
+		-1.0f, -1.0f, // bottom left
+		-1.0f,  1.0f, // top left
+	};
+	unsigned int indices[] = {
+		0, 1, 2,   // first triangle
+		2, 3, 0    // second triangle
+	};
+
+	// only the buffers are shared, each system has its own vertex arrays pointing at them
+	glGenBuffers(1, &quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glGenBuffers(1, &quadEBO);
+	// the element buffer binding belongs to whichever vertex array is bound, so fill it thru the array buffer binding instead.
+	// Buffers don't care what they're bound as
+	glBindBuffer(GL_ARRAY_BUFFER, quadEBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
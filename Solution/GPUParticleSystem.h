@@ -0,0 +1,146 @@
+#pragma once
+#include <memory>
+#include <deque>
+#include "Component.h"
+#include "ShaderProgram.h"
+#include "OrthoCamera.h"
+#include "ParticleSystem.h"
+
+// Particles that are simulated entirely on the gpu, for effects where nothing on the cpu needs to know where particles are.
+// Every particle lives in one of two gpu buffers. Each update a vertex shader (ParticleSimulate.vert) reads the live particles from one buffer,
+// steps it forward and writes it into the other with transform feedback, then the buffers swap. Drawing reads the latest buffer straight
+// away as instance data, so particle data never goes thru the cpu at all (everything here is GL 3.3 core).
+// New particles are spawned into the next slots of a ring. The cpu knows how long ago every slot was spawned into, so only the part of the ring
+// that can still be alive is simulated and drawn, and particles that would have to replace live ones aren't spawned (see GetDroppedCount).
+// Coords work the same as ParticleSystem, so for a normal size set offsetSize to (1,1,0).
+// Because the cpu never sees the particles, boundsMin/boundsMax have to be set to cover where they can go for render layers and partial redraw
+class GPUParticleSystem :
+    public Component
+{
+public:
+    // Setup a new gpu particle system that can have up to maxParticles alive at once. Only slots that can still be alive are simulated and
+    // drawn, so it's fine to be generous, it just costs memory
+    GPUParticleSystem(size_t maxParticles = 100000);
+    ~GPUParticleSystem();
+
+    // what spawns particles, can be changed at any time. Colours are picked on the gpu between minColor and maxColor
+    ParticleSystem::Emitter emitter;
+
+    // added to every particle's velocity every second (global coords)
+    glm::vec2 gravity = glm::vec2(0.0f);
+    // how quickly particles slow down. Speed is multiplied by e^-drag every second, 0 for no drag
+    float drag = 0.0f;
+    // whether particles fade out over their life, otherwise they just disappear when they die
+    bool fadeOut = true;
+
+    // Smallest and biggest coords (global, relative to the entity) particles can reach, including their size.
+    // Nothing on the cpu knows where they actually are so this is what render layers and partial redraw use
+    glm::vec2 boundsMin = glm::vec2(-500.0f);
+    glm::vec2 boundsMax = glm::vec2(500.0f);
+
+    // spawns count particles from the emitter on the next update, whether it's active or not
+    void Emit(size_t count);
+
+    // kills every particle
+    void Clear();
+
+    // how many particles can be alive at once
+    size_t GetMaxParticles();
+
+    // How many slots were simulated and drawn, the particles spawned recently enough that they could still be alive.
+    // Some of them will have died already if lifetimes are random
+    size_t GetLiveSlotCount();
+
+    // How many particles weren't spawned because every slot had a particle that could still be alive in it, since it was made.
+    // If this goes up maxParticles is too small for the emitter
+    size_t GetDroppedCount();
+
+    // How many seconds the gpu spent on a recent update, for benchmarking against ParticleSystem::GetLastUpdateTime.
+    // Timer queries are read a couple of frames late so asking never stalls
+    double GetLastUpdateTime();
+
+    // spawns particles and moves every particle forward by deltaTime seconds on the gpu. Called by the scene every frame
+    void Update(float deltaTime);
+
+    // Draw every particle using reference to scene camera and parent entity's transform, in one instanced draw.
+    // The scene's draw batcher is flushed first because this draws straight from the particle buffer
+    void Draw(std::shared_ptr<OrthoCamera> camera);
+
+    // returns a hash of everything about this system that changes how it looks. Used by render layers to tell when they need redrawing.
+    // A counter that goes up every update that could have moved something is used
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords the particles can be at (before the entity's transform is applied), from boundsMin/boundsMax
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+private:
+    // what's stored on the gpu for each particle, in the order ParticleSimulate.vert's outputs are
+    struct ParticleData {
+        // xy: position, zw: velocity
+        glm::vec4 positionVelocity;
+        // x: seconds left to live, y: lifetime, z: size, w: where its colour is between the emitter's min and max colour
+        glm::vec4 life;
+    };
+
+    size_t _maxParticles;
+
+    // the two particle buffers, with a vertex array each for simulating from it and drawing from it
+    unsigned int _particleVBOs[2] = {};
+    unsigned int _simulateVAOs[2] = {};
+    unsigned int _drawVAOs[2] = {};
+    // which buffer has the latest particles in it
+    int _current = 0;
+
+    // next slot in the ring that gets spawned into
+    size_t _emitCursor = 0;
+
+    // particles spawned by one update, they can't live longer than the emitter's longest lifetime at the time
+    struct EmitRecord {
+        size_t count;
+        // seconds (of _time) that all of them are dead by
+        double expireTime;
+    };
+    // every update that spawned particles which could still be alive, oldest first. Their slots are the ones just before _emitCursor
+    std::deque<EmitRecord> _emitRecords;
+    // particles in _emitRecords, how many slots before _emitCursor are simulated and drawn
+    size_t _liveSlots = 0;
+    size_t _droppedCount = 0;
+    // seconds the system has been updated for
+    double _time = 0.0;
+    // fraction of a particle the emitter didn't spawn last update, so low rates still spawn at the right speed
+    float _emitCarry = 0.0f;
+    // particles waiting to be spawned by Emit
+    size_t _pendingBurst = 0;
+    // changed every update so spawned particles get different random values
+    uint32_t _seed = 0x9E3779B9u;
+
+    // two timer queries taking turns, so one can be read while the other is timing
+    unsigned int _timerQueries[2] = {};
+    bool _isQueryWaiting[2] = {};
+    int _queryIndex = 0;
+    double _lastUpdateTime = 0.0;
+
+    // goes up by one every update that changed something
+    size_t _revision = 0;
+
+    // default shaders. Simulating uses one program for every gpu particle system and drawing uses another
+    const char* simulateVertPath = "VertexShaders/ParticleSimulate.vert";
+    const char* defaultVertPath = "VertexShaders/GPUParticleDefault.vert";
+    const char* defaultFragPath = "FragmentShaders/ParticleDefault.frag";
+    // names the programs are stored under in the resource manager
+    const char* simulateProgramName = "gpuParticleSimulateProgram";
+    const char* defaultProgramName = "defaultGPUParticleProgram";
+    ShaderProgram* _simulateProgram;
+    ShaderProgram* _drawProgram;
+
+    // Every gpu particle system shares one quad
+    static unsigned int quadVBO;
+    static unsigned int quadEBO;
+    // Initializes the shared quad's buffers
+    static void InitRenderData();
+
+    // Splits the count slots ending at _emitCursor into at most two runs, because the ring can wrap around the end of the buffer.
+    // starts/counts are filled with each run, returns how many runs there are
+    int GetSlotRuns(size_t count, size_t starts[2], size_t counts[2]);
+};
+
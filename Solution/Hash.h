@@ -0,0 +1,77 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <glm/glm.hpp>
+
+// Helpers for building one hash out of lots of values. Used to tell when something has changed (e.g. what is in a render layer)
+// without having to store and compare every value
+class Hash
+{
+public:
+	// mixes value into seed (same idea as boost::hash_combine)
+	static void Combine(size_t& seed, size_t value)
+	{
+		seed ^= value + (size_t)0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+	}
+
+	// hashes any type std::hash knows about and mixes it into seed
+	template <typename T>
+	static void Add(size_t& seed, const T& value)
+	{
+		Combine(seed, std::hash<T>()(value));
+	}
+
+	// glm vectors don't have a std::hash so do each component
+	static void Add(size_t& seed, const glm::vec2& value)
+	{
+		Add(seed, value.x);
+		Add(seed, value.y);
+	}
+
+	static void Add(size_t& seed, const glm::vec3& value)
+	{
+		Add(seed, value.x);
+		Add(seed, value.y);
+		Add(seed, value.z);
+	}
+
+	static void Add(size_t& seed, const glm::vec4& value)
+	{
+		Add(seed, value.x);
+		Add(seed, value.y);
+		Add(seed, value.z);
+		Add(seed, value.w);
+	}
+
+	static void Add(size_t& seed, const glm::mat4& value)
+	{
+		for (int column = 0; column < 4; column++)
+			Add(seed, value[column]);
+	}
+
+	// 64 bit FNV-1a of some bytes, continuing from seed. Unlike std::hash this gives the same number every run and on every compiler,
+	// so it can be saved to disk (e.g. ProgramBinaryCache's keys)
+	static unsigned long long Fnv1a(const void* data, size_t size, unsigned long long seed = 0xcbf29ce484222325ULL)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			seed ^= bytes[i];
+			seed *= 0x100000001b3ULL;
+		}
+		return seed;
+	}
+
+	static unsigned long long Fnv1a(const std::string& value, unsigned long long seed = 0xcbf29ce484222325ULL)
+	{
+		// the length goes in too so "ab" + "c" and "a" + "bc" are different
+		size_t length = value.size();
+		seed = Fnv1a(&length, sizeof(length), seed);
+		return Fnv1a(value.data(), value.size(), seed);
+	}
+
+private:
+	// only static functions
+	Hash();
+};
+
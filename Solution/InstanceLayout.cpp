@@ -0,0 +1,48 @@
+#include "InstanceLayout.h"
+
+InstanceLayout::InstanceLayout(unsigned int VAO, GLsizei stride)
+{
+	this->VAO = VAO;
+	this->stride = stride;
+}
+
+void InstanceLayout::AddAttribute(unsigned int location, int components, GLintptr offset, GLenum type, bool normalized)
+{
+	_attributes.push_back(Attribute{ location, components, offset, type, normalized ? (GLboolean)GL_TRUE : (GLboolean)GL_FALSE });
+
+	glBindVertexArray(VAO);
+	// enable the attribute and make it advance once per instance instead of once per vertex
+	glEnableVertexAttribArray(location);
+	glVertexAttribDivisor(location, 1);
+	glBindVertexArray(0);
+
+	// force the pointers to be set again on next bind
+	_boundOffset = -1;
+}
+
+void InstanceLayout::AddMatrix4Attribute(unsigned int location, GLintptr offset)
+{
+	// each column of the matrix is a vec4 in its own location
+	for (unsigned int column = 0; column < 4; column++)
+		AddAttribute(location + column, 4, offset + column * 4 * sizeof(float));
+}
+
+void InstanceLayout::BindInstanceData(unsigned int bufferID, unsigned int bufferGeneration, GLintptr byteOffset)
+{
+	glBindVertexArray(VAO);
+
+	// already pointing at the right place. A deleted buffer stays attached to the VAO, so a new buffer with the same ID still has to be bound again
+	if (bufferID == _boundBufferID && bufferGeneration == _boundBufferGeneration && byteOffset == _boundOffset)
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+	for (const Attribute& attribute : _attributes)
+		// param 1: location, 2: component count, 3: type, 4: whether to normalise, 5: stride of one instance, 6: byte offset into the buffer
+		glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized, stride, (void*)(byteOffset + attribute.offset));
+	// the VAO remembers which buffer each attribute reads from so the array buffer can be unbound
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_boundBufferID = bufferID;
+	_boundBufferGeneration = bufferGeneration;
+	_boundOffset = byteOffset;
+}
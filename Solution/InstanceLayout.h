@@ -0,0 +1,54 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+
+// Describes a mesh (VAO with its per-vertex attributes and element buffer already set up) plus how the per-instance data that goes with it is laid out.
+// Every renderer of one type shares a single layout, which is what lets the draw batcher merge them into instanced draws.
+// The per-instance attributes read from a buffer that is only known when drawing (the scene's stream buffer) so they are pointed at it with BindInstanceData
+class InstanceLayout
+{
+public:
+	// one per-instance vertex attribute, always floats in the shader
+	struct Attribute {
+		// layout location in the vertex shader
+		unsigned int location;
+		// how many values (1 to 4)
+		int components;
+		// byte offset from the start of one instance's data
+		GLintptr offset;
+		// type of each value in the buffer, e.g. GL_UNSIGNED_BYTE for a packed colour
+		GLenum type;
+		// whether integer values are turned into 0 to 1 (or -1 to 1) floats
+		GLboolean normalized;
+	};
+
+	// create a layout for the given VAO where each instance's data is stride bytes big
+	InstanceLayout(unsigned int VAO, GLsizei stride);
+
+	// vertex array object of the mesh
+	unsigned int VAO;
+	// size in bytes of one instance's data
+	GLsizei stride;
+
+	// Adds a per-instance attribute with 1 to 4 components at location. It's stored as type in the buffer and is converted to floats,
+	// normalised if normalized is true (so 4 unsigned bytes can be a 0 to 1 colour at a quarter of the size)
+	void AddAttribute(unsigned int location, int components, GLintptr offset, GLenum type = GL_FLOAT, bool normalized = false);
+
+	// adds a per-instance 4x4 matrix. A mat4 takes up 4 locations in a shader (one per column), starting at location
+	void AddMatrix4Attribute(unsigned int location, GLintptr offset);
+
+	// Points every instance attribute at bufferID, where instance 0 starts at byteOffset. Does nothing if they already point there.
+	// bufferGeneration tells a buffer apart from an older one that had the same ID (see StreamBuffer::GetGeneration).
+	// Binds the layout's VAO and leaves it bound
+	void BindInstanceData(unsigned int bufferID, unsigned int bufferGeneration, GLintptr byteOffset);
+
+private:
+	// all of the per-instance attributes
+	std::vector<Attribute> _attributes;
+
+	// buffer and offset the attributes currently point to, used to skip pointless re-binding
+	unsigned int _boundBufferID = 0;
+	unsigned int _boundBufferGeneration = 0;
+	GLintptr _boundOffset = -1;
+};
+
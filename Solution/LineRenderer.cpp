@@ -1,17 +1,20 @@
 #include "LineRenderer.h"
 #include "Entity.h"
-#include "ResourceManager.h"
+#include "Scene.h"
+#include "ShapePipeline.h"
+#include "Hash.h"
 // glad is included already thru other include
 #include <glfw3.h>
 #include <string>
+#include <array>
 #include <glm/gtc/matrix_transform.hpp> // matrix transformation math
 
 LineRenderer::LineRenderer(glm::vec2 point1, glm::vec2 point2, float thickness, glm::vec3 color, ShaderProgram* program)
 {
 	// if the program wasn't specified 
 	if (program == nullptr)
-		// use default path, add time to end to avoid lots of recursion when there are many defaultSpritePrograms
-		this->shaderProgram = ResourceManager::LoadShaderProgram("defaultLineProgram" + std::to_string(glfwGetTime()), defaultVertPath, defaultFragPath);
+		// all shapes share the same program, otherwise they couldn't be batched together
+		this->shaderProgram = ShapePipeline::GetDefaultProgram();
 	else // else use given one
 		this->shaderProgram = program;
 
@@ -22,33 +25,29 @@ LineRenderer::LineRenderer(glm::vec2 point1, glm::vec2 point2, float thickness,
 	_point1 = point1;
 	_point2 = point2;
 	_thickness = thickness;
-
-	// initialise line rect
-	InitRenderData();
-}
-
-LineRenderer::~LineRenderer()
-{
-	// de-allocate all resources once they've outlived their purpose
-	glDeleteVertexArrays(1, &lineVAO);
-	glDeleteBuffers(1, &lineVBO);
-	glDeleteBuffers(1, &lineEBO);
 }
 
 void LineRenderer::SetPoint1(glm::vec2 newPoint1)
 {
-	// set the new point
+	// that's it, the vertex shader moves the quad when it's drawn
 	_point1 = newPoint1;
-	// update vertices
-	UpdateLineVertices();
 }
 
 void LineRenderer::SetPoint2(glm::vec2 newPoint2)
 {
-	// set the new point
+	// that's it, the vertex shader moves the quad when it's drawn
 	_point2 = newPoint2;
-	// update vertices
-	UpdateLineVertices();
+}
+
+float LineRenderer::GetThickness()
+{
+	return _thickness;
+}
+
+void LineRenderer::SetThickness(float newThickness)
+{
+	// also just instance data
+	_thickness = newThickness;
 }
 
 float LineRenderer::GetAlpha()
@@ -58,117 +57,96 @@ float LineRenderer::GetAlpha()
 
 void LineRenderer::SetAlpha(float newAlpha)
 {
-	// if the new alpha is more than or equal to 1 (idk why it would be)
-	if (newAlpha >= 1.0f)
-	{
-		// cap it to 1 
-		_alpha = 1.0f;
-		// but also set it so transparency is off
-		this->hasTransprency = false;
-		// if the current renderer has a parent entity set it to no transparency
-		if (parentEntity != nullptr)
-			parentEntity->SetHasTransparency(false);
-	}
-	else
-	{
-		// do the same but for transparency turned on
-		_alpha = newAlpha;
-		this->hasTransprency = true;
-		// if the current renderer has a parent entity set it to has transparency
-		if (parentEntity != nullptr)
-			parentEntity->SetHasTransparency(true);
-	}
+	// cap it to 1 if the new alpha is more than 1 (idk why it would be)
+	_alpha = glm::min(newAlpha, 1.0f);
+	UpdateTransparency();
 }
 
-void LineRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
+bool LineRenderer::GetRoundCaps()
 {
-	if (parentEntity == nullptr)
-		throw std::exception("Tried to draw a sprite which doesn't have a parent entity");
-
-	shaderProgram->Use();
-
-	// get the transform of this renderer's parent
-	Transform spriteTransform = parentEntity->transform;
-
-	glm::mat4 view = camera->GetViewMatrix();
-	shaderProgram->SetMatrix4("view", view);
-
-
-	glm::mat4 projection = camera->GetProjectionMatrix();
-	shaderProgram->SetMatrix4("projection", projection);
-
-	// sey sprite transform
-	shaderProgram->SetMatrix4("modelTransform", spriteTransform.ToMatrix(camera));
-	// set color of rect with alpha channel included
-	shaderProgram->SetVector4f("lineColor", glm::vec4(color, _alpha));
-
-
-	// draw the rect
-	glBindVertexArray(this->lineVAO);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-	glBindVertexArray(0);
+	return _roundCaps;
 }
 
-void LineRenderer::InitRenderData()
+void LineRenderer::SetRoundCaps(bool newRoundCaps)
 {
-	// array of floats which are rect/line vertices
-	std::array<float, 12> vertices = CalculateLineVertices();
-
-	// define what order of vertices to draw line/rectangle
-	unsigned int indices[] = {  // note this is 0 based index
-		0, 1, 2,   // first triangle
-		2, 3, 1    // second triangle
-	};
-
-	// note that the VBO, VAO and EBO are actually just IDs to their values which are handled by opengl
-
-	// vertex buffer object, stores vertices
-	glGenBuffers(1, &lineVBO); // generate one buffer 
-
-	// vertex array object, holds all configurations for a VBO/EBO
-	glGenVertexArrays(1, &lineVAO); // generate 1 vertex arrya object
-
-	// Element buffer object, stores index to how vertices should be drawn cutting down amount needed
-	glGenBuffers(1, &lineEBO); // generate 1 elment buffer object
-
-	glBindVertexArray(lineVAO); // bind the vertex array object 
-
-	glBindBuffer(GL_ARRAY_BUFFER, lineVBO); // bind the generated buffer to array buffer target
-	// place vertex data into buffer memory. Pass pointer to first value like normal arrays
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &(vertices[0]), GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lineEBO);// bind generated element buffer object
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);// bind indicies to element buffer
+	_roundCaps = newRoundCaps;
+	UpdateTransparency();
+}
 
-	// set vertex attribute position pointer at location 0, with 3 values, of type float, don't normalise data, stride is 53 values, offser of 0 bytes
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-	// enable the created attribute which is at location 0
-	glEnableVertexAttribArray(0);
+void LineRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw a line which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a line which isn't in a scene");
+
+	ShapePipeline::InstanceData instance;
+	// just the entity transform, the vertex shader puts the quad between the points before this is applied
+	instance.modelTransform = parentEntity->transform.ToMatrix(camera);
+	// color of line with alpha channel included. Lines don't have a border so both are the same
+	instance.fillColor = glm::vec4(color, _alpha);
+	instance.strokeColor = instance.fillColor;
+	instance.shapeParams = glm::vec4(ShapePipeline::Line, _roundCaps ? 1.0f : 0.0f, 0.0f, _thickness);
+	// worked out in the vertex shader
+	instance.halfSize = glm::vec2(0.0f);
+	instance.linePoints = glm::vec4(_point1, _point2);
+
+	parentEntity->parentScene->drawBatcher.AddInstance(ShapePipeline::GetDrawState(shaderProgram), ShapePipeline::GetMesh(), &instance);
+}
 
-	// unbind
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+size_t LineRenderer::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, color);
+	Hash::Add(hash, _alpha);
+	Hash::Add(hash, shaderProgram);
+	Hash::Add(hash, _point1);
+	Hash::Add(hash, _point2);
+	Hash::Add(hash, _thickness);
+	Hash::Add(hash, _roundCaps);
+	return hash;
 }
 
-void LineRenderer::UpdateLineVertices()
+void LineRenderer::GetLocalBounds(glm::vec2& min, glm::vec2& max)
 {
-	// array of floats which are rect/line vertices
-	std::array<float, 12> vertices = CalculateLineVertices();
+	std::array<glm::vec2, 4> corners = CalculateLineCorners();
+	min = corners[0];
+	max = corners[0];
+	for (int i = 1; i < 4; i++)
+	{
+		min = glm::min(min, corners[i]);
+		max = glm::max(max, corners[i]);
+	}
+}
 
-	glBindVertexArray(lineVAO); // bind the vertex array object 
+bool LineRenderer::BakeStatic(std::shared_ptr<OrthoCamera> camera, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices)
+{
+	// round caps are smoothed by the shape shader, and a custom shader could do anything
+	if (shaderProgram != ShapePipeline::GetDefaultProgram() || _roundCaps)
+		return false;
+
+	// lines don't have a texture
+	key = StaticBatch::Key();
+	std::array<glm::vec2, 4> corners = CalculateLineCorners();
+	// going round the quad: left of point 1, right of point 1, right of point 2, left of point 2
+	glm::vec2 quadCorners[4] = { corners[0], corners[1], corners[3], corners[2] };
+	StaticBatch::AddQuad(vertices, parentEntity->transform.ToMatrix(camera), quadCorners, glm::vec4(color, _alpha));
+	return true;
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, lineVBO); // bind the buffer object to array buffer target
-	// place vertex data into buffer memory. Pass pointer to first value like normal arrays
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &(vertices[0]), GL_STATIC_DRAW); 
-	
-	// unbind
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+void LineRenderer::UpdateTransparency()
+{
+	// round caps are smoothed so they need blending
+	bool newTransparency = _alpha < 1.0f || _roundCaps;
 
+	this->hasTransprency = newTransparency;
+	// if the current renderer has a parent entity update its transparency
+	if (parentEntity != nullptr)
+		parentEntity->SetHasTransparency(newTransparency);
 }
 
-std::array<float, 12> LineRenderer::CalculateLineVertices()
+std::array<glm::vec2, 4> LineRenderer::CalculateLineCorners()
 {
 	/* -- Calculating the left/right side of a point --.
 	* To get a vector which points from P1 (point 1) to P2 (point 2) you just do P2 - P1. Now we have a vector which has origin (0,0) that is pointing towards
@@ -231,31 +209,27 @@ std::array<float, 12> LineRenderer::CalculateLineVertices()
 	* 
 	* You then need to do a * 2 because of dealing with normal to global coordinates stuff. Just look at transform.cpp for more info if curious
 	* 
+	* The corners aren't used for drawing anymore, ShapeDefault.vert does the same thing on the gpu to stretch the shape quad between the points.
+	* They're only worked out here when something needs the line's bounds or it's baked into a static batch
+	* 
 	* Also I write normalise not normalize cos I'm australian not american
 	*/
 
+	glm::vec2 difference = _point2 - _point1;
+	// both points are in the same spot, just point it along the x axis so normalising doesn't divide by 0
+	glm::vec2 normalisedDifferenceVector = (glm::length(difference) > 0.0f) ? glm::normalize(difference) : glm::vec2(1.0f, 0.0f);
+	// round caps stick out past the points by the thickness
+	glm::vec2 capOffset = _roundCaps ? normalisedDifferenceVector * _thickness : glm::vec2(0.0f);
 
-	glm::vec2 normalisedDifferenceVector = glm::normalize(_point2 - _point1);
-
-	// the point to the left of point 1. (90 degrees anti-clockwise)
-	glm::vec2 leftPoint1 = (glm::vec2(-(normalisedDifferenceVector.y), normalisedDifferenceVector.x) * _thickness + _point1 - 1.0f) * 2.0f;
-	// the point to the right of point 1. (90 degrees clockwise)
-	glm::vec2 rightPoint1 = (glm::vec2(normalisedDifferenceVector.y, -(normalisedDifferenceVector.x))* _thickness + _point1 - 1.0f) * 2.0f;
-
-	// the point to the left of point 2. (90 degrees anti-clockwise)
-	glm::vec2 leftPoint2 = (glm::vec2(-(normalisedDifferenceVector.y), normalisedDifferenceVector.x)* _thickness + _point2 - 1.0f) * 2.0f;
-	// the point to the right of point 2. (90 degrees clockwise)
-	glm::vec2 rightPoint2 = (glm::vec2(normalisedDifferenceVector.y, -(normalisedDifferenceVector.x))* _thickness + _point2 - 1.0f) * 2.0f;
-
-	std::array<float, 12> vertices = {
-		leftPoint1.x, leftPoint1.y, 0.0f,
-		rightPoint1.x, rightPoint1.y, 0.0f,
-		leftPoint2.x, leftPoint2.y, 0.0f,
-		rightPoint2.x, rightPoint2.y, 0.0f,
+	// the left side vector (90 degrees anti-clockwise), the right side is just the opposite
+	glm::vec2 leftVector = glm::vec2(-(normalisedDifferenceVector.y), normalisedDifferenceVector.x) * _thickness;
 
+	std::array<glm::vec2, 4> corners = {
+		(leftVector + _point1 - capOffset - 1.0f) * 2.0f, // left of point 1
+		(-leftVector + _point1 - capOffset - 1.0f) * 2.0f, // right of point 1
+		(leftVector + _point2 + capOffset - 1.0f) * 2.0f, // left of point 2
+		(-leftVector + _point2 + capOffset - 1.0f) * 2.0f // right of point 2
 	};
 
-
-	
-	return vertices;
+	return corners;
 }
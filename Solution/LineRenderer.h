@@ -3,19 +3,19 @@
 #include "Component.h"
 #include "ShaderProgram.h"
 #include "OrthoCamera.h"
+#include "StaticBatch.h"
 
-// Renders a line between two points. It is actually just a rect behind the scenes. 
+// Renders a line between two points. It is actually just a rect behind the scenes (the shape shader's quad, stretched between the points by the vertex shader). 
 // Note that transform's size just acts as a scalar value for the line. This means if you want just a normal size you have to set offsetSize to (1,1,0)
 class LineRenderer :
     public Component
 {
 public:
     // Setup a new line renderer using two points, a thickness (global coords), a given shader program and colour of line
-    // NOTE: If shader program is set to nullptr it will use a default shader
+    // NOTE: If shader program is set to nullptr it will use the default shape shader. A custom shader has to take the same per-instance attributes as ShapeDefault.vert
     LineRenderer(glm::vec2 point1, glm::vec2 point2, float thickness = 1.0f, glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
-    ~LineRenderer();
 
-    // colour of the rectangle
+    // colour of the line
     glm::vec3 color;
 
     // set the first point of the line renderer
@@ -23,16 +23,38 @@ public:
     // set the second point of the line renderer
     void SetPoint2(glm::vec2 newPoint2);
 
+    // get how thick the line is
+    float GetThickness();
+    // set how thick the line is
+    void SetThickness(float newThickness);
 
-    // get the alpha (transparency) value of this rect
+
+    // get the alpha (transparency) value of this line
     float GetAlpha();
 
-    // set the alpha (transparency) value of this rect
+    // set the alpha (transparency) value of this line
     void SetAlpha(float newAlpha);
 
-    // draw a rectangle using reference to scene camera and parent entity's transform
+    // get whether the ends of the line are rounded
+    bool GetRoundCaps();
+
+    // set whether the ends of the line are rounded (otherwise they are flat). Round caps are smoothed so they turn transparency on
+    void SetRoundCaps(bool newRoundCaps);
+
+    // draw a line using reference to scene camera and parent entity's transform. The points and thickness are sent as instance data so moving a point doesn't rebuild anything.
+    // The line is added to the scene's draw batcher so it gets drawn along with every other shape that uses the same program
     void Draw(std::shared_ptr<OrthoCamera> camera);
 
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords of the line's quad (before the entity's transform is applied)
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+    // Adds the line to vertices as a pre-transformed quad for a static batch (see Scene::BakeStatic). The corners are worked out here instead of in the vertex shader.
+    // Returns false if it can't be baked (custom shader or round caps) and doesn't add anything
+    bool BakeStatic(std::shared_ptr<OrthoCamera> camera, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices);
+
 private:
     // first point of line
     glm::vec2 _point1;
@@ -43,26 +65,18 @@ private:
     // how thick the rendered line is
     float _thickness;
 
-    // the alpha channel (transparency) of the current rect
+    // whether the ends are rounded
+    bool _roundCaps = false;
+
+    // the alpha channel (transparency) of the current line
     float _alpha = 1.0f;
     // shader program that the renderer uses
     ShaderProgram* shaderProgram;
-    // default vertex sahader
-    const char* defaultVertPath = "VertexShaders/LineDefault.vert";
-    // default frag sahader
-    const char* defaultFragPath = "FragmentShaders/LineDefault.frag";
-    // vretex array object ID for the line's rect
-    unsigned int lineVAO;
-    unsigned int lineVBO;
-    unsigned int lineEBO;
-
-    // Initializes and configures the line's buffer and vertex attributes
-    void InitRenderData();
-
-    // Each line is just a rect. This updates its vertices whenever there is a change in either points
-    void UpdateLineVertices();
-
-    // Calculates the vertices of the rect for a line renderer based on its two points and thickness
-    std::array<float, 12> CalculateLineVertices();
+
+    // Works out the 4 corners of the line's rect in local coords (before the entity's transform is applied). Only used for bounds and baking, the vertex shader does this when drawing
+    std::array<glm::vec2, 4> CalculateLineCorners();
+
+    // turns transparency on if the line is see through or has smoothed (round) caps, off otherwise
+    void UpdateTransparency();
 };
 
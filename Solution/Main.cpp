@@ -4,7 +4,10 @@
 #include <glm/glm.hpp> // OpenGL maths: Include all GLM core / GLSL features
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/constants.hpp>
 #include <vector>
+#include <cmath>
+#include <algorithm>
 
 
 // stuff i made
@@ -14,9 +17,19 @@
 #include "Scene.h"
 #include "EllipseRenderer.h"
 #include "LineRenderer.h"
+#include "PolylineRenderer.h"
+#include "TextRenderer.h"
+#include "ParticleSystem.h"
+#include "GPUParticleSystem.h"
+#include "TilemapRenderer.h"
+#include "PolygonRenderer.h"
+#include "PathRenderer.h"
+#include "SpriteAnimator.h"
 #include "FloatTween.h"
 #include "Vec2Tween.h"
 #include "Vec3Tween.h"
+#include "GLExtensions.h"
+#include "ProgramBinaryCache.h"
 
 
 
@@ -116,13 +129,22 @@ const char* defaultTexture = "Textures/ZazaWolf.jpg";
 const int defaultWindowWidth = 800;
 const int defaultWindowHeight = 800;
 const bool wireframeMode = false; // whether or not wireframe mode is activated (only show outline of primitives) and no fill
-const unsigned int antiAliasingSamples = 4; // how many samples openGL's anti aliasing functionality uses (MSAA). More samples per pixel means more chance an object will appear smoother cos more hit points
+const bool printRenderStats = false; // whether or not to print how many draw calls/submissions the scene's draw batcher made, once a second
+const unsigned int animatedCrowdSize = 100; // the crowd of animated sprites is this many across and down, they all share one sprite sheet
+const bool partialRedrawMode = false; // whether the scene only redraws the parts of the screen that changed each frame (see Scene.partialRedraw)
+const Scene::AntiAliasing antiAliasingMode = Scene::MSAA; // how the scene smooths edges at the start, press 1 (none), 2 (MSAA) or 3 (FXAA) to switch while it's running
+const int antiAliasingSamples = 4; // how many samples each pixel has in MSAA mode. More samples per pixel means more chance an object will appear smoother cos more hit points
+const bool benchmarkAntiAliasing = false; // whether to time a few hundred frames in each anti aliasing mode before the main loop and print the results
+const bool benchmarkParticles = false; // whether to time the cpu and gpu particle systems stepping the same number of particles before the main loop and print the results
+const bool dynamicResolutionMode = false; // whether the scene draws at a lower resolution when the gpu is taking longer than a 60fps frame (see Scene.dynamicResolution)
 
 // scene gets intialised in main function
 std::unique_ptr<Scene> scene;
 
 // declared functions
 static void windowReSizeCallback(GLFWwindow* window, int width, int height);
+static void runAntiAliasingBenchmark();
+static void runParticleBenchmark();
 
 void func(EventInfo e) {
 	std::cout << "Fired an event" << std::endl;
@@ -135,7 +157,6 @@ int main() {
 	// Configure glfw so it knows we are using version 3 of opengl (3.3)
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_SAMPLES, antiAliasingSamples); // turn on anti aliasing
 	// Core profile removes backwards compatability because we won't use those other functions
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
@@ -159,9 +180,18 @@ int main() {
 		return -1;
 	}
 
+	// load anything newer than GL 3.3 that the driver supports (glad only has 3.3 core)
+	GLExtensions::Load();
+
 	// intialise a new scene
 	scene = std::make_unique<Scene>(mainWindow, defaultWindowWidth, defaultWindowHeight);
 
+	scene->partialRedraw = partialRedrawMode;
+	// the scene does anti aliasing in its own back buffer, the window itself isn't multisampled
+	scene->antiAliasing = antiAliasingMode;
+	scene->msaaSamples = antiAliasingSamples;
+	scene->dynamicResolution = dynamicResolutionMode;
+
 	// attach callback for when window is resized
 	glfwSetFramebufferSizeCallback(mainWindow, windowReSizeCallback);
 
@@ -181,13 +211,19 @@ int main() {
 
 	// - Shaders
 
-	// create a shader porgram using path
-	ShaderProgram* shaderProgram = ResourceManager::LoadShaderProgram("program", defaultVertShaderPath, defaultFragShaderPath);
+	// create a shader porgram using path. It compiles in the background, the callback says when it's done
+	ShaderProgram* shaderProgram = ResourceManager::LoadShaderProgram("program", defaultVertShaderPath, defaultFragShaderPath,
+		[](ShaderProgram* program) { std::cout << "Shader program " << program->name << (program->IsLinked() ? " is ready" : " failed to build") << std::endl; });
 
 	// --- textures ---
 
 	Texture2D* zazaTexture = ResourceManager::LoadTexture("ZazaWolf", defaultTexture, false);
 
+	// show how full the atlas pages are. The wolf is too big to go in the atlas so there won't be any pages unless smaller textures are loaded
+	if (printRenderStats)
+		for (TextureAtlas::PageStats pageStats : ResourceManager::textureAtlas.GetStats())
+			std::cout << "Atlas page " << pageStats.textureID << ": " << pageStats.imageCount << " textures, " << pageStats.occupancy * 100.0f << "% full" << std::endl;
+
 	// wireframe mode
 	if(wireframeMode)
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -230,6 +266,10 @@ int main() {
 	rectRenderer2->color = glm::vec3(0.0f, 1.0f, 0.0f); // green
 	//rectRenderer2->color = glm::vec3(0.0f, 0.0f, 1.0f); // blue
 	rectRenderer2->SetAlpha(1.0f);
+	// rounded corners with a dark green border
+	rectRenderer2->SetCornerRadius(15.0f);
+	rectRenderer2->borderWidth = 4.0f;
+	rectRenderer2->borderColor = glm::vec3(0.0f, 0.4f, 0.0f);
 
 	// add to entity
 	rect2->AddComponent(Entity::RectangleRenderer, rectRenderer2);
@@ -260,9 +300,66 @@ int main() {
 
 	scene->AddEntity("sprite", sprite);
 
-	
+	// A nine-sliced panel stuck to the top of the screen. Its size is relative to the window so it changes when the window is resized,
+	// but its borders stay 24 pixels wide and it's still drawn in the same batch as the other wolf sprites
+	std::shared_ptr<Entity> panel = std::make_shared<Entity>();
+	panel->transform.type = Transform::Sticky;
+	panel->transform.relativePosition = glm::vec2(0.05f, 0.85f);
+	panel->transform.relativeSize = glm::vec2(0.9f, 0.1f);
+	panel->transform.SetZIndex(6);
+
+	std::shared_ptr<SpriteRenderer> panelRenderer = std::make_shared<SpriteRenderer>(zazaTexture);
+	panelRenderer->sliceBorders = glm::vec4(80.0f);
+	panelRenderer->sliceScale = 0.3f;
+	panel->AddComponent(Entity::SpriteRenderer, panelRenderer);
+
+	scene->AddEntity("panel", panel);
+
+	// a sprite with a texture that loads in the background. It's a checkerboard until the image is ready
+	std::shared_ptr<Entity> asyncSprite = std::make_shared<Entity>();
+	asyncSprite->transform.offsetSize = glm::vec3(91.1f, 69.0f, 0.0f);
+	asyncSprite->transform.offsetPosition = glm::vec2(650.0f, 120.0f);
+	Texture2D* asyncTexture = ResourceManager::LoadTextureAsync("ZazaWolfAsync", defaultTexture, false, [](Texture2D* texture)
+		{
+			if (texture != nullptr)
+				std::cout << "Texture " << texture->name << " finished loading" << std::endl;
+		});
+	asyncSprite->AddComponent(Entity::SpriteRenderer, std::make_shared<SpriteRenderer>(asyncTexture));
+	scene->AddEntity("asyncSprite", asyncSprite);
+
+	// sprites from a texture array, each one can use a different layer and they still all go in one draw
+	TextureArray* wolfArray = ResourceManager::LoadTextureArray("WolfArray", std::vector<std::string>{ defaultTexture }, false);
+	for (int i = 0; i < 3; i++)
+	{
+		std::shared_ptr<Entity> arraySprite = std::make_shared<Entity>();
+		arraySprite->transform.offsetSize = glm::vec3(91.1f, 69.0f, 0.0f);
+		arraySprite->transform.offsetPosition = glm::vec2(650.0f + i * 100.0f, 20.0f);
 
-	
+		// only one image in the array so far, add more files to see different layers
+		std::shared_ptr<SpriteRenderer> arraySpriteRenderer = std::make_shared<SpriteRenderer>(wolfArray, i % wolfArray->layerCount);
+		arraySprite->AddComponent(Entity::SpriteRenderer, arraySpriteRenderer);
+
+		scene->AddEntity("arraySprite" + std::to_string(i), arraySprite);
+	}
+
+
+	// A million tile map behind everything. Only the chunks on screen are drawn, move the camera with WASD to see more of it
+	std::shared_ptr<Entity> tilemap = std::make_shared<Entity>();
+	// size is just a scalar like the line
+	tilemap->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+	tilemap->transform.offsetPosition = glm::vec2(-8000.0f, -8000.0f);
+
+	std::shared_ptr<TilemapRenderer> tilemapRenderer = std::make_shared<TilemapRenderer>(wolfArray, 1000, 1000, glm::vec2(16.0f));
+	// every other tile in a checker pattern, the rest are left empty
+	std::vector<uint16_t> tiles(1000 * 1000, TilemapRenderer::EmptyTile);
+	for (unsigned int y = 0; y < 1000; y++)
+		for (unsigned int x = (y % 2); x < 1000; x += 2)
+			tiles[y * 1000 + x] = 0;
+	tilemapRenderer->SetTiles(tiles);
+	tilemapRenderer->color = glm::vec3(0.35f);
+	tilemap->AddComponent(Entity::TilemapRenderer, tilemapRenderer);
+
+	scene->AddEntity("tilemap", tilemap);
 
 	// create ellipse entity
 	std::shared_ptr<Entity> ellipse = std::make_shared<Entity>();
@@ -286,6 +383,8 @@ int main() {
 	//ellipseRenderer->color = glm::vec3(0.0f, 0.0f, 1.0f); // blue
 	ellipseRenderer->color = glm::vec3(1.0f, 1.0f, 0.0f); // yellow
 	ellipseRenderer->SetAlpha(0.6f);
+	ellipseRenderer->borderWidth = 3.0f;
+	ellipseRenderer->borderColor = glm::vec3(1.0f, 0.5f, 0.0f); // orange
 
 	// add to entity
 	ellipse->AddComponent(Entity::EllipseRenderer, ellipseRenderer);
@@ -310,12 +409,220 @@ int main() {
 
 	line->transform.SetZIndex(5);
 	//lineRenderer->SetAlpha(0.9f);
+	lineRenderer->SetRoundCaps(true);
 
 	// add to entity
 	line->AddComponent(Entity::LineRenderer, lineRenderer);
 
 	scene->AddEntity("line", line);
 
+	// Create a polyline entity, a sine wave that gets a new point added every frame
+	std::shared_ptr<Entity> wave = std::make_shared<Entity>();
+	// same as the line, size is just a scalar
+	wave->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+
+	std::shared_ptr<PolylineRenderer> waveRenderer = std::make_shared<PolylineRenderer>(nullptr, 0, 2.0f, glm::vec3(1.0f, 0.0f, 1.0f)); // magenta
+	waveRenderer->SetJoinType(PolylineRenderer::RoundJoin);
+	waveRenderer->SetCapType(PolylineRenderer::RoundCap);
+	wave->transform.SetZIndex(5);
+
+	// add to entity
+	wave->AddComponent(Entity::PolylineRenderer, waveRenderer);
+
+	scene->AddEntity("wave", wave);
+
+	// Create a star shaped polygon with a square hole in it
+	std::shared_ptr<Entity> star = std::make_shared<Entity>();
+	// size is just a scalar like the line
+	star->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+	star->transform.offsetPosition = glm::vec2(1100.0f, 550.0f);
+	star->transform.SetZIndex(5);
+
+	std::vector<glm::vec2> starOutline;
+	for (int i = 0; i < 10; i++)
+	{
+		// every other point is further out
+		float radius = (i % 2 == 0) ? 100.0f : 45.0f;
+		float angle = glm::radians(90.0f + i * 36.0f);
+		starOutline.push_back(glm::vec2(std::cos(angle), std::sin(angle)) * radius);
+	}
+	std::shared_ptr<PolygonRenderer> starRenderer = std::make_shared<PolygonRenderer>(starOutline, glm::vec3(1.0f, 0.8f, 0.2f));
+	starRenderer->AddHole({ glm::vec2(-15.0f, -15.0f), glm::vec2(15.0f, -15.0f), glm::vec2(15.0f, 15.0f), glm::vec2(-15.0f, 15.0f) });
+	star->AddComponent(Entity::PolygonRenderer, starRenderer);
+
+	scene->AddEntity("star", star);
+
+	// A wobbly blob with 100k points, which is triangulated on a worker thread. It shows up once it's done
+	std::shared_ptr<Entity> blob = std::make_shared<Entity>();
+	blob->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+	blob->transform.offsetPosition = glm::vec2(1350.0f, 550.0f);
+	blob->transform.SetZIndex(5);
+
+	const int blobPointCount = 100000;
+	std::vector<glm::vec2> blobOutline(blobPointCount);
+	for (int i = 0; i < blobPointCount; i++)
+	{
+		float angle = i * glm::two_pi<float>() / blobPointCount;
+		float radius = 100.0f + std::sin(angle * 7.0f) * 15.0f + std::sin(angle * 401.0f) * 3.0f;
+		blobOutline[i] = glm::vec2(std::cos(angle), std::sin(angle)) * radius;
+	}
+	std::shared_ptr<PolygonRenderer> blobRenderer = std::make_shared<PolygonRenderer>(blobOutline, glm::vec3(0.4f, 0.9f, 0.5f));
+	blobRenderer->SetAlpha(0.8f);
+	blob->AddComponent(Entity::PolygonRenderer, blobRenderer);
+
+	scene->AddEntity("blob", blob);
+
+	// A chart made of curves. Zoom in and the curves get flattened into more segments so they stay smooth, panning reuses the cached triangles
+	std::shared_ptr<Entity> chart = std::make_shared<Entity>();
+	chart->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+	chart->transform.offsetPosition = glm::vec2(1100.0f, 250.0f);
+	chart->transform.SetZIndex(5);
+
+	std::shared_ptr<PathRenderer> chartRenderer = std::make_shared<PathRenderer>(glm::vec3(0.2f, 0.5f, 0.9f), glm::vec3(1.0f), 3.0f);
+	chartRenderer->SetJoinType(PolylineRenderer::RoundJoin);
+	// area under a smooth line, closed along the bottom
+	chartRenderer->MoveTo(glm::vec2(0.0f, 0.0f));
+	chartRenderer->LineTo(glm::vec2(0.0f, 60.0f));
+	chartRenderer->CubicTo(glm::vec2(60.0f, 160.0f), glm::vec2(100.0f, 20.0f), glm::vec2(160.0f, 90.0f));
+	chartRenderer->QuadraticTo(glm::vec2(210.0f, 150.0f), glm::vec2(260.0f, 110.0f));
+	chartRenderer->LineTo(glm::vec2(260.0f, 0.0f));
+	chartRenderer->Close();
+	// round hole in the middle, going clockwise
+	chartRenderer->MoveTo(glm::vec2(150.0f, 40.0f));
+	chartRenderer->Arc(glm::vec2(130.0f, 40.0f), 20.0f, 0.0f, -360.0f);
+	chartRenderer->Close();
+	chart->AddComponent(Entity::PathRenderer, chartRenderer);
+
+	scene->AddEntity("chart", chart);
+
+	// Create a text entity. The font's glyphs are rasterised into its distance field atlas once when it loads, zoom in to see it stay sharp
+	Font* labelFont = ResourceManager::LoadFont("Lato", "Fonts/Lato-Regular.ttf");
+	std::shared_ptr<Entity> label = std::make_shared<Entity>();
+	// size is just a scalar like the line
+	label->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+	label->transform.offsetPosition = glm::vec2(20.0f, 260.0f);
+	label->transform.SetZIndex(6);
+
+	std::shared_ptr<TextRenderer> labelRenderer = std::make_shared<TextRenderer>(labelFont, "Graphics Renderer\nSigned distance field text stays crisp at any zoom", 28.0f);
+	labelRenderer->SetWrapWidth(420.0f);
+	labelRenderer->SetAlignment(Font::Center);
+
+	// add to entity
+	label->AddComponent(Entity::TextRenderer, labelRenderer);
+
+	scene->AddEntity("label", label);
+
+	// Create a particle fountain. Every particle is in one component and drawn in one instanced draw
+	std::shared_ptr<Entity> fountain = std::make_shared<Entity>();
+	// size is just a scalar like the line
+	fountain->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+	fountain->transform.offsetPosition = glm::vec2(1100.0f, 100.0f);
+	fountain->transform.SetZIndex(4);
+
+	std::shared_ptr<ParticleSystem> fountainParticles = std::make_shared<ParticleSystem>(50000);
+	fountainParticles->gravity = glm::vec2(0.0f, -400.0f);
+	fountainParticles->drag = 0.2f;
+	ParticleSystem::Emitter fountainEmitter;
+	fountainEmitter.rate = 8000.0f;
+	fountainEmitter.area = glm::vec2(10.0f, 0.0f);
+	fountainEmitter.direction = 90.0f;
+	fountainEmitter.spread = 15.0f;
+	fountainEmitter.minSpeed = 350.0f;
+	fountainEmitter.maxSpeed = 500.0f;
+	fountainEmitter.minLifetime = 1.5f;
+	fountainEmitter.maxLifetime = 2.5f;
+	fountainEmitter.minSize = 2.0f;
+	fountainEmitter.maxSize = 5.0f;
+	fountainEmitter.minColor = glm::vec4(0.2f, 0.5f, 1.0f, 1.0f);
+	fountainEmitter.maxColor = glm::vec4(0.7f, 0.9f, 1.0f, 1.0f);
+	fountainParticles->AddEmitter(fountainEmitter);
+
+	// add to entity
+	fountain->AddComponent(Entity::ParticleSystem, fountainParticles);
+
+	scene->AddEntity("fountain", fountain);
+
+	// The same fountain simulated on the gpu instead, to compare the two. Nothing about its particles goes thru the cpu
+	std::shared_ptr<Entity> gpuFountain = std::make_shared<Entity>();
+	gpuFountain->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+	gpuFountain->transform.offsetPosition = glm::vec2(1400.0f, 100.0f);
+	gpuFountain->transform.SetZIndex(4);
+
+	std::shared_ptr<GPUParticleSystem> gpuFountainParticles = std::make_shared<GPUParticleSystem>(50000);
+	gpuFountainParticles->gravity = fountainParticles->gravity;
+	gpuFountainParticles->drag = fountainParticles->drag;
+	gpuFountainParticles->emitter = fountainEmitter;
+	// Roughly where particles can get to. The highest is about maxSpeed^2 / (2 * gravity), they fall below the start before they die
+	// and the spread takes them out to the sides
+	gpuFountainParticles->boundsMin = glm::vec2(-300.0f, -150.0f);
+	gpuFountainParticles->boundsMax = glm::vec2(300.0f, 330.0f);
+
+	gpuFountain->AddComponent(Entity::GPUParticleSystem, gpuFountainParticles);
+
+	scene->AddEntity("gpuFountain", gpuFountain);
+
+	// A crowd of animated sprites below the tilemap's corner. The wolf is cut into a 4x4 sheet of frames that every one of them shares,
+	// each one only has its own clip and time so they're all still one batched draw on the same texture
+	std::shared_ptr<SpriteSheet> wolfSheet = std::make_shared<SpriteSheet>(zazaTexture);
+	wolfSheet->AddGrid(glm::vec2(zazaTexture->width / 4.0f, zazaTexture->height / 4.0f));
+	wolfSheet->AddClip("cycle", 0, 16, 12.0f);
+	wolfSheet->AddClip("corners", std::vector<unsigned int>{ 0, 3, 15, 12 }, 4.0f);
+	for (unsigned int y = 0; y < animatedCrowdSize; y++)
+		for (unsigned int x = 0; x < animatedCrowdSize; x++)
+		{
+			std::shared_ptr<Entity> character = std::make_shared<Entity>();
+			character->transform.offsetSize = glm::vec3(12.0f, 9.0f, 0.0f);
+			character->transform.offsetPosition = glm::vec2(-1000.0f + x * 14.0f, -1500.0f + y * 11.0f);
+			character->AddComponent(Entity::SpriteRenderer, std::make_shared<SpriteRenderer>(zazaTexture));
+
+			// every other one plays the other clip, and they're spread out in time so they don't all show the same frame
+			std::shared_ptr<SpriteAnimator> characterAnimator = std::make_shared<SpriteAnimator>(wolfSheet, (x + y) % 2);
+			character->AddComponent(Entity::SpriteAnimator, characterAnimator);
+			characterAnimator->SetTime((x * 7 + y * 13) * 0.01);
+
+			scene->AddEntity("character" + std::to_string(y * animatedCrowdSize + x), character);
+		}
+
+	// A field of static rects and lines to the left, they never move so they're baked into a couple of static batches (see Scene::BakeStatic below)
+	// instead of each one being an instance every frame. Every 7th rect has a border which is baked as its own quads
+	for (int y = 0; y < 30; y++)
+		for (int x = 0; x < 30; x++)
+		{
+			std::shared_ptr<Entity> staticRect = std::make_shared<Entity>();
+			staticRect->transform.offsetSize = glm::vec3(24.0f, 24.0f, 0.0f);
+			staticRect->transform.offsetPosition = glm::vec2(-1000.0f + x * 30.0f, y * 30.0f);
+			staticRect->transform.rotation.z = (float)((x + y) % 4) * 10.0f;
+
+			std::shared_ptr<RectangleRenderer> staticRectRenderer = std::make_shared<RectangleRenderer>(glm::vec3(x / 30.0f, y / 30.0f, 0.5f));
+			if ((y * 30 + x) % 7 == 0)
+			{
+				staticRectRenderer->borderWidth = 3.0f;
+				staticRectRenderer->borderColor = glm::vec3(1.0f);
+			}
+			staticRect->AddComponent(Entity::RectangleRenderer, staticRectRenderer);
+
+			staticRect->SetIsStatic(true);
+			scene->AddEntity("staticRect" + std::to_string(y * 30 + x), staticRect);
+		}
+	for (int i = 0; i < 31; i++)
+	{
+		// grid lines between the rects, size is just a scalar for lines
+		std::shared_ptr<Entity> staticLine = std::make_shared<Entity>();
+		staticLine->transform.offsetSize = glm::vec3(1.0f, 1.0f, 0.0f);
+		std::shared_ptr<LineRenderer> staticLineRenderer = std::make_shared<LineRenderer>(glm::vec2(-1003.0f + i * 30.0f, -3.0f), glm::vec2(-1003.0f + i * 30.0f, 897.0f), 1.0f, glm::vec3(0.8f));
+		staticLine->AddComponent(Entity::LineRenderer, staticLineRenderer);
+
+		staticLine->SetIsStatic(true);
+		scene->AddEntity("staticLine" + std::to_string(i), staticLine);
+	}
+
+	// how many points the wave gets up to
+	const size_t wavePointCount = 2000;
+
+	// the sprite and first rect (zIndex 1 to 2) never change, so cache them in a render layer. They get drawn once and then the layer is just redrawn as a quad
+	std::shared_ptr<RenderLayer> staticLayer = std::make_shared<RenderLayer>(1, 2);
+	scene->AddRenderLayer(staticLayer);
+
 	//unsigned int listenerId = scene->AddListener(Scene::EventType::Frame_End,EventListener(func));
 
 	//std::cout << "Created a listener with id " << listenerId << std::endl;
@@ -345,6 +652,19 @@ int main() {
 	
 
 
+	// how many programs came from the binary cache. Every one should be a hit from the second launch on
+	if (ProgramBinaryCache::IsAvailable())
+		std::cout << "Shader cache: " << ProgramBinaryCache::hitCount << " programs loaded, " << ProgramBinaryCache::missCount << " compiled" << std::endl;
+	std::cout << ResourceManager::GetPendingShaderPrograms() << " shader programs submitted, they finish in the background" << std::endl;
+
+	// everything has been added, so bake the static entities now instead of them waiting to be baked by themselves
+	scene->BakeStatic();
+
+	if (benchmarkAntiAliasing)
+		runAntiAliasingBenchmark();
+	if (benchmarkParticles)
+		runParticleBenchmark();
+
 	// set a breakpoint here if you need to check variables before they go into main loop
 	std::cout << "checkpoint" << std::endl;
 
@@ -352,6 +672,9 @@ int main() {
 	// temp camera movement config
 	float camSpeed = 500.0f; // how many global coords cam moves per second
 
+	// last time render stats were printed
+	double lastStatsPrintTime = glfwGetTime();
+
 	// main loop that finishes when window is closed.
 	while (!glfwWindowShouldClose(mainWindow))
 	{
@@ -374,9 +697,46 @@ int main() {
 		if (glfwGetKey(mainWindow, GLFW_KEY_D) == GLFW_PRESS)
 			scene->mainCamera->position.x += camSpeed * deltaTime;
 
+		// switch anti aliasing mode
+		if (glfwGetKey(mainWindow, GLFW_KEY_1) == GLFW_PRESS)
+			scene->antiAliasing = Scene::NoAntiAliasing;
+		if (glfwGetKey(mainWindow, GLFW_KEY_2) == GLFW_PRESS)
+			scene->antiAliasing = Scene::MSAA;
+		if (glfwGetKey(mainWindow, GLFW_KEY_3) == GLFW_PRESS)
+			scene->antiAliasing = Scene::FXAA;
+
 		// rotate ellipse (revolutions are every 2*pi seconds)
 		//ellipse->transform.rotation.z = glm::degrees((float)glfwGetTime());
+		// add the next point of the wave, only the new segment gets uploaded
+		if (waveRenderer->GetPoints().size() < wavePointCount)
+		{
+			float waveX = (float)waveRenderer->GetPoints().size() * 0.5f;
+			waveRenderer->AppendPoint(glm::vec2(waveX, 150.0f + std::sin(waveX / 20.0f) * 60.0f));
+		}
+
 		scene->Update();
+
+		// print the draw batcher's stats once a second
+		if (printRenderStats && glfwGetTime() - lastStatsPrintTime >= 1.0)
+		{
+			DrawBatcher::Stats stats = scene->drawBatcher.GetStats();
+			std::cout << "Submissions: " << stats.submissions << ", draw calls: " << stats.drawCalls << ", commands: " << stats.commands
+				<< ", instances: " << stats.instances << ", draws per submission: " << stats.DrawsPerSubmission() << std::endl;
+			if (scene->partialRedraw)
+				std::cout << "Redrawn: " << scene->dirtyRegions.GetRedrawnFraction() * 100.0f << "% of the screen" << std::endl;
+			std::cout << "Particles: " << fountainParticles->GetAliveCount() << " alive, update took " << fountainParticles->GetLastUpdateTime() * 1000.0
+				<< "ms (" << (ParticleSystem::useSimd ? ParticleSystem::GetSimdName() : "Scalar") << ")" << std::endl;
+			std::cout << "GPU particles: " << gpuFountainParticles->GetLiveSlotCount() << " of " << gpuFountainParticles->GetMaxParticles()
+				<< " slots live, " << gpuFountainParticles->GetDroppedCount() << " dropped, update took " << gpuFountainParticles->GetLastUpdateTime() * 1000.0
+				<< "ms on the gpu" << std::endl;
+			std::cout << "Blob: " << blobRenderer->GetTriangleCount() << " triangles, "
+				<< (blobRenderer->IsTriangulating() ? "still triangulating" : "triangulated in " + std::to_string(blobRenderer->GetLastTriangulationTime() * 1000.0) + "ms") << std::endl;
+			std::cout << "Static: " << scene->GetBakedEntityCount() << " entities baked into " << scene->GetStaticBatchCount() << " batches" << std::endl;
+			std::cout << "Tilemap: " << tilemapRenderer->GetVisibleChunkCount() << " of " << tilemapRenderer->GetChunkCount() << " chunks drawn" << std::endl;
+			std::cout << "Back buffer: " << scene->GetBackBufferMemory() / (1024.0 * 1024.0) << "MB" << std::endl;
+			std::cout << "Resolution: " << scene->GetResolutionScale() * 100.0f << "% of the window, gpu frame took " << scene->GetGPUFrameTime() * 1000.0 << "ms" << std::endl;
+			lastStatsPrintTime = glfwGetTime();
+		}
 		
 		//float timeSinceStart = (float)glfwGetTime(); // time since start of window
 		//shaderProgram.setFloat("sinTime", sin(timeSinceStart) / 2.0f + 0.5f); // normalise sin(time since start of application) to be a value between 0-1 based
@@ -400,3 +760,136 @@ void windowReSizeCallback(GLFWwindow* window, int width, int height) {
 	glViewport(0, 0, width, height);
 }
 
+void runAntiAliasingBenchmark()
+{
+	/*
+	* Draws the same frames in each anti aliasing mode and prints how long they took, how many pixels (and MSAA samples) were filled a second and how much
+	* memory the back buffer took. The scene is whatever main set up, so it's a mix of shapes, sprites and text rather than a pure fill rate test.
+	* To see how it goes on llvmpipe (software rendering, where every sample is filled by the cpu) run it with mesa's software driver,
+	* e.g. LIBGL_ALWAYS_SOFTWARE=1 on linux or mesa's opengl32.dll next to the exe on windows
+	*/
+	struct Mode {
+		const char* name;
+		Scene::AntiAliasing antiAliasing;
+		int samples;
+	};
+	Mode modes[] = {
+		{ "None", Scene::NoAntiAliasing, 0 },
+		{ "FXAA", Scene::FXAA, 0 },
+		{ "MSAA 2x", Scene::MSAA, 2 },
+		{ "MSAA 4x", Scene::MSAA, 4 },
+		{ "MSAA 8x", Scene::MSAA, 8 },
+	};
+	const int warmUpFrames = 20;
+	const int timedFrames = 200;
+
+	// vsync would make every mode take the same time
+	glfwSwapInterval(0);
+
+	Scene::AntiAliasing oldAntiAliasing = scene->antiAliasing;
+	int oldSamples = scene->msaaSamples;
+	double pixelsPerFrame = (double)scene->mainCamera->width * scene->mainCamera->height;
+
+	for (const Mode& mode : modes)
+	{
+		// the driver can't do that many samples
+		if (mode.samples > RenderTarget::GetMaxSamples())
+			continue;
+
+		scene->antiAliasing = mode.antiAliasing;
+		scene->msaaSamples = mode.samples;
+
+		// lets the back buffer get made and any shaders finish before timing
+		for (int i = 0; i < warmUpFrames; i++)
+			scene->Update();
+		glFinish();
+
+		double startTime = glfwGetTime();
+		for (int i = 0; i < timedFrames; i++)
+			scene->Update();
+		// wait for the gpu to actually finish drawing them
+		glFinish();
+		double time = glfwGetTime() - startTime;
+
+		double pixelsPerSecond = pixelsPerFrame * timedFrames / time;
+		std::cout << "Anti aliasing " << mode.name << ": " << time * 1000.0 / timedFrames << "ms per frame, "
+			<< pixelsPerSecond / 1000000.0 << " million pixels/s (" << pixelsPerSecond * std::max(mode.samples, 1) / 1000000.0 << " million samples/s), "
+			<< scene->GetBackBufferMemory() / (1024.0 * 1024.0) << "MB back buffer" << std::endl;
+	}
+
+	scene->antiAliasing = oldAntiAliasing;
+	scene->msaaSamples = oldSamples;
+	glfwSwapInterval(1);
+}
+
+void runParticleBenchmark()
+{
+	/*
+	* Steps the same number of particles on the cpu (scalar loop and SIMD) and the gpu for the same number of fixed length updates and prints how
+	* long an update took on average. Every particle is spawned at the start and lives longer than the run, so each path moves exactly count particles
+	* every update (the gpu steps every slot that could still be alive, so it's only fair when they're all alive). Only simulating is timed, nothing is drawn.
+	* The gpu time is wall time with glFinish at the end, so it includes sending the work to the driver like the cpu time includes everything
+	*/
+	const size_t particleCounts[] = { 10000, 100000, 1000000 };
+	const int warmUpUpdates = 10;
+	const int timedUpdates = 200;
+	const float deltaTime = 1.0f / 60.0f;
+
+	ParticleSystem::Emitter emitter;
+	emitter.rate = 0.0f;
+	emitter.isActive = false;
+	emitter.area = glm::vec2(100.0f);
+	// way longer than the run so nothing dies
+	emitter.minLifetime = 1000.0f;
+	emitter.maxLifetime = 1000.0f;
+
+	bool oldUseSimd = ParticleSystem::useSimd;
+
+	for (size_t count : particleCounts)
+	{
+		// -- cpu, with and without SIMD --
+		for (int simd = 0; simd < 2; simd++)
+		{
+			ParticleSystem::useSimd = simd == 1;
+			ParticleSystem cpuParticles(count);
+			cpuParticles.gravity = glm::vec2(0.0f, -400.0f);
+			cpuParticles.drag = 0.2f;
+			cpuParticles.AddEmitter(emitter);
+			cpuParticles.Emit(0, count);
+
+			for (int i = 0; i < warmUpUpdates; i++)
+				cpuParticles.Update(deltaTime);
+
+			double startTime = glfwGetTime();
+			for (int i = 0; i < timedUpdates; i++)
+				cpuParticles.Update(deltaTime);
+			double time = glfwGetTime() - startTime;
+
+			std::cout << "Particles " << count << " on the cpu (" << (ParticleSystem::useSimd ? ParticleSystem::GetSimdName() : "Scalar") << "): "
+				<< time * 1000.0 / timedUpdates << "ms per update, " << cpuParticles.GetAliveCount() << " alive" << std::endl;
+		}
+
+		// -- gpu --
+		GPUParticleSystem gpuParticles(count);
+		gpuParticles.gravity = glm::vec2(0.0f, -400.0f);
+		gpuParticles.drag = 0.2f;
+		gpuParticles.emitter = emitter;
+		gpuParticles.Emit(count);
+
+		for (int i = 0; i < warmUpUpdates; i++)
+			gpuParticles.Update(deltaTime);
+		glFinish();
+
+		double startTime = glfwGetTime();
+		for (int i = 0; i < timedUpdates; i++)
+			gpuParticles.Update(deltaTime);
+		// wait for the gpu to actually finish them
+		glFinish();
+		double time = glfwGetTime() - startTime;
+
+		std::cout << "Particles " << count << " on the gpu: " << time * 1000.0 / timedUpdates << "ms per update ("
+			<< gpuParticles.GetLastUpdateTime() * 1000.0 << "ms of that on the gpu by its timer query)" << std::endl;
+	}
+
+	ParticleSystem::useSimd = oldUseSimd;
+}
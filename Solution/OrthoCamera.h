@@ -11,9 +11,10 @@ public:
     float nearPlane;
     // anything after far plane is cut off
     float farPlane;
-    // width of viewport in pixels
+    // Width of viewport in pixels. This is the window's size, not what the scene draws at (dynamic resolution can draw into a smaller back buffer),
+    // so the projection and everything in global coords stays the same whatever the resolution is
     float width;
-    // height of viewport in pixels
+    // height of viewport in pixels, same as width
     float height;
     // create a new orthographic camera using near/far plane and width and height of viewport
     OrthoCamera(float width, float height, float nearPlane = -1.0f, float farPlane = 100.0f);
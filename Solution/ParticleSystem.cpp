@@ -0,0 +1,530 @@
+#include "ParticleSystem.h"
+#include "Entity.h"
+#include "ResourceManager.h"
+#include "Scene.h"
+#include "Hash.h"
+// glad is included already thru other include
+#include <glfw3.h>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+// -- SIMD --
+// SSE is always there on x86/x64. AVX is only used if the cpu (and os) supports it, which is checked once when the program starts,
+// so the functions that use it are compiled for AVX on their own instead of the whole program needing it
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PARTICLES_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// msvc lets any function use AVX intrinsics
+#define PARTICLES_AVX_FUNCTION
+#define PARTICLES_SSE_FUNCTION
+#else
+#define PARTICLES_AVX_FUNCTION __attribute__((target("avx")))
+#define PARTICLES_SSE_FUNCTION __attribute__((target("sse")))
+#endif
+#endif
+
+bool ParticleSystem::useSimd = true;
+InstanceLayout* ParticleSystem::_layout = nullptr;
+unsigned int ParticleSystem::quadVAO = 0;
+unsigned int ParticleSystem::quadVBO = 0;
+unsigned int ParticleSystem::quadEBO = 0;
+
+// what the integration step can use on this cpu
+enum SimdLevel {
+	SimdScalar,
+	SimdSSE,
+	SimdAVX
+};
+
+static SimdLevel DetectSimdLevel()
+{
+#if defined(PARTICLES_X86)
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	// the cpu has AVX and the os saves the AVX registers when switching threads (xgetbv says whether it does)
+	bool hasAVX = (info[2] & (1 << 28)) != 0;
+	bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+	if (hasAVX && hasOSXSave && (_xgetbv(0) & 0x6) == 0x6)
+		return SimdAVX;
+#else
+	if (__builtin_cpu_supports("avx"))
+		return SimdAVX;
+#endif
+	return SimdSSE;
+#else
+	return SimdScalar;
+#endif
+}
+
+static const SimdLevel simdLevel = DetectSimdLevel();
+
+// everything the integration step needs
+struct IntegrateArrays {
+	float* positionX;
+	float* positionY;
+	float* velocityX;
+	float* velocityY;
+	float* life;
+};
+
+// Steps particles first to end: velocity is slowed by drag and pulled by gravity, position moves by velocity and life goes down.
+// min and max are grown to fit every new position
+static void IntegrateScalar(const IntegrateArrays& arrays, size_t first, size_t end, float deltaTime, float dragFactor, glm::vec2 gravityStep,
+	glm::vec2& min, glm::vec2& max)
+{
+	for (size_t i = first; i < end; i++)
+	{
+		float velocityX = arrays.velocityX[i] * dragFactor + gravityStep.x;
+		float velocityY = arrays.velocityY[i] * dragFactor + gravityStep.y;
+		float positionX = arrays.positionX[i] + velocityX * deltaTime;
+		float positionY = arrays.positionY[i] + velocityY * deltaTime;
+		arrays.velocityX[i] = velocityX;
+		arrays.velocityY[i] = velocityY;
+		arrays.positionX[i] = positionX;
+		arrays.positionY[i] = positionY;
+		arrays.life[i] -= deltaTime;
+		min = glm::min(min, glm::vec2(positionX, positionY));
+		max = glm::max(max, glm::vec2(positionX, positionY));
+	}
+}
+
+#if defined(PARTICLES_X86)
+// Same as IntegrateScalar 4 particles at a time, the ones left over at the end use the scalar version
+PARTICLES_SSE_FUNCTION
+static void IntegrateSSE(const IntegrateArrays& arrays, size_t count, float deltaTime, float dragFactor, glm::vec2 gravityStep,
+	glm::vec2& min, glm::vec2& max)
+{
+	__m128 time = _mm_set1_ps(deltaTime);
+	__m128 drag = _mm_set1_ps(dragFactor);
+	__m128 gravityX = _mm_set1_ps(gravityStep.x);
+	__m128 gravityY = _mm_set1_ps(gravityStep.y);
+	__m128 minX = _mm_set1_ps(min.x), minY = _mm_set1_ps(min.y);
+	__m128 maxX = _mm_set1_ps(max.x), maxY = _mm_set1_ps(max.y);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 velocityX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(arrays.velocityX + i), drag), gravityX);
+		__m128 velocityY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(arrays.velocityY + i), drag), gravityY);
+		__m128 positionX = _mm_add_ps(_mm_loadu_ps(arrays.positionX + i), _mm_mul_ps(velocityX, time));
+		__m128 positionY = _mm_add_ps(_mm_loadu_ps(arrays.positionY + i), _mm_mul_ps(velocityY, time));
+		_mm_storeu_ps(arrays.velocityX + i, velocityX);
+		_mm_storeu_ps(arrays.velocityY + i, velocityY);
+		_mm_storeu_ps(arrays.positionX + i, positionX);
+		_mm_storeu_ps(arrays.positionY + i, positionY);
+		_mm_storeu_ps(arrays.life + i, _mm_sub_ps(_mm_loadu_ps(arrays.life + i), time));
+		minX = _mm_min_ps(minX, positionX);
+		minY = _mm_min_ps(minY, positionY);
+		maxX = _mm_max_ps(maxX, positionX);
+		maxY = _mm_max_ps(maxY, positionY);
+	}
+
+	// bring the 4 lanes of the bounds together
+	float lanes[4][4];
+	_mm_storeu_ps(lanes[0], minX);
+	_mm_storeu_ps(lanes[1], minY);
+	_mm_storeu_ps(lanes[2], maxX);
+	_mm_storeu_ps(lanes[3], maxY);
+	for (int lane = 0; lane < 4; lane++)
+	{
+		min = glm::min(min, glm::vec2(lanes[0][lane], lanes[1][lane]));
+		max = glm::max(max, glm::vec2(lanes[2][lane], lanes[3][lane]));
+	}
+
+	IntegrateScalar(arrays, i, count, deltaTime, dragFactor, gravityStep, min, max);
+}
+
+// Same as IntegrateScalar 8 particles at a time, the ones left over at the end use the scalar version
+PARTICLES_AVX_FUNCTION
+static void IntegrateAVX(const IntegrateArrays& arrays, size_t count, float deltaTime, float dragFactor, glm::vec2 gravityStep,
+	glm::vec2& min, glm::vec2& max)
+{
+	__m256 time = _mm256_set1_ps(deltaTime);
+	__m256 drag = _mm256_set1_ps(dragFactor);
+	__m256 gravityX = _mm256_set1_ps(gravityStep.x);
+	__m256 gravityY = _mm256_set1_ps(gravityStep.y);
+	__m256 minX = _mm256_set1_ps(min.x), minY = _mm256_set1_ps(min.y);
+	__m256 maxX = _mm256_set1_ps(max.x), maxY = _mm256_set1_ps(max.y);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 velocityX = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(arrays.velocityX + i), drag), gravityX);
+		__m256 velocityY = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(arrays.velocityY + i), drag), gravityY);
+		__m256 positionX = _mm256_add_ps(_mm256_loadu_ps(arrays.positionX + i), _mm256_mul_ps(velocityX, time));
+		__m256 positionY = _mm256_add_ps(_mm256_loadu_ps(arrays.positionY + i), _mm256_mul_ps(velocityY, time));
+		_mm256_storeu_ps(arrays.velocityX + i, velocityX);
+		_mm256_storeu_ps(arrays.velocityY + i, velocityY);
+		_mm256_storeu_ps(arrays.positionX + i, positionX);
+		_mm256_storeu_ps(arrays.positionY + i, positionY);
+		_mm256_storeu_ps(arrays.life + i, _mm256_sub_ps(_mm256_loadu_ps(arrays.life + i), time));
+		minX = _mm256_min_ps(minX, positionX);
+		minY = _mm256_min_ps(minY, positionY);
+		maxX = _mm256_max_ps(maxX, positionX);
+		maxY = _mm256_max_ps(maxY, positionY);
+	}
+
+	// bring the 8 lanes of the bounds together
+	float lanes[4][8];
+	_mm256_storeu_ps(lanes[0], minX);
+	_mm256_storeu_ps(lanes[1], minY);
+	_mm256_storeu_ps(lanes[2], maxX);
+	_mm256_storeu_ps(lanes[3], maxY);
+	for (int lane = 0; lane < 8; lane++)
+	{
+		min = glm::min(min, glm::vec2(lanes[0][lane], lanes[1][lane]));
+		max = glm::max(max, glm::vec2(lanes[2][lane], lanes[3][lane]));
+	}
+
+	// going from AVX back to SSE/scalar code without this is slow on some cpus
+	_mm256_zeroupper();
+	IntegrateScalar(arrays, i, count, deltaTime, dragFactor, gravityStep, min, max);
+}
+#endif
+
+// packs a 0 to 1 colour into bytes, r in the lowest byte so it's r, g, b, a in memory
+static uint32_t PackColor(glm::vec4 color)
+{
+	glm::vec4 clamped = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+	return (uint32_t)clamped.r | ((uint32_t)clamped.g << 8) | ((uint32_t)clamped.b << 16) | ((uint32_t)clamped.a << 24);
+}
+
+ParticleSystem::ParticleSystem(size_t maxParticles, ShaderProgram* program)
+{
+	// if the program wasn't specified
+	if (program == nullptr)
+	{
+		// all default particle systems share the same program, otherwise they couldn't be batched together
+		this->shaderProgram = ResourceManager::GetShader(defaultProgramName);
+		// load it if this is the first default particle system
+		if (this->shaderProgram == nullptr)
+			this->shaderProgram = ResourceManager::LoadShaderProgram(defaultProgramName, defaultVertPath, defaultFragPath);
+	}
+	else // else use given one
+		this->shaderProgram = program;
+
+	this->type = Entity::ParticleSystem;
+	// particles have soft edges and fade out
+	this->hasTransprency = true;
+
+	_maxParticles = 0;
+	SetMaxParticles(maxParticles);
+
+	// initialise the shared quad if this is the first particle system
+	if (_layout == nullptr)
+		InitRenderData();
+}
+
+const char* ParticleSystem::GetSimdName()
+{
+	switch (simdLevel)
+	{
+	case SimdAVX:
+		return "AVX";
+	case SimdSSE:
+		return "SSE";
+	default:
+		return "Scalar";
+	}
+}
+
+size_t ParticleSystem::AddEmitter(const Emitter& emitter)
+{
+	emitters.push_back(emitter);
+	return emitters.size() - 1;
+}
+
+void ParticleSystem::Emit(size_t emitterIndex, size_t count)
+{
+	if (emitterIndex >= emitters.size())
+		throw std::exception("Tried to emit particles from an emitter that doesn't exist");
+
+	Spawn(emitters[emitterIndex], count);
+	_revision++;
+}
+
+void ParticleSystem::Clear()
+{
+	_aliveCount = 0;
+	_revision++;
+}
+
+size_t ParticleSystem::GetAliveCount()
+{
+	return _aliveCount;
+}
+
+size_t ParticleSystem::GetMaxParticles()
+{
+	return _maxParticles;
+}
+
+void ParticleSystem::SetMaxParticles(size_t newMaxParticles)
+{
+	_maxParticles = newMaxParticles;
+	_positionX.resize(newMaxParticles);
+	_positionY.resize(newMaxParticles);
+	_velocityX.resize(newMaxParticles);
+	_velocityY.resize(newMaxParticles);
+	_size.resize(newMaxParticles);
+	_life.resize(newMaxParticles);
+	_lifetime.resize(newMaxParticles);
+	_color.resize(newMaxParticles);
+	_aliveCount = std::min(_aliveCount, newMaxParticles);
+	_revision++;
+}
+
+double ParticleSystem::GetLastUpdateTime()
+{
+	return _lastUpdateTime;
+}
+
+void ParticleSystem::Update(float deltaTime)
+{
+	double startTime = glfwGetTime();
+
+	// nothing alive and nothing to spawn, leave the revision alone so cached layers stay cached
+	bool anyEmitting = false;
+	for (const Emitter& emitter : emitters)
+		anyEmitting |= emitter.isActive && emitter.rate > 0.0f;
+	if (_aliveCount == 0 && !anyEmitting)
+	{
+		_lastUpdateTime = 0.0;
+		return;
+	}
+
+	// -- move every particle --
+	// bounds start inside out so the first position sets them
+	glm::vec2 min(1e30f);
+	glm::vec2 max(-1e30f);
+	IntegrateArrays arrays = { _positionX.data(), _positionY.data(), _velocityX.data(), _velocityY.data(), _life.data() };
+	float dragFactor = std::exp(-drag * deltaTime);
+	glm::vec2 gravityStep = gravity * deltaTime;
+#if defined(PARTICLES_X86)
+	if (useSimd && simdLevel == SimdAVX)
+		IntegrateAVX(arrays, _aliveCount, deltaTime, dragFactor, gravityStep, min, max);
+	else if (useSimd && simdLevel == SimdSSE)
+		IntegrateSSE(arrays, _aliveCount, deltaTime, dragFactor, gravityStep, min, max);
+	else
+#endif
+		IntegrateScalar(arrays, 0, _aliveCount, deltaTime, dragFactor, gravityStep, min, max);
+	_boundsMin = min;
+	_boundsMax = max;
+
+	Compact();
+
+	// -- spawn new particles --
+	_emitterCarry.resize(emitters.size(), 0.0f);
+	for (size_t i = 0; i < emitters.size(); i++)
+	{
+		const Emitter& emitter = emitters[i];
+		if (!emitter.isActive || emitter.rate <= 0.0f)
+		{
+			_emitterCarry[i] = 0.0f;
+			continue;
+		}
+		float toSpawn = emitter.rate * deltaTime + _emitterCarry[i];
+		size_t count = (size_t)toSpawn;
+		_emitterCarry[i] = toSpawn - (float)count;
+		Spawn(emitter, count);
+	}
+
+	_revision++;
+	_lastUpdateTime = glfwGetTime() - startTime;
+}
+
+void ParticleSystem::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw a particle system which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a particle system which isn't in a scene");
+
+	if (_aliveCount == 0)
+		return;
+
+	// Particle p (global coords relative to the entity) is at local coord (p - 1) * 2 like LineRenderer's points, so it ends up at
+	// 2 * position - size + 2 * scale * p once the model matrix is applied. That's worked out here instead so the matrix isn't needed per particle
+	Transform& transform = parentEntity->transform;
+	glm::vec3 size = transform.GetGlobalSize(camera);
+	glm::vec2 origin = transform.GetGlobalPosition(camera) * 2.0f - glm::vec2(size);
+	float scale = size.x;
+	// the depth of the entity's zIndex
+	float depth = transform.ToMatrix(camera)[3][2];
+
+	DrawBatcher::DrawState state;
+	state.program = shaderProgram;
+	state.layout = _layout;
+	// particles are all at the same depth so they'd hide each other instead of blending
+	state.depthWrite = false;
+
+	// draw the 6 indices of the quad
+	DrawBatcher::MeshRange mesh;
+	mesh.indexCount = 6;
+
+	// -- write every particle straight into the batcher --
+	InstanceData* instances = (InstanceData*)parentEntity->parentScene->drawBatcher.AddInstances(state, mesh, (unsigned int)_aliveCount);
+	float positionScale = scale * 2.0f;
+	for (size_t i = 0; i < _aliveCount; i++)
+	{
+		instances[i].positionSize = glm::vec4(origin.x + _positionX[i] * positionScale, origin.y + _positionY[i] * positionScale, depth, _size[i] * scale);
+		uint32_t color = _color[i];
+		if (fadeOut)
+		{
+			// scale the alpha byte by how much life is left
+			float lifeLeft = glm::clamp(_life[i] / _lifetime[i], 0.0f, 1.0f);
+			uint32_t alpha = (uint32_t)((color >> 24) * lifeLeft);
+			color = (color & 0x00FFFFFFu) | (alpha << 24);
+		}
+		instances[i].color = color;
+	}
+}
+
+size_t ParticleSystem::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, _revision);
+	Hash::Add(hash, _aliveCount);
+	Hash::Add(hash, fadeOut);
+	Hash::Add(hash, shaderProgram);
+	return hash;
+}
+
+void ParticleSystem::GetLocalBounds(glm::vec2& min, glm::vec2& max)
+{
+	// nothing is drawn
+	if (_aliveCount == 0)
+	{
+		min = glm::vec2(0.0f);
+		max = glm::vec2(0.0f);
+		return;
+	}
+
+	// a point p is at local coord (p - 1) * 2 (see Draw), padded by the biggest particle's radius
+	glm::vec2 padding(_largestSize * 0.5f);
+	min = (_boundsMin - padding - 1.0f) * 2.0f;
+	max = (_boundsMax + padding - 1.0f) * 2.0f;
+}
+
+void ParticleSystem::Spawn(const Emitter& emitter, size_t count)
+{
+	count = std::min(count, _maxParticles - _aliveCount);
+	if (count == 0)
+		return;
+
+	if (_aliveCount == 0)
+	{
+		// nothing to grow the bounds from
+		_boundsMin = glm::vec2(1e30f);
+		_boundsMax = glm::vec2(-1e30f);
+	}
+
+	for (size_t spawned = 0; spawned < count; spawned++)
+	{
+		size_t i = _aliveCount++;
+
+		glm::vec2 position = emitter.position + glm::vec2(RandomRange(-1.0f, 1.0f), RandomRange(-1.0f, 1.0f)) * emitter.area;
+		float angle = glm::radians(emitter.direction + RandomRange(-emitter.spread, emitter.spread));
+		float speed = RandomRange(emitter.minSpeed, emitter.maxSpeed);
+		float lifetime = std::max(RandomRange(emitter.minLifetime, emitter.maxLifetime), 0.0001f);
+
+		_positionX[i] = position.x;
+		_positionY[i] = position.y;
+		_velocityX[i] = std::cos(angle) * speed;
+		_velocityY[i] = std::sin(angle) * speed;
+		_size[i] = RandomRange(emitter.minSize, emitter.maxSize);
+		_life[i] = lifetime;
+		_lifetime[i] = lifetime;
+		_color[i] = PackColor(glm::mix(emitter.minColor, emitter.maxColor, Random()));
+
+		_boundsMin = glm::min(_boundsMin, position);
+		_boundsMax = glm::max(_boundsMax, position);
+		_largestSize = std::max(_largestSize, _size[i]);
+	}
+}
+
+void ParticleSystem::Compact()
+{
+	size_t i = 0;
+	while (i < _aliveCount)
+	{
+		if (_life[i] > 0.0f)
+		{
+			i++;
+			continue;
+		}
+
+		// move the last alive particle into the dead one's place and check it next, order doesn't matter
+		size_t last = --_aliveCount;
+		_positionX[i] = _positionX[last];
+		_positionY[i] = _positionY[last];
+		_velocityX[i] = _velocityX[last];
+		_velocityY[i] = _velocityY[last];
+		_size[i] = _size[last];
+		_life[i] = _life[last];
+		_lifetime[i] = _lifetime[last];
+		_color[i] = _color[last];
+	}
+}
+
+float ParticleSystem::Random()
+{
+	// xorshift, fast and good enough for particles
+	_randomState ^= _randomState << 13;
+	_randomState ^= _randomState >> 17;
+	_randomState ^= _randomState << 5;
+	// top 24 bits into a float from 0 to 1
+	return (_randomState >> 8) * (1.0f / 16777216.0f);
+}
+
+float ParticleSystem::RandomRange(float min, float max)
+{
+	return min + (max - min) * Random();
+}
+
+void ParticleSystem::InitRenderData()
+{
+	// corners from -1 to 1, the shader scales them by each particle's radius
+	float vertices[] = {
+		1.0f,   1.0f, // top right
+		1.0f,  -1.0f, // bottom right
+		-1.0f, -1.0f, // bottom left
+		-1.0f,  1.0f, // top left
+	};
+	unsigned int indices[] = {
+		0, 1, 2,   // first triangle
+		2, 3, 0    // second triangle
+	};
+
+	glGenBuffers(1, &quadVBO);
+	glGenVertexArrays(1, &quadVAO);
+	glGenBuffers(1, &quadEBO);
+
+	glBindVertexArray(quadVAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// corner at location 0, 2 floats
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// unbind
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	// -- per instance attributes, these are read from the scene's stream buffer when drawn --
+	_layout = new InstanceLayout(quadVAO, sizeof(InstanceData));
+	// position, depth and radius at location 1
+	_layout->AddAttribute(1, 4, offsetof(InstanceData, positionSize));
+	// colour at location 2, 4 bytes turned into 0 to 1
+	_layout->AddAttribute(2, 4, offsetof(InstanceData, color), GL_UNSIGNED_BYTE, true);
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Component.h"
+#include "ShaderProgram.h"
+#include "OrthoCamera.h"
+#include "InstanceLayout.h"
+
+// Lots of small round particles handled by one component, instead of an entity and renderer per particle.
+// Particles are stored as a structure of arrays (every x position together, every y position together etc.) so the update can step
+// 8 (AVX) or 4 (SSE) particles at once. Which one is used is picked when the program starts, with a plain loop for cpus that have neither.
+// Dead particles are swapped with the last alive one so the alive ones are always at the start of the arrays.
+// Every particle is drawn in one instanced draw (a few bytes per particle).
+// Particles are in global coords relative to the entity's position like LineRenderer's points and the transform's size acts as a scalar value,
+// so for a normal size set offsetSize to (1,1,0). The transform's rotation is ignored.
+// Particles are moved by the scene every frame (Update), even if they aren't drawn
+class ParticleSystem :
+    public Component
+{
+public:
+    // spawns particles at a rate and/or in bursts with Emit
+    struct Emitter {
+        // where particles spawn, relative to the entity (global coords)
+        glm::vec2 position = glm::vec2(0.0f);
+        // half the width and height of the box particles spawn in, 0 spawns them all on position
+        glm::vec2 area = glm::vec2(0.0f);
+        // particles spawned every second, 0 for bursts only
+        float rate = 100.0f;
+        // direction particles go in, degrees anticlockwise from the right
+        float direction = 90.0f;
+        // how many degrees either side of direction they can go
+        float spread = 180.0f;
+        // range of speeds particles start with (global coords per second)
+        float minSpeed = 50.0f;
+        float maxSpeed = 100.0f;
+        // range of how many seconds particles live for
+        float minLifetime = 1.0f;
+        float maxLifetime = 2.0f;
+        // range of particle diameters (global coords)
+        float minSize = 4.0f;
+        float maxSize = 8.0f;
+        // each particle gets a random colour (with alpha) between these
+        glm::vec4 minColor = glm::vec4(1.0f);
+        glm::vec4 maxColor = glm::vec4(1.0f);
+        // whether it spawns particles at its rate
+        bool isActive = true;
+    };
+
+    // Setup a new particle system that can have up to maxParticles alive at once. Memory for all of them is allocated straight away
+    // NOTE: If shader program is set to nullptr it will use the default particle shader. A custom shader has to take the same attributes as ParticleDefault.vert
+    ParticleSystem(size_t maxParticles = 100000, ShaderProgram* program = nullptr);
+
+    // every emitter, they can be changed at any time
+    std::vector<Emitter> emitters;
+
+    // added to every particle's velocity every second (global coords)
+    glm::vec2 gravity = glm::vec2(0.0f);
+    // how quickly particles slow down. Speed is multiplied by e^-drag every second, 0 for no drag
+    float drag = 0.0f;
+    // whether particles fade out over their life, otherwise they just disappear when they die
+    bool fadeOut = true;
+
+    // Whether the update uses SIMD (AVX or SSE) when the cpu has it. Turn off to compare against the plain loop
+    static bool useSimd;
+    // name of what the update uses on this cpu ("AVX", "SSE" or "Scalar"), ignoring useSimd
+    static const char* GetSimdName();
+
+    // adds an emitter and returns its index
+    size_t AddEmitter(const Emitter& emitter);
+
+    // spawns count particles from an emitter straight away, whether it's active or not. Particles past maxParticles aren't spawned
+    void Emit(size_t emitterIndex, size_t count);
+
+    // kills every particle
+    void Clear();
+
+    // how many particles are alive
+    size_t GetAliveCount();
+
+    // how many particles can be alive at once
+    size_t GetMaxParticles();
+    // change how many particles can be alive at once. Particles past the new amount are killed
+    void SetMaxParticles(size_t newMaxParticles);
+
+    // how many seconds the last Update took, for benchmarking
+    double GetLastUpdateTime();
+
+    // spawns particles from the emitters, moves every particle forward by deltaTime seconds and removes dead ones. Called by the scene every frame
+    void Update(float deltaTime);
+
+    // draw every particle using reference to scene camera and parent entity's transform, in one instanced draw
+    void Draw(std::shared_ptr<OrthoCamera> camera);
+
+    // returns a hash of everything about this system that changes how it looks. Used by render layers to tell when they need redrawing.
+    // A counter that goes up every update is used instead of hashing every particle
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords of the particles (before the entity's transform is applied)
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+private:
+    // what gets sent to the gpu for each particle
+    struct InstanceData {
+        // xy: centre, z: depth, w: radius. All in the same coords as the model matrix outputs (2 per global unit)
+        glm::vec4 positionSize;
+        // colour as bytes, the shader gets it as 0 to 1
+        uint32_t color;
+    };
+
+    // -- one array per property, only the first _aliveCount of each are alive --
+    std::vector<float> _positionX;
+    std::vector<float> _positionY;
+    std::vector<float> _velocityX;
+    std::vector<float> _velocityY;
+    std::vector<float> _size;
+    // seconds left to live
+    std::vector<float> _life;
+    // how many seconds it lived for in total, used for fading out
+    std::vector<float> _lifetime;
+    // rgba packed into bytes
+    std::vector<uint32_t> _color;
+
+    size_t _aliveCount = 0;
+    size_t _maxParticles;
+
+    // fraction of a particle each emitter didn't spawn last update, so low rates still spawn at the right speed
+    std::vector<float> _emitterCarry;
+
+    // state of the random number generator (xorshift)
+    uint32_t _randomState = 0x9E3779B9u;
+
+    // smallest and biggest particle positions after the last update, and the biggest size ever spawned
+    glm::vec2 _boundsMin = glm::vec2(0.0f);
+    glm::vec2 _boundsMax = glm::vec2(0.0f);
+    float _largestSize = 0.0f;
+
+    // goes up by one every update that changed something
+    size_t _revision = 0;
+    double _lastUpdateTime = 0.0;
+
+    // shader program that the system uses
+    ShaderProgram* shaderProgram;
+
+    // default shaders
+    const char* defaultVertPath = "VertexShaders/ParticleDefault.vert";
+    const char* defaultFragPath = "FragmentShaders/ParticleDefault.frag";
+    // name that the default program is stored under in the resource manager
+    const char* defaultProgramName = "defaultParticleProgram";
+    // Every particle system shares one quad and instance layout
+    static InstanceLayout* _layout;
+    static unsigned int quadVAO;
+    static unsigned int quadVBO;
+    static unsigned int quadEBO;
+    // Initializes and configures the shared quad's buffer and vertex attributes
+    static void InitRenderData();
+
+    // spawns count particles from emitter
+    void Spawn(const Emitter& emitter, size_t count);
+
+    // removes dead particles by moving the last alive one into their place
+    void Compact();
+
+    // random number from 0 to 1
+    float Random();
+    // random number from min to max
+    float RandomRange(float min, float max);
+};
+
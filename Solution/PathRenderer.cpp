@@ -0,0 +1,535 @@
+#include "PathRenderer.h"
+#include "Entity.h"
+#include "Scene.h"
+#include "Triangulator.h"
+#include "Hash.h"
+#include <cmath>
+#include <algorithm>
+#include <glm/gtc/constants.hpp>
+
+float PathRenderer::flatteningTolerance = 0.25f;
+
+// most segments one curve can be flattened into, so a huge zoom doesn't make millions of triangles
+static const int maxCurveSegments = 1024;
+
+PathRenderer::PathRenderer(glm::vec3 fillColor, glm::vec3 strokeColor, float thickness, ShaderProgram* program)
+{
+	// if the program wasn't specified
+	if (program == nullptr)
+		// paths share the polyline program and buffer, so they're batched together
+		this->shaderProgram = PolylinePipeline::GetDefaultProgram();
+	else // else use given one
+		this->shaderProgram = program;
+
+	// set type of component
+	this->type = Entity::PathRenderer;
+	this->fillColor = fillColor;
+	this->strokeColor = strokeColor;
+	_thickness = thickness;
+}
+
+PathRenderer::~PathRenderer()
+{
+	ClearCache();
+}
+
+void PathRenderer::MoveTo(glm::vec2 point)
+{
+	// a subpath that never got any segments is just replaced, otherwise an empty first subpath would stop the fill
+	if (!_subpaths.empty() && _subpaths.back().segments.empty())
+		_subpaths.back() = Subpath();
+	else
+		_subpaths.push_back(Subpath());
+
+	_subpaths.back().start = point;
+	GrowBounds(point);
+	ClearCache();
+}
+
+void PathRenderer::LineTo(glm::vec2 point)
+{
+	Segment segment;
+	segment.type = Line;
+	segment.end = point;
+	AddSegment(segment);
+	GrowBounds(point);
+}
+
+void PathRenderer::QuadraticTo(glm::vec2 control, glm::vec2 end)
+{
+	Segment segment;
+	segment.type = Quadratic;
+	segment.control1 = control;
+	segment.end = end;
+	AddSegment(segment);
+	// the curve never goes outside its control points
+	GrowBounds(control);
+	GrowBounds(end);
+}
+
+void PathRenderer::CubicTo(glm::vec2 control1, glm::vec2 control2, glm::vec2 end)
+{
+	Segment segment;
+	segment.type = Cubic;
+	segment.control1 = control1;
+	segment.control2 = control2;
+	segment.end = end;
+	AddSegment(segment);
+	GrowBounds(control1);
+	GrowBounds(control2);
+	GrowBounds(end);
+}
+
+void PathRenderer::Arc(glm::vec2 centre, float radius, float startAngle, float endAngle)
+{
+	if (radius <= 0.0f)
+		throw std::exception("Tried to add an arc with no radius to a path");
+
+	Segment segment;
+	segment.type = ArcSegment;
+	segment.centre = centre;
+	segment.radius = radius;
+	segment.startAngle = glm::radians(startAngle);
+	segment.endAngle = glm::radians(endAngle);
+	segment.end = centre + glm::vec2(std::cos(segment.endAngle), std::sin(segment.endAngle)) * radius;
+
+	// the arc starts from wherever the path is, so it has to get to the start of the arc first
+	glm::vec2 arcStart = centre + glm::vec2(std::cos(segment.startAngle), std::sin(segment.startAngle)) * radius;
+	if (_subpaths.empty())
+		MoveTo(arcStart);
+	else if (GetCurrentPoint() != arcStart)
+		LineTo(arcStart);
+
+	AddSegment(segment);
+	// the whole circle, working out which bits of it the arc goes round isn't worth it for bounds
+	GrowBounds(centre - radius);
+	GrowBounds(centre + radius);
+}
+
+void PathRenderer::Close()
+{
+	GetCurrentSubpath().closed = true;
+	ClearCache();
+}
+
+void PathRenderer::Clear()
+{
+	_subpaths.clear();
+	_hasBounds = false;
+	_pointsMin = glm::vec2(0.0f);
+	_pointsMax = glm::vec2(0.0f);
+	ClearCache();
+}
+
+bool PathRenderer::GetIsFilled()
+{
+	return _isFilled;
+}
+
+void PathRenderer::SetIsFilled(bool newIsFilled)
+{
+	// the cache doesn't have to be thrown away, a mesh without the fill is made again the next time it's drawn
+	_isFilled = newIsFilled;
+}
+
+bool PathRenderer::GetIsStroked()
+{
+	return _isStroked;
+}
+
+void PathRenderer::SetIsStroked(bool newIsStroked)
+{
+	_isStroked = newIsStroked;
+}
+
+float PathRenderer::GetThickness()
+{
+	return _thickness;
+}
+
+void PathRenderer::SetThickness(float newThickness)
+{
+	_thickness = newThickness;
+	ClearCache();
+}
+
+PolylineRenderer::JoinType PathRenderer::GetJoinType()
+{
+	return _joinType;
+}
+
+void PathRenderer::SetJoinType(PolylineRenderer::JoinType newJoinType)
+{
+	_joinType = newJoinType;
+	ClearCache();
+}
+
+PolylineRenderer::CapType PathRenderer::GetCapType()
+{
+	return _capType;
+}
+
+void PathRenderer::SetCapType(PolylineRenderer::CapType newCapType)
+{
+	_capType = newCapType;
+	ClearCache();
+}
+
+float PathRenderer::GetAlpha()
+{
+	return _alpha;
+}
+
+void PathRenderer::SetAlpha(float newAlpha)
+{
+	// cap it to 1 if the new alpha is more than 1
+	_alpha = glm::min(newAlpha, 1.0f);
+	UpdateTransparency();
+}
+
+size_t PathRenderer::GetCachedBucketCount()
+{
+	return _cache.size();
+}
+
+size_t PathRenderer::GetFlattenCount()
+{
+	return _flattenCount;
+}
+
+void PathRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw a path which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a path which isn't in a scene");
+
+	// nothing to draw
+	if (_subpaths.empty() || (!_isFilled && !_isStroked))
+		return;
+
+	_lastBucket = GetBucket(camera);
+	CachedMesh& mesh = GetMesh(_lastBucket);
+	mesh.lastUsed = ++_drawCount;
+
+	DrawBatcher& drawBatcher = parentEntity->parentScene->drawBatcher;
+	DrawBatcher::DrawState state = PolylinePipeline::GetDrawState(shaderProgram);
+
+	PolylinePipeline::InstanceData instance;
+	instance.modelTransform = parentEntity->transform.ToMatrix(camera);
+
+	if (_isFilled && mesh.fillVertexCount > 0)
+	{
+		// colour of fill with alpha channel included
+		instance.color = glm::vec4(fillColor, _alpha);
+		drawBatcher.AddInstance(state, PolylinePipeline::GetMesh(mesh.fillAllocation, mesh.fillVertexCount), &instance);
+	}
+
+	if (_isStroked && mesh.strokeVertexCount > 0)
+	{
+		// The outline is at the same depth as the fill so it would fail the depth test where they overlap. Moving it half a zIndex towards the
+		// camera puts it on top of the fill but still behind the next zIndex up
+		instance.modelTransform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.5f)) * instance.modelTransform;
+		instance.color = glm::vec4(strokeColor, _alpha);
+		drawBatcher.AddInstance(state, PolylinePipeline::GetMesh(mesh.strokeAllocation, mesh.strokeVertexCount), &instance);
+	}
+}
+
+size_t PathRenderer::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, fillColor);
+	Hash::Add(hash, strokeColor);
+	Hash::Add(hash, _alpha);
+	Hash::Add(hash, _isFilled);
+	Hash::Add(hash, _isStroked);
+	Hash::Add(hash, shaderProgram);
+	// the points aren't hashed one by one, the revision goes up whenever they change
+	Hash::Add(hash, _pathRevision);
+	Hash::Add(hash, _lastBucket);
+	return hash;
+}
+
+void PathRenderer::GetLocalBounds(glm::vec2& min, glm::vec2& max)
+{
+	// nothing is drawn
+	if (!_hasBounds)
+	{
+		min = glm::vec2(0.0f);
+		max = glm::vec2(0.0f);
+		return;
+	}
+
+	// the outline can stick out past the points by up to the length of a miter join
+	float margin = _isStroked ? _thickness * _miterLimit : 0.0f;
+	// global to local coords, same as PolylineRenderer
+	min = (_pointsMin - margin - 1.0f) * 2.0f;
+	max = (_pointsMax + margin - 1.0f) * 2.0f;
+}
+
+PathRenderer::Subpath& PathRenderer::GetCurrentSubpath()
+{
+	// no path yet, start from the origin
+	if (_subpaths.empty())
+		MoveTo(glm::vec2(0.0f));
+	// a closed subpath can't be added to, anything after it starts a new one from the same start (like svg)
+	else if (_subpaths.back().closed)
+		MoveTo(_subpaths.back().start);
+
+	return _subpaths.back();
+}
+
+glm::vec2 PathRenderer::GetCurrentPoint()
+{
+	if (_subpaths.empty())
+		return glm::vec2(0.0f);
+
+	const Subpath& subpath = _subpaths.back();
+	if (subpath.closed || subpath.segments.empty())
+		return subpath.start;
+	return subpath.segments.back().end;
+}
+
+void PathRenderer::AddSegment(const Segment& segment)
+{
+	GetCurrentSubpath().segments.push_back(segment);
+	ClearCache();
+}
+
+void PathRenderer::GrowBounds(glm::vec2 point)
+{
+	_pointsMin = _hasBounds ? glm::min(_pointsMin, point) : point;
+	_pointsMax = _hasBounds ? glm::max(_pointsMax, point) : point;
+	_hasBounds = true;
+}
+
+int PathRenderer::GetBucket(std::shared_ptr<OrthoCamera> camera)
+{
+	/*
+	* One global unit of the path is the transform's size in screen pixels (see PolylineRenderer) and the camera's size scales everything
+	* down, so a camera of scalar size 2 makes everything half as big. How many pixels a unit takes up is all that matters for flattening
+	* so panning never changes the bucket.
+	* The bucket is rounded up so the path is always flattened for at least the zoom it's drawn at
+	*/
+	glm::vec3 size = parentEntity->transform.GetGlobalSize(camera);
+	float entityScale = glm::max(std::abs(size.x), std::abs(size.y));
+	float cameraScale = glm::min(std::abs(camera->scalarSize.x), std::abs(camera->scalarSize.y));
+	if (entityScale <= 0.0f || cameraScale <= 0.0f)
+		return 0;
+
+	float bucket = std::ceil(std::log2(entityScale / cameraScale) * bucketsPerDoubling);
+	// way past anything that would be drawn, stops it from overflowing
+	return (int)glm::clamp(bucket, -64.0f, 64.0f);
+}
+
+PathRenderer::CachedMesh& PathRenderer::GetMesh(int bucket)
+{
+	// -- already flattened at this zoom --
+	CachedMesh* mesh = nullptr;
+	for (CachedMesh& cachedMesh : _cache)
+		if (cachedMesh.bucket == bucket)
+			mesh = &cachedMesh;
+
+	// has everything that's being drawn
+	if (mesh != nullptr && (mesh->hasFill || !_isFilled) && (mesh->hasStroke || !_isStroked))
+		return *mesh;
+
+	// -- make room for it --
+	if (mesh != nullptr)
+		// it's missing the fill or outline, just make it again
+		FreeMesh(*mesh);
+	else
+	{
+		if (_cache.size() >= maxCachedBuckets)
+		{
+			// throw away the one used the longest time ago
+			std::vector<CachedMesh>::iterator oldest = std::min_element(_cache.begin(), _cache.end(),
+				[](const CachedMesh& a, const CachedMesh& b) { return a.lastUsed < b.lastUsed; });
+			FreeMesh(*oldest);
+			_cache.erase(oldest);
+		}
+		_cache.push_back(CachedMesh());
+		mesh = &_cache.back();
+	}
+
+	mesh->bucket = bucket;
+	mesh->hasFill = _isFilled;
+	mesh->hasStroke = _isStroked;
+
+	// -- flatten for the most zoomed in end of the bucket, tolerance is in pixels so turn it into global units --
+	float pixelsPerUnit = std::exp2((float)bucket / bucketsPerDoubling);
+	float tolerance = flatteningTolerance / pixelsPerUnit;
+	std::vector<std::vector<glm::vec2>> lines;
+	Flatten(tolerance, lines);
+	_flattenCount++;
+
+	// -- fill, the first subpath is the outline and the rest are holes --
+	std::vector<glm::vec2> vertices;
+	if (_isFilled)
+	{
+		// the fill always closes every subpath, so one that ends on its start would have that point twice
+		std::vector<std::vector<glm::vec2>> rings = lines;
+		for (std::vector<glm::vec2>& ring : rings)
+			if (ring.size() > 1 && glm::distance(ring.back(), ring.front()) < tolerance * 0.01f)
+				ring.pop_back();
+
+		std::vector<std::vector<glm::vec2>> holes;
+		for (size_t i = 1; i < rings.size(); i++)
+			if (rings[i].size() >= 3)
+				holes.push_back(rings[i]);
+
+		// an outline with less than 3 points has no inside
+		std::vector<glm::vec2>& outline = rings[0];
+		if (outline.size() < 3)
+			outline.clear();
+
+		std::vector<uint32_t> indices;
+		if (!outline.empty())
+			indices = Triangulator::Triangulate(outline, holes);
+
+		// every point in one list so the indices can look them up, same order as Triangulator
+		std::vector<glm::vec2> points = outline;
+		for (const std::vector<glm::vec2>& hole : holes)
+			points.insert(points.end(), hole.begin(), hole.end());
+
+		// global to local coords, same as PolylineRenderer so the fill lines up with the outline
+		vertices.resize(indices.size());
+		for (size_t i = 0; i < indices.size(); i++)
+			vertices[i] = (points[indices[i]] - 1.0f) * 2.0f;
+
+		mesh->fillVertexCount = (GLsizei)vertices.size();
+		if (mesh->fillVertexCount > 0)
+		{
+			mesh->fillAllocation = PolylinePipeline::Allocate(mesh->fillVertexCount);
+			PolylinePipeline::Upload(mesh->fillAllocation, 0, mesh->fillVertexCount, vertices.data());
+		}
+	}
+
+	// -- outline, each subpath is its own line --
+	if (_isStroked)
+	{
+		vertices.clear();
+		for (size_t i = 0; i < lines.size(); i++)
+			PolylineRenderer::BuildStroke(lines[i].data(), lines[i].size(), _subpaths[i].closed, _thickness, _joinType, _capType, _miterLimit, vertices);
+
+		mesh->strokeVertexCount = (GLsizei)vertices.size();
+		if (mesh->strokeVertexCount > 0)
+		{
+			mesh->strokeAllocation = PolylinePipeline::Allocate(mesh->strokeVertexCount);
+			PolylinePipeline::Upload(mesh->strokeAllocation, 0, mesh->strokeVertexCount, vertices.data());
+		}
+	}
+
+	return *mesh;
+}
+
+void PathRenderer::Flatten(float tolerance, std::vector<std::vector<glm::vec2>>& lines)
+{
+	lines.resize(_subpaths.size());
+
+	for (size_t i = 0; i < _subpaths.size(); i++)
+	{
+		const Subpath& subpath = _subpaths[i];
+		std::vector<glm::vec2>& line = lines[i];
+		line.push_back(subpath.start);
+
+		// adds a point, skipping it if it's on top of the last one because it would have no direction
+		auto addPoint = [&line](glm::vec2 point)
+			{
+				if (line.back() != point)
+					line.push_back(point);
+			};
+
+		glm::vec2 current = subpath.start;
+		for (const Segment& segment : subpath.segments)
+		{
+			switch (segment.type)
+			{
+			case Line:
+				addPoint(segment.end);
+				break;
+			case Quadratic:
+			{
+				/*
+				* Wang's formula gives how many even steps along a bezier keep every straight piece within tolerance of the curve.
+				* It only needs the biggest second difference of the control points (how much the curve bends), for a quadratic that's
+				* steps = sqrt(|p0 - 2p1 + p2| / (4 * tolerance))
+				*/
+				float bend = glm::length(current - 2.0f * segment.control1 + segment.end);
+				int steps = glm::clamp((int)std::ceil(std::sqrt(bend / (4.0f * tolerance))), 1, maxCurveSegments);
+				for (int step = 1; step <= steps; step++)
+				{
+					float t = (float)step / steps;
+					float u = 1.0f - t;
+					addPoint(u * u * current + 2.0f * u * t * segment.control1 + t * t * segment.end);
+				}
+				break;
+			}
+			case Cubic:
+			{
+				// Wang's formula for a cubic, steps = sqrt(3 * biggest second difference / (4 * tolerance))
+				float bend = glm::max(glm::length(current - 2.0f * segment.control1 + segment.control2),
+					glm::length(segment.control1 - 2.0f * segment.control2 + segment.end));
+				int steps = glm::clamp((int)std::ceil(std::sqrt(3.0f * bend / (4.0f * tolerance))), 1, maxCurveSegments);
+				for (int step = 1; step <= steps; step++)
+				{
+					float t = (float)step / steps;
+					float u = 1.0f - t;
+					addPoint(u * u * u * current + 3.0f * u * u * t * segment.control1 + 3.0f * u * t * t * segment.control2 + t * t * t * segment.end);
+				}
+				break;
+			}
+			case ArcSegment:
+			{
+				// A straight piece across an angle of a circle is furthest from it in the middle, by radius * (1 - cos(angle / 2)).
+				// Making that the tolerance gives the biggest angle each piece can go across. Always at least 4 pieces for a whole circle
+				float cosHalfStep = glm::clamp(1.0f - tolerance / segment.radius, 0.0f, 1.0f);
+				float maxStep = glm::min(2.0f * std::acos(cosHalfStep), glm::half_pi<float>());
+				float sweep = segment.endAngle - segment.startAngle;
+				int steps = glm::clamp((int)std::ceil(std::abs(sweep) / glm::max(maxStep, 0.0001f)), 1, maxCurveSegments);
+				for (int step = 1; step < steps; step++)
+				{
+					float angle = segment.startAngle + sweep * step / steps;
+					addPoint(segment.centre + glm::vec2(std::cos(angle), std::sin(angle)) * segment.radius);
+				}
+				// exactly where the next segment starts from
+				addPoint(segment.end);
+				break;
+			}
+			}
+			current = segment.end;
+		}
+
+		// A closed line goes back to the start by itself, a last point on top of the start would have no direction.
+		// Arcs all the way round only get back to the start give or take float error so it doesn't have to be exact
+		if (subpath.closed && line.size() > 1 && glm::distance(line.back(), line.front()) < tolerance * 0.01f)
+			line.pop_back();
+	}
+}
+
+void PathRenderer::FreeMesh(CachedMesh& mesh)
+{
+	PolylinePipeline::Free(mesh.fillAllocation);
+	PolylinePipeline::Free(mesh.strokeAllocation);
+	mesh.fillVertexCount = 0;
+	mesh.strokeVertexCount = 0;
+}
+
+void PathRenderer::ClearCache()
+{
+	for (CachedMesh& mesh : _cache)
+		FreeMesh(mesh);
+	_cache.clear();
+	_pathRevision++;
+}
+
+void PathRenderer::UpdateTransparency()
+{
+	bool newTransparency = _alpha < 1.0f;
+
+	this->hasTransprency = newTransparency;
+	// if the current renderer has a parent entity update its transparency
+	if (parentEntity != nullptr)
+		parentEntity->SetHasTransparency(newTransparency);
+}
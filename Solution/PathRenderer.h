@@ -0,0 +1,203 @@
+#pragma once
+#include <vector>
+#include "Component.h"
+#include "ShaderProgram.h"
+#include "OrthoCamera.h"
+#include "PolylinePipeline.h"
+#include "PolylineRenderer.h"
+
+// Renders a vector path made of straight lines, quadratic and cubic bezier curves and circular arcs, filled in and/or outlined (e.g. charts and UI shapes).
+// Curves are flattened into straight segments only as finely as the camera zoom needs, so they never look like corners at that zoom but aren't
+// made of thousands of segments when zoomed out. The triangles are cached per zoom bucket (every doubling of zoom is split into bucketsPerDoubling buckets),
+// so panning and small zoom changes just draw the triangles already in PolylinePipeline's shared buffer and only going into a new bucket flattens it again.
+// The fill and outline are drawn in the same batch as polylines and polygons.
+// Points are in global coords like PolylineRenderer and thickness means the same thing too. The transform's size just acts as a scalar value, so for a
+// normal size set offsetSize to (1,1,0)
+class PathRenderer :
+    public Component
+{
+public:
+    // Setup a new empty path renderer with fill and outline colours, outline thickness (global coords) and shader program
+    // NOTE: If shader program is set to nullptr it will use the default polyline shader. A custom shader has to take the same attributes as PolylineDefault.vert
+    PathRenderer(glm::vec3 fillColor = glm::vec3(1.0f), glm::vec3 strokeColor = glm::vec3(0.0f), float thickness = 1.0f, ShaderProgram* program = nullptr);
+
+    // gives every cached range of the shared buffer back
+    ~PathRenderer();
+
+    // the allocations in the shared buffer can't be shared between two renderers
+    PathRenderer(const PathRenderer&) = delete;
+    PathRenderer& operator=(const PathRenderer&) = delete;
+
+    // How far (in screen pixels) a flattened curve can be from the real curve. Smaller is smoother but has more triangles.
+    // Only changes paths flattened after it's set
+    static float flatteningTolerance;
+
+    // how many zoom buckets every doubling of the zoom is split into. More means less triangles but flattening again more often when zooming
+    static const int bucketsPerDoubling = 2;
+
+    // how many zoom buckets each path keeps the triangles of. The one used the longest time ago is thrown away to make room
+    static const size_t maxCachedBuckets = 4;
+
+    // colour of the inside of the path
+    glm::vec3 fillColor;
+    // colour of the outline
+    glm::vec3 strokeColor;
+
+    // starts a new subpath at point. The first subpath is the outside of the fill and any after it are holes in it (like PolygonRenderer)
+    void MoveTo(glm::vec2 point);
+    // straight line from the current point
+    void LineTo(glm::vec2 point);
+    // quadratic bezier curve from the current point to end, pulled towards control
+    void QuadraticTo(glm::vec2 control, glm::vec2 end);
+    // cubic bezier curve from the current point to end, leaving towards control1 and arriving from control2
+    void CubicTo(glm::vec2 control1, glm::vec2 control2, glm::vec2 end);
+    // Circular arc around centre from startAngle to endAngle (degrees, anti-clockwise from the positive x axis, going clockwise if endAngle is smaller).
+    // If there is a current point a straight line joins it onto the start of the arc (like a html canvas)
+    void Arc(glm::vec2 centre, float radius, float startAngle, float endAngle);
+    // joins the current subpath back onto its start, so its outline has no caps
+    void Close();
+    // removes every subpath
+    void Clear();
+
+    // whether the inside is drawn
+    bool GetIsFilled();
+    // set whether the inside is drawn
+    void SetIsFilled(bool newIsFilled);
+
+    // whether the outline is drawn
+    bool GetIsStroked();
+    // set whether the outline is drawn
+    void SetIsStroked(bool newIsStroked);
+
+    // get how thick the outline is
+    float GetThickness();
+    // set how thick the outline is, clears the cache
+    void SetThickness(float newThickness);
+
+    // get the type of join between the outline's segments
+    PolylineRenderer::JoinType GetJoinType();
+    // set the type of join between the outline's segments, clears the cache
+    void SetJoinType(PolylineRenderer::JoinType newJoinType);
+
+    // get the type of cap on the ends of subpaths that aren't closed
+    PolylineRenderer::CapType GetCapType();
+    // set the type of cap on the ends of subpaths that aren't closed, clears the cache
+    void SetCapType(PolylineRenderer::CapType newCapType);
+
+    // get the alpha (transparency) value of this path
+    float GetAlpha();
+    // set the alpha (transparency) value of this path
+    void SetAlpha(float newAlpha);
+
+    // how many zoom buckets have triangles cached
+    size_t GetCachedBucketCount();
+    // how many times the path has been flattened, useful to check the cache is working
+    size_t GetFlattenCount();
+
+    // Draw the path using reference to scene camera and parent entity's transform. Flattens it first if the zoom bucket isn't cached.
+    // The fill and outline are added to the scene's draw batcher so they get drawn along with every polyline and polygon that uses the same program
+    void Draw(std::shared_ptr<OrthoCamera> camera);
+
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords of the path (before the entity's transform is applied)
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+private:
+    enum SegmentType {
+        Line,
+        Quadratic,
+        Cubic,
+        ArcSegment
+    };
+
+    // one piece of a subpath, going from the end of the one before it (or the subpath's start)
+    struct Segment {
+        SegmentType type = Line;
+        // bezier control points, unused by lines and arcs
+        glm::vec2 control1 = glm::vec2(0.0f);
+        glm::vec2 control2 = glm::vec2(0.0f);
+        // where the segment finishes
+        glm::vec2 end = glm::vec2(0.0f);
+        // arc values, angles are in radians
+        glm::vec2 centre = glm::vec2(0.0f);
+        float radius = 0.0f;
+        float startAngle = 0.0f;
+        float endAngle = 0.0f;
+    };
+
+    struct Subpath {
+        glm::vec2 start = glm::vec2(0.0f);
+        std::vector<Segment> segments;
+        bool closed = false;
+    };
+
+    // triangles of the path for one zoom bucket
+    struct CachedMesh {
+        int bucket = 0;
+        // what was drawn when it was flattened, it's made again if one gets turned on
+        bool hasFill = false;
+        bool hasStroke = false;
+        PolylinePipeline::Allocation fillAllocation;
+        GLsizei fillVertexCount = 0;
+        PolylinePipeline::Allocation strokeAllocation;
+        GLsizei strokeVertexCount = 0;
+        // draw count when it was last used, the smallest is thrown away first
+        size_t lastUsed = 0;
+    };
+
+    std::vector<Subpath> _subpaths;
+    std::vector<CachedMesh> _cache;
+
+    bool _isFilled = true;
+    bool _isStroked = true;
+    float _thickness;
+    PolylineRenderer::JoinType _joinType = PolylineRenderer::MiterJoin;
+    PolylineRenderer::CapType _capType = PolylineRenderer::ButtCap;
+
+    // how long a miter join's point can be compared to the thickness, same as PolylineRenderer's default
+    const float _miterLimit = 4.0f;
+
+    // smallest and biggest global coords of every point, control points and whole arc circles (curves can't go outside them)
+    glm::vec2 _pointsMin = glm::vec2(0.0f);
+    glm::vec2 _pointsMax = glm::vec2(0.0f);
+    // whether the bounds have any points in them yet
+    bool _hasBounds = false;
+
+    // goes up by one whenever the path or how it's drawn changes
+    size_t _pathRevision = 0;
+    // bucket of the last draw
+    int _lastBucket = 0;
+    size_t _drawCount = 0;
+    size_t _flattenCount = 0;
+
+    // the alpha channel (transparency) of the path
+    float _alpha = 1.0f;
+    // shader program that the renderer uses
+    ShaderProgram* shaderProgram;
+
+    // returns the subpath being added to, starting one at (0,0) if there isn't one
+    Subpath& GetCurrentSubpath();
+    // returns where the current subpath got up to
+    glm::vec2 GetCurrentPoint();
+    // adds a segment to the end of the current subpath, which makes the cache out of date
+    void AddSegment(const Segment& segment);
+    // grows the bounds to fit point
+    void GrowBounds(glm::vec2 point);
+
+    // which zoom bucket the path is drawn in, from how many screen pixels one global unit of the path takes up
+    int GetBucket(std::shared_ptr<OrthoCamera> camera);
+
+    // returns the cached triangles for bucket, flattening and uploading them if they aren't there
+    CachedMesh& GetMesh(int bucket);
+    // turns every subpath into points that are never further than tolerance (global coords) from the real curve
+    void Flatten(float tolerance, std::vector<std::vector<glm::vec2>>& lines);
+    // gives a cached mesh's ranges of the shared buffer back
+    void FreeMesh(CachedMesh& mesh);
+    // throws every cached mesh away, for when the path changes
+    void ClearCache();
+
+    // updates whether it has transparency from the alpha
+    void UpdateTransparency();
+};
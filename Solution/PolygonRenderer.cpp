@@ -0,0 +1,229 @@
+#include "PolygonRenderer.h"
+#include "Entity.h"
+#include "Scene.h"
+#include "ResourceManager.h"
+#include "Triangulator.h"
+#include "Hash.h"
+// glad is included already thru other include
+#include <glfw3.h>
+
+size_t PolygonRenderer::asyncThreshold = 20000;
+
+PolygonRenderer::PolygonRenderer(const std::vector<glm::vec2>& outline, glm::vec3 color, ShaderProgram* program)
+{
+	// if the program wasn't specified
+	if (program == nullptr)
+		// polygons share the polyline program and buffer, so they're batched together
+		this->shaderProgram = PolylinePipeline::GetDefaultProgram();
+	else // else use given one
+		this->shaderProgram = program;
+
+	// set type of component
+	this->type = Entity::PolygonRenderer;
+	// set colour
+	this->color = color;
+	_outline = outline;
+}
+
+PolygonRenderer::~PolygonRenderer()
+{
+	// a job that's still running just finishes with nobody waiting on it
+	PolylinePipeline::Free(_allocation);
+}
+
+const std::vector<glm::vec2>& PolygonRenderer::GetOutline()
+{
+	return _outline;
+}
+
+void PolygonRenderer::SetOutline(const std::vector<glm::vec2>& newOutline)
+{
+	_outline = newOutline;
+	_isDirty = true;
+}
+
+const std::vector<std::vector<glm::vec2>>& PolygonRenderer::GetHoles()
+{
+	return _holes;
+}
+
+void PolygonRenderer::AddHole(const std::vector<glm::vec2>& hole)
+{
+	_holes.push_back(hole);
+	_isDirty = true;
+}
+
+void PolygonRenderer::ClearHoles()
+{
+	if (_holes.empty())
+		return;
+	_holes.clear();
+	_isDirty = true;
+}
+
+float PolygonRenderer::GetAlpha()
+{
+	return _alpha;
+}
+
+void PolygonRenderer::SetAlpha(float newAlpha)
+{
+	// cap it to 1 if the new alpha is more than 1
+	_alpha = glm::min(newAlpha, 1.0f);
+	UpdateTransparency();
+}
+
+bool PolygonRenderer::IsTriangulating()
+{
+	return _job != nullptr;
+}
+
+double PolygonRenderer::GetLastTriangulationTime()
+{
+	return _lastTriangulationTime;
+}
+
+size_t PolygonRenderer::GetTriangleCount()
+{
+	return _vertices.size() / 3;
+}
+
+void PolygonRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw a polygon which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a polygon which isn't in a scene");
+
+	UpdateTriangulation();
+
+	// not triangulated yet or nothing to draw
+	if (_vertices.empty())
+		return;
+
+	GLsizei vertexCount = (GLsizei)_vertices.size();
+
+	// -- upload new triangles once, they stay there until the points change --
+	if (_needsUpload)
+	{
+		// a range that's way too big is given back so it doesn't waste the shared buffer
+		if (vertexCount > _allocation.capacity || vertexCount * 2 < _allocation.capacity)
+		{
+			PolylinePipeline::Free(_allocation);
+			_allocation = PolylinePipeline::Allocate(vertexCount);
+		}
+		PolylinePipeline::Upload(_allocation, 0, vertexCount, _vertices.data());
+		_needsUpload = false;
+	}
+
+	PolylinePipeline::InstanceData instance;
+	instance.modelTransform = parentEntity->transform.ToMatrix(camera);
+	// color of polygon with alpha channel included
+	instance.color = glm::vec4(color, _alpha);
+
+	parentEntity->parentScene->drawBatcher.AddInstance(PolylinePipeline::GetDrawState(shaderProgram), PolylinePipeline::GetMesh(_allocation, vertexCount), &instance);
+}
+
+size_t PolygonRenderer::GetStateHash()
+{
+	// picks up a finished triangulation even if the polygon isn't being drawn because its layer is cached
+	UpdateTriangulation();
+
+	size_t hash = 0;
+	Hash::Add(hash, color);
+	Hash::Add(hash, _alpha);
+	Hash::Add(hash, shaderProgram);
+	Hash::Add(hash, _meshRevision);
+	return hash;
+}
+
+void PolygonRenderer::GetLocalBounds(glm::vec2& min, glm::vec2& max)
+{
+	min = _boundsMin;
+	max = _boundsMax;
+}
+
+void PolygonRenderer::UpdateTriangulation()
+{
+	// -- pick up a finished job --
+	if (_job != nullptr && _job->isDone)
+	{
+		// nothing changed while it was running so its triangles are still right. Otherwise they're thrown away and it's done again below
+		if (!_isDirty)
+			SetTriangles(_job->outline, _job->holes, _job->indices);
+		_lastTriangulationTime = _job->time;
+		_job = nullptr;
+	}
+
+	// nothing to do, or it has to wait for the running job first
+	if (!_isDirty || _job != nullptr)
+		return;
+	_isDirty = false;
+
+	size_t pointCount = _outline.size();
+	for (const std::vector<glm::vec2>& hole : _holes)
+		pointCount += hole.size();
+
+	// -- small enough to just do now --
+	if (pointCount < asyncThreshold)
+	{
+		double startTime = glfwGetTime();
+		SetTriangles(_outline, _holes, Triangulator::Triangulate(_outline, _holes));
+		_lastTriangulationTime = glfwGetTime() - startTime;
+		return;
+	}
+
+	// -- too big, do it on a worker thread --
+	std::shared_ptr<TriangulationJob> job = std::make_shared<TriangulationJob>();
+	job->outline = _outline;
+	job->holes = _holes;
+	_job = job;
+	ResourceManager::GetWorkerPool()->Submit([job]()
+		{
+			double startTime = glfwGetTime();
+			job->indices = Triangulator::Triangulate(job->outline, job->holes);
+			job->time = glfwGetTime() - startTime;
+			// everything above has to be written before the render thread sees this
+			job->isDone = true;
+		});
+}
+
+void PolygonRenderer::SetTriangles(const std::vector<glm::vec2>& outline, const std::vector<std::vector<glm::vec2>>& holes, const std::vector<uint32_t>& indices)
+{
+	// every point in one list so the indices can look them up
+	std::vector<glm::vec2> points = outline;
+	for (const std::vector<glm::vec2>& hole : holes)
+		points.insert(points.end(), hole.begin(), hole.end());
+
+	// a point p (global coords) is at local coord (p - 1) * 2 like LineRenderer's and PolylineRenderer's points, so an outline drawn with the same points lines up
+	_vertices.resize(indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+		_vertices[i] = (points[indices[i]] - 1.0f) * 2.0f;
+
+	// the holes are inside the outline so it's the only thing that matters for the bounds
+	_boundsMin = glm::vec2(0.0f);
+	_boundsMax = glm::vec2(0.0f);
+	if (!_vertices.empty())
+	{
+		_boundsMin = _boundsMax = (outline[0] - 1.0f) * 2.0f;
+		for (const glm::vec2& point : outline)
+		{
+			_boundsMin = glm::min(_boundsMin, (point - 1.0f) * 2.0f);
+			_boundsMax = glm::max(_boundsMax, (point - 1.0f) * 2.0f);
+		}
+	}
+
+	_needsUpload = true;
+	_meshRevision++;
+}
+
+void PolygonRenderer::UpdateTransparency()
+{
+	bool newTransparency = _alpha < 1.0f;
+
+	this->hasTransprency = newTransparency;
+	// if the current renderer has a parent entity update its transparency
+	if (parentEntity != nullptr)
+		parentEntity->SetHasTransparency(newTransparency);
+}
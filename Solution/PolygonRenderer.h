@@ -0,0 +1,120 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include "Component.h"
+#include "ShaderProgram.h"
+#include "OrthoCamera.h"
+#include "PolylinePipeline.h"
+
+// Renders a filled polygon of any shape, with or without holes in it (e.g. regions on a map or a chart).
+// The polygon is cut into triangles by Triangulator once and the triangles are kept in PolylinePipeline's shared buffer, so it's only
+// triangulated and uploaded again when its points change and every polygon is drawn in the same batch as polylines.
+// Polygons with at least asyncThreshold points are triangulated on a worker thread, the last triangles (or nothing the first time) are drawn until it's done.
+// Points are in global coords like LineRenderer and the transform's size just acts as a scalar value, so for a normal size set offsetSize to (1,1,0)
+class PolygonRenderer :
+    public Component
+{
+public:
+    // Setup a new polygon renderer with its outline (at least 3 points, going either way round), colour and shader program
+    // NOTE: If shader program is set to nullptr it will use the default polyline shader. A custom shader has to take the same attributes as PolylineDefault.vert
+    PolygonRenderer(const std::vector<glm::vec2>& outline = std::vector<glm::vec2>(), glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
+
+    // gives the polygon's range of the shared buffer back
+    ~PolygonRenderer();
+
+    // the allocation in the shared buffer can't be shared between two renderers
+    PolygonRenderer(const PolygonRenderer&) = delete;
+    PolygonRenderer& operator=(const PolygonRenderer&) = delete;
+
+    // polygons with at least this many points (outline and holes together) are triangulated on a worker thread
+    static size_t asyncThreshold;
+
+    // colour of the polygon
+    glm::vec3 color;
+
+    // returns the outline
+    const std::vector<glm::vec2>& GetOutline();
+    // replaces the outline, it gets triangulated again
+    void SetOutline(const std::vector<glm::vec2>& newOutline);
+
+    // returns every hole
+    const std::vector<std::vector<glm::vec2>>& GetHoles();
+    // adds a hole, which has to be inside the outline and not overlap other holes. It gets triangulated again
+    void AddHole(const std::vector<glm::vec2>& hole);
+    // removes every hole, it gets triangulated again
+    void ClearHoles();
+
+    // get the alpha (transparency) value of this polygon
+    float GetAlpha();
+    // set the alpha (transparency) value of this polygon
+    void SetAlpha(float newAlpha);
+
+    // whether a triangulation is running on a worker thread
+    bool IsTriangulating();
+    // how many seconds the last triangulation took, wherever it ran
+    double GetLastTriangulationTime();
+    // how many triangles are being drawn
+    size_t GetTriangleCount();
+
+    // Draw the polygon using reference to scene camera and parent entity's transform. Triangulates and uploads first if the points changed.
+    // The polygon is added to the scene's draw batcher so it gets drawn along with every polyline and polygon that uses the same program
+    void Draw(std::shared_ptr<OrthoCamera> camera);
+
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing.
+    // The points aren't hashed one by one, a counter that goes up whenever new triangles are ready is used instead
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords of the polygon (before the entity's transform is applied)
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+private:
+    // a triangulation that was handed to a worker thread. Shared with the job so it's fine if the renderer is deleted first
+    struct TriangulationJob {
+        // copies of the points, the renderer's own can change while the job runs
+        std::vector<glm::vec2> outline;
+        std::vector<std::vector<glm::vec2>> holes;
+        // what the job made, only read once isDone is true
+        std::vector<uint32_t> indices;
+        double time = 0.0;
+        std::atomic<bool> isDone{ false };
+    };
+
+    std::vector<glm::vec2> _outline;
+    std::vector<std::vector<glm::vec2>> _holes;
+
+    // whether the points changed since they were last triangulated
+    bool _isDirty = true;
+    // triangulation running on a worker thread, nullptr if there isn't one
+    std::shared_ptr<TriangulationJob> _job;
+
+    // every triangle's corners in local coords, ready to upload
+    std::vector<glm::vec2> _vertices;
+    // whether _vertices has changed since it was uploaded
+    bool _needsUpload = false;
+    // the polygon's range of the shared buffer
+    PolylinePipeline::Allocation _allocation;
+
+    // smallest and biggest local coords of the outline
+    glm::vec2 _boundsMin = glm::vec2(0.0f);
+    glm::vec2 _boundsMax = glm::vec2(0.0f);
+
+    double _lastTriangulationTime = 0.0;
+    // goes up by one whenever new triangles are ready
+    size_t _meshRevision = 0;
+
+    // the alpha channel (transparency) of the polygon
+    float _alpha = 1.0f;
+    // shader program that the renderer uses
+    ShaderProgram* shaderProgram;
+
+    // Triangulates if the points changed, straight away or on a worker thread if there are lots of them, and picks up a finished worker result.
+    // Called by Draw and GetStateHash, so a polygon in a cached render layer still gets its triangles once they're done
+    void UpdateTriangulation();
+    // turns triangle indices into vertices (outline then holes, same as Triangulator) and marks them to be uploaded
+    void SetTriangles(const std::vector<glm::vec2>& outline, const std::vector<std::vector<glm::vec2>>& holes, const std::vector<uint32_t>& indices);
+
+    // updates whether it has transparency from the alpha
+    void UpdateTransparency();
+};
+
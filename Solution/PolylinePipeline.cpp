@@ -0,0 +1,214 @@
+#include "PolylinePipeline.h"
+#include "ResourceManager.h"
+#include <cstddef>
+#include <algorithm>
+
+const char* PolylinePipeline::defaultVertPath = "VertexShaders/PolylineDefault.vert";
+const char* PolylinePipeline::defaultFragPath = "FragmentShaders/PolylineDefault.frag";
+const char* PolylinePipeline::defaultProgramName = "defaultPolylineProgram";
+
+ShaderProgram* PolylinePipeline::_defaultProgram = nullptr;
+InstanceLayout* PolylinePipeline::_layout = nullptr;
+unsigned int PolylinePipeline::VAO = 0;
+unsigned int PolylinePipeline::VBO = 0;
+unsigned int PolylinePipeline::EBO = 0;
+GLsizei PolylinePipeline::_vertexCapacity = 0;
+GLsizei PolylinePipeline::_indexCount = 0;
+GLsizei PolylinePipeline::_allocatedVertices = 0;
+std::vector<PolylinePipeline::Allocation> PolylinePipeline::_freeRanges;
+
+void PolylinePipeline::Initialise()
+{
+	// already done
+	if (_layout != nullptr)
+		return;
+
+	_defaultProgram = ResourceManager::LoadShaderProgram(defaultProgramName, defaultVertPath, defaultFragPath);
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &EBO);
+
+	// the element buffer is remembered by the VAO so it only has to be bound here once
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBindVertexArray(0);
+
+	// creates the vertex buffer and points attribute 0 at it
+	GrowVertexBuffer(startingCapacity);
+	GrowIndexBuffer(startingCapacity);
+
+	// -- per instance attributes, these are read from the scene's stream buffer when drawn --
+	_layout = new InstanceLayout(VAO, sizeof(InstanceData));
+	// model transform at locations 1 to 4
+	_layout->AddMatrix4Attribute(1, offsetof(InstanceData, modelTransform));
+	// colour at location 5
+	_layout->AddAttribute(5, 4, offsetof(InstanceData, color));
+}
+
+ShaderProgram* PolylinePipeline::GetDefaultProgram()
+{
+	Initialise();
+	return _defaultProgram;
+}
+
+DrawBatcher::DrawState PolylinePipeline::GetDrawState(ShaderProgram* program)
+{
+	Initialise();
+
+	DrawBatcher::DrawState state;
+	state.program = program;
+	state.layout = _layout;
+	return state;
+}
+
+PolylinePipeline::Allocation PolylinePipeline::Allocate(GLsizei vertexCount)
+{
+	Initialise();
+
+	// first gap that is big enough
+	for (size_t i = 0; i < _freeRanges.size(); i++)
+	{
+		Allocation& range = _freeRanges[i];
+		if (range.capacity < vertexCount)
+			continue;
+
+		// take the start of the gap and leave the rest free
+		Allocation allocation = { range.firstVertex, vertexCount };
+		range.firstVertex += vertexCount;
+		range.capacity -= vertexCount;
+		if (range.capacity == 0)
+			_freeRanges.erase(_freeRanges.begin() + i);
+
+		_allocatedVertices += vertexCount;
+		return allocation;
+	}
+
+	// no gap is big enough so grow the buffer (at least doubling so this doesn't happen often) and try again.
+	// The new space is added onto the end so it joins up with a gap at the end if there is one
+	GrowVertexBuffer(std::max(_vertexCapacity * 2, _vertexCapacity + vertexCount));
+	return Allocate(vertexCount);
+}
+
+void PolylinePipeline::Free(Allocation& allocation)
+{
+	// nothing allocated
+	if (allocation.capacity == 0)
+		return;
+
+	AddFreeRange(allocation);
+	_allocatedVertices -= allocation.capacity;
+	allocation = Allocation();
+}
+
+void PolylinePipeline::Upload(const Allocation& allocation, GLsizei offset, GLsizei count, const glm::vec2* vertices)
+{
+	if (count <= 0)
+		return;
+
+	if (offset + count > allocation.capacity)
+		throw std::exception("ERROR: Tried to upload more polyline vertices than were allocated");
+
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(allocation.firstVertex + offset) * sizeof(glm::vec2), (GLsizeiptr)count * sizeof(glm::vec2), vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+DrawBatcher::MeshRange PolylinePipeline::GetMesh(const Allocation& allocation, GLsizei vertexCount)
+{
+	// every index up to the vertex count has to exist
+	GrowIndexBuffer(vertexCount);
+
+	// indices are 0, 1, 2... so the base vertex moves them onto the polyline's range
+	DrawBatcher::MeshRange mesh;
+	mesh.indexCount = vertexCount;
+	mesh.firstIndex = 0;
+	mesh.baseVertex = allocation.firstVertex;
+	return mesh;
+}
+
+void PolylinePipeline::GetUsage(GLsizei& allocatedVertices, GLsizei& bufferCapacity)
+{
+	allocatedVertices = _allocatedVertices;
+	bufferCapacity = _vertexCapacity;
+}
+
+void PolylinePipeline::GrowVertexBuffer(GLsizei newCapacity)
+{
+	unsigned int newVBO;
+	glGenBuffers(1, &newVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, newVBO);
+	// dynamic because parts of it change whenever a polyline does
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)newCapacity * sizeof(glm::vec2), nullptr, GL_DYNAMIC_DRAW);
+
+	// copy the old vertices over on the gpu, every allocation stays where it was
+	if (VBO != 0)
+	{
+		glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, 0, 0, (GLsizeiptr)_vertexCapacity * sizeof(glm::vec2));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glDeleteBuffers(1, &VBO);
+	}
+
+	// point the position attribute at the new buffer. Location 0, 2 floats, don't normalise, stride of 1 vertex, no offset
+	glBindVertexArray(VAO);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+	glEnableVertexAttribArray(0);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// the space that was just added is free
+	AddFreeRange(Allocation{ _vertexCapacity, newCapacity - _vertexCapacity });
+
+	VBO = newVBO;
+	_vertexCapacity = newCapacity;
+}
+
+void PolylinePipeline::GrowIndexBuffer(GLsizei count)
+{
+	// already big enough
+	if (count <= _indexCount)
+		return;
+
+	// at least double it so it isn't recreated for every point added to a growing line
+	GLsizei newCount = std::max(count, _indexCount * 2);
+	std::vector<GLuint> indices(newCount);
+	for (GLsizei i = 0; i < newCount; i++)
+		indices[i] = (GLuint)i;
+
+	// the element buffer binding is part of the VAO's state so bind the VAO first
+	glBindVertexArray(VAO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	glBindVertexArray(0);
+
+	_indexCount = newCount;
+}
+
+void PolylinePipeline::AddFreeRange(Allocation range)
+{
+	if (range.capacity <= 0)
+		return;
+
+	// find where it goes to keep the list sorted
+	auto next = std::lower_bound(_freeRanges.begin(), _freeRanges.end(), range,
+		[](const Allocation& a, const Allocation& b) { return a.firstVertex < b.firstVertex; });
+	auto inserted = _freeRanges.insert(next, range);
+
+	// merge with the gap after it
+	auto after = inserted + 1;
+	if (after != _freeRanges.end() && inserted->firstVertex + inserted->capacity == after->firstVertex)
+	{
+		inserted->capacity += after->capacity;
+		inserted = _freeRanges.erase(after) - 1;
+	}
+
+	// merge with the gap before it
+	if (inserted != _freeRanges.begin())
+	{
+		auto before = inserted - 1;
+		if (before->firstVertex + before->capacity == inserted->firstVertex)
+		{
+			before->capacity += inserted->capacity;
+			_freeRanges.erase(inserted);
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ShaderProgram.h"
+#include "InstanceLayout.h"
+#include "DrawBatcher.h"
+
+// Every polyline's triangles live in one big shared vertex buffer. Each polyline gets its own range of it (an allocation) and only
+// the part of the range that changed is re-uploaded, so appending points to a long line doesn't send the whole thing again.
+// Because they all share the same VAO, program and layout the draw batcher puts every polyline in one submission: each one is a
+// command that starts at its range (base vertex) so they all go out in one multi draw indirect.
+// The element buffer is just 0, 1, 2, 3... so the indices of a range are the same as drawing its vertices in order.
+// PolygonRenderer and PathRenderer keep their triangles in here too since it's the same kind of mesh (a list of triangle corners in local coords).
+// Static class like the resource manager because everything in it is shared
+class PolylinePipeline
+{
+public:
+	// what gets sent to the gpu for each polyline
+	struct InstanceData {
+		glm::mat4 modelTransform;
+		// colour with alpha
+		glm::vec4 color;
+	};
+
+	// range of vertices in the shared buffer that belongs to one polyline
+	struct Allocation {
+		// first vertex of the range
+		GLint firstVertex = 0;
+		// how many vertices fit in the range, 0 means nothing is allocated
+		GLsizei capacity = 0;
+	};
+
+	// Loads the shared program and creates the buffers if they haven't been already. Needs a current GL context
+	static void Initialise();
+
+	// the program every polyline uses unless it is given its own
+	static ShaderProgram* GetDefaultProgram();
+
+	// draw state for a polyline drawn with program. A custom program has to take the same attributes as PolylineDefault.vert
+	static DrawBatcher::DrawState GetDrawState(ShaderProgram* program);
+
+	// Finds (or makes room for) a range of at least vertexCount vertices. The buffer grows if there isn't a gap big enough
+	static Allocation Allocate(GLsizei vertexCount);
+
+	// Gives a range back so it can be used by other polylines. Sets allocation back to empty
+	static void Free(Allocation& allocation);
+
+	// Writes count vertices into allocation starting at offset vertices into it
+	static void Upload(const Allocation& allocation, GLsizei offset, GLsizei count, const glm::vec2* vertices);
+
+	// part of the shared mesh to draw for the first vertexCount vertices of allocation
+	static DrawBatcher::MeshRange GetMesh(const Allocation& allocation, GLsizei vertexCount);
+
+	// how many vertices are allocated to polylines and how many the shared buffer can hold
+	static void GetUsage(GLsizei& allocatedVertices, GLsizei& bufferCapacity);
+
+private:
+	// default vertex sahader
+	static const char* defaultVertPath;
+	// default frag sahader
+	static const char* defaultFragPath;
+	// name that the default program is stored under in the resource manager
+	static const char* defaultProgramName;
+
+	// how many vertices the shared buffer starts out holding
+	static const GLsizei startingCapacity = 16384;
+
+	static ShaderProgram* _defaultProgram;
+	static InstanceLayout* _layout;
+	static unsigned int VAO;
+	static unsigned int VBO;
+	static unsigned int EBO;
+
+	// how many vertices fit in the vertex buffer
+	static GLsizei _vertexCapacity;
+	// how many indices are in the element buffer
+	static GLsizei _indexCount;
+	// how many vertices are handed out
+	static GLsizei _allocatedVertices;
+	// unused gaps in the vertex buffer, sorted by first vertex and never touching each other (touching gaps get merged)
+	static std::vector<Allocation> _freeRanges;
+
+	// makes the vertex buffer hold at least newCapacity vertices, copying the old vertices over
+	static void GrowVertexBuffer(GLsizei newCapacity);
+
+	// makes sure the element buffer has at least count indices
+	static void GrowIndexBuffer(GLsizei count);
+
+	// adds a gap to the free list, merging it with any gap it touches
+	static void AddFreeRange(Allocation range);
+
+	// private constructor, only static functions
+	PolylinePipeline();
+};
+
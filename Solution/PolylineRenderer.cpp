@@ -0,0 +1,445 @@
+#include "PolylineRenderer.h"
+#include "Entity.h"
+#include "Scene.h"
+#include "Hash.h"
+// glad is included already thru other include
+#include <glfw3.h>
+#include <cmath>
+#include <algorithm>
+#include <glm/gtc/constants.hpp>
+
+// how many triangles make up half a circle, for round joins and caps
+static const float roundSegmentsPerHalfCircle = 16.0f;
+
+PolylineRenderer::PolylineRenderer(const glm::vec2* points, size_t count, float thickness, glm::vec3 color, ShaderProgram* program)
+{
+	// if the program wasn't specified
+	if (program == nullptr)
+		// every polyline shares the same program, otherwise they couldn't be batched together
+		this->shaderProgram = PolylinePipeline::GetDefaultProgram();
+	else // else use given one
+		this->shaderProgram = program;
+
+	// set type of component
+	this->type = Entity::PolylineRenderer;
+	// set colour
+	this->color = color;
+	_thickness = thickness;
+
+	AppendPoints(points, count);
+}
+
+PolylineRenderer::PolylineRenderer(const std::vector<glm::vec2>& points, float thickness, glm::vec3 color, ShaderProgram* program)
+	: PolylineRenderer(points.data(), points.size(), thickness, color, program)
+{
+}
+
+PolylineRenderer::~PolylineRenderer()
+{
+	PolylinePipeline::Free(_allocation);
+}
+
+void PolylineRenderer::SetPoints(const glm::vec2* points, size_t count)
+{
+	// empty it out, then adding the points builds the whole thing
+	_points.clear();
+	RebuildMesh();
+	AppendPoints(points, count);
+}
+
+void PolylineRenderer::SetPoints(const std::vector<glm::vec2>& points)
+{
+	SetPoints(points.data(), points.size());
+}
+
+void PolylineRenderer::AppendPoints(const glm::vec2* points, size_t count)
+{
+	size_t oldPointCount = _points.size();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		// a point on top of the last one has no direction so it can't be joined onto
+		if (!_points.empty() && _points.back() == points[i])
+			continue;
+		_points.push_back(points[i]);
+	}
+
+	// only build the new bit
+	if (_points.size() != oldPointCount)
+		ExtendMesh(oldPointCount);
+}
+
+void PolylineRenderer::AppendPoint(glm::vec2 point)
+{
+	AppendPoints(&point, 1);
+}
+
+void PolylineRenderer::ClearPoints()
+{
+	_points.clear();
+	RebuildMesh();
+}
+
+const std::vector<glm::vec2>& PolylineRenderer::GetPoints()
+{
+	return _points;
+}
+
+float PolylineRenderer::GetThickness()
+{
+	return _thickness;
+}
+
+void PolylineRenderer::SetThickness(float newThickness)
+{
+	_thickness = newThickness;
+	RebuildMesh();
+}
+
+PolylineRenderer::JoinType PolylineRenderer::GetJoinType()
+{
+	return _joinType;
+}
+
+void PolylineRenderer::SetJoinType(JoinType newJoinType)
+{
+	_joinType = newJoinType;
+	RebuildMesh();
+}
+
+PolylineRenderer::CapType PolylineRenderer::GetCapType()
+{
+	return _capType;
+}
+
+void PolylineRenderer::SetCapType(CapType newCapType)
+{
+	_capType = newCapType;
+	RebuildMesh();
+}
+
+float PolylineRenderer::GetMiterLimit()
+{
+	return _miterLimit;
+}
+
+void PolylineRenderer::SetMiterLimit(float newMiterLimit)
+{
+	// anything under 1 would bevel every corner
+	_miterLimit = glm::max(newMiterLimit, 1.0f);
+	RebuildMesh();
+}
+
+float PolylineRenderer::GetAlpha()
+{
+	return _alpha;
+}
+
+void PolylineRenderer::SetAlpha(float newAlpha)
+{
+	// cap it to 1 if the new alpha is more than 1 (idk why it would be)
+	_alpha = glm::min(newAlpha, 1.0f);
+	UpdateTransparency();
+}
+
+void PolylineRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw a polyline which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a polyline which isn't in a scene");
+
+	// less than 2 points, nothing to draw
+	if (_vertices.empty())
+		return;
+
+	GLsizei vertexCount = (GLsizei)_vertices.size();
+
+	// doesn't fit in its range anymore, move to a bigger one. It gets double what it needs so a growing line doesn't have to move every time a point is added
+	if (vertexCount > _allocation.capacity)
+	{
+		PolylinePipeline::Free(_allocation);
+		_allocation = PolylinePipeline::Allocate(vertexCount * 2);
+		// new range, everything has to go in it
+		_firstDirtyVertex = 0;
+	}
+
+	// upload only what changed
+	if (_firstDirtyVertex < _vertices.size())
+	{
+		PolylinePipeline::Upload(_allocation, (GLsizei)_firstDirtyVertex, vertexCount - (GLsizei)_firstDirtyVertex, _vertices.data() + _firstDirtyVertex);
+		_firstDirtyVertex = _vertices.size();
+	}
+
+	PolylinePipeline::InstanceData instance;
+	instance.modelTransform = parentEntity->transform.ToMatrix(camera);
+	// color of line with alpha channel included
+	instance.color = glm::vec4(color, _alpha);
+
+	parentEntity->parentScene->drawBatcher.AddInstance(PolylinePipeline::GetDrawState(shaderProgram), PolylinePipeline::GetMesh(_allocation, vertexCount), &instance);
+}
+
+size_t PolylineRenderer::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, color);
+	Hash::Add(hash, _alpha);
+	Hash::Add(hash, shaderProgram);
+	Hash::Add(hash, _meshRevision);
+	return hash;
+}
+
+void PolylineRenderer::GetLocalBounds(glm::vec2& min, glm::vec2& max)
+{
+	// nothing is drawn
+	if (_vertices.empty())
+	{
+		min = glm::vec2(0.0f);
+		max = glm::vec2(0.0f);
+		return;
+	}
+
+	min = _bodyMin;
+	max = _bodyMax;
+	// the end cap is only a few vertices so just check them here
+	for (size_t i = _bodyVertexCount; i < _vertices.size(); i++)
+	{
+		min = glm::min(min, _vertices[i]);
+		max = glm::max(max, _vertices[i]);
+	}
+}
+
+void PolylineRenderer::RebuildMesh()
+{
+	_vertices.clear();
+	_bodyVertexCount = 0;
+	ExtendMesh(0);
+}
+
+void PolylineRenderer::ExtendMesh(size_t firstNewPoint)
+{
+	// take the end cap off, everything from here on gets built again
+	_vertices.resize(_bodyVertexCount);
+	_firstDirtyVertex = std::min(_firstDirtyVertex, _bodyVertexCount);
+	size_t firstNewVertex = _bodyVertexCount;
+	StrokeStyle style = GetStyle();
+
+	// each new point adds the segment leading up to it. The first point doesn't have one
+	for (size_t i = std::max(firstNewPoint, (size_t)1); i < _points.size(); i++)
+	{
+		glm::vec2 direction = glm::normalize(_points[i] - _points[i - 1]);
+
+		if (i == 1)
+			// first segment, put the start cap on facing backwards
+			AddCap(style, _vertices, _points[0], -direction);
+		else
+			// fill the corner between the last segment and this one
+			AddJoin(style, _vertices, _points[i - 1], glm::normalize(_points[i - 1] - _points[i - 2]), direction);
+
+		AddSegment(style, _vertices, _points[i - 1], _points[i]);
+	}
+
+	_bodyVertexCount = _vertices.size();
+
+	// grow the bounds to fit the new part of the body
+	for (size_t i = firstNewVertex; i < _bodyVertexCount; i++)
+	{
+		_bodyMin = (i == 0) ? _vertices[i] : glm::min(_bodyMin, _vertices[i]);
+		_bodyMax = (i == 0) ? _vertices[i] : glm::max(_bodyMax, _vertices[i]);
+	}
+
+	// put the end cap back on
+	if (_points.size() >= 2)
+	{
+		size_t last = _points.size() - 1;
+		AddCap(style, _vertices, _points[last], glm::normalize(_points[last] - _points[last - 1]));
+	}
+
+	_meshRevision++;
+}
+
+void PolylineRenderer::BuildStroke(const glm::vec2* points, size_t count, bool closed, float thickness, JoinType joinType, CapType capType, float miterLimit, std::vector<glm::vec2>& vertices)
+{
+	// less than 2 points, nothing to draw
+	if (count < 2)
+		return;
+
+	// 2 points can't go round in a loop, it would just be the same segment back again
+	if (count == 2)
+		closed = false;
+
+	StrokeStyle style{ thickness, joinType, capType, glm::max(miterLimit, 1.0f) };
+
+	// same as ExtendMesh except a closed line has a join where a cap would go
+	for (size_t i = 1; i < count; i++)
+	{
+		glm::vec2 direction = glm::normalize(points[i] - points[i - 1]);
+
+		if (i == 1 && closed)
+			// the segment coming back round from the last point joins onto the first one
+			AddJoin(style, vertices, points[0], glm::normalize(points[0] - points[count - 1]), direction);
+		else if (i == 1)
+			AddCap(style, vertices, points[0], -direction);
+		else
+			AddJoin(style, vertices, points[i - 1], glm::normalize(points[i - 1] - points[i - 2]), direction);
+
+		AddSegment(style, vertices, points[i - 1], points[i]);
+	}
+
+	size_t last = count - 1;
+	glm::vec2 lastDirection = glm::normalize(points[last] - points[last - 1]);
+	if (closed)
+	{
+		// the segment that closes the loop
+		AddJoin(style, vertices, points[last], lastDirection, glm::normalize(points[0] - points[last]));
+		AddSegment(style, vertices, points[last], points[0]);
+	}
+	else
+		AddCap(style, vertices, points[last], lastDirection);
+}
+
+PolylineRenderer::StrokeStyle PolylineRenderer::GetStyle()
+{
+	return StrokeStyle{ _thickness, _joinType, _capType, _miterLimit };
+}
+
+void PolylineRenderer::AddSegment(const StrokeStyle& style, std::vector<glm::vec2>& vertices, glm::vec2 start, glm::vec2 end)
+{
+	glm::vec2 direction = glm::normalize(end - start);
+	// the left side vector (90 degrees anti-clockwise) scaled to the thickness. See LineRenderer for the full explanation
+	glm::vec2 left = glm::vec2(-direction.y, direction.x) * style.thickness;
+
+	// same rect as a LineRenderer, as 2 triangles
+	AddTriangle(vertices, start + left, start - left, end + left);
+	AddTriangle(vertices, end + left, start - left, end - left);
+}
+
+void PolylineRenderer::AddJoin(const StrokeStyle& style, std::vector<glm::vec2>& vertices, glm::vec2 point, glm::vec2 incoming, glm::vec2 outgoing)
+{
+	/*
+	* The two segments are plain rects that end right on the point. On the inside of the corner they overlap and on the outside there's a gap
+	* shaped like a wedge. The join just fills in that wedge.
+	*
+	* The sign of the cross product says which way the line turns. Turning left (anti-clockwise) means the gap is on the right side and turning right means
+	* it's on the left. outerSide flips the left side vectors so they point into the gap.
+	*
+	* The overlap on the inside doesn't get drawn twice when the line is see through because everything in a polyline is at the same depth, so the
+	* depth test throws away the second fragment
+	*/
+	float cross = incoming.x * outgoing.y - incoming.y * outgoing.x;
+	float dot = glm::dot(incoming, outgoing);
+
+	// going straight on, no gap
+	if (std::abs(cross) < 0.0001f && dot > 0.0f)
+		return;
+
+	float outerSide = (cross > 0.0f) ? -1.0f : 1.0f;
+	// the side vectors of each segment pointing at the outside of the corner
+	glm::vec2 incomingOuter = glm::vec2(-incoming.y, incoming.x) * outerSide;
+	glm::vec2 outgoingOuter = glm::vec2(-outgoing.y, outgoing.x) * outerSide;
+
+	// outside corners of each segment at the point
+	glm::vec2 incomingCorner = point + incomingOuter * style.thickness;
+	glm::vec2 outgoingCorner = point + outgoingOuter * style.thickness;
+
+	switch (style.joinType)
+	{
+	case MiterJoin:
+	{
+		// The miter point is where the outside edges of the segments would meet if they kept going. It's in the direction halfway between
+		// the two side vectors and the sharper the corner the further away it gets (thickness / cos of half the angle between them)
+		glm::vec2 halfway = incomingOuter + outgoingOuter;
+		float halfwayLength = glm::length(halfway);
+		// a line that turns straight back on itself has no halfway direction
+		if (halfwayLength > 0.0001f)
+		{
+			halfway /= halfwayLength;
+			float cosHalfAngle = glm::dot(halfway, incomingOuter);
+			// miter length compared to the thickness, same as the svg miter limit
+			float miterRatio = 1.0f / glm::max(cosHalfAngle, 0.0001f);
+			if (miterRatio <= style.miterLimit)
+			{
+				glm::vec2 miterPoint = point + halfway * style.thickness * miterRatio;
+				AddTriangle(vertices, point, incomingCorner, miterPoint);
+				AddTriangle(vertices, point, miterPoint, outgoingCorner);
+				break;
+			}
+		}
+		// too long, bevel it instead
+		AddTriangle(vertices, point, incomingCorner, outgoingCorner);
+		break;
+	}
+	case BevelJoin:
+		AddTriangle(vertices, point, incomingCorner, outgoingCorner);
+		break;
+	case RoundJoin:
+	{
+		// angle to turn from one outside corner to the other, the sign says which way
+		float angle = std::atan2(incomingOuter.x * outgoingOuter.y - incomingOuter.y * outgoingOuter.x, glm::dot(incomingOuter, outgoingOuter));
+		AddRoundFan(vertices, point, incomingCorner, angle);
+		break;
+	}
+	}
+}
+
+void PolylineRenderer::AddCap(const StrokeStyle& style, std::vector<glm::vec2>& vertices, glm::vec2 point, glm::vec2 outwards)
+{
+	// left side vector of the outwards direction scaled to the thickness
+	glm::vec2 left = glm::vec2(-outwards.y, outwards.x) * style.thickness;
+
+	switch (style.capType)
+	{
+	case ButtCap:
+		// nothing past the point
+		break;
+	case SquareCap:
+	{
+		// rect sticking out by the thickness
+		glm::vec2 out = outwards * style.thickness;
+		AddTriangle(vertices, point + left, point - left, point + left + out);
+		AddTriangle(vertices, point + left + out, point - left, point - left + out);
+		break;
+	}
+	case RoundCap:
+		// half circle from the left side round the front to the right side (clockwise)
+		AddRoundFan(vertices, point, point + left, -glm::pi<float>());
+		break;
+	}
+}
+
+void PolylineRenderer::AddRoundFan(std::vector<glm::vec2>& vertices, glm::vec2 centre, glm::vec2 start, float angle)
+{
+	// enough triangles that each one covers at most 1/16th of a half circle
+	int segments = glm::max(1, (int)std::ceil(std::abs(angle) / glm::pi<float>() * roundSegmentsPerHalfCircle));
+	float step = angle / segments;
+	float stepCos = std::cos(step);
+	float stepSin = std::sin(step);
+
+	glm::vec2 offset = start - centre;
+	for (int i = 0; i < segments; i++)
+	{
+		// rotate the offset by one step
+		glm::vec2 nextOffset = glm::vec2(offset.x * stepCos - offset.y * stepSin, offset.x * stepSin + offset.y * stepCos);
+		AddTriangle(vertices, centre, centre + offset, centre + nextOffset);
+		offset = nextOffset;
+	}
+}
+
+void PolylineRenderer::AddTriangle(std::vector<glm::vec2>& vertices, glm::vec2 a, glm::vec2 b, glm::vec2 c)
+{
+	// global to local coords, same as LineRenderer
+	vertices.push_back((a - 1.0f) * 2.0f);
+	vertices.push_back((b - 1.0f) * 2.0f);
+	vertices.push_back((c - 1.0f) * 2.0f);
+}
+
+void PolylineRenderer::UpdateTransparency()
+{
+	bool newTransparency = _alpha < 1.0f;
+
+	this->hasTransprency = newTransparency;
+	// if the current renderer has a parent entity update its transparency
+	if (parentEntity != nullptr)
+		parentEntity->SetHasTransparency(newTransparency);
+}
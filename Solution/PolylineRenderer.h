@@ -0,0 +1,179 @@
+#pragma once
+#include <vector>
+#include "Component.h"
+#include "ShaderProgram.h"
+#include "OrthoCamera.h"
+#include "PolylinePipeline.h"
+
+// Renders a line through any amount of points as one mesh, with joins filling the corners between segments and caps on the ends.
+// Points are in global coords like LineRenderer and thickness means the same thing too, so a polyline through 2 points lines up with a LineRenderer.
+// Like LineRenderer the transform's size just acts as a scalar value, so for a normal size set offsetSize to (1,1,0).
+// The mesh lives in PolylinePipeline's shared buffer so every polyline using the same program is drawn together.
+// Adding points to the end only builds and uploads the new part, everything before the last join stays as it is
+class PolylineRenderer :
+    public Component
+{
+public:
+    // how the corner between two segments is filled in
+    enum JoinType {
+        // sharp corner, turns into a bevel if the point would be longer than miterLimit
+        MiterJoin,
+        // corner is cut off flat
+        BevelJoin,
+        // corner is rounded
+        RoundJoin
+    };
+
+    // what the ends of the line look like
+    enum CapType {
+        // line stops right on the end point
+        ButtCap,
+        // line sticks out past the end point by the thickness
+        SquareCap,
+        // line ends with a half circle around the end point
+        RoundCap
+    };
+
+    // Setup a new polyline renderer through count points (can be 0 and added later), with a thickness (global coords), colour and shader program
+    // NOTE: If shader program is set to nullptr it will use the default polyline shader. A custom shader has to take the same attributes as PolylineDefault.vert
+    PolylineRenderer(const glm::vec2* points = nullptr, size_t count = 0, float thickness = 1.0f, glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
+
+    // same as above but takes the points from a vector
+    PolylineRenderer(const std::vector<glm::vec2>& points, float thickness = 1.0f, glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
+
+    // gives the polyline's range of the shared buffer back
+    ~PolylineRenderer();
+
+    // the allocation in the shared buffer can't be shared between two renderers
+    PolylineRenderer(const PolylineRenderer&) = delete;
+    PolylineRenderer& operator=(const PolylineRenderer&) = delete;
+
+    // colour of the line
+    glm::vec3 color;
+
+    // replaces every point, which rebuilds the whole mesh
+    void SetPoints(const glm::vec2* points, size_t count);
+    void SetPoints(const std::vector<glm::vec2>& points);
+
+    // Adds points onto the end of the line. Only the new segments, the join before them and the end cap are rebuilt and uploaded.
+    // A point in the same spot as the one before it is skipped because it has no direction
+    void AppendPoints(const glm::vec2* points, size_t count);
+    void AppendPoint(glm::vec2 point);
+
+    // removes every point
+    void ClearPoints();
+
+    // returns all of the points
+    const std::vector<glm::vec2>& GetPoints();
+
+    // get how thick the line is
+    float GetThickness();
+    // set how thick the line is, rebuilds the whole mesh
+    void SetThickness(float newThickness);
+
+    // get the type of join between segments
+    JoinType GetJoinType();
+    // set the type of join between segments, rebuilds the whole mesh
+    void SetJoinType(JoinType newJoinType);
+
+    // get the type of cap on the ends
+    CapType GetCapType();
+    // set the type of cap on the ends, rebuilds the whole mesh
+    void SetCapType(CapType newCapType);
+
+    // get the miter limit
+    float GetMiterLimit();
+    // Set how long a miter join's point can be compared to the thickness before it is bevelled instead (sharp corners have very long points).
+    // Rebuilds the whole mesh
+    void SetMiterLimit(float newMiterLimit);
+
+    // get the alpha (transparency) value of this line
+    float GetAlpha();
+
+    // set the alpha (transparency) value of this line
+    void SetAlpha(float newAlpha);
+
+    // draw the polyline using reference to scene camera and parent entity's transform. Uploads any part of the mesh that changed first.
+    // The line is added to the scene's draw batcher so it gets drawn along with every other polyline that uses the same program
+    void Draw(std::shared_ptr<OrthoCamera> camera);
+
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing.
+    // The points aren't hashed one by one (there could be thousands), a counter that goes up whenever they change is used instead
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords of the mesh (before the entity's transform is applied)
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+    // Adds the triangles of a line through count points onto vertices (local coords), built the same way as a polyline renderer's mesh.
+    // A closed line joins its last point back onto the first instead of having caps. Points on top of the one before them have to be taken out first.
+    // Used by PathRenderer to outline its flattened curves
+    static void BuildStroke(const glm::vec2* points, size_t count, bool closed, float thickness, JoinType joinType, CapType capType, float miterLimit, std::vector<glm::vec2>& vertices);
+
+private:
+    // everything about how the line is built, so the building functions can be used without a renderer
+    struct StrokeStyle {
+        float thickness;
+        JoinType joinType;
+        CapType capType;
+        float miterLimit;
+    };
+
+    // every point of the line, with repeated points skipped
+    std::vector<glm::vec2> _points;
+
+    // how thick the line is, same as LineRenderer
+    float _thickness;
+    JoinType _joinType = MiterJoin;
+    CapType _capType = ButtCap;
+    float _miterLimit = 4.0f;
+
+    // the alpha channel (transparency) of the current line
+    float _alpha = 1.0f;
+    // shader program that the renderer uses
+    ShaderProgram* shaderProgram;
+
+    // triangles of the line in local coords. In order: start cap, first segment, then a join and segment for every point after that, then the end cap
+    std::vector<glm::vec2> _vertices;
+    // how many of the vertices come before the end cap. The end cap is the only part that gets thrown away when points are added
+    size_t _bodyVertexCount = 0;
+    // first vertex that changed since the last upload
+    size_t _firstDirtyVertex = 0;
+
+    // the polyline's range of the shared buffer
+    PolylinePipeline::Allocation _allocation;
+
+    // smallest and biggest local coords of the body (the end cap is added on when asked for)
+    glm::vec2 _bodyMin = glm::vec2(0.0f);
+    glm::vec2 _bodyMax = glm::vec2(0.0f);
+
+    // goes up by one whenever the mesh changes, used instead of hashing every point
+    size_t _meshRevision = 0;
+
+    // throws away the mesh and builds it again from every point
+    void RebuildMesh();
+
+    // builds everything after the body for points from firstNewPoint onwards, then puts the end cap back on
+    void ExtendMesh(size_t firstNewPoint);
+
+    // returns the renderer's own style
+    StrokeStyle GetStyle();
+
+    // adds the triangles of the segment from start to end
+    static void AddSegment(const StrokeStyle& style, std::vector<glm::vec2>& vertices, glm::vec2 start, glm::vec2 end);
+
+    // adds the triangles that fill the corner at point between a segment going in direction incoming and one going in direction outgoing
+    static void AddJoin(const StrokeStyle& style, std::vector<glm::vec2>& vertices, glm::vec2 point, glm::vec2 incoming, glm::vec2 outgoing);
+
+    // adds a cap at point, where outwards is the direction pointing away from the line
+    static void AddCap(const StrokeStyle& style, std::vector<glm::vec2>& vertices, glm::vec2 point, glm::vec2 outwards);
+
+    // adds a fan of triangles around centre from start, turning by angle radians (anti-clockwise if positive)
+    static void AddRoundFan(std::vector<glm::vec2>& vertices, glm::vec2 centre, glm::vec2 start, float angle);
+
+    // adds one triangle, converting the points from global to local coords
+    static void AddTriangle(std::vector<glm::vec2>& vertices, glm::vec2 a, glm::vec2 b, glm::vec2 c);
+
+    // turns transparency on if the line is see through, off otherwise
+    void UpdateTransparency();
+};
+
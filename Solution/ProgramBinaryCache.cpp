@@ -0,0 +1,170 @@
+#include "ProgramBinaryCache.h"
+#include "GLExtensions.h"
+#include "Hash.h"
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+bool ProgramBinaryCache::isEnabled = true;
+std::string ProgramBinaryCache::directory = "ShaderCache";
+unsigned int ProgramBinaryCache::hitCount = 0;
+unsigned int ProgramBinaryCache::missCount = 0;
+unsigned long long ProgramBinaryCache::_driverHash = 0;
+bool ProgramBinaryCache::_hasDriverHash = false;
+
+// start of every cache file, bump the version if the layout changes
+static const char fileMagic[4] = { 'G', 'R', 'P', 'B' };
+static const unsigned int fileVersion = 1;
+
+// what comes before the binary in a cache file
+struct CacheFileHeader {
+	char magic[4];
+	unsigned int version;
+	// key it was saved under, checked in case two keys ever end up with the same file
+	unsigned long long key;
+	// driver's enum for the binary's format
+	unsigned int binaryFormat;
+	// size of the binary in bytes
+	unsigned int binaryLength;
+};
+
+bool ProgramBinaryCache::IsAvailable()
+{
+	return isEnabled && GLExtensions::hasProgramBinary;
+}
+
+unsigned long long ProgramBinaryCache::GetKey(const char* vertexSource, const char* fragmentSource)
+{
+	// -- the driver part only needs working out once --
+	if (!_hasDriverHash)
+	{
+		// a binary only works on the exact driver that made it
+		unsigned long long hash = Hash::Fnv1a(std::string((const char*)glGetString(GL_VENDOR)));
+		hash = Hash::Fnv1a(std::string((const char*)glGetString(GL_RENDERER)), hash);
+		hash = Hash::Fnv1a(std::string((const char*)glGetString(GL_VERSION)), hash);
+
+		// and the formats it can load
+		GLint formatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		std::vector<GLint> formats(formatCount);
+		if (formatCount > 0)
+			glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+		hash = Hash::Fnv1a(formats.data(), formats.size() * sizeof(GLint), hash);
+
+		_driverHash = hash;
+		_hasDriverHash = true;
+	}
+
+	unsigned long long key = Hash::Fnv1a(std::string(vertexSource), _driverHash);
+	return Hash::Fnv1a(std::string(fragmentSource), key);
+}
+
+bool ProgramBinaryCache::Load(unsigned int programID, unsigned long long key)
+{
+	std::string filePath = GetFilePath(key);
+	std::ifstream file(filePath, std::ios::binary);
+	// never saved, a normal miss
+	if (!file)
+	{
+		missCount++;
+		return false;
+	}
+
+	CacheFileHeader header;
+	file.read((char*)&header, sizeof(header));
+	std::vector<char> binary;
+	bool valid = file && memcmp(header.magic, fileMagic, 4) == 0 && header.version == fileVersion && header.key == key;
+	if (valid)
+	{
+		// a truncated or corrupt file could ask for gigabytes, it can only be as long as what's left of the file
+		std::streampos binaryStart = file.tellg();
+		file.seekg(0, std::ios::end);
+		std::streamoff remaining = file.tellg() - binaryStart;
+		file.seekg(binaryStart);
+		valid = file && header.binaryLength > 0 && (std::streamoff)header.binaryLength <= remaining;
+	}
+	if (valid)
+	{
+		binary.resize(header.binaryLength);
+		file.read(binary.data(), header.binaryLength);
+		valid = file.gcount() == (std::streamsize)header.binaryLength;
+	}
+	file.close();
+
+	GLint linked = GL_FALSE;
+	if (valid)
+	{
+		GLExtensions::ProgramBinary(programID, header.binaryFormat, binary.data(), (GLsizei)binary.size());
+		// the driver says whether it took it by whether the program is linked now
+		glGetProgramiv(programID, GL_LINK_STATUS, &linked);
+	}
+
+	if (linked != GL_TRUE)
+	{
+		// broken or refused (usually a driver update that didn't change the version string), get rid of it so it gets saved again
+		std::cout << "Shader cache: binary " << filePath << " was rejected, compiling from source" << std::endl;
+		std::remove(filePath.c_str());
+		missCount++;
+		return false;
+	}
+
+	hitCount++;
+	return true;
+}
+
+void ProgramBinaryCache::Save(unsigned int programID, unsigned long long key)
+{
+	GLint length = 0;
+	glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length);
+	// the driver didn't keep a binary (e.g. the retrievable hint wasn't set)
+	if (length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLsizei writtenLength = 0;
+	GLenum binaryFormat = 0;
+	GLExtensions::GetProgramBinary(programID, length, &writtenLength, &binaryFormat, binary.data());
+	if (writtenLength <= 0)
+		return;
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	CacheFileHeader header;
+	memcpy(header.magic, fileMagic, 4);
+	header.version = fileVersion;
+	header.key = key;
+	header.binaryFormat = binaryFormat;
+	header.binaryLength = (unsigned int)writtenLength;
+
+	// write to a temporary file and rename it so a crash half way through can't leave a broken file with the real name
+	std::string filePath = GetFilePath(key);
+	std::string temporaryPath = filePath + ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		file.write((const char*)&header, sizeof(header));
+		file.write(binary.data(), writtenLength);
+		if (!file)
+		{
+			std::cout << "Shader cache: couldn't write " << temporaryPath << std::endl;
+			return;
+		}
+	}
+	std::filesystem::rename(temporaryPath, filePath, error);
+}
+
+void ProgramBinaryCache::Clear()
+{
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
+
+std::string ProgramBinaryCache::GetFilePath(unsigned long long key)
+{
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.bin", key);
+	return (std::filesystem::path(directory) / fileName).string();
+}
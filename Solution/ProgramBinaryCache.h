@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+
+// Saves linked shader programs to disk as the driver's own binary and loads them back next launch, so ShaderProgram::Compile
+// can skip compiling and linking (which is most of the start up cost with lots of programs).
+// Each program is saved under a key made from its sources (which include any #defines) and the driver's vendor/renderer/version
+// and binary formats, so editing a shader or updating the driver just makes a new key instead of loading something old.
+// The driver can still refuse a binary (they don't promise to take back their own), in that case the file is deleted and the program
+// gets compiled like normal and saved again.
+// Static class like the resource manager
+class ProgramBinaryCache
+{
+public:
+	// turn off to always compile from source
+	static bool isEnabled;
+	// folder the binaries are saved in (made if it doesn't exist), relative to the working directory
+	static std::string directory;
+
+	// how many programs were loaded from the cache, and how many had to be compiled (misses, including rejected binaries)
+	static unsigned int hitCount;
+	static unsigned int missCount;
+
+	// whether programs can be cached at all (enabled and the driver supports program binaries). Needs GLExtensions loaded
+	static bool IsAvailable();
+
+	// key for a program made from these sources, on this driver
+	static unsigned long long GetKey(const char* vertexSource, const char* fragmentSource);
+
+	// Tries to load the binary saved under key into programID (a new program with nothing attached).
+	// Returns whether it worked and the program is linked and ready. If it didn't the program should be deleted and compiled from source
+	static bool Load(unsigned int programID, unsigned long long key);
+
+	// saves a linked program under key. The program should have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+	static void Save(unsigned int programID, unsigned long long key);
+
+	// deletes every saved binary
+	static void Clear();
+
+private:
+	// private constructor, only static functions
+	ProgramBinaryCache();
+
+	// hash of the driver strings and binary formats, worked out once
+	static unsigned long long _driverHash;
+	static bool _hasDriverHash;
+
+	// where the binary for key is saved
+	static std::string GetFilePath(unsigned long long key);
+};
+
@@ -0,0 +1,225 @@
+#include "QOIImage.h"
+#include <fstream>
+#include <iterator>
+#include <cstdlib>
+#include <cstring>
+
+// the first byte of each op. The 2 bit ops are told apart by the top 2 bits, the 8 bit ones by the whole byte
+static const unsigned char opIndex = 0x00;
+static const unsigned char opDiff = 0x40;
+static const unsigned char opLuma = 0x80;
+static const unsigned char opRun = 0xC0;
+static const unsigned char opRGB = 0xFE;
+static const unsigned char opRGBA = 0xFF;
+static const unsigned char opMask = 0xC0;
+
+static const size_t headerSize = 14;
+// 7 zeros then a 1
+static const unsigned char endMarker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+// files with more pixels than this are assumed to be broken, same limit as the reference decoder
+static const unsigned int maxPixels = 400000000;
+
+// where a pixel goes in the table of 64 recently seen pixels
+static inline int HashPixel(const unsigned char* pixel)
+{
+	return (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+}
+
+bool QOIImage::IsQOI(const unsigned char* data, size_t size)
+{
+	return size >= 4 && memcmp(data, "qoif", 4) == 0;
+}
+
+unsigned char* QOIImage::Decode(const unsigned char* data, size_t size, int& width, int& height, int& channels, int desiredChannels, bool flipVertically)
+{
+	if (size < headerSize + sizeof(endMarker) || !IsQOI(data, size))
+		return nullptr;
+
+	// header is big endian
+	unsigned int fileWidth = ((unsigned int)data[4] << 24) | (data[5] << 16) | (data[6] << 8) | data[7];
+	unsigned int fileHeight = ((unsigned int)data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11];
+	int fileChannels = data[12];
+
+	if (fileWidth == 0 || fileHeight == 0 || (fileChannels != 3 && fileChannels != 4) || fileHeight >= maxPixels / fileWidth)
+		return nullptr;
+	if (desiredChannels == 0)
+		desiredChannels = fileChannels;
+	if (desiredChannels != 3 && desiredChannels != 4)
+		return nullptr;
+
+	size_t rowSize = (size_t)fileWidth * desiredChannels;
+	unsigned char* pixels = (unsigned char*)malloc(rowSize * fileHeight);
+	if (pixels == nullptr)
+		return nullptr;
+
+	// both start as black, the last pixel is opaque
+	unsigned char seen[64][4] = {};
+	unsigned char pixel[4] = { 0, 0, 0, 255 };
+	int run = 0;
+
+	// stop before the end marker so the ops below can never read past the end
+	size_t position = headerSize;
+	size_t end = size - sizeof(endMarker);
+
+	for (unsigned int y = 0; y < fileHeight; y++)
+	{
+		// the file is top row first, the renderer wants bottom row first
+		unsigned char* row = pixels + rowSize * (flipVertically ? fileHeight - 1 - y : y);
+
+		for (unsigned int x = 0; x < fileWidth; x++)
+		{
+			if (run > 0)
+				run--;
+			else if (position < end)
+			{
+				unsigned char op = data[position++];
+
+				if (op == opRGB)
+				{
+					pixel[0] = data[position];
+					pixel[1] = data[position + 1];
+					pixel[2] = data[position + 2];
+					position += 3;
+				}
+				else if (op == opRGBA)
+				{
+					pixel[0] = data[position];
+					pixel[1] = data[position + 1];
+					pixel[2] = data[position + 2];
+					pixel[3] = data[position + 3];
+					position += 4;
+				}
+				else if ((op & opMask) == opIndex)
+					memcpy(pixel, seen[op], 4);
+				else if ((op & opMask) == opDiff)
+				{
+					// -2 to 1 for each channel
+					pixel[0] += ((op >> 4) & 3) - 2;
+					pixel[1] += ((op >> 2) & 3) - 2;
+					pixel[2] += (op & 3) - 2;
+				}
+				else if ((op & opMask) == opLuma)
+				{
+					// green changes by -32 to 31, red and blue by that plus -8 to 7
+					unsigned char next = data[position++];
+					int greenDifference = (op & 0x3F) - 32;
+					pixel[0] += greenDifference - 8 + ((next >> 4) & 0xF);
+					pixel[1] += greenDifference;
+					pixel[2] += greenDifference - 8 + (next & 0xF);
+				}
+				else
+					// repeat the last pixel 1 to 62 times, this is the first one
+					run = op & 0x3F;
+
+				memcpy(seen[HashPixel(pixel)], pixel, 4);
+			}
+
+			unsigned char* destination = row + (size_t)x * desiredChannels;
+			destination[0] = pixel[0];
+			destination[1] = pixel[1];
+			destination[2] = pixel[2];
+			if (desiredChannels == 4)
+				destination[3] = pixel[3];
+		}
+	}
+
+	width = (int)fileWidth;
+	height = (int)fileHeight;
+	channels = fileChannels;
+	return pixels;
+}
+
+unsigned char* QOIImage::Load(const char* filePath, int& width, int& height, int& channels, int desiredChannels, bool flipVertically)
+{
+	std::ifstream fileStream(filePath, std::ios::binary);
+	if (!fileStream)
+		return nullptr;
+	std::vector<unsigned char> file((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+	return Decode(file.data(), file.size(), width, height, channels, desiredChannels, flipVertically);
+}
+
+std::vector<unsigned char> QOIImage::Encode(const unsigned char* pixels, int width, int height, int channels)
+{
+	std::vector<unsigned char> file;
+	// worst case is every pixel being a whole rgba op
+	file.reserve(headerSize + (size_t)width * height * (channels + 1) + sizeof(endMarker));
+
+	// -- header --
+	file.insert(file.end(), { 'q', 'o', 'i', 'f' });
+	for (int shift = 24; shift >= 0; shift -= 8)
+		file.push_back((unsigned char)((unsigned int)width >> shift));
+	for (int shift = 24; shift >= 0; shift -= 8)
+		file.push_back((unsigned char)((unsigned int)height >> shift));
+	file.push_back((unsigned char)channels);
+	// sRGB with linear alpha, it's only informative
+	file.push_back(0);
+
+	unsigned char seen[64][4] = {};
+	unsigned char previous[4] = { 0, 0, 0, 255 };
+	unsigned char pixel[4] = { 0, 0, 0, 255 };
+	int run = 0;
+	size_t pixelCount = (size_t)width * height;
+
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const unsigned char* source = pixels + i * channels;
+		pixel[0] = source[0];
+		pixel[1] = source[1];
+		pixel[2] = source[2];
+		if (channels == 4)
+			pixel[3] = source[3];
+
+		if (memcmp(pixel, previous, 4) == 0)
+		{
+			run++;
+			// runs go up to 62 (63 and 64 would look like the rgb/rgba ops)
+			if (run == 62 || i == pixelCount - 1)
+			{
+				file.push_back(opRun | (run - 1));
+				run = 0;
+			}
+			continue;
+		}
+
+		if (run > 0)
+		{
+			file.push_back(opRun | (run - 1));
+			run = 0;
+		}
+
+		int hash = HashPixel(pixel);
+		if (memcmp(seen[hash], pixel, 4) == 0)
+			file.push_back(opIndex | (unsigned char)hash);
+		else
+		{
+			memcpy(seen[hash], pixel, 4);
+
+			if (pixel[3] == previous[3])
+			{
+				// differences wrap around like the decoder's unsigned char maths
+				signed char redDifference = (signed char)(pixel[0] - previous[0]);
+				signed char greenDifference = (signed char)(pixel[1] - previous[1]);
+				signed char blueDifference = (signed char)(pixel[2] - previous[2]);
+				signed char redGreen = (signed char)(redDifference - greenDifference);
+				signed char blueGreen = (signed char)(blueDifference - greenDifference);
+
+				if (redDifference >= -2 && redDifference <= 1 && greenDifference >= -2 && greenDifference <= 1 && blueDifference >= -2 && blueDifference <= 1)
+					file.push_back(opDiff | ((redDifference + 2) << 4) | ((greenDifference + 2) << 2) | (blueDifference + 2));
+				else if (greenDifference >= -32 && greenDifference <= 31 && redGreen >= -8 && redGreen <= 7 && blueGreen >= -8 && blueGreen <= 7)
+				{
+					file.push_back(opLuma | (greenDifference + 32));
+					file.push_back((unsigned char)(((redGreen + 8) << 4) | (blueGreen + 8)));
+				}
+				else
+					file.insert(file.end(), { opRGB, pixel[0], pixel[1], pixel[2] });
+			}
+			else
+				file.insert(file.end(), { opRGBA, pixel[0], pixel[1], pixel[2], pixel[3] });
+		}
+
+		memcpy(previous, pixel, 4);
+	}
+
+	file.insert(file.end(), endMarker, endMarker + sizeof(endMarker));
+	return file;
+}
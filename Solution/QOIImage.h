@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Reads and writes QOI ("quite ok image") files. QOI is lossless like png but it's just a run of tiny one byte ops per pixel
+// (repeat the last pixel, reuse a recent one, small difference from the last one, or a whole new pixel) with no zlib, so it decodes several times faster.
+// ResourceManager uses this by itself for files that start with the QOI header. Make the files with Tools/QOIConverter.cpp
+// Doesn't need GL so the tools can use it too
+// Static class like the resource manager
+class QOIImage
+{
+public:
+	// whether data (the start of a file, at least 4 bytes) is a QOI file
+	static bool IsQOI(const unsigned char* data, size_t size);
+
+	// Decodes a QOI file in memory. Gives back pixels with desiredChannels channels (3 or 4, or 0 for however many the file has),
+	// or nullptr if it isn't a valid file. Free the pixels with free() (stbi_image_free does the same thing).
+	// channels is how many the file has, like stbi_load
+	static unsigned char* Decode(const unsigned char* data, size_t size, int& width, int& height, int& channels, int desiredChannels, bool flipVertically);
+
+	// reads and decodes a QOI file, same as Decode
+	static unsigned char* Load(const char* filePath, int& width, int& height, int& channels, int desiredChannels, bool flipVertically);
+
+	// encodes 3 or 4 channel pixels (top row first) into a QOI file
+	static std::vector<unsigned char> Encode(const unsigned char* pixels, int width, int height, int channels);
+
+private:
+	// private constructor, only static functions
+	QOIImage();
+};
+
@@ -1,6 +1,8 @@
 #include "RectangleRenderer.h"
 #include "Entity.h"
-#include "ResourceManager.h"
+#include "Scene.h"
+#include "ShapePipeline.h"
+#include "Hash.h"
 // glad is included already thru other include
 #include <glfw3.h>
 #include <string>
@@ -10,8 +12,8 @@ RectangleRenderer::RectangleRenderer(glm::vec3 color, ShaderProgram* program)
 {
 	// if the program wasn't specified 
 	if (program == nullptr)
-		// use default path, add time to end to avoid lots of recursion when there are many default programs
-		this->shaderProgram = ResourceManager::LoadShaderProgram("defaultRectProgram" + std::to_string(glfwGetTime()), defaultVertPath, defaultFragPath);
+		// all shapes share the same program, otherwise they couldn't be batched together
+		this->shaderProgram = ShapePipeline::GetDefaultProgram();
 	else // else use given one
 		this->shaderProgram = program;
 
@@ -19,119 +21,109 @@ RectangleRenderer::RectangleRenderer(glm::vec3 color, ShaderProgram* program)
 	this->type = Entity::RectangleRenderer;
 	// set colour
 	this->color = color;
+}
 
-	// initialise rect
-	InitRenderData();
+float RectangleRenderer::GetAlpha()
+{
+	return _alpha;
 }
 
-RectangleRenderer::~RectangleRenderer()
+void RectangleRenderer::SetAlpha(float newAlpha)
 {
-	// de-allocate all resources once they've outlived their purpose
-	glDeleteVertexArrays(1, &rectVAO);
-	glDeleteBuffers(1, &rectVBO);
-	glDeleteBuffers(1, &rectEBO);
+	// cap it to 1 if the new alpha is more than 1 (idk why it would be)
+	_alpha = glm::min(newAlpha, 1.0f);
+	UpdateTransparency();
 }
 
-float RectangleRenderer::GetAlpha()
+float RectangleRenderer::GetCornerRadius()
 {
-	return _alpha;
+	return _cornerRadius;
 }
 
-void RectangleRenderer::SetAlpha(float newAlpha)
+void RectangleRenderer::SetCornerRadius(float newCornerRadius)
 {
-	// if the new alpha is more than or equal to 1 (idk why it would be)
-	if (newAlpha >= 1.0f)
-	{
-		// cap it to 1 
-		_alpha = 1.0f;
-		// but also set it so transparency is off
-		this->hasTransprency = false;
-		// if the current renderer has a parent entity set it to no transparency
-		if (parentEntity != nullptr)
-			parentEntity->SetHasTransparency(false);
-	}
-	else 
-	{
-		// do the same but for transparency turned on
-		_alpha = newAlpha;
-		this->hasTransprency = true;
-		// if the current renderer has a parent entity set it to has transparency
-		if (parentEntity != nullptr)
-			parentEntity->SetHasTransparency(true);
-	}
+	_cornerRadius = glm::max(newCornerRadius, 0.0f);
+	UpdateTransparency();
 }
 
 void RectangleRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
 {
 	if (parentEntity == nullptr)
-		throw std::exception("Tried to draw a sprite which doesn't have a parent entity");
+		throw std::exception("Tried to draw a rect which doesn't have a parent entity");
 
-	shaderProgram->Use();
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a rect which isn't in a scene");
 
-	// get the transform of this renderer's parent
-	Transform spriteTransform = parentEntity->transform;
+	ShapePipeline::InstanceData instance;
+	// rect transform
+	instance.modelTransform = parentEntity->transform.ToMatrix(camera);
+	// colours of rect with alpha channel included
+	instance.fillColor = glm::vec4(color, _alpha);
+	instance.strokeColor = glm::vec4(borderColor, _alpha);
 
-	glm::mat4 view = camera->GetViewMatrix();
-	shaderProgram->SetMatrix4("view", view);
-	
+	// a rect with no corner radius is just the quad, which doesn't need any smoothing
+	float shapeType = (_cornerRadius > 0.0f) ? ShapePipeline::RoundedRectangle : ShapePipeline::Rectangle;
+	instance.shapeParams = glm::vec4(shapeType, _cornerRadius, borderWidth, 0.0f);
+	instance.halfSize = glm::vec2(parentEntity->transform.GetGlobalSize(camera)) / 2.0f;
+	instance.linePoints = glm::vec4(0.0f);
 
-	glm::mat4 projection = camera->GetProjectionMatrix();
-	shaderProgram->SetMatrix4("projection", projection);
+	parentEntity->parentScene->drawBatcher.AddInstance(ShapePipeline::GetDrawState(shaderProgram), ShapePipeline::GetMesh(), &instance);
+}
+
+size_t RectangleRenderer::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, color);
+	Hash::Add(hash, _alpha);
+	Hash::Add(hash, borderColor);
+	Hash::Add(hash, borderWidth);
+	Hash::Add(hash, _cornerRadius);
+	Hash::Add(hash, shaderProgram);
+	return hash;
+}
 
-	// sey sprite transform
-	shaderProgram->SetMatrix4("modelTransform", spriteTransform.ToMatrix(camera));
-	// set color of rect with alpha channel included
-	shaderProgram->SetVector4f("rectColor", glm::vec4(color, _alpha));
+bool RectangleRenderer::BakeStatic(std::shared_ptr<OrthoCamera> camera, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices)
+{
+	// baked quads are just coloured, so anything the shape shader has to smooth (or a custom shader) can't be baked
+	if (shaderProgram != ShapePipeline::GetDefaultProgram() || _cornerRadius > 0.0f)
+		return false;
 
+	// shapes don't have a texture
+	key = StaticBatch::Key();
+	glm::mat4 model = parentEntity->transform.ToMatrix(camera);
+	glm::vec4 fillColor = glm::vec4(color, _alpha);
 
-	// draw the rect
-	glBindVertexArray(this->rectVAO);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	if (borderWidth <= 0.0f)
+	{
+		StaticBatch::AddQuad(vertices, model, glm::vec2(-1.0f), glm::vec2(1.0f), fillColor);
+		return true;
+	}
 
-	glBindVertexArray(0);
+	// -- the border is inside the edge, so the fill is shrunk by it and the border is 4 strips round the fill --
+	// the quad is -1 to 1 across half the size, so the border width in local coords is width / half size
+	glm::vec2 halfSize = glm::vec2(parentEntity->transform.GetGlobalSize(camera)) / 2.0f;
+	glm::vec2 localBorder = glm::min(glm::vec2(borderWidth) / glm::max(halfSize, glm::vec2(0.0001f)), glm::vec2(1.0f));
+	glm::vec2 innerMin = glm::vec2(-1.0f) + localBorder;
+	glm::vec2 innerMax = glm::vec2(1.0f) - localBorder;
+	glm::vec4 strokeColor = glm::vec4(borderColor, _alpha);
+
+	// a border that's wider than the rect doesn't leave any fill
+	if (innerMin.x < innerMax.x && innerMin.y < innerMax.y)
+		StaticBatch::AddQuad(vertices, model, innerMin, innerMax, fillColor);
+	// bottom and top go all the way across, left and right fit in between them
+	StaticBatch::AddQuad(vertices, model, glm::vec2(-1.0f), glm::vec2(1.0f, innerMin.y), strokeColor);
+	StaticBatch::AddQuad(vertices, model, glm::vec2(-1.0f, innerMax.y), glm::vec2(1.0f), strokeColor);
+	StaticBatch::AddQuad(vertices, model, glm::vec2(-1.0f, innerMin.y), glm::vec2(innerMin.x, innerMax.y), strokeColor);
+	StaticBatch::AddQuad(vertices, model, glm::vec2(innerMax.x, innerMin.y), glm::vec2(1.0f, innerMax.y), strokeColor);
+	return true;
 }
 
-void RectangleRenderer::InitRenderData()
+void RectangleRenderer::UpdateTransparency()
 {
-	// normalised vertics from -1 to 1 on x and y axis. These start as 1s but the size transform changes them
-	float vertices[] = {
-		// positions        
-		1.0f,   1.0f, 0.0f, // top-right
-		1.0f,  -1.0f, 0.0f, // bottom-right
-		-1.0f, -1.0f, 0.0f, // bottom left
-		-1.0f,  1.0f, 0.0f  // top left
-	};
-	// define what order of vertices to draw rectangle
-	unsigned int indices[] = {  // note this is 0 based index
-		0, 1, 2,   // first triangle
-		2, 3, 0    // second triangle
-	};
-
-	// note that the VBO, VAO and EBO are actually just IDs to their values which are handled by opengl
-
-	// vertex buffer object, stores vertices
-	glGenBuffers(1, &rectVBO); // generate one buffer 
-
-	// vertex array object, holds all configurations for a VBO/EBO
-	glGenVertexArrays(1, &rectVAO); // generate 1 vertex arrya object
-
-	// Element buffer object, stores index to how vertices should be drawn cutting down amount needed
-	glGenBuffers(1, &rectEBO); // generate 1 elment buffer object
-
-	glBindVertexArray(rectVAO); // bind the vertex array object 
-
-	glBindBuffer(GL_ARRAY_BUFFER, rectVBO); // bind the generated buffer to array buffer target
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW); // place vertex data into buffer memory
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rectEBO);// bind generated element buffer object
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);// bind indicies to element buffer
-
-	// set vertex attribute position pointer at location 0, with 3 values, of type float, don't normalise data, stride is 3 values, offser of 0 bytes
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-	// enable the created attribute which is at location 0
-	glEnableVertexAttribArray(0);
-
-	// unbind
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	bool newTransparency = _alpha < 1.0f || _cornerRadius > 0.0f;
+
+	this->hasTransprency = newTransparency;
+	// if the current renderer has a parent entity update its transparency
+	if (parentEntity != nullptr)
+		parentEntity->SetHasTransparency(newTransparency);
 }
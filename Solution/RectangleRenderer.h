@@ -2,42 +2,57 @@
 #include "Component.h"
 #include "ShaderProgram.h"
 #include "OrthoCamera.h"
+#include "StaticBatch.h"
 
 class RectangleRenderer :
     public Component
 {
 public:
     // Setup a new rectangle renderer using given shader program and colour of rect
-    // NOTE: If shader program is set to nullptr it will use a default shader
+    // NOTE: If shader program is set to nullptr it will use the default shape shader. A custom shader has to take the same per-instance attributes as ShapeDefault.vert
     RectangleRenderer(glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
-    ~RectangleRenderer();
 
     // colour of the rectangle
     glm::vec3 color;
 
+    // colour of the border
+    glm::vec3 borderColor = glm::vec3(0.0f);
+
+    // width of the border (global coords) drawn inside the edge of the rect. 0 for no border
+    float borderWidth = 0.0f;
+
     // get the alpha (transparency) value of this rect
     float GetAlpha();
     
     // set the alpha (transparency) value of this rect
     void SetAlpha(float newAlpha);
 
-    // draw a rectangle using reference to scene camera and parent entity's transform
+    // get the radius (global coords) of the rect's corners
+    float GetCornerRadius();
+
+    // set the radius (global coords) of the rect's corners, 0 for square corners. Rounded corners are smoothed so they turn transparency on
+    void SetCornerRadius(float newCornerRadius);
+
+    // draw a rectangle using reference to scene camera and parent entity's transform.
+    // The rect is added to the scene's draw batcher so it gets drawn along with every other shape that uses the same program
     void Draw(std::shared_ptr<OrthoCamera> camera);
 
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing
+    size_t GetStateHash();
+
+    // Adds the rect to vertices as pre-transformed quads for a static batch (see Scene::BakeStatic), with the texture it needs in key.
+    // A border is its own 4 quads round the fill. Returns false if it can't be baked (custom shader or rounded corners) and doesn't add anything
+    bool BakeStatic(std::shared_ptr<OrthoCamera> camera, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices);
+
 private:
     // the alpha channel (transparency) of the current rect
     float _alpha = 1.0f;
+    // radius of the corners
+    float _cornerRadius = 0.0f;
     // shader program that the renderer uses
     ShaderProgram* shaderProgram;
-    // default vertex sahader
-    const char* defaultVertPath = "VertexShaders/RectangleDefault.vert";
-    // default frag sahader
-    const char* defaultFragPath = "FragmentShaders/RectangleDefault.frag";
-    // vretex array object ID for the sprite's rect
-    unsigned int rectVAO;
-    unsigned int rectVBO;
-    unsigned int rectEBO;
-    // Initializes and configures the rects's buffer and vertex attributes
-    void InitRenderData();
+
+    // turns transparency on if the rect is see through or has smoothed (rounded) edges, off otherwise
+    void UpdateTransparency();
 };
 
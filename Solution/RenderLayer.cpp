@@ -0,0 +1,251 @@
+#include "RenderLayer.h"
+#include "Entity.h"
+#include "ResourceManager.h"
+#include "Transform.h"
+#include <algorithm>
+#include <cmath>
+
+ShaderProgram* RenderLayer::_compositeProgram = nullptr;
+unsigned int RenderLayer::quadVAO = 0;
+unsigned int RenderLayer::quadVBO = 0;
+unsigned int RenderLayer::quadEBO = 0;
+
+RenderLayer::RenderLayer(unsigned int minZIndex, unsigned int maxZIndex)
+{
+	this->type = Type::ZIndexRange;
+	this->minZIndex = minZIndex;
+	this->maxZIndex = maxZIndex;
+
+	// the size gets set every time the layer is drawn into
+	_camera = std::make_shared<OrthoCamera>(1.0f, 1.0f);
+}
+
+RenderLayer::RenderLayer(std::string tag)
+{
+	this->type = Type::Tag;
+	this->tag = tag;
+
+	// the size gets set every time the layer is drawn into
+	_camera = std::make_shared<OrthoCamera>(1.0f, 1.0f);
+}
+
+bool RenderLayer::Contains(Entity* entity)
+{
+	if (type == Type::ZIndexRange)
+	{
+		unsigned int zIndex = entity->transform.GetZIndex();
+		return zIndex >= minZIndex && zIndex <= maxZIndex;
+	}
+	else
+		// tags are only matched when the layer actually has one, otherwise every untagged entity would be in it
+		return tag != "" && entity->layerTag == tag;
+}
+
+void RenderLayer::Invalidate()
+{
+	_isDirty = true;
+}
+
+void RenderLayer::Clear()
+{
+	_hasRendered = false;
+}
+
+bool RenderLayer::HasContent()
+{
+	return _hasRendered;
+}
+
+unsigned int RenderLayer::GetRenderCount()
+{
+	return _renderCount;
+}
+
+unsigned int RenderLayer::GetCompositeZIndex()
+{
+	return _compositeZIndex;
+}
+
+bool RenderLayer::NeedsRender(size_t contentHash, std::shared_ptr<OrthoCamera> mainCamera)
+{
+	// never drawn, told to re-draw or something in the layer changed
+	if (!_hasRendered || _isDirty || contentHash != _contentHash)
+		return true;
+
+	// zoom or viewport changed, the cached pixels would be the wrong size
+	if (mainCamera->scalarSize != _renderedScalarSize || mainCamera->width != _renderedWidth || mainCamera->height != _renderedHeight)
+		return true;
+
+	// otherwise it only needs re-drawing if the camera can see outside of the cached area
+	glm::vec2 viewMin, viewMax;
+	GetVisibleBounds(mainCamera, viewMin, viewMax);
+	return viewMin.x < _areaMin.x || viewMin.y < _areaMin.y || viewMax.x > _areaMax.x || viewMax.y > _areaMax.y;
+}
+
+std::shared_ptr<OrthoCamera> RenderLayer::BeginRender(std::shared_ptr<OrthoCamera> mainCamera, size_t contentHash, unsigned int compositeZIndex)
+{
+	// -- work out the area to cache --
+	// the layer camera isn't rotated, the quad gets rotated with the main camera when it is drawn. That just means a rotated view needs a bigger area
+	glm::vec2 viewMin, viewMax;
+	GetVisibleBounds(mainCamera, viewMin, viewMax);
+	glm::vec2 viewCentre = (viewMin + viewMax) / 2.0f;
+
+	_camera->scalarSize = mainCamera->scalarSize;
+	_camera->rotation = glm::vec3(0.0f);
+	_camera->position = glm::vec2(0.0f);
+	_camera->nearPlane = mainCamera->nearPlane;
+	_camera->farPlane = mainCamera->farPlane;
+
+	// how many pixels the main camera has per global unit. Worked out with an unrotated copy of it so zoom is taken into account
+	_camera->UpdateProjection(mainCamera->width, mainCamera->height);
+	glm::vec2 unrotatedMin, unrotatedMax;
+	GetVisibleBounds(_camera, unrotatedMin, unrotatedMax);
+	glm::vec2 pixelsPerUnit = glm::vec2(mainCamera->width, mainCamera->height) / (unrotatedMax - unrotatedMin);
+
+	// the view plus padding on every side, in pixels. Can't be bigger than the driver allows
+	glm::vec2 areaSize = (viewMax - viewMin) * (1.0f + 2.0f * padding);
+	int maxSize = RenderTarget::GetMaxSize();
+	int pixelWidth = std::min((int)std::ceil(areaSize.x * pixelsPerUnit.x), maxSize);
+	int pixelHeight = std::min((int)std::ceil(areaSize.y * pixelsPerUnit.y), maxSize);
+
+	// size the layer camera to the area and move it so the area is centred on the view
+	_camera->UpdateProjection((float)pixelWidth, (float)pixelHeight);
+	glm::vec2 areaMin, areaMax;
+	GetVisibleBounds(_camera, areaMin, areaMax);
+	// moving the camera moves what it can see by the same amount
+	_camera->position = viewCentre - (areaMin + areaMax) / 2.0f;
+	GetVisibleBounds(_camera, _areaMin, _areaMax);
+
+	// -- remember what it was drawn with --
+	_contentHash = contentHash;
+	_compositeZIndex = compositeZIndex;
+	_renderedScalarSize = mainCamera->scalarSize;
+	_renderedWidth = mainCamera->width;
+	_renderedHeight = mainCamera->height;
+	_hasRendered = true;
+	_isDirty = false;
+	_renderCount++;
+
+	// -- get the texture ready --
+	if (_target == nullptr)
+		_target = std::make_unique<RenderTarget>(pixelWidth, pixelHeight);
+	else
+		_target->Resize(pixelWidth, pixelHeight);
+
+	_target->Bind();
+	// clear to fully transparent so only what is drawn covers the scene
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// Colour is blended as normal but ends up multiplied by alpha and alpha is added up properly. 
+	// With the normal blend function alpha would get multiplied by itself and the layer would come out more transparent than the entities were
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	return _camera;
+}
+
+void RenderLayer::EndRender(int windowWidth, int windowHeight)
+{
+	RenderTarget::BindWindow(windowWidth, windowHeight);
+	// back to the blend function that main sets up
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void RenderLayer::Composite(std::shared_ptr<OrthoCamera> mainCamera, unsigned int highestZIndex)
+{
+	if (!_hasRendered)
+		return;
+
+	if (_compositeProgram == nullptr)
+		InitRenderData();
+
+	_compositeProgram->Use();
+
+	// the quad covers the cached area, at the depth of the layer's highest zIndex (same as Transform::ToMatrix)
+	glm::mat4 modelTransform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -((float)highestZIndex - _compositeZIndex)))
+		* Transform::ValuesToMatrix(_areaMin, glm::vec3(_areaMax - _areaMin, 1.0f), glm::vec3(0.0f));
+
+	_compositeProgram->SetMatrix4("modelTransform", modelTransform);
+	_compositeProgram->SetMatrix4("view", mainCamera->GetViewMatrix());
+	_compositeProgram->SetMatrix4("projection", mainCamera->GetProjectionMatrix());
+	_compositeProgram->SetInt("layerTexture", 0);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, _target->colorTextureID);
+
+	// colour in the layer is already multiplied by alpha
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	// don't write depth. The empty parts of the quad would hide anything drawn behind them afterwards
+	glDepthMask(GL_FALSE);
+
+	glBindVertexArray(quadVAO);
+	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	glBindVertexArray(0);
+
+	glDepthMask(GL_TRUE);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void RenderLayer::InitRenderData()
+{
+	_compositeProgram = ResourceManager::LoadShaderProgram("layerCompositeProgram", compositeVertPath, compositeFragPath);
+
+	// normalised vertics from -1 to 1 on x and y axis. The model transform stretches it over the cached area
+	float vertices[] = {
+		// positions        // texture coords
+		1.0f,   1.0f, 0.0f,   1.0f, 1.0f, // top right
+		1.0f,  -1.0f, 0.0f,   1.0f, 0.0f, // bottom right
+		-1.0f, -1.0f, 0.0f,   0.0f, 0.0f, // bottom left
+		-1.0f,  1.0f, 0.0f,   0.0f, 1.0f, // top left 
+	};
+	// define what order of vertices to draw rectangle
+	unsigned int indices[] = {  // note this is 0 based index
+		0, 1, 2,   // first triangle
+		2, 3, 0    // second triangle
+	};
+
+	glGenVertexArrays(1, &quadVAO);
+	glGenBuffers(1, &quadVBO);
+	glGenBuffers(1, &quadEBO);
+
+	glBindVertexArray(quadVAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// position at location 0 and texture coords at location 1, 5 floats per vertex
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void RenderLayer::GetVisibleBounds(std::shared_ptr<OrthoCamera> camera, glm::vec2& min, glm::vec2& max)
+{
+	// anything on screen is between -1 and 1 after projection * view, so undo that for each corner of the screen
+	glm::mat4 screenToLocal = glm::inverse(camera->GetProjectionMatrix() * camera->GetViewMatrix());
+
+	glm::vec2 corners[4] = { glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f) };
+	for (int i = 0; i < 4; i++)
+	{
+		// 2 local units is 1 global unit so halve it
+		glm::vec2 corner = glm::vec2(screenToLocal * glm::vec4(corners[i], 0.0f, 1.0f)) / 2.0f;
+
+		if (i == 0)
+		{
+			min = corner;
+			max = corner;
+		}
+		else
+		{
+			min = glm::min(min, corner);
+			max = glm::max(max, corner);
+		}
+	}
+}
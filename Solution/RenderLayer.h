@@ -0,0 +1,120 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "OrthoCamera.h"
+#include "RenderTarget.h"
+#include "ShaderProgram.h"
+
+// forward declare entity
+class Entity;
+
+// A retained layer of the scene. Every entity in the layer (a range of zIndexes or every entity with a tag) is drawn into a texture once and then the
+// scene just draws that texture as one quad each frame until something in the layer changes. Good for backgrounds and decorations that never move.
+// A layer is re-drawn when:
+//  - an entity in it changes transform, colour, alpha, active state or anything else its renderer draws with
+//  - an entity joins or leaves the layer (added/removed from scene, zIndex or tag changed)
+//  - the camera zooms or the viewport changes size
+//  - the camera moves far enough that the view isn't inside the cached area anymore (the layer caches padding extra around the view)
+// Moving the camera otherwise only moves the cached quad. Sticky and relative transforms depend on the camera/viewport, so a layer with sticky entities
+// gets re-drawn whenever the camera moves and one with relative values whenever the viewport changes size.
+// The layer is drawn back into the scene at the depth of its highest zIndex, so entities outside the layer shouldn't have zIndexes between the lowest and highest in it.
+class RenderLayer
+{
+public:
+	enum Type {
+		// every entity with minZIndex <= zIndex <= maxZIndex
+		ZIndexRange,
+		// every entity with layerTag == tag
+		Tag
+	};
+
+	// create a layer of every entity with a zIndex between minZIndex and maxZIndex (inclusive)
+	RenderLayer(unsigned int minZIndex, unsigned int maxZIndex);
+	// create a layer of every entity whose layerTag is tag
+	RenderLayer(std::string tag);
+
+	// the type of layer this is
+	Type type;
+	// lowest zIndex in a zIndex range layer
+	unsigned int minZIndex = 0;
+	// highest zIndex in a zIndex range layer
+	unsigned int maxZIndex = 0;
+	// tag of a tagged layer
+	std::string tag = "";
+
+	// how much extra is cached around the view on each side, as a fraction of the view size. The camera can move this far before the layer is re-drawn.
+	// Bigger values use more memory
+	float padding = 0.5f;
+
+	// whether the layer is used. If false its entities are just drawn normally
+	bool isActive = true;
+
+	// whether an entity belongs in this layer
+	bool Contains(Entity* entity);
+
+	// makes the layer re-draw next frame, e.g. if something it can't detect changed (like a custom shader's uniforms)
+	void Invalidate();
+
+	// Forgets whatever was drawn. The scene calls this when the layer has no entities
+	void Clear();
+
+	// whether something has been drawn into the layer that can be drawn into the scene
+	bool HasContent();
+
+	// how many times the layer has been drawn into. Handy for checking that it isn't being re-drawn every frame
+	unsigned int GetRenderCount();
+
+	// zIndex the layer is drawn into the scene at (highest zIndex of its entities)
+	unsigned int GetCompositeZIndex();
+
+	// -- used by the scene --
+
+	// whether the layer needs to be drawn into again. contentHash is a hash of every entity in the layer
+	bool NeedsRender(size_t contentHash, std::shared_ptr<OrthoCamera> mainCamera);
+
+	// binds and clears the layer's texture, ready for its entities to be drawn into it. Returns the camera they should be drawn from
+	std::shared_ptr<OrthoCamera> BeginRender(std::shared_ptr<OrthoCamera> mainCamera, size_t contentHash, unsigned int compositeZIndex);
+
+	// goes back to drawing to the window
+	void EndRender(int windowWidth, int windowHeight);
+
+	// draws the layer's texture into the scene as one quad from the main camera. 
+	// highestZIndex is the scene's highest zIndex, used to put the quad at the right depth
+	void Composite(std::shared_ptr<OrthoCamera> mainCamera, unsigned int highestZIndex);
+
+private:
+	// the texture the layer is drawn into. Created on first render
+	std::unique_ptr<RenderTarget> _target;
+	// camera the entities are drawn into the layer with. Covers the cached area
+	std::shared_ptr<OrthoCamera> _camera;
+
+	// -- what the layer was last drawn with --
+	bool _hasRendered = false;
+	bool _isDirty = false;
+	size_t _contentHash = 0;
+	unsigned int _compositeZIndex = 0;
+	glm::vec2 _renderedScalarSize = glm::vec2(1.0f);
+	float _renderedWidth = 0.0f;
+	float _renderedHeight = 0.0f;
+	// cached area in global coords
+	glm::vec2 _areaMin = glm::vec2(0.0f);
+	glm::vec2 _areaMax = glm::vec2(0.0f);
+
+	unsigned int _renderCount = 0;
+
+	// default vertex sahader
+	const char* compositeVertPath = "VertexShaders/LayerComposite.vert";
+	// default frag sahader
+	const char* compositeFragPath = "FragmentShaders/LayerComposite.frag";
+	// every layer draws with the same program and quad
+	static ShaderProgram* _compositeProgram;
+	static unsigned int quadVAO;
+	static unsigned int quadVBO;
+	static unsigned int quadEBO;
+	// Initializes the shared quad and program
+	void InitRenderData();
+
+	// gets the axis aligned area (in global coords) that a camera can see. Works with rotated and scaled cameras
+	static void GetVisibleBounds(std::shared_ptr<OrthoCamera> camera, glm::vec2& min, glm::vec2& max);
+};
+
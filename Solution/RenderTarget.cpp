@@ -0,0 +1,239 @@
+#include "RenderTarget.h"
+#include "ResourceManager.h"
+#include <iostream>
+#include <algorithm>
+
+ShaderProgram* RenderTarget::_copyProgram = nullptr;
+ShaderProgram* RenderTarget::_fxaaProgram = nullptr;
+unsigned int RenderTarget::_copyVAO = 0;
+
+RenderTarget::RenderTarget(int width, int height, int samples)
+{
+	// a 0 sized framebuffer isn't complete, so always have at least a pixel
+	_width = std::max(width, 1);
+	_height = std::max(height, 1);
+	_samples = std::clamp(samples, 0, GetMaxSamples());
+
+	glGenFramebuffers(1, &ID);
+	glGenRenderbuffers(1, &depthRenderbufferID);
+
+	if (_samples > 0)
+		// multisampled textures need GL 3.2 texelFetch to read, a renderbuffer is all a blit needs
+		glGenRenderbuffers(1, &colorRenderbufferID);
+	else
+	{
+		glGenTextures(1, &colorTextureID);
+
+		// -- colour texture --
+		glBindTexture(GL_TEXTURE_2D, colorTextureID);
+		// it is drawn back 1:1 most of the time so linear is plenty, and no mipmaps because it is redrawn. FXAA needs linear too
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		// clamp so the edges don't bleed into the other side when filtered
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	AllocateStorage();
+
+	// -- attach everything to the framebuffer --
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	if (_samples > 0)
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbufferID);
+	else
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTextureID, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbufferID);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR: Render target framebuffer is not complete" << std::endl;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+RenderTarget::~RenderTarget()
+{
+	// de-allocate all resources once they've outlived their purpose
+	glDeleteFramebuffers(1, &ID);
+	// deleting 0 is ignored, so whichever kind of colour it doesn't have is fine
+	glDeleteTextures(1, &colorTextureID);
+	glDeleteRenderbuffers(1, &colorRenderbufferID);
+	glDeleteRenderbuffers(1, &depthRenderbufferID);
+}
+
+int RenderTarget::GetWidth()
+{
+	return _width;
+}
+
+int RenderTarget::GetHeight()
+{
+	return _height;
+}
+
+int RenderTarget::GetSamples()
+{
+	return _samples;
+}
+
+size_t RenderTarget::GetMemoryUsage()
+{
+	// RGBA8 colour and 24 bit depth + 8 bit stencil are 4 bytes each, for every sample of every pixel
+	size_t memory = (size_t)_width * _height * std::max(_samples, 1) * (4 + 4);
+	if (_resolveTarget != nullptr)
+		memory += _resolveTarget->GetMemoryUsage();
+	return memory;
+}
+
+void RenderTarget::Resize(int width, int height)
+{
+	width = std::max(width, 1);
+	height = std::max(height, 1);
+
+	// nothing changed
+	if (width == _width && height == _height)
+		return;
+
+	_width = width;
+	_height = height;
+	// the attachments keep the same IDs so the framebuffer doesn't need to be set up again
+	AllocateStorage();
+}
+
+void RenderTarget::Bind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	glViewport(0, 0, _width, _height);
+}
+
+void RenderTarget::BindWindow(int windowWidth, int windowHeight)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, windowWidth, windowHeight);
+}
+
+void RenderTarget::CopyToWindow(int windowWidth, int windowHeight)
+{
+	// -- multisampled and a different size, resolve it at its own size and stretch that --
+	if (_samples > 0 && (_width != windowWidth || _height != windowHeight))
+	{
+		if (_resolveTarget == nullptr)
+			_resolveTarget = std::make_unique<RenderTarget>(_width, _height);
+		else
+			_resolveTarget->Resize(_width, _height);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _resolveTarget->ID);
+		glBlitFramebuffer(0, 0, _width, _height, 0, 0, _width, _height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		_resolveTarget->CopyToWindow(windowWidth, windowHeight);
+		return;
+	}
+
+	// the resolve target isn't needed anymore
+	_resolveTarget = nullptr;
+
+	BindWindow(windowWidth, windowHeight);
+
+	// how many samples the window has
+	GLint windowSamples = 0;
+	glGetIntegerv(GL_SAMPLES, &windowSamples);
+
+	// a multisampled target has no texture to draw, so it always blits
+	if (windowSamples == 0 || _samples > 0)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		// linear so it still looks ok if stretched. A multisampled blit can't stretch so it has to be nearest (it's the same size anyway)
+		glBlitFramebuffer(0, 0, _width, _height, 0, 0, windowWidth, windowHeight, GL_COLOR_BUFFER_BIT, 
+			(_samples > 0 || (_width == windowWidth && _height == windowHeight)) ? GL_NEAREST : GL_LINEAR);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		return;
+	}
+
+	// -- multisampled window, draw it instead --
+	if (_copyProgram == nullptr)
+		_copyProgram = ResourceManager::LoadShaderProgram("screenCopyProgram", copyVertPath, copyFragPath);
+
+	DrawToWindow(_copyProgram);
+}
+
+void RenderTarget::CopyToWindowFXAA(int windowWidth, int windowHeight)
+{
+	if (_samples > 0)
+		throw std::exception("Tried to use FXAA on a multisampled render target");
+
+	BindWindow(windowWidth, windowHeight);
+
+	if (_fxaaProgram == nullptr)
+		_fxaaProgram = ResourceManager::LoadShaderProgram("fxaaProgram", copyVertPath, fxaaFragPath);
+
+	_fxaaProgram->Use();
+	// FXAA steps one texel at a time looking for the ends of edges
+	_fxaaProgram->SetVector2f("inverseScreenSize", glm::vec2(1.0f / _width, 1.0f / _height));
+
+	DrawToWindow(_fxaaProgram);
+}
+
+int RenderTarget::GetMaxSize()
+{
+	// the smaller of the two limits is what a render target can actually be
+	GLint maxTextureSize = 0;
+	GLint maxRenderbufferSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbufferSize);
+	return std::min(maxTextureSize, maxRenderbufferSize);
+}
+
+int RenderTarget::GetMaxSamples()
+{
+	// it never changes so only ask the driver once
+	static GLint maxSamples = -1;
+	if (maxSamples == -1)
+		glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+	return maxSamples;
+}
+
+void RenderTarget::DrawToWindow(ShaderProgram* program)
+{
+	if (_copyVAO == 0)
+		glGenVertexArrays(1, &_copyVAO);
+
+	program->Use();
+	program->SetInt("screenTexture", 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, colorTextureID);
+
+	// straight copy, nothing to blend with or depth test against
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+
+	glBindVertexArray(_copyVAO);
+	// one triangle that covers the whole screen, the vertex shader makes the positions from gl_VertexID
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+
+	// back to what main sets up
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+}
+
+void RenderTarget::AllocateStorage()
+{
+	// colour is 8 bits per channel with alpha so anything drawn into it can be blended back over the scene
+	if (_samples > 0)
+	{
+		glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbufferID);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, _samples, GL_RGBA8, _width, _height);
+	}
+	else
+	{
+		glBindTexture(GL_TEXTURE_2D, colorTextureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	// depth has to have the same number of samples as the colour
+	glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbufferID);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, _samples, GL_DEPTH24_STENCIL8, _width, _height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <glad/glad.h>
+#include <memory>
+#include "ShaderProgram.h"
+
+// An offscreen framebuffer (FBO) that can be drawn into instead of the window. 
+// The colour goes into a texture (RGBA) so it can be drawn back onto the screen later and there is a depth renderbuffer so zIndexes still work when drawing into it.
+// A multisampled render target (MSAA) has its colour in a multisampled renderbuffer instead, since it can't be read as a normal texture. It gets resolved
+// (every pixel's samples averaged) when it's blitted onto the window
+class RenderTarget
+{
+public:
+	// Create a render target with a size in pixels. Needs a current GL context.
+	// samples is how many samples each pixel has for MSAA, 0 for a normal render target. It's capped to GetMaxSamples
+	RenderTarget(int width, int height, int samples = 0);
+	~RenderTarget();
+
+	// the GL objects are owned by the render target so it can't be copied
+	RenderTarget(const RenderTarget&) = delete;
+	RenderTarget& operator=(const RenderTarget&) = delete;
+
+	// ID of the framebuffer object
+	unsigned int ID = 0;
+	// ID of the texture that colour is drawn into, 0 if it's multisampled
+	unsigned int colorTextureID = 0;
+	// ID of the multisampled colour renderbuffer, 0 if it isn't multisampled
+	unsigned int colorRenderbufferID = 0;
+	// ID of the depth renderbuffer
+	unsigned int depthRenderbufferID = 0;
+
+	// size in pixels
+	int GetWidth();
+	int GetHeight();
+
+	// how many samples each pixel has, 0 if it isn't multisampled
+	int GetSamples();
+
+	// roughly how many bytes of gpu memory the colour and depth take up (drivers can pad it or compress it)
+	size_t GetMemoryUsage();
+
+	// changes the size of the render target. Anything drawn into it is lost. Does nothing if the size is the same
+	void Resize(int width, int height);
+
+	// binds the framebuffer and sets the viewport to cover all of it
+	void Bind();
+
+	// binds the window's framebuffer again and sets the viewport to the given window size
+	static void BindWindow(int windowWidth, int windowHeight);
+
+	// Copies the colour over the whole window (stretched if the sizes are different). Leaves the window's framebuffer bound.
+	// Uses glBlitFramebuffer unless the window is multisampled (you can't blit into that) in which case it draws a screen covering triangle.
+	// A multisampled render target is resolved by the blit (the window can't be multisampled). A multisampled blit can't stretch, so if the sizes are
+	// different it's resolved into another render target first
+	void CopyToWindow(int windowWidth, int windowHeight);
+
+	// Draws the colour over the whole window with FXAA, which smooths edges by blurring along them where the brightness changes sharply.
+	// Much cheaper than MSAA (one pass over the screen instead of every pixel being drawn several times) but it can blur fine details like small text.
+	// Leaves the window's framebuffer bound. Can't be used on a multisampled render target
+	void CopyToWindowFXAA(int windowWidth, int windowHeight);
+
+	// returns the biggest width/height a render target can be on this driver
+	static int GetMaxSize();
+
+	// returns the most samples a multisampled render target can have on this driver
+	static int GetMaxSamples();
+
+private:
+	// default vertex sahader for copying to a multisampled window
+	const char* copyVertPath = "VertexShaders/ScreenCopy.vert";
+	// default frag sahader for copying to a multisampled window
+	const char* copyFragPath = "FragmentShaders/ScreenCopy.frag";
+	// frag shader for FXAA, uses the same vertex shader as the copy
+	const char* fxaaFragPath = "FragmentShaders/FXAA.frag";
+	// program and empty VAO (core profile needs one bound to draw) shared by every render target
+	static ShaderProgram* _copyProgram;
+	static ShaderProgram* _fxaaProgram;
+	static unsigned int _copyVAO;
+
+	int _width = 0;
+	int _height = 0;
+	int _samples = 0;
+
+	// what a multisampled render target is resolved into before being stretched onto the window, made the first time it's needed
+	std::unique_ptr<RenderTarget> _resolveTarget;
+
+	// draws a triangle covering the whole window with the colour texture bound, using program. The window has to be bound first (see BindWindow)
+	void DrawToWindow(ShaderProgram* program);
+
+	// (re)creates the texture and renderbuffer storage at the current size
+	void AllocateStorage();
+};
+
@@ -1,7 +1,13 @@
 #include "ResourceManager.h"
+#include "CompressedTexture.h"
+#include "QOIImage.h"
 
 #include <fstream>
 #include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <glfw3.h>
 
 // store current state of warnings
 #pragma warning ( push )
@@ -18,9 +24,21 @@
 
 std::map<std::string, ShaderProgram> ResourceManager::shaderPrograms;
 std::map<std::string, Texture2D> ResourceManager::textures;
+TextureAtlas ResourceManager::textureAtlas;
+std::map<std::string, TextureArray> ResourceManager::textureArrays;
+std::map<std::string, Font> ResourceManager::fonts;
+double ResourceManager::asyncUploadTimeBudget = 0.002;
+size_t ResourceManager::asyncUploadChunkSize = 1024 * 1024;
+WorkerPool* ResourceManager::_workerPool = nullptr;
+std::mutex ResourceManager::_asyncMutex;
+std::deque<std::shared_ptr<ResourceManager::AsyncTextureLoad>> ResourceManager::_decodedLoads;
+std::shared_ptr<ResourceManager::AsyncTextureLoad> ResourceManager::_currentUpload;
+unsigned int ResourceManager::_pendingAsyncLoads = 0;
+std::vector<ResourceManager::PendingShaderProgram> ResourceManager::_pendingShaderPrograms;
+unsigned int ResourceManager::_placeholderTextureID = 0;
 
 
-ShaderProgram* ResourceManager::LoadShaderProgram(std::string name, const char* vShaderFile, const char* fShaderFile)
+ShaderProgram* ResourceManager::LoadShaderProgram(std::string name, const char* vShaderFile, const char* fShaderFile, ShaderReadyCallback onReady)
 {
 	// change the name to one that is available in map. Adds "1" until there is an available name
 	name = GetValidNameForMap<ShaderProgram>(name, shaderPrograms);
@@ -30,7 +48,54 @@ ShaderProgram* ResourceManager::LoadShaderProgram(std::string name, const char*
 	shaderPrograms.insert(std::pair<std::string, ShaderProgram>(name, program) );
 	// return pointer to program (at is used instead of [] because it requires a default constructor) 
 	// program will go out of scope if don't return pointer which is a big no no
-	return &shaderPrograms.at(name);
+	ShaderProgram* storedProgram = &shaderPrograms.at(name);
+
+	// keep checking on it until it's done. Map pointers don't change when other things are added so it can be stored
+	_pendingShaderPrograms.push_back(PendingShaderProgram{ storedProgram, onReady });
+
+	return storedProgram;
+}
+
+ShaderProgram* ResourceManager::LoadFeedbackShaderProgram(std::string name, const char* vShaderFile, const std::vector<std::string>& feedbackVaryings,
+	ShaderReadyCallback onReady)
+{
+	// same as LoadShaderProgram, just with no fragment shader
+	name = GetValidNameForMap<ShaderProgram>(name, shaderPrograms);
+	ShaderProgram program = loadShaderProgramFromFiles(name, vShaderFile, nullptr, feedbackVaryings);
+	shaderPrograms.insert(std::pair<std::string, ShaderProgram>(name, program));
+	ShaderProgram* storedProgram = &shaderPrograms.at(name);
+	_pendingShaderPrograms.push_back(PendingShaderProgram{ storedProgram, onReady });
+	return storedProgram;
+}
+
+void ResourceManager::UpdatePendingShaderPrograms()
+{
+	for (size_t i = 0; i < _pendingShaderPrograms.size();)
+	{
+		PendingShaderProgram pending = _pendingShaderPrograms[i];
+		// without parallel compile this waits for it, but everything has been submitted by now so the driver has had a head start
+		if (!pending.program->IsReady())
+		{
+			i++;
+			continue;
+		}
+
+		_pendingShaderPrograms.erase(_pendingShaderPrograms.begin() + i);
+		if (pending.onReady)
+			pending.onReady(pending.program);
+	}
+}
+
+WorkerPool* ResourceManager::GetWorkerPool()
+{
+	if (_workerPool == nullptr)
+		_workerPool = new WorkerPool();
+	return _workerPool;
+}
+
+unsigned int ResourceManager::GetPendingShaderPrograms()
+{
+	return (unsigned int)_pendingShaderPrograms.size();
 }
 
 ShaderProgram* ResourceManager::GetShader(std::string name)
@@ -43,12 +108,12 @@ ShaderProgram* ResourceManager::GetShader(std::string name)
 		return nullptr;
 }
 
-Texture2D* ResourceManager::LoadTexture(std::string name, const char* file, bool alpha)
+Texture2D* ResourceManager::LoadTexture(std::string name, const char* file, bool alpha, bool useAtlas)
 {
 	// change the name to one that is available in map. Adds "1" until there is an available name
 	name = GetValidNameForMap<Texture2D>(name, textures);
 	// create new texture
-	Texture2D texture = loadTextureFromFile(name, file, alpha);
+	Texture2D texture = loadTextureFromFile(name, file, alpha, useAtlas);
 	// add to map
 	textures.insert(std::pair<std::string, Texture2D>(name, texture));
 	// return pointer to texture (at is used instead of [] because it requires a default constructor) 
@@ -56,6 +121,187 @@ Texture2D* ResourceManager::LoadTexture(std::string name, const char* file, bool
 	return &textures.at(name);
 }
 
+Texture2D* ResourceManager::LoadTextureAsync(std::string name, const char* file, bool alpha, TextureLoadedCallback onLoaded)
+{
+	// change the name to one that is available in map. Adds "1" until there is an available name
+	name = GetValidNameForMap<Texture2D>(name, textures);
+
+	// create the texture straight away so there's something to hand back
+	Texture2D texture = Texture2D(name);
+	if (alpha)
+	{
+		texture.internalFormat = GL_RGBA;
+		texture.imageFormat = GL_RGBA;
+	}
+
+	std::shared_ptr<AsyncTextureLoad> load = std::make_shared<AsyncTextureLoad>();
+	load->textureName = name;
+	load->filePath = file;
+	load->alpha = alpha;
+	load->onLoaded = onLoaded;
+	// the texture's own ID is where the image goes, it shows the placeholder until then
+	load->textureID = texture.ID;
+	texture.ID = GetPlaceholderTexture();
+	texture.width = 2;
+	texture.height = 2;
+	texture.isLoaded = false;
+
+	textures.insert(std::pair<std::string, Texture2D>(name, texture));
+
+	_pendingAsyncLoads++;
+
+	// decode on a worker thread, the rest needs GL so it's left for UpdateAsyncLoads
+	GetWorkerPool()->Submit([load]()
+		{
+			int numChannels;
+			// every pixel gets exactly the channels the texture format says, so the upload can't be given the wrong amount
+			load->imageData = loadImageFromFile(load->filePath.c_str(), load->width, load->height, numChannels, load->alpha ? 4 : 3);
+
+			std::lock_guard<std::mutex> lock(_asyncMutex);
+			_decodedLoads.push_back(load);
+		});
+
+	return &textures.at(name);
+}
+
+void ResourceManager::UpdateAsyncLoads()
+{
+	// nothing loading
+	if (_pendingAsyncLoads == 0)
+		return;
+
+	double startTime = glfwGetTime();
+	do
+	{
+		// get the next decoded image if there isn't one being uploaded
+		if (_currentUpload == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(_asyncMutex);
+			// nothing ready yet
+			if (_decodedLoads.empty())
+				return;
+			_currentUpload = _decodedLoads.front();
+			_decodedLoads.pop_front();
+		}
+
+		std::shared_ptr<AsyncTextureLoad> load = _currentUpload;
+		Texture2D* texture = GetTexture(load->textureName);
+
+		// couldn't decode it (or the texture was removed), it stays as the placeholder
+		if (load->imageData == nullptr || texture == nullptr)
+		{
+			std::cout << "ERROR: Failed to load texture " << load->filePath << " asynchronously" << std::endl;
+			glDeleteTextures(1, &load->textureID);
+			if (load->imageData != nullptr)
+				stbi_image_free(load->imageData);
+			_currentUpload = nullptr;
+			_pendingAsyncLoads--;
+			if (load->onLoaded)
+				load->onLoaded(nullptr);
+			continue;
+		}
+
+		// finished uploading, swap the real texture in
+		if (UploadAsyncChunk(*load, *texture))
+		{
+			stbi_image_free(load->imageData);
+			load->imageData = nullptr;
+			texture->ID = load->textureID;
+			texture->width = load->width;
+			texture->height = load->height;
+			texture->isLoaded = true;
+			_currentUpload = nullptr;
+			_pendingAsyncLoads--;
+			if (load->onLoaded)
+				load->onLoaded(texture);
+		}
+	} while (_pendingAsyncLoads > 0 && glfwGetTime() - startTime < asyncUploadTimeBudget);
+}
+
+unsigned int ResourceManager::GetPendingAsyncLoads()
+{
+	return _pendingAsyncLoads;
+}
+
+bool ResourceManager::UploadAsyncChunk(AsyncTextureLoad& load, Texture2D& texture)
+{
+	int channels = load.alpha ? 4 : 3;
+	size_t rowSize = (size_t)load.width * channels;
+
+	// first chunk, make space for the whole image and the pixel buffer it goes through
+	if (load.pixelBuffer == 0)
+	{
+		glBindTexture(GL_TEXTURE_2D, load.textureID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture.wrapS);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture.wrapT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.filterMin);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.filterMax);
+		glTexImage2D(GL_TEXTURE_2D, 0, texture.internalFormat, load.width, load.height, 0, texture.imageFormat, GL_UNSIGNED_BYTE, nullptr);
+		glGenBuffers(1, &load.pixelBuffer);
+	}
+
+	// as many whole rows as fit in a chunk
+	int rows = (int)std::max((size_t)1, asyncUploadChunkSize / rowSize);
+	rows = std::min(rows, load.height - load.uploadedRows);
+	size_t chunkSize = rowSize * rows;
+
+	// Copy the rows into the pixel buffer then upload from it. With a pixel buffer bound glTexSubImage2D reads from the buffer instead
+	// of cpu memory, so the driver can do the copy to the texture in the background instead of making the render thread wait
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, load.pixelBuffer);
+	// new storage each chunk (orphaning) so it doesn't have to wait for the last chunk's copy to finish
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, chunkSize, nullptr, GL_STREAM_DRAW);
+	void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, chunkSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (mapped != nullptr)
+	{
+		memcpy(mapped, load.imageData + rowSize * load.uploadedRows, chunkSize);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+		glBindTexture(GL_TEXTURE_2D, load.textureID);
+		// rgb rows aren't always a multiple of 4 bytes long
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		// the last param is an offset into the pixel buffer now, not a pointer
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, load.uploadedRows, load.width, rows, texture.imageFormat, GL_UNSIGNED_BYTE, (void*)0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		load.uploadedRows += rows;
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	bool finished = load.uploadedRows >= load.height;
+	if (finished)
+	{
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glDeleteBuffers(1, &load.pixelBuffer);
+		load.pixelBuffer = 0;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return finished;
+}
+
+unsigned int ResourceManager::GetPlaceholderTexture()
+{
+	if (_placeholderTextureID != 0)
+		return _placeholderTextureID;
+
+	// 2x2 grey checkerboard
+	unsigned char pixels[] = {
+		200, 200, 200, 255,   120, 120, 120, 255,
+		120, 120, 120, 255,   200, 200, 200, 255
+	};
+
+	glGenTextures(1, &_placeholderTextureID);
+	glBindTexture(GL_TEXTURE_2D, _placeholderTextureID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// nearest so the squares stay sharp
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return _placeholderTextureID;
+}
+
 Texture2D* ResourceManager::GetTexture(std::string name)
 {
 	// return pointer if found, else not because .at() will throw exception
@@ -66,23 +312,150 @@ Texture2D* ResourceManager::GetTexture(std::string name)
 		return nullptr;
 }
 
+TextureArray* ResourceManager::LoadTextureArray(std::string name, const std::vector<std::string>& files, bool alpha)
+{
+	// change the name to one that is available in map. Adds "1" until there is an available name
+	name = GetValidNameForMap<TextureArray>(name, textureArrays);
+	// create new texture array
+	TextureArray textureArray = loadTextureArrayFromFiles(name, files, alpha);
+	// add to map
+	textureArrays.insert(std::pair<std::string, TextureArray>(name, textureArray));
+	return &textureArrays.at(name);
+}
+
+TextureArray* ResourceManager::LoadTextureArray(std::string name, const char* directory, bool alpha)
+{
+	std::vector<std::string> files;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+	{
+		if (!entry.is_regular_file())
+			continue;
+
+		// only the image types stb_image can load, plus QOI which loadImageFromFile decodes itself
+		std::string extension = entry.path().extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga" || extension == ".qoi")
+			files.push_back(entry.path().string());
+	}
+
+	if (files.empty())
+		throw std::exception("Failed to load texture array, no images in directory");
+
+	// directory order isn't guaranteed so sort them, that way the layers are always in the same order
+	std::sort(files.begin(), files.end());
+	return LoadTextureArray(name, files, alpha);
+}
+
+TextureArray* ResourceManager::GetTextureArray(std::string name)
+{
+	// return pointer if found, else not because .at() will throw exception
+	if (ItemExistsInMap<TextureArray>(name, textureArrays))
+		return &textureArrays.at(name);
+	else
+		// not found
+		return nullptr;
+}
+
+Font* ResourceManager::LoadFont(std::string name, const char* file)
+{
+	// change the name to one that is available in map. Adds "1" until there is an available name
+	name = GetValidNameForMap<Font>(name, fonts);
+
+	// baked fonts start with their own header, anything else is treated as a ttf
+	unsigned char header[4] = {};
+	std::ifstream fileStream(file, std::ios::binary);
+	if (!fileStream)
+		throw std::exception("Failed to open font file");
+	fileStream.read((char*)header, sizeof(header));
+	size_t headerSize = (size_t)fileStream.gcount();
+	fileStream.close();
+
+	// fonts can't be copied (their layouts point at their glyphs) so it's made in the map
+	Font* font = &fonts.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple(name)).first->second;
+	try
+	{
+		if (Font::IsBakedFile(header, headerSize))
+			font->LoadBaked(file);
+		else
+			font->LoadTTF(file);
+	}
+	catch (...)
+	{
+		// the atlas might have been made before it failed
+		unsigned int fontTextureID = font->GetTextureID();
+		if (fontTextureID != 0)
+			glDeleteTextures(1, &fontTextureID);
+		fonts.erase(name);
+		throw;
+	}
+	return font;
+}
+
+Font* ResourceManager::GetFont(std::string name)
+{
+	// return pointer if found, else not because .at() will throw exception
+	if (ItemExistsInMap<Font>(name, fonts))
+		return &fonts.at(name);
+	else
+		// not found
+		return nullptr;
+}
+
 void ResourceManager::Clear()
 {
+	// stop the workers first (waits for any decoding to finish) so nothing gets added while clearing
+	delete _workerPool;
+	_workerPool = nullptr;
+	// throw away anything that hasn't finished loading
+	if (_currentUpload != nullptr)
+		_decodedLoads.push_back(_currentUpload);
+	for (std::shared_ptr<AsyncTextureLoad> load : _decodedLoads)
+	{
+		if (load->imageData != nullptr)
+			stbi_image_free(load->imageData);
+		glDeleteTextures(1, &load->textureID);
+		glDeleteBuffers(1, &load->pixelBuffer);
+	}
+	_decodedLoads.clear();
+	_currentUpload = nullptr;
+	_pendingAsyncLoads = 0;
+
+	// nothing to wait for once they're gone
+	_pendingShaderPrograms.clear();
+
 	// TODO: check if objects get destroyed without using delete
-	for (std::pair<std::string, ShaderProgram> iterator : shaderPrograms)
+	for (std::pair<const std::string, ShaderProgram>& iterator : shaderPrograms)
+	{
+		// deletes its shaders if it's still compiling
+		iterator.second.Finish();
 		// delete the program 
 		glDeleteProgram(iterator.second.ID);
+	}
 	for (std::pair<std::string, Texture2D> iterator : textures)
-		// delete the texture
+		// delete the texture, atlas pages are shared so the atlas deletes those. Textures still loading are showing the placeholder
+		if (!iterator.second.isInAtlas && iterator.second.isLoaded)
+			glDeleteTextures(1, &iterator.second.ID);
+	textureAtlas.Clear();
+	for (std::pair<std::string, TextureArray> iterator : textureArrays)
 		glDeleteTextures(1, &iterator.second.ID);
+	for (std::pair<const std::string, Font>& iterator : fonts)
+	{
+		unsigned int fontTextureID = iterator.second.GetTextureID();
+		glDeleteTextures(1, &fontTextureID);
+	}
 	// erase all map elements
 	shaderPrograms.clear();
 	textures.clear();
+	textureArrays.clear();
+	fonts.clear();
+	glDeleteTextures(1, &_placeholderTextureID);
+	_placeholderTextureID = 0;
 
 
 }
 
-ShaderProgram ResourceManager::loadShaderProgramFromFiles(std::string name, const char* vertShaderFilePath, const char* fragShaderFilePath)
+ShaderProgram ResourceManager::loadShaderProgramFromFiles(std::string name, const char* vertShaderFilePath, const char* fragShaderFilePath,
+	const std::vector<std::string>& feedbackVaryings)
 {
 	// 1. retrieve the vertex/fragment source code from filePath
 	std::string vertexCode;
@@ -96,18 +469,23 @@ ShaderProgram ResourceManager::loadShaderProgramFromFiles(std::string name, cons
 	{
 		// open files for reading
 		vShaderFile.open(vertShaderFilePath);
-		fShaderFile.open(fragShaderFilePath);
 		// string streams that the file stream writes to
 		std::stringstream vShaderStream, fShaderStream;
 		// read file's buffer contents into streams
 		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
 		// close file handlers
 		vShaderFile.close();
-		fShaderFile.close();
 		// convert stream into string
 		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+
+		// transform feedback programs don't have a fragment shader
+		if (fragShaderFilePath != nullptr)
+		{
+			fShaderFile.open(fragShaderFilePath);
+			fShaderStream << fShaderFile.rdbuf();
+			fShaderFile.close();
+			fragmentCode = fShaderStream.str();
+		}
 	}
 	// on error reading file
 	catch (std::exception e)
@@ -116,17 +494,18 @@ ShaderProgram ResourceManager::loadShaderProgramFromFiles(std::string name, cons
 	}
 	// convert shaders into char arrays
 	const char* vertShaderCode = vertexCode.c_str();
-	const char* fragShaderCode = fragmentCode.c_str();
+	const char* fragShaderCode = fragShaderFilePath != nullptr ? fragmentCode.c_str() : nullptr;
 
 	// create shader program 
 	ShaderProgram program = ShaderProgram(name);
-	// compile the source code
-	program.Compile(vertShaderCode, fragShaderCode);
+	program.feedbackVaryings = feedbackVaryings;
+	// start compiling the source code, it's checked on later so the driver can compile other programs at the same time
+	program.Submit(vertShaderCode, fragShaderCode);
 	// return created program
 	return program;
 }
 
-Texture2D ResourceManager::loadTextureFromFile(std::string name, const char* filePath, bool alpha)
+Texture2D ResourceManager::loadTextureFromFile(std::string name, const char* filePath, bool alpha, bool useAtlas)
 {
 	// create a texture object
 	Texture2D texture = Texture2D(name);
@@ -137,17 +516,39 @@ Texture2D ResourceManager::loadTextureFromFile(std::string name, const char* fil
 		texture.imageFormat = GL_RGBA;
 	}
 
+	// -- KTX2 and DDS files are already block compressed, they go to the gpu as is and never into the atlas --
+	unsigned char header[12] = {};
+	std::ifstream headerStream(filePath, std::ios::binary);
+	headerStream.read((char*)header, sizeof(header));
+	if (CompressedTexture::IsContainer(header, (size_t)headerStream.gcount()))
+	{
+		// the file decides whether there's alpha
+		CompressedTexture::Upload(CompressedTexture::ReadFile(filePath), texture);
+		return texture;
+	}
+
 	// width and height of image along with number of colour channels 
 	int width, height, numChannels;
-	stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis. It starts with y on the top which is not cool cos opengl is y on bottom
-
-	// load in the image file. Idk what the 0 is for
-	unsigned char* imageData = stbi_load(filePath, &width, &height, &numChannels, 0);
+	// load in the image file. The 0 means keep however many channels the file has
+	unsigned char* imageData = loadImageFromFile(filePath, width, height, numChannels, 0);
 
 	if (imageData)
 	{
-		// generate the texture
-		texture.Generate(width, height, imageData);
+		TextureAtlas::Region region;
+		// small enough to share a page with other textures
+		if (useAtlas && textureAtlas.Accepts(width, height) && textureAtlas.Add(imageData, width, height, numChannels, region))
+		{
+			// doesn't need the texture it made for itself
+			glDeleteTextures(1, &texture.ID);
+			texture.ID = region.textureID;
+			texture.width = width;
+			texture.height = height;
+			texture.isInAtlas = true;
+			texture.uvRect = region.uvRect;
+		}
+		else
+			// generate the texture
+			texture.Generate(width, height, imageData);
 	}
 	else
 	{
@@ -159,6 +560,80 @@ Texture2D ResourceManager::loadTextureFromFile(std::string name, const char* fil
 	return texture;
 }
 
+TextureArray ResourceManager::loadTextureArrayFromFiles(std::string name, const std::vector<std::string>& files, bool alpha)
+{
+	if (files.empty())
+		throw std::exception("Failed to load texture array, no files given");
+
+	// create a texture array object
+	TextureArray textureArray = TextureArray(name);
+	// set appropriate format if alpha channel is active
+	if (alpha)
+	{
+		textureArray.internalFormat = GL_RGBA;
+		textureArray.imageFormat = GL_RGBA;
+	}
+	// every layer has to have the same amount of channels so make stb_image give this many
+	int channels = alpha ? 4 : 3;
+
+	std::vector<unsigned char*> layers;
+	int width = 0, height = 0;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		int layerWidth, layerHeight, numChannels;
+		unsigned char* imageData = loadImageFromFile(files[i].c_str(), layerWidth, layerHeight, numChannels, channels);
+
+		// the first image decides the size
+		if (i == 0)
+		{
+			width = layerWidth;
+			height = layerHeight;
+		}
+
+		if (!imageData || layerWidth != width || layerHeight != height)
+		{
+			// free everything loaded so far before throwing
+			if (imageData)
+				stbi_image_free(imageData);
+			for (unsigned char* layer : layers)
+				stbi_image_free(layer);
+
+			if (!imageData)
+				throw std::exception("Failed to load texture array, couldn't load an image");
+			throw std::exception("Failed to load texture array, every image has to be the same size");
+		}
+
+		layers.push_back(imageData);
+		// layer names are the file name without the folder or extension
+		textureArray.layerNames.push_back(std::filesystem::path(files[i]).stem().string());
+	}
+
+	// generate the texture array
+	textureArray.Generate(width, height, (unsigned int)layers.size(), layers);
+
+	// no longer need image data
+	for (unsigned char* layer : layers)
+		stbi_image_free(layer);
+
+	return textureArray;
+}
+
+unsigned char* ResourceManager::loadImageFromFile(const char* filePath, int& width, int& height, int& numChannels, int desiredChannels)
+{
+	// -- QOI files decode a lot faster with their own decoder, stb_image doesn't read them anyway --
+	unsigned char header[4] = {};
+	std::ifstream headerStream(filePath, std::ios::binary);
+	headerStream.read((char*)header, sizeof(header));
+	if (QOIImage::IsQOI(header, (size_t)headerStream.gcount()))
+		// only does 3 or 4 channels, which is all a QOI file can have anyway
+		return QOIImage::Load(filePath, width, height, numChannels, desiredChannels, true);
+
+	// tell stb_image.h to flip loaded texture's on the y-axis. It starts with y on the top which is not cool cos opengl is y on bottom.
+	// The flip setting is global by default, this version only affects the current thread so workers can use it too
+	stbi_set_flip_vertically_on_load_thread(true);
+	return stbi_load(filePath, &width, &height, &numChannels, desiredChannels);
+}
+
 template<typename T>
 bool ResourceManager::ItemExistsInMap(std::string name, std::map<std::string, T>& inputMap)
 {
@@ -3,6 +3,15 @@
 #include <map>
 #include "ShaderProgram.h"
 #include "Texture2D.h"
+#include "TextureAtlas.h"
+#include "TextureArray.h"
+#include "Font.h"
+#include <vector>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include "WorkerPool.h"
 
 // based off
 // https://learnopengl.com/code_viewer_gh.php?code=src/7.in_practice/3.2d_game/0.full_source/resource_manager.h
@@ -14,19 +23,112 @@ public:
     static std::map<std::string, ShaderProgram> shaderPrograms;
     // map of all textures in file indexed by name
     static std::map<std::string, Texture2D> textures;
+    // Called on the render thread once a shader program has finished compiling and linking (check IsLinked for whether it worked)
+    typedef std::function<void(ShaderProgram*)> ShaderReadyCallback;
     // Loads (and stores in map) a shader program under specified name from vertex and fragment shader files. 
     // "1" is added to name if it already exists 
-    static ShaderProgram* LoadShaderProgram(std::string name, const char* vertShaderFilePath, const char* fragShaderFilePath);
+    // It's only submitted, not waited for (see ShaderProgram::Submit), so load every program before using any. Using it waits if it isn't done yet.
+    // onReady is called by UpdatePendingShaderPrograms once it's done
+    static ShaderProgram* LoadShaderProgram(std::string name, const char* vertShaderFilePath, const char* fragShaderFilePath, ShaderReadyCallback onReady = nullptr);
+    // Same as LoadShaderProgram but for a program that only has a vertex shader and writes feedbackVaryings into transform feedback buffers
+    // instead of drawing (see ShaderProgram::feedbackVaryings)
+    static ShaderProgram* LoadFeedbackShaderProgram(std::string name, const char* vertShaderFilePath, const std::vector<std::string>& feedbackVaryings,
+        ShaderReadyCallback onReady = nullptr);
+    // Finishes programs that are done compiling and calls their callbacks, never waits. The scene calls it every frame
+    static void UpdatePendingShaderPrograms();
+    // how many loaded programs haven't finished compiling
+    static unsigned int GetPendingShaderPrograms();
     // retrieves a stored sader as pointer. Nullptr if not found
     static ShaderProgram* GetShader(std::string name);
+    // Small textures are packed into shared pages so sprites using them can be batched together. Change its settings before loading textures
+    static TextureAtlas textureAtlas;
     // loads (and stores) a texture from file under specified name. 
     // "1" is added to name if it already exists
-    static Texture2D* LoadTexture(std::string name, const char* file, bool alpha);
+    // Images no bigger than textureAtlas.maxImageSize go into the atlas unless useAtlas is false (e.g. if it needs to repeat or have mipmaps)
+    // KTX2 and DDS files (see CompressedTexture) are loaded block compressed with their mipmaps, alpha and useAtlas are ignored for them
+    static Texture2D* LoadTexture(std::string name, const char* file, bool alpha, bool useAtlas = true);
+    // Called on the render thread when a texture loaded with LoadTextureAsync is ready. Given nullptr if the image couldn't be loaded
+    typedef std::function<void(Texture2D*)> TextureLoadedCallback;
+    // Starts loading a texture in the background and returns it straight away so it can be used right now. It shows a placeholder
+    // (checkerboard) until it's done and then switches over by itself, isLoaded says which. The image is decoded on a worker thread then
+    // uploaded a bit at a time by UpdateAsyncLoads. Async textures always get their own texture, they aren't put in the atlas
+    static Texture2D* LoadTextureAsync(std::string name, const char* file, bool alpha, TextureLoadedCallback onLoaded = nullptr);
+    // Uploads decoded async textures for up to asyncUploadTimeBudget seconds (at least one chunk). The scene calls it every frame
+    static void UpdateAsyncLoads();
+    // Threads shared by anything that wants work done off the render thread (decoding images, triangulating polygons etc.), made the first time it's asked for.
+    // Jobs can't use GL, anything that needs it has to be handed back to the render thread
+    static WorkerPool* GetWorkerPool();
+    // how many async textures haven't finished loading
+    static unsigned int GetPendingAsyncLoads();
+    // seconds per frame that UpdateAsyncLoads can spend uploading
+    static double asyncUploadTimeBudget;
+    // how many bytes of an image are uploaded at once
+    static size_t asyncUploadChunkSize;
     // retrieves a stored texture as pointer. Nullptr if not found
     static Texture2D* GetTexture(std::string name);
+    // map of all texture arrays indexed by name
+    static std::map<std::string, TextureArray> textureArrays;
+    // Loads (and stores) a texture array under specified name, with one layer per file in the order given. Every image has to be the same size.
+    // "1" is added to name if it already exists
+    static TextureArray* LoadTextureArray(std::string name, const std::vector<std::string>& files, bool alpha);
+    // Same as above but uses every image file (png, jpg, jpeg, bmp, tga, qoi) in a directory, sorted by file name
+    static TextureArray* LoadTextureArray(std::string name, const char* directory, bool alpha);
+    // retrieves a stored texture array as pointer. Nullptr if not found
+    static TextureArray* GetTextureArray(std::string name);
+    // map of all fonts indexed by name
+    static std::map<std::string, Font> fonts;
+    // Loads (and stores) a font under specified name, either a TrueType file or one baked with Font::SaveBaked (worked out from the file's header).
+    // "1" is added to name if it already exists
+    static Font* LoadFont(std::string name, const char* file);
+    // retrieves a stored font as pointer. Nullptr if not found
+    static Font* GetFont(std::string name);
     // properly de-allocates all loaded resources
     static void Clear();
 private:
+    // a texture that is loading in the background
+    struct AsyncTextureLoad {
+        // name of the texture in the map
+        std::string textureName;
+        std::string filePath;
+        bool alpha;
+        TextureLoadedCallback onLoaded;
+        // decoded image, nullptr until the worker is done (and after if it failed)
+        unsigned char* imageData = nullptr;
+        int width = 0;
+        int height = 0;
+        // the texture it will end up in (swapped in for the placeholder once it's uploaded)
+        unsigned int textureID = 0;
+        // pixel buffer object the rows are copied into on their way to the texture
+        unsigned int pixelBuffer = 0;
+        // how many rows have been uploaded
+        int uploadedRows = 0;
+    };
+
+    // a shader program that was submitted but hasn't finished yet
+    struct PendingShaderProgram {
+        ShaderProgram* program;
+        ShaderReadyCallback onReady;
+    };
+    // programs UpdatePendingShaderPrograms is waiting on
+    static std::vector<PendingShaderProgram> _pendingShaderPrograms;
+
+    // worker threads (see GetWorkerPool), made the first time they are needed
+    static WorkerPool* _workerPool;
+    // guards _decodedLoads, which the workers add to
+    static std::mutex _asyncMutex;
+    // loads that finished decoding and are waiting to be uploaded, in order
+    static std::deque<std::shared_ptr<AsyncTextureLoad>> _decodedLoads;
+    // the load currently being uploaded (only touched on the render thread)
+    static std::shared_ptr<AsyncTextureLoad> _currentUpload;
+    // how many async loads haven't finished
+    static unsigned int _pendingAsyncLoads;
+    // checkerboard texture shown while async textures load
+    static unsigned int _placeholderTextureID;
+
+    // uploads the next chunk of rows of the current upload, returns true once the whole image is uploaded
+    static bool UploadAsyncChunk(AsyncTextureLoad& load, Texture2D& texture);
+    // creates the placeholder texture if it hasn't been already
+    static unsigned int GetPlaceholderTexture();
     // whether an item of specific name exists in a map (passed as pointer) is a template in case more maps are added
     template <typename T>
     static bool ItemExistsInMap(std::string name, std::map<std::string, T>& inputMap );
@@ -36,8 +138,14 @@ private:
 
     // private constructor, that is we do not want any actual resource manager objects. Its members and functions should be publicly available (static).
     ResourceManager();
-    // loads and generates a shader progran from shader files, with specified name
-    static ShaderProgram loadShaderProgramFromFiles(std::string name, const char* vShaderFile, const char* fShaderFile);
+    // loads and generates a shader progran from shader files, with specified name. fShaderFile can be nullptr for a transform feedback program
+    static ShaderProgram loadShaderProgramFromFiles(std::string name, const char* vShaderFile, const char* fShaderFile,
+        const std::vector<std::string>& feedbackVaryings = std::vector<std::string>());
     // loads a single texture from file with specified name
-    static Texture2D loadTextureFromFile(std::string name, const char* filePath, bool alpha);
+    static Texture2D loadTextureFromFile(std::string name, const char* filePath, bool alpha, bool useAtlas);
+    // loads a texture array with one layer per file, with specified name
+    static TextureArray loadTextureArrayFromFiles(std::string name, const std::vector<std::string>& files, bool alpha);
+    // Decodes an image file (bottom row first) with stb_image, or QOIImage if it starts with the QOI header. desiredChannels works like stbi_load's.
+    // Free it with stbi_image_free. Safe to call from worker threads
+    static unsigned char* loadImageFromFile(const char* filePath, int& width, int& height, int& numChannels, int desiredChannels);
 };
@@ -3,6 +3,18 @@
 #include "RectangleRenderer.h"
 #include "EllipseRenderer.h"
 #include "LineRenderer.h"
+#include "PolylineRenderer.h"
+#include "TextRenderer.h"
+#include "ParticleSystem.h"
+#include "GPUParticleSystem.h"
+#include "TilemapRenderer.h"
+#include "PolygonRenderer.h"
+#include "PathRenderer.h"
+#include "SpriteAnimator.h"
+#include "Hash.h"
+#include "ResourceManager.h"
+#include <cmath>
+#include <algorithm>
 
 
 
@@ -21,11 +33,14 @@ Scene::Scene(GLFWwindow* window, float width, float height, glm::vec3 background
 		mainCamera = camera;
 	// setup scene
 	Initialise();
+
+	glGenQueries(frameQueryCount, _frameTimerQueries);
 }
 
 Scene::~Scene()
 {
 	// cleanup scene
+	glDeleteQueries(frameQueryCount, _frameTimerQueries);
 }
 
 void Scene::AddEntity(std::string name, std::shared_ptr<Entity> entity)
@@ -74,10 +89,22 @@ void Scene::AddEntity(std::string name, std::shared_ptr<Entity> entity)
 	}
 	else // else is opaque
 		_opaqueEntities.insert(std::pair<std::string, std::shared_ptr<Entity>>(name, entity));
+
+	// start keeping track of it for baking, it gets baked once it's gone a while without changing (or when BakeStatic is called)
+	if (entity->GetIsStatic())
+	{
+		StaticEntity staticEntity;
+		staticEntity.entity = entity;
+		_staticEntities[entity.get()] = staticEntity;
+	}
 }
 
 void Scene::RemoveEntity(std::string name)
 {
+	// anything it was baked into has to be drawn without it now
+	std::shared_ptr<Entity> entityToUnbake = GetEntity(name);
+	if (entityToUnbake != nullptr)
+		RemoveStaticEntity(entityToUnbake.get());
 
 	// if the entity exists in opaue entites then remove it
 	if (ItemExistsInMap<std::shared_ptr<Entity>>(name, _opaqueEntities)) {
@@ -167,6 +194,31 @@ void Scene::UpdateEntityName(std::shared_ptr<Entity> entity, std::string newName
 	AddEntity(newName, entity);
 }
 
+void Scene::UpdateEntityStatic(Entity* entity)
+{
+	// error checks
+	if (entity == nullptr)
+		throw std::exception("Why did you just try to update whether nullptr is static");
+
+	if (entity->parentScene != this)
+		throw std::exception("Why did you just try to update whether an entity that doesn't belong to this scene is static?");
+
+	if (!entity->GetIsStatic())
+	{
+		RemoveStaticEntity(entity);
+		return;
+	}
+
+	// the scene's own pointer to it is needed to keep track of it
+	std::shared_ptr<Entity> sceneEntity = GetEntity(entity->GetName());
+	if (sceneEntity.get() != entity || _staticEntities.find(entity) != _staticEntities.end())
+		return;
+
+	StaticEntity staticEntity;
+	staticEntity.entity = sceneEntity;
+	_staticEntities[entity] = staticEntity;
+}
+
 void Scene::UpdateHighestZIndex()
 {
 	// first loop through each opaque entity
@@ -217,11 +269,27 @@ void Scene::Update()
 	// -- frame begin --
 	FireListener(EventType::Frame_Start);
 
-	// set background colour
-	glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b, 1.0f);
-	// Make sure background is applied and reset z buffer to make depth testing work properly
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	// whether the scene is drawn into the back buffer instead of straight onto the window
+	bool usesBackBuffer = partialRedraw || antiAliasing != NoAntiAliasing || dynamicResolution;
+
+	// partial redraw clears just the dirty parts of its back buffer instead, and anti aliasing/dynamic resolution clear the whole back buffer
+	if (!usesBackBuffer)
+	{
+		// nothing needs the back buffer anymore, give its memory back
+		_backBuffer = nullptr;
+		// set background colour
+		glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b, 1.0f);
+		// Make sure background is applied and reset z buffer to make depth testing work properly
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	// move the stream buffer on to a region the gpu isn't reading anymore
+	streamBuffer.BeginFrame();
 
+	// upload a bit more of any textures loading in the background
+	ResourceManager::UpdateAsyncLoads();
+	// finish any shader programs that are done compiling
+	ResourceManager::UpdatePendingShaderPrograms();
 	
 	
 	// check for keyboard inputs
@@ -230,14 +298,86 @@ void Scene::Update()
 	glfwPollEvents();
 	// update tweens
 	tweenManager.UpdateAll();
+	// Step anything that moves by itself. This is separate from drawing because entities that are off screen, not in a dirty region
+	// or in a render layer that didn't change aren't drawn but still have to keep going
+	SimulateEntities();
+	// bake/unbake static entities before anything is drawn, so a static entity that changed this frame is drawn normally straight away
+	UpdateStaticBatches();
+
+	// pick the resolution to draw at from how long the gpu took on recent frames
+	UpdateResolutionScale();
+	// time the gpu takes to draw the frame. Started after the simulation so it doesn't overlap the gpu particles' own query (they can't be nested)
+	glBeginQuery(GL_TIME_ELAPSED, _frameTimerQueries[_frameQueryIndex]);
+
+	// start batching draws from the main camera
+	drawBatcher.Begin(mainCamera);
+
+	// draw any render layers that have changed into their textures
+	bool layersChanged = UpdateRenderLayers();
+
+	// layers get drawn into the scene along with the transparent entities (in zIndex order), so sort the ones that have something to draw
+	std::vector<RenderLayer*> layersToComposite;
+	for (std::shared_ptr<RenderLayer> layer : _renderLayers)
+		if (layer->isActive && layer->HasContent())
+			layersToComposite.push_back(layer.get());
+	std::stable_sort(layersToComposite.begin(), layersToComposite.end(), 
+		[](RenderLayer* a, RenderLayer* b) { return a->GetCompositeZIndex() < b->GetCompositeZIndex(); });
+
+	if (partialRedraw)
+		PartialRedraw(layersToComposite, layersChanged);
+	else if (usesBackBuffer)
+	{
+		// draw everything into the back buffer, then it's smoothed and/or stretched on the way to the window
+		UpdateBackBuffer();
+		_backBuffer->Bind();
+		glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		DrawEntities(layersToComposite, nullptr);
+		PresentBackBuffer();
+	}
+	else
+		// draw everything
+		DrawEntities(layersToComposite, nullptr);
+
+	// save the batcher's stats for the frame
+	drawBatcher.End();
+
+	glEndQuery(GL_TIME_ELAPSED);
+	_isFrameQueryWaiting[_frameQueryIndex] = true;
+	_frameQueryIndex = (_frameQueryIndex + 1) % frameQueryCount;
+
+	// fence off everything streamed this frame
+	streamBuffer.EndFrame();
+	
+	// swap the front buffer with the back buffer to draw any changes
+	glfwSwapBuffers(_window);
+
+	// frame has ended
+	FireListener(EventType::Frame_End);
+}
+
+void Scene::DrawEntities(std::vector<RenderLayer*>& layersToComposite, const DirtyRegionTracker::Rect* region)
+{
+	// index of the next layer to draw into the scene
+	size_t nextLayerToComposite = 0;
+
+	// static batches are opaque so they go in first. They're drawn whole, in partial redraw mode the scissor test keeps them inside the region
+	if (!_staticBatches.empty())
+	{
+		// they don't go through the batcher
+		drawBatcher.Flush();
+		for (std::unique_ptr<StaticBatch>& batch : _staticBatches)
+			batch->Draw(drawBatcher.GetViewMatrix(), drawBatcher.GetProjectionMatrix());
+	}
 
 	// first loop through each opaque entity
 	for (std::pair<std::string, std::shared_ptr<Entity>> entityIterator : _opaqueEntities)
 	{
 		std::shared_ptr<Entity> iteratedEntity = entityIterator.second;
 
-		// if the actual entity is enabled
-		if(iteratedEntity->isActive)
+		// if the actual entity is enabled, not already drawn in a render layer or static batch and in the region being drawn
+		if(iteratedEntity->isActive && GetRenderLayerOf(iteratedEntity.get()) == nullptr && !IsEntityBaked(iteratedEntity.get())
+			&& (region == nullptr || dirtyRegions.GetBounds(iteratedEntity.get()).Overlaps(*region)))
 			// loop through each component under entity
 			for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : iteratedEntity->GetComponents()) 
 			{
@@ -251,8 +391,18 @@ void Scene::Update()
 	{
 		std::shared_ptr<Entity> iteratedEntity = entity;
 
-		// if the actual entity is enabled
-		if (iteratedEntity->isActive)
+		// draw any layers that are behind (or level with) this entity first
+		while (nextLayerToComposite < layersToComposite.size() && layersToComposite[nextLayerToComposite]->GetCompositeZIndex() <= iteratedEntity->transform.GetZIndex())
+		{
+			// anything waiting in the batcher is behind the layer
+			drawBatcher.Flush();
+			layersToComposite[nextLayerToComposite]->Composite(mainCamera, _highestZIndex);
+			nextLayerToComposite++;
+		}
+
+		// if the actual entity is enabled, not already drawn in a render layer and in the region being drawn
+		if (iteratedEntity->isActive && GetRenderLayerOf(iteratedEntity.get()) == nullptr
+			&& (region == nullptr || dirtyRegions.GetBounds(iteratedEntity.get()).Overlaps(*region)))
 			// loop through each component under entity
 			for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : iteratedEntity->GetComponents())
 			{
@@ -261,12 +411,254 @@ void Scene::Update()
 			}
 	}
 
-	
-	// swap the front buffer with the back buffer to draw any changes
-	glfwSwapBuffers(_window);
+	// draw whatever is left in the batcher
+	drawBatcher.Flush();
 
-	// frame has ended
-	FireListener(EventType::Frame_End);
+	// then any layers in front of every transparent entity
+	for (; nextLayerToComposite < layersToComposite.size(); nextLayerToComposite++)
+		layersToComposite[nextLayerToComposite]->Composite(mainCamera, _highestZIndex);
+}
+
+void Scene::PartialRedraw(std::vector<RenderLayer*>& layersToComposite, bool layersChanged)
+{
+	// dirty regions are in the back buffer's pixels, which are smaller than the window's with dynamic resolution
+	glm::ivec2 renderSize = GetRenderSize();
+
+	// -- make sure the back buffer is the render size. What's in it is kept between frames --
+	bool backBufferRemade = UpdateBackBuffer();
+
+	// -- work out what changed --
+	// anything that moves every pixel on screen
+	size_t frameHash = 0;
+	glm::mat4 viewProjection = mainCamera->GetProjectionMatrix() * mainCamera->GetViewMatrix();
+	for (int column = 0; column < 4; column++)
+		Hash::Add(frameHash, viewProjection[column]);
+	Hash::Add(frameHash, backgroundColor);
+
+	dirtyRegions.BeginFrame(renderSize.x, renderSize.y, frameHash);
+
+	// a render layer being re-drawn can change anything it covers, which is most of the screen. A new or resized back buffer has nothing in it
+	if (layersChanged || backBufferRemade)
+		dirtyRegions.MarkAllDirty();
+
+	for (std::pair<std::string, std::shared_ptr<Entity>> entityIterator : _opaqueEntities)
+		dirtyRegions.TrackEntity(entityIterator.second.get(), GetEntityScreenBounds(entityIterator.second), GetEntityStateHash(entityIterator.second));
+	for (std::shared_ptr<Entity> entity : _sortedTransparentEntities)
+		dirtyRegions.TrackEntity(entity.get(), GetEntityScreenBounds(entity), GetEntityStateHash(entity));
+
+	dirtyRegions.EndTracking();
+
+	// -- redraw the dirty parts into the back buffer --
+	_backBuffer->Bind();
+	glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b, 1.0f);
+
+	if (dirtyRegions.IsFullRedraw())
+	{
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		DrawEntities(layersToComposite, nullptr);
+	}
+	else
+	{
+		// the scissor test stops anything (including clears) from touching pixels outside the rect
+		glEnable(GL_SCISSOR_TEST);
+		for (const DirtyRegionTracker::Rect& region : dirtyRegions.GetRegions())
+		{
+			glScissor(region.x, region.y, region.width, region.height);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			// only entities that overlap the rect can change it
+			DrawEntities(layersToComposite, &region);
+		}
+		glDisable(GL_SCISSOR_TEST);
+	}
+
+	// -- show it --
+	PresentBackBuffer();
+}
+
+bool Scene::UpdateBackBuffer()
+{
+	glm::ivec2 renderSize = GetRenderSize();
+	int samples = (antiAliasing == MSAA) ? std::clamp(msaaSamples, 0, RenderTarget::GetMaxSamples()) : 0;
+
+	// the number of samples can't be changed on an existing render target
+	if (_backBuffer == nullptr || _backBuffer->GetSamples() != samples)
+	{
+		_backBuffer = std::make_unique<RenderTarget>(renderSize.x, renderSize.y, samples);
+		return true;
+	}
+
+	bool isResized = _backBuffer->GetWidth() != renderSize.x || _backBuffer->GetHeight() != renderSize.y;
+	_backBuffer->Resize(renderSize.x, renderSize.y);
+	return isResized;
+}
+
+glm::ivec2 Scene::GetRenderSize()
+{
+	// the camera's size is the window's size
+	glm::vec2 windowSize = glm::vec2(mainCamera->width, mainCamera->height);
+	return glm::max(glm::ivec2(glm::round(windowSize * _resolutionScale)), glm::ivec2(1));
+}
+
+float Scene::GetResolutionScale()
+{
+	return _resolutionScale;
+}
+
+double Scene::GetGPUFrameTime()
+{
+	return _gpuFrameTime;
+}
+
+void Scene::UpdateResolutionScale()
+{
+	// -- read the query from a couple of frames ago, if it's done --
+	bool hasNewTime = false;
+	if (_isFrameQueryWaiting[_frameQueryIndex])
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(_frameTimerQueries[_frameQueryIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_TRUE)
+		{
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(_frameTimerQueries[_frameQueryIndex], GL_QUERY_RESULT, &nanoseconds);
+			_gpuFrameTime = (double)nanoseconds / 1e9;
+			hasNewTime = true;
+		}
+		// it's about to be started again either way, a result that isn't ready yet is just skipped
+		_isFrameQueryWaiting[_frameQueryIndex] = false;
+	}
+
+	if (!dynamicResolution)
+	{
+		_resolutionScale = 1.0f;
+		return;
+	}
+
+	_framesSinceResolutionChange++;
+	// give the last change time to show up in the gpu time first
+	if (!hasNewTime || _gpuFrameTime <= 0.0 || _framesSinceResolutionChange < resolutionChangeDelay)
+	{
+		_resolutionScale = glm::clamp(_resolutionScale, minResolutionScale, maxResolutionScale);
+		return;
+	}
+
+	/*
+	* When it's fill rate bound the gpu time goes with the number of pixels drawn, which is the scale squared. So the scale that would take
+	* targetFrameTime is scale * sqrt(target / time).
+	* It goes down as far as it needs to straight away so a slow patch is over quickly, but only goes up a step at a time and only once the
+	* frame is well under the target, otherwise it would keep bouncing between two sizes
+	*/
+	float idealScale = _resolutionScale * (float)std::sqrt(targetFrameTime / _gpuFrameTime);
+	float newScale = _resolutionScale;
+	if (_gpuFrameTime > targetFrameTime)
+		newScale = std::floor(idealScale / resolutionScaleStep) * resolutionScaleStep;
+	else if (_gpuFrameTime < targetFrameTime * 0.75)
+		newScale = std::min(_resolutionScale + resolutionScaleStep, idealScale);
+	newScale = glm::clamp(newScale, minResolutionScale, maxResolutionScale);
+
+	// tiny changes would resize the back buffer for nothing
+	if (std::abs(newScale - _resolutionScale) >= resolutionScaleStep * 0.5f)
+	{
+		_resolutionScale = newScale;
+		_framesSinceResolutionChange = 0;
+	}
+}
+
+void Scene::PresentBackBuffer()
+{
+	int viewportWidth = (int)mainCamera->width;
+	int viewportHeight = (int)mainCamera->height;
+
+	if (antiAliasing == FXAA)
+		_backBuffer->CopyToWindowFXAA(viewportWidth, viewportHeight);
+	else
+		// a multisampled back buffer is resolved by the copy
+		_backBuffer->CopyToWindow(viewportWidth, viewportHeight);
+}
+
+size_t Scene::GetBackBufferMemory()
+{
+	return (_backBuffer == nullptr) ? 0 : _backBuffer->GetMemoryUsage();
+}
+
+DirtyRegionTracker::Rect Scene::GetEntityScreenBounds(std::shared_ptr<Entity> entity)
+{
+	// -- local bounds of everything the entity draws --
+	glm::vec2 localMin = glm::vec2(0.0f);
+	glm::vec2 localMax = glm::vec2(0.0f);
+	bool hasBounds = false;
+	for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : entity->GetComponents())
+	{
+		glm::vec2 componentMin, componentMax;
+		GetComponentLocalBounds(componentIterator.first, componentIterator.second, componentMin, componentMax);
+		localMin = hasBounds ? glm::min(localMin, componentMin) : componentMin;
+		localMax = hasBounds ? glm::max(localMax, componentMax) : componentMax;
+		hasBounds = true;
+	}
+
+	// doesn't draw anything
+	if (!hasBounds)
+		return DirtyRegionTracker::Rect();
+
+	// -- transform each corner onto the screen --
+	glm::mat4 localToScreen = mainCamera->GetProjectionMatrix() * mainCamera->GetViewMatrix() * entity->transform.ToMatrix(mainCamera);
+	glm::vec2 corners[4] = { localMin, glm::vec2(localMax.x, localMin.y), localMax, glm::vec2(localMin.x, localMax.y) };
+
+	glm::vec2 screenMin, screenMax;
+	for (int i = 0; i < 4; i++)
+	{
+		// -1 to 1 after projection, then 0 to render size in pixels
+		glm::vec2 normalisedCorner = glm::vec2(localToScreen * glm::vec4(corners[i], 0.0f, 1.0f));
+		glm::vec2 pixelCorner = (normalisedCorner + 1.0f) / 2.0f * glm::vec2(GetRenderSize());
+
+		screenMin = (i == 0) ? pixelCorner : glm::min(screenMin, pixelCorner);
+		screenMax = (i == 0) ? pixelCorner : glm::max(screenMax, pixelCorner);
+	}
+
+	// round outwards and add a couple of pixels for anything that bleeds over the edge (smoothing, anti aliasing)
+	const int edgePadding = 2;
+	DirtyRegionTracker::Rect bounds;
+	bounds.x = (int)std::floor(screenMin.x) - edgePadding;
+	bounds.y = (int)std::floor(screenMin.y) - edgePadding;
+	bounds.width = (int)std::ceil(screenMax.x) + edgePadding - bounds.x;
+	bounds.height = (int)std::ceil(screenMax.y) + edgePadding - bounds.y;
+	return bounds;
+}
+
+void Scene::GetComponentLocalBounds(Entity::ComponentType type, std::shared_ptr<Component> component, glm::vec2& min, glm::vec2& max)
+{
+	// switch case thru different component types, most of them are just the -1 to 1 rect
+	switch (type)
+	{
+	case Entity::LineRenderer:
+		std::static_pointer_cast<LineRenderer>(component)->GetLocalBounds(min, max);
+		break;
+	case Entity::PolylineRenderer:
+		std::static_pointer_cast<PolylineRenderer>(component)->GetLocalBounds(min, max);
+		break;
+	case Entity::TextRenderer:
+		std::static_pointer_cast<TextRenderer>(component)->GetLocalBounds(min, max);
+		break;
+	case Entity::ParticleSystem:
+		std::static_pointer_cast<ParticleSystem>(component)->GetLocalBounds(min, max);
+		break;
+	case Entity::GPUParticleSystem:
+		std::static_pointer_cast<GPUParticleSystem>(component)->GetLocalBounds(min, max);
+		break;
+	case Entity::TilemapRenderer:
+		std::static_pointer_cast<TilemapRenderer>(component)->GetLocalBounds(min, max);
+		break;
+	case Entity::PolygonRenderer:
+		std::static_pointer_cast<PolygonRenderer>(component)->GetLocalBounds(min, max);
+		break;
+	case Entity::PathRenderer:
+		std::static_pointer_cast<PathRenderer>(component)->GetLocalBounds(min, max);
+		break;
+	default:
+		min = glm::vec2(-1.0f);
+		max = glm::vec2(1.0f);
+		break;
+	}
 }
 
 void Scene::UpdateComponent(Entity::ComponentType type, std::shared_ptr<Component> component)
@@ -308,11 +700,479 @@ void Scene::UpdateComponent(Entity::ComponentType type, std::shared_ptr<Componen
 		renderer->Draw(mainCamera);
 		break;
 	}
+	case Entity::PolylineRenderer:
+	{
+		// cast component to renderer
+		std::shared_ptr<PolylineRenderer> renderer = std::static_pointer_cast<PolylineRenderer>(component);
+		// render to screen
+		renderer->Draw(mainCamera);
+		break;
+	}
+	case Entity::TextRenderer:
+	{
+		// cast component to renderer
+		std::shared_ptr<TextRenderer> renderer = std::static_pointer_cast<TextRenderer>(component);
+		// render to screen
+		renderer->Draw(mainCamera);
+		break;
+	}
+	case Entity::ParticleSystem:
+	{
+		// cast component to particle system, it's stepped by SimulateEntities so this only draws
+		std::shared_ptr<ParticleSystem> particleSystem = std::static_pointer_cast<ParticleSystem>(component);
+		// render to screen
+		particleSystem->Draw(mainCamera);
+		break;
+	}
+	case Entity::GPUParticleSystem:
+	{
+		// cast component to gpu particle system, it's stepped by SimulateEntities so this only draws
+		std::shared_ptr<GPUParticleSystem> particleSystem = std::static_pointer_cast<GPUParticleSystem>(component);
+		// render to screen
+		particleSystem->Draw(mainCamera);
+		break;
+	}
+	case Entity::TilemapRenderer:
+	{
+		// cast component to renderer
+		std::shared_ptr<TilemapRenderer> renderer = std::static_pointer_cast<TilemapRenderer>(component);
+		// render to screen
+		renderer->Draw(mainCamera);
+		break;
+	}
+	case Entity::PolygonRenderer:
+	{
+		// cast component to renderer
+		std::shared_ptr<PolygonRenderer> renderer = std::static_pointer_cast<PolygonRenderer>(component);
+		// render to screen
+		renderer->Draw(mainCamera);
+		break;
+	}
+	case Entity::PathRenderer:
+	{
+		// cast component to renderer
+		std::shared_ptr<PathRenderer> renderer = std::static_pointer_cast<PathRenderer>(component);
+		// render to screen
+		renderer->Draw(mainCamera);
+		break;
+	}
 	default: // do nothing
 		break;
 	}
 }
 
+void Scene::SimulateEntities()
+{
+	for (std::pair<std::string, std::shared_ptr<Entity>> entityIterator : _opaqueEntities)
+		if (entityIterator.second->isActive)
+			for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : entityIterator.second->GetComponents())
+				SimulateComponent(componentIterator.first, componentIterator.second);
+
+	for (std::pair<std::string, std::shared_ptr<Entity>> entityIterator : _transparentEntities)
+		if (entityIterator.second->isActive)
+			for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : entityIterator.second->GetComponents())
+				SimulateComponent(componentIterator.first, componentIterator.second);
+}
+
+void Scene::SimulateComponent(Entity::ComponentType type, std::shared_ptr<Component> component)
+{
+	// switch case thru the component types that change over time
+	switch (type)
+	{
+	case Entity::ParticleSystem:
+		std::static_pointer_cast<ParticleSystem>(component)->Update((float)deltaTime);
+		break;
+	case Entity::GPUParticleSystem:
+		std::static_pointer_cast<GPUParticleSystem>(component)->Update((float)deltaTime);
+		break;
+	case Entity::SpriteAnimator:
+		std::static_pointer_cast<SpriteAnimator>(component)->Update((float)deltaTime);
+		break;
+	default: // nothing to step
+		break;
+	}
+}
+
+void Scene::AddRenderLayer(std::shared_ptr<RenderLayer> layer)
+{
+	if (layer == nullptr)
+		throw std::exception("ERROR: Tried to add a nullptr render layer to scene");
+
+	// don't add the same layer twice
+	if (std::find(_renderLayers.begin(), _renderLayers.end(), layer) == _renderLayers.end())
+		_renderLayers.push_back(layer);
+}
+
+void Scene::RemoveRenderLayer(std::shared_ptr<RenderLayer> layer)
+{
+	std::vector<std::shared_ptr<RenderLayer>>::iterator layerIterator = std::find(_renderLayers.begin(), _renderLayers.end(), layer);
+	if (layerIterator != _renderLayers.end())
+		_renderLayers.erase(layerIterator);
+}
+
+RenderLayer* Scene::GetRenderLayerOf(Entity* entity)
+{
+	// first active layer that the entity fits in
+	for (std::shared_ptr<RenderLayer>& layer : _renderLayers)
+		if (layer->isActive && layer->Contains(entity))
+			return layer.get();
+
+	return nullptr;
+}
+
+bool Scene::UpdateRenderLayers()
+{
+	bool anyRendered = false;
+
+	for (std::shared_ptr<RenderLayer>& layer : _renderLayers)
+	{
+		if (!layer->isActive)
+			continue;
+
+		// -- find every entity in the layer, in the same order the scene draws them --
+		std::vector<std::shared_ptr<Entity>> layerEntities;
+		for (std::pair<std::string, std::shared_ptr<Entity>> entityIterator : _opaqueEntities)
+			if (GetRenderLayerOf(entityIterator.second.get()) == layer.get())
+				layerEntities.push_back(entityIterator.second);
+		for (std::shared_ptr<Entity> entity : _sortedTransparentEntities)
+			if (GetRenderLayerOf(entity.get()) == layer.get())
+				layerEntities.push_back(entity);
+
+		// nothing to draw
+		if (layerEntities.empty())
+		{
+			// it had something in it last frame
+			if (layer->HasContent())
+				anyRendered = true;
+			layer->Clear();
+			continue;
+		}
+
+		// -- hash everything in the layer so changes can be spotted. This is a lot cheaper than actually drawing it all --
+		size_t contentHash = 0;
+		// the layer is drawn back in at the highest zIndex of its entities
+		unsigned int compositeZIndex = 0;
+		for (std::shared_ptr<Entity>& entity : layerEntities)
+		{
+			// the entity itself is hashed as well so joining/leaving the layer counts as a change
+			Hash::Add(contentHash, entity.get());
+			Hash::Combine(contentHash, GetEntityStateHash(entity));
+			compositeZIndex = std::max(compositeZIndex, entity->transform.GetZIndex());
+		}
+		// every zIndex's depth is relative to the highest in the scene
+		Hash::Add(contentHash, _highestZIndex);
+
+		if (!layer->NeedsRender(contentHash, mainCamera))
+			continue;
+
+		// -- draw the layer's entities into its texture --
+		std::shared_ptr<OrthoCamera> layerCamera = layer->BeginRender(mainCamera, contentHash, compositeZIndex);
+		drawBatcher.SetCamera(layerCamera);
+
+		for (std::shared_ptr<Entity>& entity : layerEntities)
+			if (entity->isActive)
+				for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : entity->GetComponents())
+					UpdateComponent(componentIterator.first, componentIterator.second);
+
+		// everything has to be drawn before going back to the window
+		drawBatcher.Flush();
+		layer->EndRender((int)mainCamera->width, (int)mainCamera->height);
+		drawBatcher.SetCamera(mainCamera);
+		anyRendered = true;
+	}
+
+	return anyRendered;
+}
+
+size_t Scene::GetEntityStateHash(std::shared_ptr<Entity> entity)
+{
+	size_t hash = 0;
+	Transform& transform = entity->transform;
+
+	Hash::Add(hash, entity->isActive);
+	// global values take sticky and relative transforms into account, so moving the camera/resizing changes them
+	Hash::Add(hash, transform.GetGlobalPosition(mainCamera));
+	Hash::Add(hash, transform.GetGlobalSize(mainCamera));
+	Hash::Add(hash, transform.rotation);
+	Hash::Add(hash, transform.GetZIndex());
+
+	for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : entity->GetComponents())
+	{
+		Hash::Add(hash, (unsigned int)componentIterator.first);
+		Hash::Combine(hash, GetComponentStateHash(componentIterator.first, componentIterator.second));
+	}
+
+	return hash;
+}
+
+size_t Scene::GetComponentStateHash(Entity::ComponentType type, std::shared_ptr<Component> component)
+{
+	// switch case thru different component types and get the according hash
+	switch (type)
+	{
+	case Entity::SpriteRenderer:
+		return std::static_pointer_cast<SpriteRenderer>(component)->GetStateHash();
+	case Entity::RectangleRenderer:
+		return std::static_pointer_cast<RectangleRenderer>(component)->GetStateHash();
+	case Entity::EllipseRenderer:
+		return std::static_pointer_cast<EllipseRenderer>(component)->GetStateHash();
+	case Entity::LineRenderer:
+		return std::static_pointer_cast<LineRenderer>(component)->GetStateHash();
+	case Entity::PolylineRenderer:
+		return std::static_pointer_cast<PolylineRenderer>(component)->GetStateHash();
+	case Entity::TextRenderer:
+		return std::static_pointer_cast<TextRenderer>(component)->GetStateHash();
+	case Entity::ParticleSystem:
+		return std::static_pointer_cast<ParticleSystem>(component)->GetStateHash();
+	case Entity::GPUParticleSystem:
+		return std::static_pointer_cast<GPUParticleSystem>(component)->GetStateHash();
+	case Entity::TilemapRenderer:
+		return std::static_pointer_cast<TilemapRenderer>(component)->GetStateHash();
+	case Entity::PolygonRenderer:
+		return std::static_pointer_cast<PolygonRenderer>(component)->GetStateHash();
+	case Entity::PathRenderer:
+		return std::static_pointer_cast<PathRenderer>(component)->GetStateHash();
+	default: // nothing to hash
+		return 0;
+	}
+}
+
+void Scene::BakeStatic()
+{
+	// start again from nothing so small batches left over from rebaking get merged back together
+	_staticBatches.clear();
+
+	std::vector<Entity*> entitiesToBake;
+	for (std::pair<Entity* const, StaticEntity>& staticIterator : _staticEntities)
+	{
+		StaticEntity& staticEntity = staticIterator.second;
+		staticEntity.isBaked = false;
+		staticEntity.batches.clear();
+		staticEntity.framesUnchanged = 0;
+		staticEntity.hash = GetStaticHash(staticEntity.entity);
+
+		if (CanBakeEntity(staticEntity.entity))
+			entitiesToBake.push_back(staticIterator.first);
+	}
+
+	BakeStaticEntities(entitiesToBake);
+}
+
+size_t Scene::GetStaticBatchCount()
+{
+	return _staticBatches.size();
+}
+
+size_t Scene::GetBakedEntityCount()
+{
+	size_t bakedCount = 0;
+	for (std::pair<Entity* const, StaticEntity>& staticIterator : _staticEntities)
+		if (staticIterator.second.isBaked)
+			bakedCount++;
+	return bakedCount;
+}
+
+void Scene::UpdateStaticBatches()
+{
+	// nothing to do
+	if (_staticEntities.empty())
+		return;
+
+	std::vector<StaticBatch*> changedBatches;
+	std::vector<Entity*> entitiesToBake;
+
+	// -- hash every static entity to find the ones that changed. This is a lot cheaper than drawing them all one by one --
+	for (std::pair<Entity* const, StaticEntity>& staticIterator : _staticEntities)
+	{
+		StaticEntity& staticEntity = staticIterator.second;
+		size_t hash = GetStaticHash(staticEntity.entity);
+		bool canBake = CanBakeEntity(staticEntity.entity);
+
+		if (staticEntity.isBaked)
+		{
+			// what was baked isn't right anymore
+			if (hash != staticEntity.hash || !canBake)
+			{
+				changedBatches.insert(changedBatches.end(), staticEntity.batches.begin(), staticEntity.batches.end());
+				// an entity with nothing to draw isn't in any batches, so it has to be unbaked here
+				staticEntity.isBaked = false;
+				staticEntity.framesUnchanged = 0;
+			}
+			continue;
+		}
+
+		// not baked, wait for it to stop changing
+		staticEntity.framesUnchanged = (hash == staticEntity.hash) ? staticEntity.framesUnchanged + 1 : 0;
+		staticEntity.hash = hash;
+		if (canBake && staticEntity.framesUnchanged >= staticRebakeDelay)
+			entitiesToBake.push_back(staticIterator.first);
+	}
+
+	// only the batches with something that changed are thrown away, everything else stays baked
+	for (StaticBatch* batch : changedBatches)
+		UnbakeStaticBatch(batch);
+
+	if (!entitiesToBake.empty())
+		BakeStaticEntities(entitiesToBake);
+}
+
+void Scene::BakeStaticEntities(const std::vector<Entity*>& entities)
+{
+	// an entity's quads waiting to go in a batch
+	struct BakedQuads {
+		Entity* entity;
+		std::vector<StaticBatch::Vertex> vertices;
+	};
+
+	// -- get every entity's quads, grouped by texture --
+	std::map<StaticBatch::Key, std::vector<BakedQuads>> quadsByKey;
+	for (Entity* entity : entities)
+	{
+		StaticEntity& staticEntity = _staticEntities.at(entity);
+
+		// each component can use a different texture
+		std::map<StaticBatch::Key, std::vector<StaticBatch::Vertex>> entityQuads;
+		bool canBake = true;
+		for (std::pair<Entity::ComponentType, std::shared_ptr<Component>> componentIterator : entity->GetComponents())
+		{
+			StaticBatch::Key key;
+			std::vector<StaticBatch::Vertex> componentVertices;
+			if (!BakeComponent(componentIterator.first, componentIterator.second, key, componentVertices))
+			{
+				canBake = false;
+				break;
+			}
+			// some components don't draw anything themselves
+			if (componentVertices.empty())
+				continue;
+			std::vector<StaticBatch::Vertex>& keyVertices = entityQuads[key];
+			keyVertices.insert(keyVertices.end(), componentVertices.begin(), componentVertices.end());
+		}
+
+		// it gets drawn normally. It'll be tried again after another staticRebakeDelay frames
+		if (!canBake)
+		{
+			staticEntity.framesUnchanged = 0;
+			continue;
+		}
+
+		staticEntity.isBaked = true;
+		staticEntity.hash = GetStaticHash(staticEntity.entity);
+		staticEntity.batches.clear();
+		for (std::pair<const StaticBatch::Key, std::vector<StaticBatch::Vertex>>& keyIterator : entityQuads)
+			quadsByKey[keyIterator.first].push_back(BakedQuads{ entity, std::move(keyIterator.second) });
+	}
+
+	// -- fill batches of up to maxQuads with them, an entity's quads (for one texture) are never split between batches --
+	for (std::pair<const StaticBatch::Key, std::vector<BakedQuads>>& keyIterator : quadsByKey)
+	{
+		std::vector<BakedQuads>& allQuads = keyIterator.second;
+		size_t nextQuads = 0;
+		while (nextQuads < allQuads.size())
+		{
+			std::vector<StaticBatch::Vertex> batchVertices;
+			std::vector<Entity*> batchEntities;
+			// always at least one entity, even if it has more than maxQuads by itself
+			do
+			{
+				batchVertices.insert(batchVertices.end(), allQuads[nextQuads].vertices.begin(), allQuads[nextQuads].vertices.end());
+				batchEntities.push_back(allQuads[nextQuads].entity);
+				nextQuads++;
+			} while (nextQuads < allQuads.size() && (batchVertices.size() + allQuads[nextQuads].vertices.size()) / 4 <= StaticBatch::maxQuads);
+
+			std::unique_ptr<StaticBatch> batch = std::make_unique<StaticBatch>(keyIterator.first, batchVertices);
+			batch->entities = batchEntities;
+			for (Entity* entity : batchEntities)
+				_staticEntities.at(entity).batches.push_back(batch.get());
+			_staticBatches.push_back(std::move(batch));
+		}
+	}
+}
+
+void Scene::UnbakeStaticBatch(StaticBatch* batch)
+{
+	// it might have already gone with another batch that shared an entity
+	std::vector<std::unique_ptr<StaticBatch>>::iterator batchIterator = std::find_if(_staticBatches.begin(), _staticBatches.end(),
+		[batch](std::unique_ptr<StaticBatch>& otherBatch) { return otherBatch.get() == batch; });
+	if (batchIterator == _staticBatches.end())
+		return;
+
+	// the batch's entities are drawn normally now, so any other batches they're in have to go too or their quads would be drawn twice
+	std::vector<StaticBatch*> otherBatches;
+	for (Entity* entity : batch->entities)
+	{
+		StaticEntity& staticEntity = _staticEntities.at(entity);
+		staticEntity.isBaked = false;
+		staticEntity.framesUnchanged = 0;
+		for (StaticBatch* otherBatch : staticEntity.batches)
+			if (otherBatch != batch)
+				otherBatches.push_back(otherBatch);
+		staticEntity.batches.clear();
+	}
+
+	_staticBatches.erase(batchIterator);
+
+	for (StaticBatch* otherBatch : otherBatches)
+		UnbakeStaticBatch(otherBatch);
+}
+
+void Scene::RemoveStaticEntity(Entity* entity)
+{
+	std::unordered_map<Entity*, StaticEntity>::iterator staticIterator = _staticEntities.find(entity);
+	if (staticIterator == _staticEntities.end())
+		return;
+
+	// copy the list, unbaking changes it
+	std::vector<StaticBatch*> batches = staticIterator->second.batches;
+	for (StaticBatch* batch : batches)
+		UnbakeStaticBatch(batch);
+
+	_staticEntities.erase(staticIterator);
+}
+
+bool Scene::IsEntityBaked(Entity* entity)
+{
+	// most scenes don't have any static entities
+	if (_staticEntities.empty())
+		return false;
+
+	std::unordered_map<Entity*, StaticEntity>::iterator staticIterator = _staticEntities.find(entity);
+	return staticIterator != _staticEntities.end() && staticIterator->second.isBaked;
+}
+
+bool Scene::CanBakeEntity(std::shared_ptr<Entity> entity)
+{
+	// transparent entities have to be drawn back to front with everything else
+	return entity->isActive && !entity->GetHasTransparency() && GetRenderLayerOf(entity.get()) == nullptr;
+}
+
+size_t Scene::GetStaticHash(std::shared_ptr<Entity> entity)
+{
+	size_t hash = GetEntityStateHash(entity);
+	// every zIndex's depth is relative to the highest in the scene
+	Hash::Add(hash, _highestZIndex);
+	return hash;
+}
+
+bool Scene::BakeComponent(Entity::ComponentType type, std::shared_ptr<Component> component, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices)
+{
+	// switch case thru the component types that can be baked
+	switch (type)
+	{
+	case Entity::SpriteRenderer:
+		return std::static_pointer_cast<SpriteRenderer>(component)->BakeStatic(mainCamera, key, vertices);
+	case Entity::RectangleRenderer:
+		return std::static_pointer_cast<RectangleRenderer>(component)->BakeStatic(mainCamera, key, vertices);
+	case Entity::LineRenderer:
+		return std::static_pointer_cast<LineRenderer>(component)->BakeStatic(mainCamera, key, vertices);
+	case Entity::SpriteAnimator:
+		// doesn't draw anything itself, the frame it's on is baked with the sprite (and a new frame unbakes it)
+		return true;
+	default: // anything else has to be drawn normally
+		return false;
+	}
+}
+
 void Scene::Initialise()
 {
 	// intialise last frame time to creation of scene
@@ -4,11 +4,18 @@
 #include <iostream>
 #include <map>
 #include <vector>
+#include <unordered_map>
 
 #include "Entity.h"
 #include "OrthoCamera.h"
 #include "EventListener.h"
 #include "TweenManager.h"
+#include "StreamBuffer.h"
+#include "DrawBatcher.h"
+#include "RenderLayer.h"
+#include "RenderTarget.h"
+#include "DirtyRegionTracker.h"
+#include "StaticBatch.h"
 
 // Create a new scene to render entities.
 // Note that you must call the UpdateViewport function of this scene whenever the viewport is updated
@@ -44,6 +51,9 @@ public:
 	// This updates the stored maps of entities with the new name
 	void UpdateEntityName(std::shared_ptr<Entity> entity, std::string newName);
 
+	// Called by Entity::SetIsStatic when an entity in this scene becomes static or stops being static, so the scene can start/stop baking it
+	void UpdateEntityStatic(Entity* entity);
+
 	// linearly searches through all entities in scene to find the highest zIndex. 
 	// Only call this when the entity with the highest index has been removed or changed
 	void UpdateHighestZIndex();
@@ -66,6 +76,87 @@ public:
 	// This tween manager manages all tweens for the current scene
 	TweenManager tweenManager = TweenManager(this);
 
+	// Per-frame data (vertices, instance data) is uploaded through this buffer by renderers. It is reset at the start of every frame
+	StreamBuffer streamBuffer;
+
+	// Renderers hand their draws to this instead of drawing straight away, it merges them into instanced/multi draws. Instance data goes into the stream buffer
+	DrawBatcher drawBatcher = DrawBatcher(&streamBuffer);
+
+	// Adds a render layer to the scene. Entities in it get drawn into the layer's texture and only re-drawn when something in the layer changes.
+	// If an entity fits in more than one layer it goes in whichever was added first
+	void AddRenderLayer(std::shared_ptr<RenderLayer> layer);
+
+	// Removes a render layer from the scene, its entities go back to being drawn every frame
+	void RemoveRenderLayer(std::shared_ptr<RenderLayer> layer);
+
+	// Partial redraw mode, for scenes where only a few things change each frame (e.g. dashboards). Default is off.
+	// The scene is drawn into a back buffer that is kept between frames and only the parts of the screen that changed (see dirtyRegions) are cleared and
+	// redrawn with glScissor. The back buffer is then copied to the window. Anything that moves every pixel (camera, background colour) redraws everything
+	bool partialRedraw = false;
+
+	// Tracks what changed on screen for partial redraw mode. Has settings for how rects are merged and stats on how much was redrawn
+	DirtyRegionTracker dirtyRegions;
+
+	// ways of smoothing the jagged edges of shapes
+	enum AntiAliasing {
+		// drawn straight onto the window
+		NoAntiAliasing,
+		// drawn into a multisampled back buffer with msaaSamples samples per pixel, which is resolved onto the window. Smoothest but every pixel
+		// that's drawn costs that many times more fill rate and memory
+		MSAA,
+		// drawn into a normal back buffer, then copied onto the window with an FXAA pass. One extra pass over the screen no matter how much is drawn
+		FXAA
+	};
+
+	// How the scene smooths edges, can be changed at any time (the back buffer is made again to match). Default is none.
+	// Anti aliasing is done by the scene instead of the window so passes that don't need it (render layers, the GPU particle update) don't pay for it
+	AntiAliasing antiAliasing = NoAntiAliasing;
+
+	// how many samples each pixel has in MSAA mode, capped to what the driver supports
+	int msaaSamples = 4;
+
+	// how many bytes the scene's back buffer takes up, 0 if it is drawing straight onto the window
+	size_t GetBackBufferMemory();
+
+	// Dynamic resolution, for when the scene is fill rate bound (lots of big or overlapping see through shapes). Default is off.
+	// The scene is drawn into a back buffer that's a fraction of the window's size and stretched onto the window. How long the gpu takes to draw
+	// each frame is measured with timer queries and the fraction goes down when it's over targetFrameTime and back up when there's room again.
+	// Everything is drawn in global units (see OrthoCamera) and smoothing uses screen space derivatives, so it all looks the same just blurrier
+	bool dynamicResolution = false;
+
+	// how many seconds the gpu should take to draw a frame in dynamic resolution mode
+	double targetFrameTime = 1.0 / 60.0;
+
+	// smallest and biggest fraction of the window's size that dynamic resolution can draw at
+	float minResolutionScale = 0.5f;
+	float maxResolutionScale = 1.0f;
+
+	// how many frames dynamic resolution waits after changing the resolution before it changes it again, so it has time to see the new gpu time
+	unsigned int resolutionChangeDelay = 15;
+
+	// the fraction of the window's size the scene is drawn at, always 1 when dynamic resolution is off
+	float GetResolutionScale();
+
+	// how many seconds the gpu took to draw a recent frame (render layers, entities and copying to the window). It's from a couple of frames ago so it doesn't have to wait on the gpu
+	double GetGPUFrameTime();
+
+	// Bakes every static entity (see Entity::SetIsStatic) into static batches now. Opaque rects, sprites (per texture/atlas page) and lines are put through
+	// their entity's transform once and merged into combined vertex buffers, which are drawn in a handful of calls instead of one instance each.
+	// Static entities get baked by themselves once they've gone staticRebakeDelay frames without changing, so this is for straight after loading
+	// a scene (so they're baked from the first frame). It also starts the batches again from scratch, merging small ones left over from rebaking.
+	// An entity that changes (transform, components, transparency etc.) only unbakes the batches it's in, it's drawn normally until it's baked again.
+	// Entities that are transparent, in a render layer or have a component that can't be baked (text, custom shaders etc.) just get drawn normally
+	void BakeStatic();
+
+	// how many frames a static entity has to go without changing before it's baked (again). Stops something that changes every frame from having its batch rebuilt every frame
+	unsigned int staticRebakeDelay = 30;
+
+	// how many static batches are being drawn
+	size_t GetStaticBatchCount();
+
+	// how many static entities are baked into a static batch
+	size_t GetBakedEntityCount();
+
 	// update the scene
 	void Update();
 
@@ -120,6 +211,57 @@ private:
 	// There shouldn't be too much overhead with the vectors for each event type but like what do I know I'm 16 yknow
 	std::map < EventType, std::vector<EventListener>> _eventListeners;
 
+	// render layers in the order they were added
+	std::vector<std::shared_ptr<RenderLayer>> _renderLayers;
+
+	// what partial redraw and anti aliasing draw into, created the first time it is used
+	std::unique_ptr<RenderTarget> _backBuffer;
+
+	// makes sure the back buffer is the render size and has the samples the anti aliasing mode needs.
+	// Returns true if it had to be made again or resized (so nothing that was drawn into it is left)
+	bool UpdateBackBuffer();
+
+	// size in pixels the scene is drawn at, the window's size times the resolution scale
+	glm::ivec2 GetRenderSize();
+
+	// fraction of the window's size the scene is drawn at
+	float _resolutionScale = 1.0f;
+	// how much the resolution scale goes up or down by, so tiny changes in gpu time don't resize the back buffer
+	const float resolutionScaleStep = 0.05f;
+	unsigned int _framesSinceResolutionChange = 0;
+
+	// timer queries around each frame's drawing. There's a few so the result of one from a couple of frames ago can be read without waiting
+	static const int frameQueryCount = 3;
+	unsigned int _frameTimerQueries[frameQueryCount] = {};
+	// whether each query has been started and not read yet
+	bool _isFrameQueryWaiting[frameQueryCount] = {};
+	int _frameQueryIndex = 0;
+	double _gpuFrameTime = 0.0;
+
+	// reads the gpu time of a recent frame and moves the resolution scale towards what would make it take targetFrameTime
+	void UpdateResolutionScale();
+
+	// copies the back buffer onto the window, resolving it (MSAA) or through the FXAA pass
+	void PresentBackBuffer();
+
+	// a static entity that the scene is keeping track of for baking
+	struct StaticEntity {
+		std::shared_ptr<Entity> entity;
+		// GetStaticHash of the entity when it was baked, or last frame while it isn't baked
+		size_t hash = 0;
+		// how many frames in a row it hasn't changed while it isn't baked
+		unsigned int framesUnchanged = 0;
+		bool isBaked = false;
+		// the batches its quads are in (one for each texture its components use)
+		std::vector<StaticBatch*> batches;
+	};
+
+	// every static entity in the scene, indexed by pointer so drawing can quickly check if one is baked
+	std::unordered_map<Entity*, StaticEntity> _staticEntities;
+
+	// every static batch, drawn with the opaque entities
+	std::vector<std::unique_ptr<StaticBatch>> _staticBatches;
+
 	// this is incremented each time an event listener is added. It is used to set the id of each added event listener
 	// No one is using more than 2^32 - 1 (4,294,967,295) event listeners
 	unsigned int amntOfEventListenersCreated = 0;
@@ -153,6 +295,61 @@ private:
 	std::string GetValidName(std::string inputName);
 	// Run update function on a component based on type
 	void UpdateComponent(Entity::ComponentType type, std::shared_ptr<Component> component);
+
+	// steps every active entity's components that change over time by themselves (particles etc.)
+	void SimulateEntities();
+
+	// steps a component forward by deltaTime based on type, most don't do anything
+	void SimulateComponent(Entity::ComponentType type, std::shared_ptr<Component> component);
+
+	// returns a hash of everything that changes how an entity looks (transform, active state and each component's state)
+	size_t GetEntityStateHash(std::shared_ptr<Entity> entity);
+
+	// returns a hash of a component's state based on type
+	size_t GetComponentStateHash(Entity::ComponentType type, std::shared_ptr<Component> component);
+
+	// returns the active render layer an entity is drawn in, nullptr if it isn't in one
+	RenderLayer* GetRenderLayerOf(Entity* entity);
+
+	// re-draws any render layers that have changed. Returns whether any were re-drawn
+	bool UpdateRenderLayers();
+
+	// Draws every entity (opaque then transparent back to front) and the render layers in between. 
+	// If region isn't nullptr only entities whose screen bounds overlap it are drawn
+	void DrawEntities(std::vector<RenderLayer*>& layersToComposite, const DirtyRegionTracker::Rect* region);
+
+	// Partial redraw mode: works out what changed, redraws it into the back buffer and copies that to the window
+	void PartialRedraw(std::vector<RenderLayer*>& layersToComposite, bool layersChanged);
+
+	// returns the pixels an entity covers on screen, from the main camera
+	DirtyRegionTracker::Rect GetEntityScreenBounds(std::shared_ptr<Entity> entity);
+
+	// Unbakes the batches of any static entity that changed and bakes static entities that have stopped changing. Run each frame before drawing
+	void UpdateStaticBatches();
+
+	// puts the given static entities into new static batches. Entities that can't be baked are skipped
+	void BakeStaticEntities(const std::vector<Entity*>& entities);
+
+	// throws a static batch away, its entities (and any other batches they're in) go back to being drawn normally
+	void UnbakeStaticBatch(StaticBatch* batch);
+
+	// stops keeping track of a static entity, unbaking it first
+	void RemoveStaticEntity(Entity* entity);
+
+	// whether an entity is baked into a static batch, so it shouldn't be drawn by itself
+	bool IsEntityBaked(Entity* entity);
+
+	// whether a static entity can be baked as it is right now (active, opaque and not in a render layer)
+	bool CanBakeEntity(std::shared_ptr<Entity> entity);
+
+	// the entity's state hash along with anything else that changes its baked vertices (the highest zIndex changes every entity's depth)
+	size_t GetStaticHash(std::shared_ptr<Entity> entity);
+
+	// adds a component's pre-transformed quads to vertices based on type. Returns false if the component can't be baked
+	bool BakeComponent(Entity::ComponentType type, std::shared_ptr<Component> component, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices);
+
+	// gets the local bounds of what a component draws based on type
+	void GetComponentLocalBounds(Entity::ComponentType type, std::shared_ptr<Component> component, glm::vec2& min, glm::vec2& max);
 	//when the last frame occurred in seconds (relative to how long program has been running for)
 	double lastFrameTime;
 };
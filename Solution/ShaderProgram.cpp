@@ -1,6 +1,9 @@
 #include "ShaderProgram.h"
 
 #include <glad/glad.h>
+#include "GLExtensions.h"
+#include "ProgramBinaryCache.h"
+#include "Hash.h"
 #include <fstream>
 #include <sstream>
 #include <glm/gtc/type_ptr.hpp> // used to convert glm matrices to data readable for opengl
@@ -13,39 +16,126 @@ ShaderProgram::ShaderProgram(std::string name)
 
 void ShaderProgram::Compile(const char* vertexSource, const char* fragmentSource)
 {
+	Submit(vertexSource, fragmentSource);
+	Finish();
+}
+
+void ShaderProgram::Submit(const char* vertexSource, const char* fragmentSource)
+{
+	/*
+	* Nothing in here asks GL whether something worked. Every status check (glGet*iv) makes the driver finish whatever it's doing first,
+	* so checking after each step would compile every program one at a time on this thread. Leaving the checks for Finish means the
+	* driver can keep compiling (on its own threads with parallel shader compile) while more programs get submitted
+	*/
+	_isFinished = false;
+	_isLinked = false;
+
+	// -- try the binary saved last time first, which skips compiling and linking completely --
+	_saveToCache = ProgramBinaryCache::IsAvailable();
+	if (_saveToCache)
+	{
+		_cacheKey = ProgramBinaryCache::GetKey(vertexSource, fragmentSource != nullptr ? fragmentSource : "");
+		// the same shaders capturing different outputs link to a different program
+		for (const std::string& varying : feedbackVaryings)
+			_cacheKey = Hash::Fnv1a(varying, _cacheKey);
+		ID = glCreateProgram();
+		if (ProgramBinaryCache::Load(ID, _cacheKey))
+		{
+			// loading it already checked it linked
+			_isFinished = true;
+			_isLinked = true;
+			return;
+		}
+		// start again with a fresh program so nothing from the failed binary is left over
+		glDeleteProgram(ID);
+	}
+
 	// generate an id for a vertex shader
-	unsigned int vertShaderID = glCreateShader(GL_VERTEX_SHADER);
+	_vertShaderID = glCreateShader(GL_VERTEX_SHADER);
 	// attach shader source code to the generated vertex shader
 	// param 1: shader id, 2: how many strings passing as source code, 3: source code, 4: unknown
-	glShaderSource(vertShaderID, 1, &vertexSource, NULL);
+	glShaderSource(_vertShaderID, 1, &vertexSource, NULL);
 	// compile the shader
-	glCompileShader(vertShaderID);
-	// error check
-	CheckCompileErrors(vertShaderID, ShaderType::Vertex);
-
+	glCompileShader(_vertShaderID);
 
-	// do the same for frag shader
-	unsigned int fragShaderID = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragShaderID, 1, &fragmentSource, NULL);
-	glCompileShader(fragShaderID);
-	// error check
-	CheckCompileErrors(fragShaderID, ShaderType::Fragment);
+	// do the same for frag shader, if there is one
+	if (fragmentSource != nullptr)
+	{
+		_fragShaderID = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(_fragShaderID, 1, &fragmentSource, NULL);
+		glCompileShader(_fragShaderID);
+	}
 
 	// create a shader program, returns ID of it
 	ID = glCreateProgram();
 
 	// attach shaders to prorgram
-	glAttachShader(ID, vertShaderID);
-	glAttachShader(ID, fragShaderID);
-	// link shaders
+	glAttachShader(ID, _vertShaderID);
+	if (_fragShaderID != 0)
+		glAttachShader(ID, _fragShaderID);
+	// which outputs get captured has to be set before linking
+	if (!feedbackVaryings.empty())
+	{
+		std::vector<const char*> varyingNames;
+		for (const std::string& varying : feedbackVaryings)
+			varyingNames.push_back(varying.c_str());
+		glTransformFeedbackVaryings(ID, (GLsizei)varyingNames.size(), varyingNames.data(), GL_INTERLEAVED_ATTRIBS);
+	}
+	// tell the driver to keep the binary around so it can be saved
+	if (_saveToCache)
+		GLExtensions::ProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	// link shaders. Linking doesn't need the compiles to be checked first, it just fails if one of them did
 	glLinkProgram(ID);
+}
 
-	// error check
-	CheckCompileErrors(ID, ShaderType::Program);
+bool ShaderProgram::IsReady()
+{
+	if (_isFinished)
+		return true;
+
+	// without parallel compile there's no way to ask without waiting, so just finish it
+	if (GLExtensions::hasParallelShaderCompile)
+	{
+		GLint completed = GL_FALSE;
+		glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &completed);
+		if (completed != GL_TRUE)
+			return false;
+	}
+
+	Finish();
+	return true;
+}
+
+bool ShaderProgram::IsLinked()
+{
+	Finish();
+	return _isLinked;
+}
+
+void ShaderProgram::Finish()
+{
+	if (_isFinished)
+		return;
+	_isFinished = true;
+
+	// error check. The link status is enough to know if everything worked, the shaders only need checking to find out why it didn't
+	_isLinked = CheckCompileErrors(ID, ShaderType::Program);
+	if (!_isLinked)
+	{
+		CheckCompileErrors(_vertShaderID, ShaderType::Vertex);
+		if (_fragShaderID != 0)
+			CheckCompileErrors(_fragShaderID, ShaderType::Fragment);
+	}
+	// only save it if it actually linked
+	else if (_saveToCache)
+		ProgramBinaryCache::Save(ID, _cacheKey);
 
 	// cleanup shaders don't need them anymore cos they attached
-	glDeleteShader(vertShaderID);
-	glDeleteShader(fragShaderID);
+	glDeleteShader(_vertShaderID);
+	if (_fragShaderID != 0)
+		glDeleteShader(_fragShaderID);
+	_vertShaderID = 0;
+	_fragShaderID = 0;
 }
 
 
@@ -58,6 +148,8 @@ ShaderProgram::~ShaderProgram()
 
 void ShaderProgram::Use()
 {
+	// the driver would wait for it anyway, this way any errors get printed
+	Finish();
 	// use/activate the shader
 	glUseProgram(ID);
 }
@@ -151,7 +243,7 @@ void ShaderProgram::SetVector2f(const char* uniformName, glm::vec2 vector)
 	glUniform2f(uniformLocation, vector.x, vector.y);
 }
 
-void ShaderProgram::CheckCompileErrors(unsigned int objectID, ShaderType type)
+bool ShaderProgram::CheckCompileErrors(unsigned int objectID, ShaderType type)
 {
 	int success;
 	char infoLog[1024];
@@ -179,4 +271,5 @@ void ShaderProgram::CheckCompileErrors(unsigned int objectID, ShaderType type)
 				<< std::endl;
 		}
 	}
+	return success != 0;
 }
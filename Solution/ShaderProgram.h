@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp> // OpenGL maths: Include all GLM core / GLSL features
 #include <iostream>
+#include <string>
+#include <vector>
 
 // Make a a shader program easily
 class ShaderProgram
@@ -12,13 +14,29 @@ public:
 	
 	// name of the shader prorgram which can be indexed through resource manager
 	std::string name;
+	// Names of vertex shader outputs that get written into transform feedback buffers (one after the other in one buffer), for programs
+	// that work out data on the gpu instead of drawing it (e.g. GPUParticleSystem). Has to be set before Submit/Compile
+	std::vector<std::string> feedbackVaryings;
 	// Reads in a vertex and fragment shader from files, then builds the shaders, optional boolean reference is whether or not everything built without errors
 	ShaderProgram(std::string name);
 	//ShaderProgram();
 	~ShaderProgram();
 
-	// compiles the shader from given source code
+	// compiles the shader from given source code. fragmentSource can be nullptr for a program that only uses the vertex shader with transform feedback,
+	// or or loads it from ProgramBinaryCache if it was compiled on an earlier launch.
+	// Waits for it to finish, same as Submit then Finish
 	void Compile(const char* vertexSource, const char* fragmentSource);
+	// Starts compiling and linking without waiting for any of it or checking for errors. Submit every program first then check them
+	// later (IsReady/Finish) so the driver can compile them all at the same time instead of one after the other
+	void Submit(const char* vertexSource, const char* fragmentSource);
+	// Whether the program has finished compiling and linking (whether it worked or not). Doesn't wait with parallel shader compile,
+	// without it there's no way to ask without waiting so it just finishes it
+	bool IsReady();
+	// whether the program linked, waits for it if it isn't ready
+	bool IsLinked();
+	// Waits for the submitted program, prints any errors and saves it to the cache. Use() calls this so a program
+	// can be used straight after it's submitted, it just waits then
+	void Finish();
 
 	// use/activate the shader
 	void Use();
@@ -37,6 +55,16 @@ public:
 	// set a float vector 2 uniform
 	void SetVector2f(const char* uniformName, glm::vec2 vector);
 private:
+	// shaders being compiled, deleted once the program is finished
+	unsigned int _vertShaderID = 0;
+	unsigned int _fragShaderID = 0;
+	// whether Finish has been done (or there was nothing to finish)
+	bool _isFinished = true;
+	bool _isLinked = false;
+	// whether to save it to ProgramBinaryCache once it's linked, and the key to save it under
+	bool _saveToCache = false;
+	unsigned long long _cacheKey = 0;
+
 	// used to check for compile errors
 	enum ShaderType {
 		Vertex,
@@ -45,6 +73,6 @@ private:
 		Program
 	};
 
-	// checks for compile errors based on given shader type
-	void CheckCompileErrors(unsigned int objectID, ShaderType type);
+	// checks for compile errors based on given shader type, returns whether it compiled/linked
+	bool CheckCompileErrors(unsigned int objectID, ShaderType type);
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "ShapePipeline.h"
+#include "ResourceManager.h"
+#include <cstddef>
+
+const char* ShapePipeline::defaultVertPath = "VertexShaders/ShapeDefault.vert";
+const char* ShapePipeline::defaultFragPath = "FragmentShaders/ShapeDefault.frag";
+const char* ShapePipeline::defaultProgramName = "defaultShapeProgram";
+
+ShaderProgram* ShapePipeline::_defaultProgram = nullptr;
+InstanceLayout* ShapePipeline::_layout = nullptr;
+unsigned int ShapePipeline::quadVAO = 0;
+unsigned int ShapePipeline::quadVBO = 0;
+unsigned int ShapePipeline::quadEBO = 0;
+
+void ShapePipeline::Initialise()
+{
+	// already done
+	if (_layout != nullptr)
+		return;
+
+	_defaultProgram = ResourceManager::LoadShaderProgram(defaultProgramName, defaultVertPath, defaultFragPath);
+
+	// normalised vertics from -1 to 1 on x and y axis. These start as 1s but the size transform changes them
+	float vertices[] = {
+		// positions        
+		1.0f,   1.0f, 0.0f, // top-right
+		1.0f,  -1.0f, 0.0f, // bottom-right
+		-1.0f, -1.0f, 0.0f, // bottom left
+		-1.0f,  1.0f, 0.0f  // top left
+	};
+	// define what order of vertices to draw rectangle
+	unsigned int indices[] = {  // note this is 0 based index
+		0, 1, 2,   // first triangle
+		2, 3, 0    // second triangle
+	};
+
+	// note that the VBO, VAO and EBO are actually just IDs to their values which are handled by opengl
+
+	// vertex buffer object, stores vertices
+	glGenBuffers(1, &quadVBO); // generate one buffer 
+
+	// vertex array object, holds all configurations for a VBO/EBO
+	glGenVertexArrays(1, &quadVAO); // generate 1 vertex arrya object
+
+	// Element buffer object, stores index to how vertices should be drawn cutting down amount needed
+	glGenBuffers(1, &quadEBO); // generate 1 elment buffer object
+
+	glBindVertexArray(quadVAO); // bind the vertex array object 
+
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO); // bind the generated buffer to array buffer target
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW); // place vertex data into buffer memory
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);// bind generated element buffer object
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);// bind indicies to element buffer
+
+	// set vertex attribute position pointer at location 0, with 3 values, of type float, don't normalise data, stride is 3 values, offser of 0 bytes
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	// enable the created attribute which is at location 0
+	glEnableVertexAttribArray(0);
+
+	// unbind
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	// -- per instance attributes, these are read from the scene's stream buffer when drawn --
+	_layout = new InstanceLayout(quadVAO, sizeof(InstanceData));
+	// model transform at locations 1 to 4
+	_layout->AddMatrix4Attribute(1, offsetof(InstanceData, modelTransform));
+	// fill colour at location 5
+	_layout->AddAttribute(5, 4, offsetof(InstanceData, fillColor));
+	// border colour at location 6
+	_layout->AddAttribute(6, 4, offsetof(InstanceData, strokeColor));
+	// shape type and parameters at location 7
+	_layout->AddAttribute(7, 4, offsetof(InstanceData, shapeParams));
+	// half size at location 8
+	_layout->AddAttribute(8, 2, offsetof(InstanceData, halfSize));
+	// line points at location 9
+	_layout->AddAttribute(9, 4, offsetof(InstanceData, linePoints));
+}
+
+ShaderProgram* ShapePipeline::GetDefaultProgram()
+{
+	Initialise();
+	return _defaultProgram;
+}
+
+DrawBatcher::DrawState ShapePipeline::GetDrawState(ShaderProgram* program)
+{
+	Initialise();
+
+	DrawBatcher::DrawState state;
+	state.program = program;
+	state.layout = _layout;
+	return state;
+}
+
+DrawBatcher::MeshRange ShapePipeline::GetMesh()
+{
+	// the 6 indices of the quad
+	DrawBatcher::MeshRange mesh;
+	mesh.indexCount = 6;
+	return mesh;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "ShaderProgram.h"
+#include "InstanceLayout.h"
+#include "DrawBatcher.h"
+
+// Rectangles, rounded rectangles, ellipses and lines are all drawn through this. They share one program (ShapeDefault), one quad and one instance layout,
+// each instance says what shape it is and the fragment shader works out how much of each pixel the shape covers (signed distance functions).
+// That means shapes of different types can go in the same instanced draw, so a scene mixing them is one draw per blend group (opaque / transparent run)
+// instead of switching programs whenever the shape type changes.
+// Static class like the resource manager because everything in it is shared
+class ShapePipeline
+{
+public:
+	// which signed distance function an instance uses
+	enum ShapeType {
+		// fills the whole quad
+		Rectangle = 0,
+		// rectangle with rounded corners, the corner radius is in shapeParams.y
+		RoundedRectangle = 1,
+		Ellipse = 2,
+		// quad stretched between linePoints by the vertex shader. shapeParams.y is 1 for round caps (otherwise the ends are flat) and shapeParams.w is the thickness
+		Line = 3
+	};
+
+	// what gets sent to the gpu for each shape
+	struct InstanceData {
+		glm::mat4 modelTransform;
+		// colour inside the border
+		glm::vec4 fillColor;
+		// colour of the border
+		glm::vec4 strokeColor;
+		// x: shape type, y: corner radius (rounded rect) or round caps (line), z: border width, w: thickness (line)
+		glm::vec4 shapeParams;
+		// half the width and height of the shape in global units before it is rotated. The shader measures the corner radius and border in these units.
+		// Not used by lines, the vertex shader works it out from the points
+		glm::vec2 halfSize;
+		// lines only: xy is the first point and zw is the second (global coords)
+		glm::vec4 linePoints;
+	};
+
+	// Loads the shared program, quad and layout if they haven't been already. Needs a current GL context
+	static void Initialise();
+
+	// the program every shape renderer uses unless it is given its own
+	static ShaderProgram* GetDefaultProgram();
+
+	// draw state for a shape drawn with program. A custom program has to take the same per-instance attributes as ShapeDefault.vert
+	static DrawBatcher::DrawState GetDrawState(ShaderProgram* program);
+
+	// part of the quad to draw (all of it)
+	static DrawBatcher::MeshRange GetMesh();
+
+private:
+	// default vertex sahader
+	static const char* defaultVertPath;
+	// default frag sahader
+	static const char* defaultFragPath;
+	// name that the default program is stored under in the resource manager
+	static const char* defaultProgramName;
+
+	static ShaderProgram* _defaultProgram;
+	static InstanceLayout* _layout;
+	// vretex array object ID for the shared quad
+	static unsigned int quadVAO;
+	static unsigned int quadVBO;
+	static unsigned int quadEBO;
+
+	// private constructor, only static functions
+	ShapePipeline();
+};
+
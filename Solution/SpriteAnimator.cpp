@@ -0,0 +1,108 @@
+#include "SpriteAnimator.h"
+#include "Entity.h"
+#include "SpriteRenderer.h"
+#include <cmath>
+
+SpriteAnimator::SpriteAnimator(std::shared_ptr<SpriteSheet> spriteSheet, unsigned int clip)
+{
+	if (spriteSheet == nullptr)
+		throw std::exception("Tried to make a sprite animator without a sprite sheet");
+
+	// set type of component
+	this->type = Entity::SpriteAnimator;
+	_spriteSheet = spriteSheet;
+	// checks the clip exists
+	Play(clip, true);
+}
+
+std::shared_ptr<SpriteSheet> SpriteAnimator::GetSpriteSheet()
+{
+	return _spriteSheet;
+}
+
+void SpriteAnimator::Play(unsigned int clip, bool restart)
+{
+	if (clip >= _spriteSheet->GetClipCount())
+		throw std::exception("Tried to play a clip that isn't in the animator's sprite sheet");
+
+	// keep going if it's already playing
+	if (clip == _clip && !restart)
+		return;
+
+	_clip = clip;
+	_time = 0.0;
+	ShowFrame();
+}
+
+void SpriteAnimator::Play(std::string clipName, bool restart)
+{
+	int clip = _spriteSheet->GetClipIndex(clipName);
+	if (clip == -1)
+		throw std::exception("Tried to play a clip that isn't in the animator's sprite sheet");
+
+	Play((unsigned int)clip, restart);
+}
+
+unsigned int SpriteAnimator::GetClip()
+{
+	return _clip;
+}
+
+double SpriteAnimator::GetTime()
+{
+	return _time;
+}
+
+void SpriteAnimator::SetTime(double newTime)
+{
+	_time = newTime;
+	ShowFrame();
+}
+
+bool SpriteAnimator::IsFinished()
+{
+	return !_spriteSheet->GetClip(_clip).loop && _time >= _spriteSheet->GetClipLength(_clip);
+}
+
+unsigned int SpriteAnimator::GetFrame()
+{
+	return _spriteSheet->GetFrameAt(_clip, _time);
+}
+
+void SpriteAnimator::Update(float deltaTime)
+{
+	if (!isPlaying)
+		return;
+
+	_time += deltaTime * speed;
+
+	// keep a looping clip's time inside one loop, otherwise it'd lose precision after running for a long time (and going backwards would go below 0)
+	double clipLength = _spriteSheet->GetClipLength(_clip);
+	if (_spriteSheet->GetClip(_clip).loop && std::isfinite(clipLength) && clipLength > 0.0)
+		_time -= std::floor(_time / clipLength) * clipLength;
+
+	ShowFrame();
+}
+
+void SpriteAnimator::SetSpriteRenderer(SpriteRenderer* renderer)
+{
+	_renderer = renderer;
+	// the new renderer hasn't been shown anything yet
+	_shownFrame = -1;
+	ShowFrame();
+}
+
+void SpriteAnimator::ShowFrame()
+{
+	// no sprite renderer on the entity (or not added to one yet), it's shown when there is one
+	if (_renderer == nullptr)
+		return;
+
+	// most updates are still on the same frame, nothing to change then
+	int frame = (int)GetFrame();
+	if (frame == _shownFrame)
+		return;
+
+	_renderer->sourceRect = _spriteSheet->GetFrame(frame);
+	_shownFrame = frame;
+}
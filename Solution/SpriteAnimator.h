@@ -0,0 +1,71 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "Component.h"
+#include "SpriteSheet.h"
+
+class SpriteRenderer;
+
+// Plays clips from a sprite sheet on the entity's SpriteRenderer. The sheet (frames and clips) is shared, each animator only has which clip
+// it's playing and how far into it it is. Every update it works out the frame from the time and sets the sprite renderer's sourceRect to it,
+// so animated sprites are still normal sprites on one texture and thousands of them go in the same batched draw.
+// The entity also needs a SpriteRenderer that draws the sheet's texture. The scene steps animators every frame (Update), even if they aren't drawn.
+// The renderer is found once when either component is added to the entity, and sourceRect is only set when the frame changes
+class SpriteAnimator :
+    public Component
+{
+public:
+    // Setup a new animator that plays clip from a sprite sheet
+    SpriteAnimator(std::shared_ptr<SpriteSheet> spriteSheet, unsigned int clip = 0);
+
+    // how fast the clip plays, 1 is normal speed
+    float speed = 1.0f;
+
+    // whether time is going forward
+    bool isPlaying = true;
+
+    // returns the sprite sheet
+    std::shared_ptr<SpriteSheet> GetSpriteSheet();
+
+    // starts playing a clip. If it's the clip already playing it keeps going unless restart is true
+    void Play(unsigned int clip, bool restart = false);
+    // starts playing a clip by name
+    void Play(std::string clipName, bool restart = false);
+
+    // returns the index of the clip that's playing
+    unsigned int GetClip();
+
+    // returns how many seconds into the clip it is
+    double GetTime();
+    // jumps to time seconds into the clip
+    void SetTime(double newTime);
+
+    // whether a clip that doesn't loop has got to its last frame
+    bool IsFinished();
+
+    // returns the index of the sprite sheet's frame that's showing
+    unsigned int GetFrame();
+
+    // moves time forward by deltaTime seconds and shows the frame for it on the sprite renderer
+    void Update(float deltaTime);
+
+    // Sets which sprite renderer frames are shown on (nullptr for none) and shows the current frame on it.
+    // The entity calls this when a SpriteAnimator or SpriteRenderer is added to or removed from it, so it doesn't need calling normally
+    void SetSpriteRenderer(SpriteRenderer* renderer);
+
+private:
+    std::shared_ptr<SpriteSheet> _spriteSheet;
+    // index of the clip in the sprite sheet
+    unsigned int _clip = 0;
+    // seconds since the clip started
+    double _time = 0.0;
+
+    // the parent entity's sprite renderer, owned by the entity
+    SpriteRenderer* _renderer = nullptr;
+    // the sprite sheet frame the renderer's sourceRect was last set to, -1 if it hasn't been
+    int _shownFrame = -1;
+
+    // sets the sprite renderer's source rect to the frame for the current time, if it's a different frame to the one showing
+    void ShowFrame();
+};
+
@@ -1,17 +1,31 @@
 #include "SpriteRenderer.h"
 #include "Entity.h"
 #include "ResourceManager.h"
+#include "Scene.h"
+#include "Hash.h"
 // glad is included already thru other include
 #include <glfw3.h>
 #include <string>
 #include <glm/gtc/matrix_transform.hpp> // matrix transformation math
+#include <cstddef>
+#include <vector>
+
+InstanceLayout* SpriteRenderer::_layout = nullptr;
+unsigned int SpriteRenderer::rectVAO = 0;
+unsigned int SpriteRenderer::rectVBO = 0;
+unsigned int SpriteRenderer::rectEBO = 0;
 
 SpriteRenderer::SpriteRenderer(Texture2D* texture, glm::vec3 color, ShaderProgram* program)
 {
 	// if the program wasn't specified 
 	if (program == nullptr)
-		// use default path, add time to end to avoid lots of recursion when there are many defaultSpritePrograms
-		this->shaderProgram = ResourceManager::LoadShaderProgram("defaultSpriteProgram" +std::to_string(glfwGetTime()), defaultVertPath, defaultFragPath);
+	{
+		// all default sprites share the same program, otherwise they couldn't be batched together
+		this->shaderProgram = ResourceManager::GetShader(defaultProgramName);
+		// load it if this is the first default sprite
+		if (this->shaderProgram == nullptr)
+			this->shaderProgram = ResourceManager::LoadShaderProgram(defaultProgramName, defaultVertPath, defaultFragPath);
+	}
 	else // else use given one
 		this->shaderProgram = program;
 
@@ -25,16 +39,33 @@ SpriteRenderer::SpriteRenderer(Texture2D* texture, glm::vec3 color, ShaderProgra
 	// set colour
 	this->color = color;
 
-	// initialise sprite rect
-	InitRenderData();
+	// initialise the shared sprite rect if this is the first sprite renderer
+	if (_layout == nullptr)
+		InitRenderData();
 }
 
-SpriteRenderer::~SpriteRenderer()
+SpriteRenderer::SpriteRenderer(TextureArray* textureArray, unsigned int layer, glm::vec3 color, ShaderProgram* program)
 {
-	// de-allocate all resources once they've outlived their purpose
-	glDeleteVertexArrays(1, &rectVAO);
-	glDeleteBuffers(1, &rectVBO);
-	glDeleteBuffers(1, &rectEBO);
+	// same as above but with the texture array program
+	if (program == nullptr)
+	{
+		this->shaderProgram = ResourceManager::GetShader(defaultArrayProgramName);
+		if (this->shaderProgram == nullptr)
+			this->shaderProgram = ResourceManager::LoadShaderProgram(defaultArrayProgramName, defaultArrayVertPath, defaultArrayFragPath);
+	}
+	else
+		this->shaderProgram = program;
+
+	this->type = Entity::SpriteRenderer;
+	this->textureArray = textureArray;
+	SetLayer(layer);
+	if (textureArray->imageFormat == GL_RGBA)
+		this->hasTransprency = true;
+	this->color = color;
+
+	// array sprites share the same rect and layout as normal ones
+	if (_layout == nullptr)
+		InitRenderData();
 }
 
 float SpriteRenderer::GetAlpha()
@@ -66,53 +97,214 @@ void SpriteRenderer::SetAlpha(float newAlpha)
 	}
 }
 
+unsigned int SpriteRenderer::GetLayer()
+{
+	return _layer;
+}
+
+void SpriteRenderer::SetLayer(unsigned int newLayer)
+{
+	// normal textures only have the one layer
+	if (textureArray == nullptr)
+		return;
+
+	if (newLayer >= textureArray->layerCount)
+		throw std::exception("Tried to set a sprite's layer to one that isn't in its texture array");
+
+	_layer = newLayer;
+}
+
 void SpriteRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
 {
 	if (parentEntity == nullptr)
 		throw std::exception("Tried to draw a sprite which doesn't have a parent entity");
 
-	shaderProgram->Use();
-	
-	// get the transform of this renderer's parent
-	Transform spriteTransform = parentEntity->transform;
-	glm::mat4 view = camera->GetViewMatrix();
-	shaderProgram->SetMatrix4("view", view);
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a sprite which isn't in a scene");
 
-	glm::mat4 projection = camera->GetProjectionMatrix();
-	shaderProgram->SetMatrix4("projection", projection);
+	InstanceData instance;
+	// sprite transform
+	instance.modelTransform = parentEntity->transform.ToMatrix(camera);
+	// color of sprite with alpha channel included
+	instance.color = glm::vec4(color, _alpha);
+	// the source rect inside the texture's part of the atlas page (or all of it if it isn't in one). Texture arrays just use the source rect of the layer
+	instance.uvRect = GetUVRect();
+	instance.layer = (float)_layer;
+	// the vertex shader turns these into the 9 quads, working out how big they are from the size in modelTransform
+	instance.sliceBorders = sliceBorders * sliceScale;
+	instance.sliceUVs = GetSliceUVs();
 
-	// sey sprite transform
-	shaderProgram->SetMatrix4("modelTransform", spriteTransform.ToMatrix(camera));
-	// set color of sprite with alpha channel included
-	shaderProgram->SetVector4f("spriteColor", glm::vec4(color, _alpha));
+	DrawBatcher::DrawState state;
+	state.program = shaderProgram;
+	state.layout = _layout;
+	// sprites with different textures can't be drawn together. Different layers of the same array can
+	if (texture != nullptr)
+		state.texture = texture->ID;
+	else
+	{
+		state.textureTarget = GL_TEXTURE_2D_ARRAY;
+		state.texture = textureArray->ID;
+	}
 
-	// bind texture onto corresponding texture unit
-	glActiveTexture(GL_TEXTURE0);
-	texture->Bind();
+	// draw the 6 indices of the rect, or the nine-slice grid after it. Both are in the same buffers so they still go in the same submission
+	DrawBatcher::MeshRange mesh;
+	mesh.indexCount = rectIndexCount;
+	if (IsNineSliced())
+	{
+		mesh.indexCount = sliceIndexCount;
+		mesh.firstIndex = rectIndexCount;
+		mesh.baseVertex = 4;
+	}
 
-	// draw the rect
-	glBindVertexArray(this->rectVAO);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	parentEntity->parentScene->drawBatcher.AddInstance(state, mesh, &instance);
+}
 
-	glBindVertexArray(0);
+size_t SpriteRenderer::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, color);
+	Hash::Add(hash, _alpha);
+	Hash::Add(hash, shaderProgram);
+	Hash::Add(hash, sourceRect);
+	Hash::Add(hash, sliceBorders);
+	Hash::Add(hash, sliceScale);
+	if (texture != nullptr)
+	{
+		Hash::Add(hash, texture->ID);
+		Hash::Add(hash, texture->uvRect);
+	}
+	else
+	{
+		Hash::Add(hash, textureArray->ID);
+		Hash::Add(hash, _layer);
+	}
+	return hash;
+}
+
+bool SpriteRenderer::BakeStatic(std::shared_ptr<OrthoCamera> camera, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices)
+{
+	// the static batch shaders only do what the default sprite shaders do
+	if (shaderProgram != ResourceManager::GetShader((texture != nullptr) ? defaultProgramName : defaultArrayProgramName))
+		return false;
+
+	// same texture and uv rect as Draw, sprites in the same atlas page end up with the same key
+	key = StaticBatch::Key();
+	glm::vec4 uvRect = GetUVRect();
+	if (texture != nullptr)
+		key.texture = texture->ID;
+	else
+	{
+		key.textureTarget = GL_TEXTURE_2D_ARRAY;
+		key.texture = textureArray->ID;
+	}
+
+	glm::mat4 model = parentEntity->transform.ToMatrix(camera);
+	glm::vec4 bakedColor = glm::vec4(color, _alpha);
+
+	if (!IsNineSliced())
+	{
+		StaticBatch::AddQuad(vertices, model, glm::vec2(-1.0f), glm::vec2(1.0f), bakedColor, uvRect, (float)_layer);
+		return true;
+	}
+
+	// -- the same 9 quads the vertex shader makes (see SpriteDefault.vert) --
+	// the quad is 2 local units across the whole size, so a border in global units is 2 * border / size in local units
+	glm::vec2 size = glm::max(glm::vec2(parentEntity->transform.GetGlobalSize(camera)), glm::vec2(0.0001f));
+	glm::vec4 localBorders = sliceBorders * sliceScale * 2.0f / glm::vec4(size.x, size.x, size.y, size.y);
+	// borders that add up to more than the sprite get shrunk to fit
+	float shrinkX = glm::min(1.0f, 2.0f / glm::max(localBorders.x + localBorders.y, 0.0001f));
+	float shrinkY = glm::min(1.0f, 2.0f / glm::max(localBorders.z + localBorders.w, 0.0001f));
+	glm::vec4 sliceUVs = GetSliceUVs();
+
+	// where each column and row of the grid is, in local coords and uvs of the drawn part
+	float columns[4] = { -1.0f, -1.0f + localBorders.x * shrinkX, 1.0f - localBorders.y * shrinkX, 1.0f };
+	float rows[4] = { -1.0f, -1.0f + localBorders.z * shrinkY, 1.0f - localBorders.w * shrinkY, 1.0f };
+	float columnUVs[4] = { 0.0f, sliceUVs.x, 1.0f - sliceUVs.y, 1.0f };
+	float rowUVs[4] = { 0.0f, sliceUVs.z, 1.0f - sliceUVs.w, 1.0f };
+
+	for (int row = 0; row < 3; row++)
+		for (int column = 0; column < 3; column++)
+		{
+			// the cell's part of the drawn part of the texture
+			glm::vec2 cellUVMin = glm::vec2(columnUVs[column], rowUVs[row]);
+			glm::vec2 cellUVSize = glm::vec2(columnUVs[column + 1], rowUVs[row + 1]) - cellUVMin;
+			glm::vec4 cellUVRect = glm::vec4(glm::vec2(uvRect.x, uvRect.y) + cellUVMin * glm::vec2(uvRect.z, uvRect.w), cellUVSize * glm::vec2(uvRect.z, uvRect.w));
+
+			StaticBatch::AddQuad(vertices, model, glm::vec2(columns[column], rows[row]), glm::vec2(columns[column + 1], rows[row + 1]), bakedColor, cellUVRect, (float)_layer);
+		}
+	return true;
+}
+
+glm::vec4 SpriteRenderer::GetUVRect()
+{
+	// texture arrays don't go in the atlas, every layer is the whole texture
+	if (texture == nullptr)
+		return sourceRect;
+
+	// squash the source rect into the texture's part of its page
+	glm::vec4 textureRect = texture->uvRect;
+	return glm::vec4(glm::vec2(textureRect.x, textureRect.y) + glm::vec2(sourceRect.x, sourceRect.y) * glm::vec2(textureRect.z, textureRect.w),
+		glm::vec2(sourceRect.z, sourceRect.w) * glm::vec2(textureRect.z, textureRect.w));
+}
+
+bool SpriteRenderer::IsNineSliced()
+{
+	return sliceBorders != glm::vec4(0.0f);
+}
+
+glm::vec4 SpriteRenderer::GetSliceUVs()
+{
+	if (!IsNineSliced())
+		return glm::vec4(0.0f);
+
+	// pixels of the drawn part of the image
+	glm::vec2 imageSize = (texture != nullptr) ? glm::vec2((float)texture->width, (float)texture->height) : glm::vec2((float)textureArray->width, (float)textureArray->height);
+	glm::vec2 drawnSize = imageSize * glm::vec2(sourceRect.z, sourceRect.w);
+	// an async texture doesn't have a size until it's loaded
+	if (drawnSize.x <= 0.0f || drawnSize.y <= 0.0f)
+		return glm::vec4(0.0f);
+
+	return sliceBorders / glm::vec4(drawnSize.x, drawnSize.x, drawnSize.y, drawnSize.y);
 }
 
 void SpriteRenderer::InitRenderData()
 {
 	// normalised vertics from -1 to 1 on x and y axis. These start as 1s but the size transform changes them
-	float vertices[] = {
-		// positions        // texture coords
-		1.0f,   1.0f, 0.0f,   1.0f, 1.0f, // top right
-		1.0f,  -1.0f, 0.0f,   1.0f, 0.0f, // bottom right
-		-1.0f, -1.0f, 0.0f,   0.0f, 0.0f, // bottom left
-		-1.0f,  1.0f, 0.0f,   0.0f, 1.0f, // top left 
+	// The slice offset is which way the vertex is moved in by the nine-slice borders, it's 0 for the plain rect
+	std::vector<float> vertices = {
+		// positions        // texture coords // slice offset
+		1.0f,   1.0f, 0.0f,   1.0f, 1.0f,     0.0f, 0.0f, // top right
+		1.0f,  -1.0f, 0.0f,   1.0f, 0.0f,     0.0f, 0.0f, // bottom right
+		-1.0f, -1.0f, 0.0f,   0.0f, 0.0f,     0.0f, 0.0f, // bottom left
+		-1.0f,  1.0f, 0.0f,   0.0f, 1.0f,     0.0f, 0.0f, // top left 
 	};
 	// define what order of vertices to draw rectangle
-	unsigned int indices[] = {  // note this is 0 based index
+	std::vector<unsigned int> indices = {  // note this is 0 based index
 		0, 1, 2,   // first triangle
 		2, 3, 0    // second triangle
 	};
 
+	// -- nine-slice grid, 4x4 vertices from the bottom left --
+	// The inner 2 columns/rows start on the edges (same as the outer ones) and the vertex shader moves them in by the borders.
+	// Column 1 moves right by the left border, column 2 moves left by the right border, same for rows with the bottom/top borders
+	for (int row = 0; row < 4; row++)
+		for (int column = 0; column < 4; column++)
+		{
+			float edgeX = (column < 2) ? -1.0f : 1.0f;
+			float edgeY = (row < 2) ? -1.0f : 1.0f;
+			float offsetX = (column == 1) ? 1.0f : ((column == 2) ? -1.0f : 0.0f);
+			float offsetY = (row == 1) ? 1.0f : ((row == 2) ? -1.0f : 0.0f);
+			vertices.insert(vertices.end(), { edgeX, edgeY, 0.0f,   (edgeX + 1.0f) / 2.0f, (edgeY + 1.0f) / 2.0f,   offsetX, offsetY });
+		}
+	// 2 triangles for each of the 9 cells. These are relative to the grid's first vertex (the draw's base vertex)
+	for (unsigned int row = 0; row < 3; row++)
+		for (unsigned int column = 0; column < 3; column++)
+		{
+			unsigned int bottomLeft = row * 4 + column;
+			unsigned int topLeft = bottomLeft + 4;
+			indices.insert(indices.end(), { bottomLeft, bottomLeft + 1, topLeft + 1,   topLeft + 1, topLeft, bottomLeft });
+		}
+
 	// note that the VBO, VAO and EBO are actually just IDs to their values which are handled by opengl
 
 	// vertex buffer object, stores vertices
@@ -127,22 +319,41 @@ void SpriteRenderer::InitRenderData()
 	glBindVertexArray(rectVAO); // bind the vertex array object 
 
 	glBindBuffer(GL_ARRAY_BUFFER, rectVBO); // bind the generated buffer to array buffer target
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW); // place vertex data into buffer memory
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW); // place vertex data into buffer memory
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rectEBO);// bind generated element buffer object
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);// bind indicies to element buffer
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);// bind indicies to element buffer
 
-	// set vertex attribute position pointer at location 0, with 3 values, of type float, don't normalise data, stride is 5 values, offser of 0 bytes
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	// set vertex attribute position pointer at location 0, with 3 values, of type float, don't normalise data, stride is 7 values, offser of 0 bytes
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)0);
 	// enable the created attribute which is at location 0
 	glEnableVertexAttribArray(0);
 
-	// set vertex attribute texture coords pointer at location 1, with 2 values, of type float, don't normalise data, stride is 5 float values, offset of 3 floats (3 * sizeof (float) bytes)
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	// set vertex attribute texture coords pointer at location 1, with 2 values, of type float, don't normalise data, stride is 7 float values, offset of 3 floats (3 * sizeof (float) bytes)
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
 	// enable the created attribute which is at location 0
 	glEnableVertexAttribArray(1);
 
+	// nine-slice offset at location 9 (2 to 8 are per instance), offset of 5 floats
+	glVertexAttribPointer(9, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(5 * sizeof(float)));
+	glEnableVertexAttribArray(9);
+
 	// unbind
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+
+	// -- per instance attributes, these are read from the scene's stream buffer when drawn --
+	_layout = new InstanceLayout(rectVAO, sizeof(InstanceData));
+	// model transform at locations 2 to 5
+	_layout->AddMatrix4Attribute(2, offsetof(InstanceData, modelTransform));
+	// colour at location 6
+	_layout->AddAttribute(6, 4, offsetof(InstanceData, color));
+	// uv rect at location 7
+	_layout->AddAttribute(7, 4, offsetof(InstanceData, uvRect));
+	// texture array layer at location 8
+	_layout->AddAttribute(8, 1, offsetof(InstanceData, layer));
+	// nine-slice borders in global units at location 10
+	_layout->AddAttribute(10, 4, offsetof(InstanceData, sliceBorders));
+	// nine-slice borders in uvs at location 11
+	_layout->AddAttribute(11, 4, offsetof(InstanceData, sliceUVs));
 }
@@ -2,46 +2,119 @@
 #include "Component.h"
 #include "ShaderProgram.h"
 #include "Texture2D.h"
+#include "TextureArray.h"
 #include "OrthoCamera.h"
+#include "InstanceLayout.h"
+#include "StaticBatch.h"
 
 class SpriteRenderer :
     public Component
 {
 public:
     // Setup a new sprite renderer using given shader program, texture and colour of sprite
-    // NOTE: If shader program is set to nullptr it will use a default shader
+    // NOTE: If shader program is set to nullptr it will use a default shader. A custom shader has to take the same per-instance attributes as SpriteDefault.vert
     SpriteRenderer(Texture2D* texture, glm::vec3 color = glm::vec3(1.0f) , ShaderProgram* program = nullptr);
-    ~SpriteRenderer();
+
+    // Setup a new sprite renderer that draws one layer of a texture array. Sprites using the same array are batched together whatever layer they use
+    // NOTE: If shader program is set to nullptr it will use the default texture array shader (SpriteArray.vert/.frag)
+    SpriteRenderer(TextureArray* textureArray, unsigned int layer, glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
 
     // colour of the sprite
     glm::vec3 color;
 
+    // Part of the texture (or texture array layer) to draw, xy: bottom left corner and zw: size, from 0 to 1 across the image. The whole image by default.
+    // It's still the same texture so sprites showing different parts of it are batched together. SpriteAnimator sets this to its current frame
+    glm::vec4 sourceRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+    // Nine-slice mode (for UI panels, buttons etc.): the image is split by these borders (pixels of the image, or of the source rect's part of it) into 9 parts.
+    // The corners are never stretched, the edges only stretch along their edge and the middle stretches both ways, so resizing the sprite doesn't distort its borders.
+    // x: left, y: right, z: bottom, w: top. All 0 (the default) stretches the whole image like normal.
+    // The 9 quads are made by the vertex shader from a grid that is part of the shared sprite mesh, so sliced sprites are batched with normal sprites
+    // on the same texture and resizing them (e.g. with relative sizes) doesn't rebuild anything
+    glm::vec4 sliceBorders = glm::vec4(0.0f);
+
+    // how many global units one pixel of the slice borders is drawn as
+    float sliceScale = 1.0f;
+
     // get the alpha (transparency) value of this sprite
     float GetAlpha();
 
     // set the alpha (transparency) value of this sprite
     void SetAlpha(float newAlpha);
 
-    // draw a sprite using reference to scene camera and parent entity's transform
+    // get which layer of the texture array is drawn (always 0 for a normal texture)
+    unsigned int GetLayer();
+
+    // set which layer of the texture array is drawn. Does nothing for a normal texture
+    void SetLayer(unsigned int newLayer);
+
+    // draw a sprite using reference to scene camera and parent entity's transform.
+    // The sprite is added to the scene's draw batcher so it gets drawn along with every other sprite that uses the same program and texture.
+    // Textures in the same atlas page count as the same texture
     void Draw(std::shared_ptr<OrthoCamera> camera);
 
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing
+    size_t GetStateHash();
+
+    // Adds the sprite to vertices as a pre-transformed quad for a static batch (see Scene::BakeStatic), with its texture in key so sprites
+    // on the same texture or atlas page share a batch. Returns false if it can't be baked (custom shader) and doesn't add anything
+    bool BakeStatic(std::shared_ptr<OrthoCamera> camera, StaticBatch::Key& key, std::vector<StaticBatch::Vertex>& vertices);
+
 private:
+    // what gets sent to the gpu for each sprite
+    struct InstanceData {
+        glm::mat4 modelTransform;
+        glm::vec4 color;
+        // part of the texture to use, see Texture2D::uvRect
+        glm::vec4 uvRect;
+        // layer of the texture array, unused by normal textures
+        float layer;
+        // nine-slice borders in global units (left, right, bottom, top), 0 when it isn't sliced
+        glm::vec4 sliceBorders;
+        // nine-slice borders in uvs of the drawn part of the texture (0 to 1 across the source rect)
+        glm::vec4 sliceUVs;
+    };
+
     // the alpha channel (transparency) of the current sprite
     float _alpha = 1.0f;
     // shader program that the sprite renderer uses
     ShaderProgram* shaderProgram;
-    // texture that the sprite renderer uses
-    Texture2D* texture;
+    // texture that the sprite renderer uses, nullptr if it uses a texture array
+    Texture2D* texture = nullptr;
+    // texture array that the sprite renderer uses, nullptr if it uses a normal texture
+    TextureArray* textureArray = nullptr;
+    // layer of the texture array to draw
+    unsigned int _layer = 0;
     // default vertex sahader
     const char* defaultVertPath = "VertexShaders/SpriteDefault.vert";
     // default frag sahader
     const char* defaultFragPath = "FragmentShaders/SpriteDefault.frag";
-    // vretex array object ID for the sprite's rect
-    unsigned int rectVAO;
-    unsigned int rectVBO;
-    unsigned int rectEBO;
-    // Initializes and configures the rects's buffer and vertex attributes
-    void InitRenderData();
+    // name that the default program is stored under in the resource manager. Every default sprite shares it
+    const char* defaultProgramName = "defaultSpriteProgram";
+    // default shaders and program name for sprites that use a texture array
+    const char* defaultArrayVertPath = "VertexShaders/SpriteArray.vert";
+    const char* defaultArrayFragPath = "FragmentShaders/SpriteArray.frag";
+    const char* defaultArrayProgramName = "defaultSpriteArrayProgram";
+    // Every sprite renderer shares one rect mesh and instance layout, that way they can all be drawn in one instanced draw
+    static InstanceLayout* _layout;
+    // Every sprite's mesh: a plain rect (4 vertices, 6 indices) and then a 4x4 grid of vertices for nine-slice sprites (16 vertices, 54 indices)
+    static const GLsizei rectIndexCount = 6;
+    static const GLsizei sliceIndexCount = 54;
+    // vretex array object ID for the shared rect
+    static unsigned int rectVAO;
+    static unsigned int rectVBO;
+    static unsigned int rectEBO;
+    // Initializes and configures the shared rect's buffer and vertex attributes
+    static void InitRenderData();
+
+    // the part of the bound texture to draw, sourceRect inside the texture's uv rect
+    glm::vec4 GetUVRect();
+
+    // whether any slice border is set
+    bool IsNineSliced();
+
+    // gets the slice borders in uvs of the source rect (see InstanceData::sliceUVs)
+    glm::vec4 GetSliceUVs();
 
 };
 
@@ -0,0 +1,133 @@
+#include "SpriteSheet.h"
+#include <cmath>
+#include <algorithm>
+
+SpriteSheet::SpriteSheet(Texture2D* texture)
+{
+	if (texture == nullptr)
+		throw std::exception("Tried to make a sprite sheet without a texture");
+
+	this->texture = texture;
+}
+
+unsigned int SpriteSheet::AddFrame(glm::vec2 pixelPosition, glm::vec2 pixelSize)
+{
+	// an async texture that's still loading is the placeholder's size, so the rect would be normalised against the wrong size
+	if (!texture->isLoaded || texture->width == 0 || texture->height == 0)
+		throw std::exception("Tried to add a frame to a sprite sheet whose texture hasn't loaded");
+
+	// pixels to 0 to 1 across the image
+	glm::vec2 textureSize = glm::vec2((float)texture->width, (float)texture->height);
+	_frames.push_back(glm::vec4(pixelPosition / textureSize, pixelSize / textureSize));
+	return (unsigned int)_frames.size() - 1;
+}
+
+unsigned int SpriteSheet::AddGrid(glm::vec2 frameSize, unsigned int frameCount)
+{
+	if (frameSize.x <= 0.0f || frameSize.y <= 0.0f)
+		throw std::exception("Tried to add a grid of frames with no size to a sprite sheet");
+	// the grid is worked out from the texture's size, which is the placeholder's until it's loaded
+	if (!texture->isLoaded)
+		throw std::exception("Tried to add a grid of frames to a sprite sheet whose texture hasn't loaded");
+
+	unsigned int columns = (unsigned int)(texture->width / frameSize.x);
+	unsigned int rows = (unsigned int)(texture->height / frameSize.y);
+	// every cell
+	if (frameCount == 0)
+		frameCount = columns * rows;
+
+	if (frameCount > columns * rows)
+		throw std::exception("Tried to add more frames to a sprite sheet than fit in its texture");
+
+	unsigned int firstFrame = (unsigned int)_frames.size();
+	for (unsigned int i = 0; i < frameCount; i++)
+	{
+		unsigned int column = i % columns;
+		unsigned int row = i / columns;
+		// the image's rows go bottom to top, so the top row is the highest y
+		glm::vec2 pixelPosition = glm::vec2(column * frameSize.x, texture->height - (row + 1) * frameSize.y);
+		AddFrame(pixelPosition, frameSize);
+	}
+	return firstFrame;
+}
+
+unsigned int SpriteSheet::AddClip(std::string name, std::vector<unsigned int> frames, float framesPerSecond, bool loop)
+{
+	if (frames.empty())
+		throw std::exception("Tried to add a clip with no frames to a sprite sheet");
+
+	for (unsigned int frame : frames)
+		if (frame >= _frames.size())
+			throw std::exception("Tried to add a clip to a sprite sheet with a frame that doesn't exist");
+
+	Clip clip;
+	clip.name = name;
+	clip.frames = frames;
+	clip.framesPerSecond = framesPerSecond;
+	clip.loop = loop;
+	_clips.push_back(clip);
+	return (unsigned int)_clips.size() - 1;
+}
+
+unsigned int SpriteSheet::AddClip(std::string name, unsigned int firstFrame, unsigned int frameCount, float framesPerSecond, bool loop)
+{
+	std::vector<unsigned int> frames(frameCount);
+	for (unsigned int i = 0; i < frameCount; i++)
+		frames[i] = firstFrame + i;
+	return AddClip(name, frames, framesPerSecond, loop);
+}
+
+int SpriteSheet::GetClipIndex(std::string name)
+{
+	// there's only ever a few clips so a linear search is fine
+	for (size_t i = 0; i < _clips.size(); i++)
+		if (_clips[i].name == name)
+			return (int)i;
+	return -1;
+}
+
+const SpriteSheet::Clip& SpriteSheet::GetClip(unsigned int clipIndex)
+{
+	if (clipIndex >= _clips.size())
+		throw std::exception("Tried to get a clip that isn't in the sprite sheet");
+	return _clips[clipIndex];
+}
+
+size_t SpriteSheet::GetClipCount()
+{
+	return _clips.size();
+}
+
+size_t SpriteSheet::GetFrameCount()
+{
+	return _frames.size();
+}
+
+glm::vec4 SpriteSheet::GetFrame(unsigned int frameIndex)
+{
+	if (frameIndex >= _frames.size())
+		throw std::exception("Tried to get a frame that isn't in the sprite sheet");
+	return _frames[frameIndex];
+}
+
+unsigned int SpriteSheet::GetFrameAt(unsigned int clipIndex, double time)
+{
+	const Clip& clip = GetClip(clipIndex);
+	size_t frameCount = clip.frames.size();
+
+	// how many frames in it is, this is all the work each animated sprite does
+	double framePosition = std::floor(std::max(time, 0.0) * clip.framesPerSecond);
+	size_t clipFrame = (framePosition >= (double)frameCount)
+		? (clip.loop ? (size_t)std::fmod(framePosition, (double)frameCount) : frameCount - 1)
+		: (size_t)framePosition;
+	return clip.frames[clipFrame];
+}
+
+double SpriteSheet::GetClipLength(unsigned int clipIndex)
+{
+	const Clip& clip = GetClip(clipIndex);
+	// a clip that doesn't move never ends
+	if (clip.framesPerSecond <= 0.0f)
+		return INFINITY;
+	return clip.frames.size() / (double)clip.framesPerSecond;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Texture2D.h"
+
+// A texture with lots of animation frames on it, the rect of each frame and clips (runs of frames played at some speed).
+// One sprite sheet is shared by every SpriteAnimator that uses it (as a shared pointer), so an animated sprite only has to remember
+// which clip it's on and how far into it it is. Frame rects are relative to the texture's own image, so it works the same whether
+// or not the texture was packed into an atlas page
+class SpriteSheet
+{
+public:
+	// a run of frames that plays as one animation
+	struct Clip {
+		std::string name;
+		// indices of the sheet's frames, in the order they're shown. A frame can be in it more than once
+		std::vector<unsigned int> frames;
+		// how many frames are shown every second
+		float framesPerSecond = 10.0f;
+		// whether it starts again after the last frame, otherwise it stays on the last frame
+		bool loop = true;
+	};
+
+	// Create an empty sprite sheet for a texture. The texture's size is needed for pixel rects so an async texture has to be loaded first
+	SpriteSheet(Texture2D* texture);
+
+	// texture every frame is on. Sprite renderers that use the sheet have to draw this texture
+	Texture2D* texture;
+
+	// Adds a frame from a rect of the texture in pixels (position is its bottom left corner). Returns the frame's index.
+	// Throws if the texture is still loading (see Texture2D::isLoaded), add frames from ResourceManager::LoadTextureAsync's callback instead
+	unsigned int AddFrame(glm::vec2 pixelPosition, glm::vec2 pixelSize);
+
+	// Cuts the texture into a grid of frameSize (pixels) cells and adds them as frames going left to right, top row first (how sheets are usually drawn).
+	// frameCount is how many to add, 0 for every cell. Returns the index of the first one
+	unsigned int AddGrid(glm::vec2 frameSize, unsigned int frameCount = 0);
+
+	// Adds a clip that plays the given frames. Returns the clip's index
+	unsigned int AddClip(std::string name, std::vector<unsigned int> frames, float framesPerSecond = 10.0f, bool loop = true);
+
+	// Adds a clip that plays frameCount frames in a row starting from firstFrame. Returns the clip's index
+	unsigned int AddClip(std::string name, unsigned int firstFrame, unsigned int frameCount, float framesPerSecond = 10.0f, bool loop = true);
+
+	// returns the index of the clip with this name, -1 if there isn't one
+	int GetClipIndex(std::string name);
+
+	// returns a clip by index
+	const Clip& GetClip(unsigned int clipIndex);
+
+	// how many clips there are
+	size_t GetClipCount();
+
+	// how many frames there are
+	size_t GetFrameCount();
+
+	// Returns a frame's rect, xy: bottom left corner and zw: size, from 0 to 1 across the texture's image (see SpriteRenderer::sourceRect)
+	glm::vec4 GetFrame(unsigned int frameIndex);
+
+	// returns the index of the sheet's frame that a clip shows time seconds after it started
+	unsigned int GetFrameAt(unsigned int clipIndex, double time);
+
+	// how many seconds a clip takes to play once
+	double GetClipLength(unsigned int clipIndex);
+
+private:
+	// every frame's rect
+	std::vector<glm::vec4> _frames;
+	std::vector<Clip> _clips;
+};
+
@@ -0,0 +1,142 @@
+#include "StaticBatch.h"
+#include "ResourceManager.h"
+#include <cstddef>
+
+const char* StaticBatch::vertPath = "VertexShaders/StaticBatch.vert";
+const char* StaticBatch::shapeFragPath = "FragmentShaders/StaticShape.frag";
+// textured batches use the sprite fragment shaders, StaticBatch.vert gives them the same inputs
+const char* StaticBatch::spriteFragPath = "FragmentShaders/SpriteDefault.frag";
+const char* StaticBatch::arrayFragPath = "FragmentShaders/SpriteArray.frag";
+
+bool StaticBatch::Key::operator<(const Key& other) const
+{
+	if (textureTarget != other.textureTarget)
+		return textureTarget < other.textureTarget;
+	return texture < other.texture;
+}
+
+StaticBatch::StaticBatch(Key key, const std::vector<Vertex>& vertices)
+{
+	this->key = key;
+	_quadCount = vertices.size() / 4;
+
+	// every quad is 2 triangles going round its 4 corners
+	std::vector<unsigned int> indices(_quadCount * 6);
+	for (size_t quad = 0; quad < _quadCount; quad++)
+	{
+		unsigned int firstVertex = (unsigned int)(quad * 4);
+		unsigned int quadIndices[6] = { 0, 1, 2, 2, 3, 0 };
+		for (int i = 0; i < 6; i++)
+			indices[quad * 6 + i] = firstVertex + quadIndices[i];
+	}
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+
+	glBindVertexArray(VAO);
+
+	// it never changes, a changed entity gets a whole new batch
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+	// position at location 0
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+	glEnableVertexAttribArray(0);
+	// colour at location 1
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+	glEnableVertexAttribArray(1);
+	// texture coords and layer at location 2
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+	glEnableVertexAttribArray(2);
+
+	// unbind the vertex array first so it keeps its element buffer
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+StaticBatch::~StaticBatch()
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+}
+
+size_t StaticBatch::GetQuadCount()
+{
+	return _quadCount;
+}
+
+void StaticBatch::Draw(const glm::mat4& view, const glm::mat4& projection)
+{
+	ShaderProgram* program = GetProgram(key);
+	program->Use();
+	program->SetMatrix4("view", view);
+	program->SetMatrix4("projection", projection);
+
+	if (key.texture != 0)
+	{
+		// bind texture onto corresponding texture unit
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(key.textureTarget, key.texture);
+	}
+
+	glBindVertexArray(VAO);
+	glDrawElements(GL_TRIANGLES, (GLsizei)(_quadCount * 6), GL_UNSIGNED_INT, 0);
+	glBindVertexArray(0);
+}
+
+void StaticBatch::AddQuad(std::vector<Vertex>& vertices, const glm::mat4& model, glm::vec2 localMin, glm::vec2 localMax, glm::vec4 color, glm::vec4 uvRect, float layer)
+{
+	// going round from the bottom left, with the texture coords squashed into the image's part of the texture like SpriteDefault.vert
+	glm::vec2 corners[4] = { localMin, glm::vec2(localMax.x, localMin.y), localMax, glm::vec2(localMin.x, localMax.y) };
+	glm::vec2 texCoords[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+
+	for (int i = 0; i < 4; i++)
+	{
+		Vertex vertex;
+		vertex.position = glm::vec3(model * glm::vec4(corners[i], 0.0f, 1.0f));
+		vertex.color = color;
+		vertex.texCoord = glm::vec3(glm::vec2(uvRect.x, uvRect.y) + texCoords[i] * glm::vec2(uvRect.z, uvRect.w), layer);
+		vertices.push_back(vertex);
+	}
+}
+
+void StaticBatch::AddQuad(std::vector<Vertex>& vertices, const glm::mat4& model, const glm::vec2 corners[4], glm::vec4 color)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		Vertex vertex;
+		vertex.position = glm::vec3(model * glm::vec4(corners[i], 0.0f, 1.0f));
+		vertex.color = color;
+		vertex.texCoord = glm::vec3(0.0f);
+		vertices.push_back(vertex);
+	}
+}
+
+ShaderProgram* StaticBatch::GetProgram(Key key)
+{
+	// which program goes with the texture
+	std::string programName = "staticShapeProgram";
+	const char* fragPath = shapeFragPath;
+	if (key.texture != 0 && key.textureTarget == GL_TEXTURE_2D_ARRAY)
+	{
+		programName = "staticSpriteArrayProgram";
+		fragPath = arrayFragPath;
+	}
+	else if (key.texture != 0)
+	{
+		programName = "staticSpriteProgram";
+		fragPath = spriteFragPath;
+	}
+
+	ShaderProgram* program = ResourceManager::GetShader(programName);
+	// load it the first time a batch needs it
+	if (program == nullptr)
+		program = ResourceManager::LoadShaderProgram(programName, vertPath, fragPath);
+	return program;
+}
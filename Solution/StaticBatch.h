@@ -0,0 +1,81 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "ShaderProgram.h"
+
+// forward declare entity class
+class Entity;
+
+// Quads of static entities (see Entity::SetIsStatic) that have already been put through their entity's transform, all in one vertex buffer.
+// Every quad in a batch uses the same texture (or none for shapes) so the whole batch is one glDrawElements no matter how many entities are in it,
+// and nothing about them has to be worked out again each frame. The scene makes and throws these away (see Scene::BakeStatic), they aren't used directly
+class StaticBatch
+{
+public:
+	// one corner of a baked quad. Already in global coords (times 2, same as after an entity's ToMatrix) so drawing doesn't need each entity's transform
+	struct Vertex {
+		glm::vec3 position;
+		glm::vec4 color;
+		// xy: texture coords, z: layer of the texture array
+		glm::vec3 texCoord;
+	};
+
+	// what quads have to share to go in the same batch
+	struct Key {
+		// what kind of texture is bound (GL_TEXTURE_2D etc.)
+		unsigned int textureTarget = GL_TEXTURE_2D;
+		// texture to draw with, 0 for shapes which are just coloured
+		unsigned int texture = 0;
+
+		bool operator<(const Key& other) const;
+	};
+
+	// most quads that go in one batch. A change to one entity rebuilds its whole batch, so lots of smaller batches keep that cheap
+	static const size_t maxQuads = 4096;
+
+	// Uploads vertices (4 per quad, going round the quad) into a new batch. Needs a current GL context
+	StaticBatch(Key key, const std::vector<Vertex>& vertices);
+	// deletes the batch's buffers
+	~StaticBatch();
+
+	// the buffers can't be shared between two batches
+	StaticBatch(const StaticBatch&) = delete;
+	StaticBatch& operator=(const StaticBatch&) = delete;
+
+	// texture the batch is drawn with
+	Key key;
+
+	// every entity that has quads in the batch
+	std::vector<Entity*> entities;
+
+	// how many quads are in the batch
+	size_t GetQuadCount();
+
+	// draws every quad in the batch. It doesn't go through the draw batcher so anything in there has to be flushed first
+	void Draw(const glm::mat4& view, const glm::mat4& projection);
+
+	// Adds the 4 corners of a quad that goes from localMin to localMax (before model is applied), with part of a texture (see Texture2D::uvRect)
+	static void AddQuad(std::vector<Vertex>& vertices, const glm::mat4& model, glm::vec2 localMin, glm::vec2 localMax, glm::vec4 color,
+		glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), float layer = 0.0f);
+
+	// Adds a quad with any 4 corners (local coords, going round the quad) that isn't textured
+	static void AddQuad(std::vector<Vertex>& vertices, const glm::mat4& model, const glm::vec2 corners[4], glm::vec4 color);
+
+private:
+	// vertex array object ID
+	unsigned int VAO = 0;
+	unsigned int VBO = 0;
+	unsigned int EBO = 0;
+	size_t _quadCount = 0;
+
+	// shaders. Every batch uses the same vertex shader, the fragment shader depends on what texture it has
+	static const char* vertPath;
+	static const char* shapeFragPath;
+	static const char* spriteFragPath;
+	static const char* arrayFragPath;
+
+	// gets (loading if it needs to) the program that draws a batch with key
+	static ShaderProgram* GetProgram(Key key);
+};
+
@@ -0,0 +1,240 @@
+#include "StreamBuffer.h"
+#include "GLExtensions.h"
+#include <iostream>
+#include <cstring>
+
+StreamBuffer::StreamBuffer(GLsizeiptr bytesPerFrame)
+{
+	_bytesPerFrame = bytesPerFrame;
+	// extensions need to be checked before we know which path to take
+	if (!GLExtensions::isLoaded)
+		GLExtensions::Load();
+	// use persistent mapping if the driver supports it
+	_persistent = GLExtensions::hasBufferStorage;
+	CreateBuffer();
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	// de-allocate all resources once they've outlived their purpose
+	DestroyBuffer();
+}
+
+void StreamBuffer::BeginFrame()
+{
+	// If the last frame ran out of space then grow the buffer. This is the only time the stream buffer is allowed to stall, and it
+	// only happens until the buffer is big enough for the scene
+	if (_overflowed)
+	{
+		// at least double it, or more if the frame asked for way more than that
+		GLsizeiptr newSize = _bytesPerFrame * 2;
+		while (newSize < _requestedThisFrame)
+			newSize *= 2;
+
+		std::cout << "Stream buffer ran out of space, growing from " << _bytesPerFrame << " to " << newSize << " bytes per frame" << std::endl;
+
+		DestroyBuffer();
+		_bytesPerFrame = newSize;
+		CreateBuffer();
+		_overflowed = false;
+	}
+
+	// move on to the next region and reset the bump pointer
+	_frameIndex = (_frameIndex + 1) % frameCount;
+	_head = 0;
+	_flushedHead = 0;
+	_requestedThisFrame = 0;
+
+	if (_persistent)
+	{
+		// The region we are about to write to was last used frameCount frames ago. Normally the gpu is long done with it so the fence
+		// is already signalled and this returns straight away. If it isn't we have no choice but to wait, otherwise we overwrite data the gpu is reading
+		GLsync fence = _fences[_frameIndex];
+		if (fence != 0)
+		{
+			// first check without waiting at all
+			GLenum waitResult = glClientWaitSync(fence, 0, 0);
+			// then wait in 1ms steps, flushing so the fence actually gets submitted
+			while (waitResult == GL_TIMEOUT_EXPIRED)
+				waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+			if (waitResult == GL_WAIT_FAILED)
+				std::cout << "ERROR: Waiting on a stream buffer fence failed" << std::endl;
+
+			glDeleteSync(fence);
+			_fences[_frameIndex] = 0;
+		}
+	}
+	else
+	{
+		// orphan the buffer. GL gives us fresh memory while the gpu keeps reading the old memory for any draws still in flight
+		glBindBuffer(GL_ARRAY_BUFFER, ID);
+		glBufferData(GL_ARRAY_BUFFER, _bytesPerFrame, nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
+
+void StreamBuffer::EndFrame()
+{
+	// upload anything that hasn't been flushed yet, just in case
+	Flush();
+
+	// fence the region so we know when the gpu is finished with it
+	if (_persistent)
+		_fences[_frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamBuffer::Allocation StreamBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment)
+{
+	Allocation allocation;
+
+	if (alignment <= 0)
+		alignment = 1;
+
+	GLintptr regionStart = RegionStart();
+	// where the bump pointer is in the whole buffer
+	GLintptr absoluteHead = regionStart + _head;
+	// round up to the next multiple of alignment. Done on the whole buffer offset so offset/alignment is a whole number
+	GLintptr alignedOffset = ((absoluteHead + alignment - 1) / alignment) * alignment;
+	// where the bump pointer will be after this allocation
+	GLsizeiptr newHead = (alignedOffset - regionStart) + size;
+
+	// keep track of how much the frame wanted in total so the buffer knows how much to grow by
+	_requestedThisFrame += (alignedOffset - absoluteHead) + size;
+
+	// doesn't fit
+	if (newHead > _bytesPerFrame)
+	{
+		// only print once per frame otherwise the console gets spammed
+		if (!_overflowed)
+			std::cout << "ERROR: Stream buffer is full this frame, it will grow next frame" << std::endl;
+		_overflowed = true;
+		return allocation;
+	}
+
+	allocation.offset = alignedOffset;
+	allocation.size = size;
+
+	if (_persistent)
+		// write straight into the mapped buffer
+		allocation.data = _mappedData + alignedOffset;
+	else
+		// write into the staging copy, it gets uploaded on flush
+		allocation.data = _stagingData.data() + (alignedOffset - regionStart);
+
+	_head = newHead;
+
+	return allocation;
+}
+
+void StreamBuffer::Flush()
+{
+	// coherent persistent mapping means writes are already visible to the gpu
+	if (_persistent || _head <= _flushedHead)
+		return;
+
+	GLsizeiptr flushSize = _head - _flushedHead;
+
+	glBindBuffer(GL_ARRAY_BUFFER, ID);
+	// The buffer was orphaned at the start of the frame and this range hasn't been used yet so there is no need for GL to synchronise.
+	// Unsynchronized + invalidate range means the driver doesn't wait on any draws that are still reading earlier parts of the buffer
+	void* destination = glMapBufferRange(GL_ARRAY_BUFFER, _flushedHead, flushSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (destination != nullptr)
+	{
+		memcpy(destination, _stagingData.data() + _flushedHead, flushSize);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+	else
+		// mapping failed for some reason, plain upload still works
+		glBufferSubData(GL_ARRAY_BUFFER, _flushedHead, flushSize, _stagingData.data() + _flushedHead);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_flushedHead = _head;
+}
+
+bool StreamBuffer::IsPersistent()
+{
+	return _persistent;
+}
+
+GLsizeiptr StreamBuffer::GetBytesPerFrame()
+{
+	return _bytesPerFrame;
+}
+
+GLsizeiptr StreamBuffer::GetBytesUsed()
+{
+	return _head;
+}
+
+unsigned int StreamBuffer::GetGeneration()
+{
+	return _generation;
+}
+
+void StreamBuffer::CreateBuffer()
+{
+	glGenBuffers(1, &ID);
+	_generation++;
+	glBindBuffer(GL_ARRAY_BUFFER, ID);
+
+	if (_persistent)
+	{
+		// every frame region lives in the one buffer
+		GLsizeiptr totalSize = _bytesPerFrame * frameCount;
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		// immutable storage that is allowed to stay mapped while the gpu uses it
+		GLExtensions::BufferStorage(GL_ARRAY_BUFFER, totalSize, nullptr, flags);
+		_mappedData = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, flags);
+
+		// if mapping fails fall back to orphaning
+		if (_mappedData == nullptr)
+		{
+			std::cout << "ERROR: Failed to persistently map stream buffer, falling back to orphaning" << std::endl;
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glDeleteBuffers(1, &ID);
+			_persistent = false;
+			CreateBuffer();
+			return;
+		}
+	}
+	else
+	{
+		// only one region is needed because orphaning gives us new memory every frame
+		glBufferData(GL_ARRAY_BUFFER, _bytesPerFrame, nullptr, GL_STREAM_DRAW);
+		_stagingData.resize(_bytesPerFrame);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamBuffer::DestroyBuffer()
+{
+	// fences are meaningless once the buffer is gone
+	for (unsigned int i = 0; i < frameCount; i++)
+	{
+		if (_fences[i] != 0)
+			glDeleteSync(_fences[i]);
+		_fences[i] = 0;
+	}
+
+	if (_mappedData != nullptr)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, ID);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		_mappedData = nullptr;
+	}
+
+	// GL keeps the memory around until any draws still using it are finished
+	glDeleteBuffers(1, &ID);
+	ID = 0;
+}
+
+GLintptr StreamBuffer::RegionStart()
+{
+	// orphaning only has one region
+	if (!_persistent)
+		return 0;
+	return (GLintptr)_frameIndex * _bytesPerFrame;
+}
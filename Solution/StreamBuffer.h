@@ -0,0 +1,94 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+
+// A big GL buffer that any per-frame data (vertices, instance data etc.) gets streamed through.
+// The buffer is split into 3 frame regions. While the cpu writes into one region the gpu can still be reading the other two, each region is
+// guarded by a fence so it is only reused once the gpu is done with it. Inside a frame region space is handed out with a bump pointer.
+// If ARB_buffer_storage is supported the whole buffer stays mapped (persistent + coherent) so writes go straight into gpu visible memory.
+// Otherwise it falls back to orphaning the buffer each frame and uploading whatever was written with glBufferSubData when Flush() is called.
+// The data you get back from Allocate is only valid until the end of the current frame
+class StreamBuffer
+{
+public:
+	// how many frame regions the buffer is split into
+	static const unsigned int frameCount = 3;
+
+	// a chunk of the stream buffer that has been handed out
+	struct Allocation {
+		// where to write the data to. nullptr if the allocation didn't fit in the frame
+		void* data = nullptr;
+		// byte offset of the allocation from the start of the GL buffer. Use this for attribute pointers/base vertex etc.
+		GLintptr offset = 0;
+		// size in bytes
+		GLsizeiptr size = 0;
+	};
+
+	// Creates a stream buffer where each frame gets bytesPerFrame bytes. Needs a current GL context
+	StreamBuffer(GLsizeiptr bytesPerFrame = 8 * 1024 * 1024);
+	~StreamBuffer();
+
+	// ID of the GL buffer object. This changes if the buffer has to grow so don't hold on to it for longer than a frame
+	unsigned int ID = 0;
+
+	// Goes up by one every time the GL buffer is made again. glGenBuffers often hands back the ID that was just deleted, so anything that
+	// remembers which buffer it points at (like a VAO's attributes) needs this as well as the ID to tell it's a new buffer
+	unsigned int GetGeneration();
+
+	// Call at the beginning of a frame before anything is allocated. Moves to the next frame region
+	void BeginFrame();
+
+	// Call once everything for the frame has been drawn. Fences the region that was just used
+	void EndFrame();
+
+	// Hands out size bytes from the current frame region. The offset is a multiple of alignment (doesn't need to be a power of 2, so you can
+	// align to a vertex stride and use offset/stride as a base vertex or base instance)
+	Allocation Allocate(GLsizeiptr size, GLsizeiptr alignment = 4);
+
+	// Makes everything allocated so far visible to GL. MUST be called before drawing with allocated data.
+	// Doesn't do anything when the buffer is persistently mapped.
+	void Flush();
+
+	// whether the buffer is persistently mapped (otherwise it is using the orphaning fallback)
+	bool IsPersistent();
+
+	// how many bytes each frame region has
+	GLsizeiptr GetBytesPerFrame();
+
+	// how many bytes have been allocated in the current frame
+	GLsizeiptr GetBytesUsed();
+
+private:
+	// how many bytes each frame region has
+	GLsizeiptr _bytesPerFrame;
+	// whether the buffer is persistently mapped
+	bool _persistent = false;
+	// pointer to the start of the mapped buffer (persistent mode only)
+	unsigned char* _mappedData = nullptr;
+	// cpu side copy of the current frame that gets uploaded on Flush() (orphaning mode only)
+	std::vector<unsigned char> _stagingData;
+
+	// which frame region is being written to
+	unsigned int _frameIndex = 0;
+	// fences for each frame region, 0 if the region hasn't been used yet
+	GLsync _fences[frameCount] = {};
+
+	// bump pointer, how far into the current frame region has been allocated
+	GLsizeiptr _head = 0;
+	// how far into the current frame region has been uploaded (orphaning mode only)
+	GLsizeiptr _flushedHead = 0;
+	// largest amount asked for in a single frame, used to grow the buffer when a frame runs out of space
+	GLsizeiptr _requestedThisFrame = 0;
+	// whether an allocation failed this frame because the region was full
+	bool _overflowed = false;
+	// how many times the GL buffer has been made
+	unsigned int _generation = 0;
+
+	// creates the GL buffer (and maps it if persistent)
+	void CreateBuffer();
+	// unmaps and deletes the GL buffer along with all fences
+	void DestroyBuffer();
+	// byte offset of the start of the current frame region
+	GLintptr RegionStart();
+};
+
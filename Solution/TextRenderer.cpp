@@ -0,0 +1,257 @@
+#include "TextRenderer.h"
+#include "Entity.h"
+#include "ResourceManager.h"
+#include "Scene.h"
+#include "Hash.h"
+#include <cstddef>
+#include <cstring>
+
+InstanceLayout* TextRenderer::_instanceLayout = nullptr;
+unsigned int TextRenderer::quadVAO = 0;
+unsigned int TextRenderer::quadVBO = 0;
+unsigned int TextRenderer::quadEBO = 0;
+
+TextRenderer::TextRenderer(Font* font, std::string text, float fontSize, glm::vec3 color, ShaderProgram* program)
+{
+	if (font == nullptr)
+		throw std::exception("Tried to make a text renderer without a font");
+
+	// if the program wasn't specified
+	if (program == nullptr)
+	{
+		// all default text shares the same program, otherwise it couldn't be batched together
+		this->shaderProgram = ResourceManager::GetShader(defaultProgramName);
+		// load it if this is the first default text renderer
+		if (this->shaderProgram == nullptr)
+			this->shaderProgram = ResourceManager::LoadShaderProgram(defaultProgramName, defaultVertPath, defaultFragPath);
+	}
+	else // else use given one
+		this->shaderProgram = program;
+
+	this->type = Entity::TextRenderer;
+	// the edges of glyphs are blended so text always needs sorting with the transparent entities
+	this->hasTransprency = true;
+	this->color = color;
+	_font = font;
+	_text = text;
+	_fontSize = fontSize;
+
+	// initialise the shared quad if this is the first text renderer
+	if (_instanceLayout == nullptr)
+		InitRenderData();
+}
+
+const std::string& TextRenderer::GetText()
+{
+	return _text;
+}
+
+void TextRenderer::SetText(const std::string& newText)
+{
+	if (newText == _text)
+		return;
+	_text = newText;
+	_layout = nullptr;
+}
+
+Font* TextRenderer::GetFont()
+{
+	return _font;
+}
+
+void TextRenderer::SetFont(Font* newFont)
+{
+	if (newFont == nullptr)
+		throw std::exception("Tried to set a text renderer's font to nullptr");
+	_font = newFont;
+	_layout = nullptr;
+}
+
+float TextRenderer::GetFontSize()
+{
+	return _fontSize;
+}
+
+void TextRenderer::SetFontSize(float newFontSize)
+{
+	if (newFontSize == _fontSize)
+		return;
+	_fontSize = newFontSize;
+	_layout = nullptr;
+}
+
+Font::Alignment TextRenderer::GetAlignment()
+{
+	return _alignment;
+}
+
+void TextRenderer::SetAlignment(Font::Alignment newAlignment)
+{
+	if (newAlignment == _alignment)
+		return;
+	_alignment = newAlignment;
+	_layout = nullptr;
+}
+
+float TextRenderer::GetWrapWidth()
+{
+	return _wrapWidth;
+}
+
+void TextRenderer::SetWrapWidth(float newWrapWidth)
+{
+	if (newWrapWidth == _wrapWidth)
+		return;
+	_wrapWidth = newWrapWidth;
+	_layout = nullptr;
+}
+
+float TextRenderer::GetAlpha()
+{
+	return _alpha;
+}
+
+void TextRenderer::SetAlpha(float newAlpha)
+{
+	// text is always drawn as transparent (see constructor) so there's nothing else to change
+	_alpha = glm::clamp(newAlpha, 0.0f, 1.0f);
+}
+
+glm::vec2 TextRenderer::GetSize()
+{
+	return GetLayout().size;
+}
+
+const Font::Layout& TextRenderer::GetLayout()
+{
+	if (_layout == nullptr)
+		_layout = _font->GetLayout(_text, _fontSize, _alignment, _wrapWidth);
+	return *_layout;
+}
+
+void TextRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw text which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw text which isn't in a scene");
+
+	const Font::Layout& layout = GetLayout();
+	if (layout.quads.empty())
+		return;
+
+	// Each glyph's corners go thru the entity's transform here, which is cheaper than a matrix per glyph on the gpu.
+	// A point t in the text (0 at the bottom left, global units) is at local coord (t - 1) * 2 like LineRenderer's points
+	glm::mat4 model = parentEntity->transform.ToMatrix(camera);
+
+	// -- only work the glyphs out again if something they depend on changed --
+	size_t key = 0;
+	Hash::Add(key, model);
+	Hash::Add(key, color);
+	Hash::Add(key, _alpha);
+	// glyph uvs change when the font's atlas grows
+	Hash::Add(key, _font->GetRevision());
+	if (_instancesLayout != _layout || key != _instancesKey)
+	{
+		_instancesLayout = _layout;
+		_instancesKey = key;
+		_instances.resize(layout.quads.size());
+
+		InstanceData instance;
+		instance.color = glm::vec4(color, _alpha);
+		for (size_t i = 0; i < layout.quads.size(); i++)
+		{
+			const Font::GlyphQuad& quad = layout.quads[i];
+			glm::vec4 origin = model * glm::vec4((quad.position - 1.0f) * 2.0f, 0.0f, 1.0f);
+			glm::vec4 axisX = model * glm::vec4(quad.size.x * 2.0f, 0.0f, 0.0f, 0.0f);
+			glm::vec4 axisY = model * glm::vec4(0.0f, quad.size.y * 2.0f, 0.0f, 0.0f);
+			instance.origin = glm::vec4(glm::vec3(origin), 0.0f);
+			instance.axes = glm::vec4(axisX.x, axisX.y, axisY.x, axisY.y);
+			instance.uvRect = quad.glyph->uvRect;
+			_instances[i] = instance;
+		}
+	}
+
+	DrawBatcher::DrawState state;
+	state.program = shaderProgram;
+	state.layout = _instanceLayout;
+	state.texture = _font->GetTextureID();
+
+	// draw the 6 indices of the quad
+	DrawBatcher::MeshRange mesh;
+	mesh.indexCount = 6;
+
+	// every glyph goes in at once
+	void* instances = parentEntity->parentScene->drawBatcher.AddInstances(state, mesh, (unsigned int)_instances.size());
+	memcpy(instances, _instances.data(), _instances.size() * sizeof(InstanceData));
+}
+
+size_t TextRenderer::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, _text);
+	Hash::Add(hash, _font);
+	// glyph uvs change when the font's atlas grows
+	Hash::Add(hash, _font->GetRevision());
+	Hash::Add(hash, _fontSize);
+	Hash::Add(hash, (int)_alignment);
+	Hash::Add(hash, _wrapWidth);
+	Hash::Add(hash, color);
+	Hash::Add(hash, _alpha);
+	Hash::Add(hash, shaderProgram);
+	return hash;
+}
+
+void TextRenderer::GetLocalBounds(glm::vec2& min, glm::vec2& max)
+{
+	// same conversion as Draw, the text goes from 0 to its size
+	min = glm::vec2(-2.0f);
+	max = (GetLayout().size - 1.0f) * 2.0f;
+}
+
+void TextRenderer::InitRenderData()
+{
+	// corners from 0 to 1, each glyph's instance data says where they actually go
+	float vertices[] = {
+		1.0f, 1.0f, // top right
+		1.0f, 0.0f, // bottom right
+		0.0f, 0.0f, // bottom left
+		0.0f, 1.0f, // top left
+	};
+	unsigned int indices[] = {
+		0, 1, 2,   // first triangle
+		2, 3, 0    // second triangle
+	};
+
+	glGenBuffers(1, &quadVBO);
+	glGenVertexArrays(1, &quadVAO);
+	glGenBuffers(1, &quadEBO);
+
+	glBindVertexArray(quadVAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// corner at location 0, 2 floats. It's also the texture coord within the glyph
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// unbind
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	// -- per instance attributes, these are read from the scene's stream buffer when drawn --
+	_instanceLayout = new InstanceLayout(quadVAO, sizeof(InstanceData));
+	// corner after transform at location 1
+	_instanceLayout->AddAttribute(1, 4, offsetof(InstanceData, origin));
+	// edges after transform at location 2
+	_instanceLayout->AddAttribute(2, 4, offsetof(InstanceData, axes));
+	// uv rect at location 3
+	_instanceLayout->AddAttribute(3, 4, offsetof(InstanceData, uvRect));
+	// colour at location 4
+	_instanceLayout->AddAttribute(4, 4, offsetof(InstanceData, color));
+}
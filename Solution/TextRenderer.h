@@ -0,0 +1,120 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <vector>
+#include "Component.h"
+#include "ShaderProgram.h"
+#include "OrthoCamera.h"
+#include "InstanceLayout.h"
+#include "Font.h"
+
+// Renders a string with a Font. Each glyph is a quad showing its part of the font's signed distance field atlas, so text stays sharp
+// at any size or camera zoom and every text renderer using the same font is drawn together in one instanced draw.
+// The bottom left corner of the block of text is at (0,0) in the same coords as LineRenderer's points and fontSize is the height of an em in global coords.
+// Like LineRenderer the transform's size just acts as a scalar value, so for a normal size set offsetSize to (1,1,0).
+// The layout (where each glyph goes) comes from the font's cache and is only looked up again when the text or how it's laid out changes
+class TextRenderer :
+    public Component
+{
+public:
+    // Setup a new text renderer that draws text (utf-8, '\n' for new lines) in font, with a font size (global coords), colour and shader program
+    // NOTE: If shader program is set to nullptr it will use the default text shader. A custom shader has to take the same attributes as TextDefault.vert
+    TextRenderer(Font* font, std::string text = "", float fontSize = 32.0f, glm::vec3 color = glm::vec3(1.0f), ShaderProgram* program = nullptr);
+
+    // colour of the text
+    glm::vec3 color;
+
+    // get the text being drawn
+    const std::string& GetText();
+    // set the text being drawn
+    void SetText(const std::string& newText);
+
+    // get the font
+    Font* GetFont();
+    // set the font
+    void SetFont(Font* newFont);
+
+    // get the font size, the height of an em in global coords
+    float GetFontSize();
+    // set the font size
+    void SetFontSize(float newFontSize);
+
+    // get how lines line up with each other
+    Font::Alignment GetAlignment();
+    // set how lines line up with each other
+    void SetAlignment(Font::Alignment newAlignment);
+
+    // get the width lines are wrapped at, 0 if they aren't
+    float GetWrapWidth();
+    // set the width (global coords, before the transform's size) lines are broken at spaces to fit in. 0 turns wrapping off
+    void SetWrapWidth(float newWrapWidth);
+
+    // get the alpha (transparency) value of this text
+    float GetAlpha();
+    // set the alpha (transparency) value of this text
+    void SetAlpha(float newAlpha);
+
+    // width and height of the block of text in global coords, before the transform's size
+    glm::vec2 GetSize();
+
+    // draw the text using reference to scene camera and parent entity's transform.
+    // Every glyph is added to the scene's draw batcher so it gets drawn along with all other text in the same font.
+    // The glyphs' instance data is kept between draws, so text that hasn't changed or moved is one copy into the batcher
+    void Draw(std::shared_ptr<OrthoCamera> camera);
+
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords of the text (before the entity's transform is applied)
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+private:
+    // what gets sent to the gpu for each glyph. The corners are worked out here rather than sending a whole matrix per glyph
+    struct InstanceData {
+        // bottom left corner after the entity's transform, w is unused
+        glm::vec4 origin;
+        // xy is the quad's bottom edge and zw its left edge, after the entity's transform
+        glm::vec4 axes;
+        // part of the atlas the glyph is in
+        glm::vec4 uvRect;
+        // colour of the text with alpha
+        glm::vec4 color;
+    };
+
+    Font* _font;
+    std::string _text;
+    float _fontSize;
+    Font::Alignment _alignment = Font::Left;
+    float _wrapWidth = 0.0f;
+    // the alpha channel (transparency) of the text
+    float _alpha = 1.0f;
+    // shader program that the renderer uses
+    ShaderProgram* shaderProgram;
+
+    // layout of the text from the font's cache, nullptr when something changed and it needs looking up again
+    std::shared_ptr<const Font::Layout> _layout;
+    // returns the layout, looking it up if it needs to be
+    const Font::Layout& GetLayout();
+
+    // Every glyph's instance data from the last draw, so text that hasn't changed or moved is copied into the batcher in one go.
+    // Made again when the layout it came from or the instances key changes
+    std::vector<InstanceData> _instances;
+    // the layout the instances were made from. Holding on to it means a new layout can't have the same address
+    std::shared_ptr<const Font::Layout> _instancesLayout;
+    // hash of the model matrix, colour, alpha and font revision the instances were made with
+    size_t _instancesKey = 0;
+
+    // default shaders
+    const char* defaultVertPath = "VertexShaders/TextDefault.vert";
+    const char* defaultFragPath = "FragmentShaders/TextDefault.frag";
+    // name that the default program is stored under in the resource manager. All default text shares it
+    const char* defaultProgramName = "defaultTextProgram";
+    // Every text renderer shares one quad (0 to 1, unlike the sprite rect) and instance layout
+    static InstanceLayout* _instanceLayout;
+    static unsigned int quadVAO;
+    static unsigned int quadVBO;
+    static unsigned int quadEBO;
+    // Initializes and configures the shared quad's buffer and vertex attributes
+    static void InitRenderData();
+};
+
@@ -1,6 +1,7 @@
 #pragma once
 #include <glad/glad.h>
 #include <iostream>
+#include <glm/glm.hpp>
 
 class Texture2D
 {
@@ -26,6 +27,12 @@ public:
     unsigned int wrapT = GL_REPEAT; // wrapping mode on T axis
     unsigned int filterMin = GL_NEAREST; // filtering mode if texture pixels < screen pixels
     unsigned int filterMax = GL_LINEAR; // filtering mode if texture pixels > screen pixels
+    // false while a texture loaded with ResourceManager::LoadTextureAsync is still loading. ID is the placeholder texture until then
+    bool isLoaded = true;
+    // whether the image was packed into one of the resource manager's atlas pages. If it is then ID is the page's texture
+    bool isInAtlas = false;
+    // Part of the texture that the image is in. xy: uv of the bottom left corner, zw: uv size. The whole texture unless it's in an atlas
+    glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
     
     
     // generates texture from image data
@@ -0,0 +1,53 @@
+#include "TextureArray.h"
+
+TextureArray::TextureArray(std::string name)
+{
+	this->name = name;
+}
+
+int TextureArray::GetLayer(std::string layerName)
+{
+	for (size_t i = 0; i < layerNames.size(); i++)
+		if (layerNames[i] == layerName)
+			return (int)i;
+	// not found
+	return -1;
+}
+
+void TextureArray::Generate(unsigned int width, unsigned int height, unsigned int layerCount, const std::vector<unsigned char*>& layers)
+{
+	this->width = width;
+	this->height = height;
+	this->layerCount = layerCount;
+	glGenTextures(1, &ID); // generate a texture
+	glBindTexture(GL_TEXTURE_2D_ARRAY, ID); // bind the generated texture
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrapS); // x axis wrapping
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrapT); // y axis wrapping
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filterMin); // when texture is minified
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filterMax); // when texture is magnified
+
+	// rows of an rgb image aren't always a multiple of 4 bytes long, which is what gl expects by default
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// make space for every layer. Param 1: target, 2: mipmap level, 3: format, 4-6: width, height and layers, 7: legacy, 8&9: format and type of data, 10: no data yet
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, width, height, layerCount, 0, imageFormat, GL_UNSIGNED_BYTE, nullptr);
+	// then fill each layer in. The 0, 0, i is the x, y and layer to start at
+	for (unsigned int i = 0; i < layerCount; i++)
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, imageFormat, GL_UNSIGNED_BYTE, layers[i]);
+
+	// put it back to the default
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY); // mipmaps are made for each layer separately
+
+	// unbind texture
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::Bind()
+{
+	glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <glad/glad.h>
+#include <iostream>
+#include <vector>
+
+// A GL_TEXTURE_2D_ARRAY, a stack of same sized images (layers) in one texture. Sprites pick which layer to draw per instance so
+// sprites using different images from the same array still go in one batch. Unlike an atlas every layer is its own image so
+// mipmaps and filtering never blend in a neighbouring image.
+// Loaded thru ResourceManager::LoadTextureArray
+class TextureArray
+{
+public:
+    // constructor (sets default texture modes)
+    TextureArray(std::string name);
+
+    // name of the texture array as referenced by the resource manager
+    std::string name;
+    // holds the ID of the texture object
+    unsigned int ID = 0;
+    // width of every layer in pixels
+    unsigned int width = 0;
+    // height of every layer in pixels
+    unsigned int height = 0;
+    // how many layers there are
+    unsigned int layerCount = 0;
+    // format of texture object as gl enum
+    unsigned int internalFormat = GL_RGB;
+    // format of loaded images as gl enum
+    unsigned int imageFormat = GL_RGB;
+    unsigned int wrapS = GL_REPEAT; // wrapping mode on S axis
+    unsigned int wrapT = GL_REPEAT; // wrapping mode on T axis
+    // filtering mode if texture pixels < screen pixels. Uses mipmaps because each layer gets its own
+    unsigned int filterMin = GL_LINEAR_MIPMAP_LINEAR;
+    unsigned int filterMax = GL_LINEAR; // filtering mode if texture pixels > screen pixels
+
+    // name of each layer (the file name without its extension), in layer order
+    std::vector<std::string> layerNames;
+
+    // returns the layer with the given name, -1 if there isn't one
+    int GetLayer(std::string layerName);
+
+    // generates the array from layerCount images of width x height, one pointer to image data per layer
+    void Generate(unsigned int width, unsigned int height, unsigned int layerCount, const std::vector<unsigned char*>& layers);
+    // binds the texture as the current active GL_TEXTURE_2D_ARRAY texture object
+    void Bind();
+};
+
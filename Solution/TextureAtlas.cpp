@@ -0,0 +1,233 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <climits>
+
+bool TextureAtlas::Accepts(int width, int height)
+{
+	return isEnabled && width <= maxImageSize && height <= maxImageSize;
+}
+
+bool TextureAtlas::Add(const unsigned char* data, int width, int height, int channels, Region& region)
+{
+	int size = GetPageSize();
+	// size it takes up on the page with padding on every side
+	int paddedWidth = width + padding * 2;
+	int paddedHeight = height + padding * 2;
+
+	// -- find a spot, trying the existing pages first --
+	int x = 0, y = 0;
+	size_t node = 0;
+	size_t pageIndex = 0;
+	bool found = false;
+	for (; pageIndex < _pages.size(); pageIndex++)
+	{
+		if (FindPosition(_pages[pageIndex], paddedWidth, paddedHeight, x, y, node))
+		{
+			found = true;
+			break;
+		}
+	}
+
+	if (!found)
+	{
+		// too big for a page, no point making one
+		if (paddedWidth > size || paddedHeight > size)
+			return false;
+
+		AddPage();
+		pageIndex = _pages.size() - 1;
+		if (!FindPosition(_pages[pageIndex], paddedWidth, paddedHeight, x, y, node))
+			return false;
+	}
+
+	Page& page = _pages[pageIndex];
+	AddToSkyline(page, node, x, y, paddedWidth, paddedHeight);
+	page.imageCount++;
+	page.usedArea += (size_t)paddedWidth * paddedHeight;
+
+	// -- copy the image into an rgba buffer with its edges extruded into the padding --
+	std::vector<unsigned char> paddedData((size_t)paddedWidth * paddedHeight * 4);
+	for (int paddedY = 0; paddedY < paddedHeight; paddedY++)
+	{
+		// pixels in the padding just copy the closest edge pixel
+		int sourceY = std::min(std::max(paddedY - padding, 0), height - 1);
+		for (int paddedX = 0; paddedX < paddedWidth; paddedX++)
+		{
+			int sourceX = std::min(std::max(paddedX - padding, 0), width - 1);
+			const unsigned char* source = data + ((size_t)sourceY * width + sourceX) * channels;
+			unsigned char* destination = &paddedData[((size_t)paddedY * paddedWidth + paddedX) * 4];
+
+			// every page is rgba so turn grey/grey+alpha/rgb into that
+			switch (channels)
+			{
+			case 1:
+				destination[0] = destination[1] = destination[2] = source[0];
+				destination[3] = 255;
+				break;
+			case 2:
+				destination[0] = destination[1] = destination[2] = source[0];
+				destination[3] = source[1];
+				break;
+			case 3:
+				destination[0] = source[0];
+				destination[1] = source[1];
+				destination[2] = source[2];
+				destination[3] = 255;
+				break;
+			default:
+				destination[0] = source[0];
+				destination[1] = source[1];
+				destination[2] = source[2];
+				destination[3] = source[3];
+				break;
+			}
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, page.textureID);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, paddedData.data());
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// uv of the image itself, not the padding
+	region.textureID = page.textureID;
+	region.page = (unsigned int)pageIndex;
+	region.uvRect = glm::vec4((float)(x + padding) / size, (float)(y + padding) / size, (float)width / size, (float)height / size);
+	return true;
+}
+
+std::vector<TextureAtlas::PageStats> TextureAtlas::GetStats()
+{
+	float pageArea = (float)GetPageSize() * GetPageSize();
+
+	std::vector<PageStats> stats;
+	for (const Page& page : _pages)
+	{
+		PageStats pageStats;
+		pageStats.textureID = page.textureID;
+		pageStats.imageCount = page.imageCount;
+		pageStats.occupancy = (float)page.usedArea / pageArea;
+		stats.push_back(pageStats);
+	}
+	return stats;
+}
+
+void TextureAtlas::Clear()
+{
+	for (Page& page : _pages)
+		glDeleteTextures(1, &page.textureID);
+	_pages.clear();
+}
+
+TextureAtlas::Page& TextureAtlas::AddPage()
+{
+	int size = GetPageSize();
+
+	Page page;
+	glGenTextures(1, &page.textureID);
+	glBindTexture(GL_TEXTURE_2D, page.textureID);
+	// images can't repeat in an atlas, clamping is what the padding is for
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// same filtering as a normal texture. No mipmaps, smaller mips would blend neighbouring images together
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// starts as one flat piece along the bottom
+	page.skyline.push_back(SkylineNode{ 0, 0, size });
+
+	_pages.push_back(page);
+	return _pages.back();
+}
+
+bool TextureAtlas::FindPosition(const Page& page, int width, int height, int& bestX, int& bestY, size_t& bestNode)
+{
+	int size = GetPageSize();
+	// lowest top edge found so far, and the width of the node it was on to break ties (narrower wastes less)
+	int bestTop = INT_MAX;
+	int bestWidth = INT_MAX;
+
+	for (size_t i = 0; i < page.skyline.size(); i++)
+	{
+		int x = page.skyline[i].x;
+		// nodes are in order from left to right so nothing after this fits either
+		if (x + width > size)
+			break;
+
+		// the rect has to sit on the highest node it spans
+		int y = 0;
+		int widthLeft = width;
+		for (size_t j = i; widthLeft > 0; j++)
+		{
+			y = std::max(y, page.skyline[j].y);
+			widthLeft -= page.skyline[j].width;
+		}
+
+		// sticks out the top
+		if (y + height > size)
+			continue;
+
+		int top = y + height;
+		if (top < bestTop || (top == bestTop && page.skyline[i].width < bestWidth))
+		{
+			bestTop = top;
+			bestWidth = page.skyline[i].width;
+			bestX = x;
+			bestY = y;
+			bestNode = i;
+		}
+	}
+
+	return bestTop != INT_MAX;
+}
+
+void TextureAtlas::AddToSkyline(Page& page, size_t node, int x, int y, int width, int height)
+{
+	std::vector<SkylineNode>& skyline = page.skyline;
+
+	// the top of the new rect is a new piece of skyline
+	skyline.insert(skyline.begin() + node, SkylineNode{ x, y + height, width });
+
+	// cut away the parts of the nodes after it that are now under it
+	size_t i = node + 1;
+	while (i < skyline.size())
+	{
+		int previousEnd = skyline[i - 1].x + skyline[i - 1].width;
+		// doesn't overlap so neither do any after it
+		if (skyline[i].x >= previousEnd)
+			break;
+
+		int overlap = previousEnd - skyline[i].x;
+		skyline[i].x += overlap;
+		skyline[i].width -= overlap;
+
+		if (skyline[i].width <= 0)
+			// completely covered
+			skyline.erase(skyline.begin() + i);
+		else
+			break;
+	}
+
+	// join neighbouring pieces at the same height
+	for (i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+			i++;
+	}
+}
+
+int TextureAtlas::GetPageSize()
+{
+	GLint maxTextureSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	// no context yet, just trust the setting
+	if (maxTextureSize <= 0)
+		return pageSize;
+	return std::min(pageSize, (int)maxTextureSize);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Packs lots of small images into a few big textures (pages) so sprites using them share a texture and can be batched together.
+// Each page is packed with a skyline: the page is filled from the bottom up and the packer only remembers the height of the top edge
+// along the page (a list of flat "skyline" segments). A new image goes wherever its top ends up lowest, which keeps pages fairly full
+// without having to remember every free rect.
+// Every image gets padding around it that is filled with copies of its edge pixels (extrusion), so linear filtering near an edge
+// blends with the same colour instead of bleeding in the neighbouring image.
+// The resource manager owns one of these, see ResourceManager::LoadTexture
+class TextureAtlas
+{
+public:
+	// where an image ended up
+	struct Region {
+		// GL texture of the page
+		unsigned int textureID = 0;
+		// which page it's on
+		unsigned int page = 0;
+		// xy: uv of the bottom left corner, zw: uv size. uv = xy + texCoord * zw
+		glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	};
+
+	// how full each page is
+	struct PageStats {
+		// GL texture of the page
+		unsigned int textureID = 0;
+		// how many images are on the page
+		unsigned int imageCount = 0;
+		// fraction (0 to 1) of the page's pixels that images take up, including their padding
+		float occupancy = 0.0f;
+	};
+
+	// whether textures get packed at all, turn off to give every texture its own GL texture like before
+	bool isEnabled = true;
+	// width and height of each page in pixels, change it before anything is added. Gets lowered to the max texture size if the gpu can't do this big
+	int pageSize = 2048;
+	// Images wider or taller than this (pixels) get their own texture instead. Big images don't gain much from sharing and would fill pages up fast
+	int maxImageSize = 256;
+	// pixels of extruded edge around each image
+	int padding = 2;
+
+	// whether an image of this size would be packed, if the atlas is enabled
+	bool Accepts(int width, int height);
+
+	// Packs an image (rows bottom to top, like stb_image gives with flipping on) with 1 to 4 channels into a page, making a new page if none have room.
+	// Returns false if it doesn't fit in an empty page either
+	bool Add(const unsigned char* data, int width, int height, int channels, Region& region);
+
+	// how full each page is
+	std::vector<PageStats> GetStats();
+
+	// deletes every page. Any texture that was in the atlas is invalid after this
+	void Clear();
+
+private:
+	// one flat piece of the skyline, starting at x and going width pixels right at height y
+	struct SkylineNode {
+		int x;
+		int y;
+		int width;
+	};
+
+	struct Page {
+		unsigned int textureID = 0;
+		std::vector<SkylineNode> skyline;
+		unsigned int imageCount = 0;
+		// pixels taken up by images and their padding
+		size_t usedArea = 0;
+	};
+
+	std::vector<Page> _pages;
+
+	// makes a new empty page
+	Page& AddPage();
+
+	// Finds the spot where a width x height rect sits lowest on the page's skyline. Returns false if there is nowhere it fits
+	bool FindPosition(const Page& page, int width, int height, int& bestX, int& bestY, size_t& bestNode);
+
+	// adds a rect at x, y to the skyline, starting at node index
+	void AddToSkyline(Page& page, size_t node, int x, int y, int width, int height);
+
+	// the page size that actually gets used
+	int GetPageSize();
+};
+
@@ -0,0 +1,374 @@
+#include "TilemapRenderer.h"
+#include "Entity.h"
+#include "ResourceManager.h"
+#include "Scene.h"
+#include "Hash.h"
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+unsigned int TilemapRenderer::EBO = 0;
+
+// vertices in one chunk's slot of the vertex buffer
+static const GLint chunkVertexCount = TilemapRenderer::ChunkSize * TilemapRenderer::ChunkSize * 4;
+
+TilemapRenderer::TilemapRenderer(TextureArray* tileset, unsigned int width, unsigned int height, glm::vec2 tileSize, ShaderProgram* program)
+{
+	if (tileset == nullptr)
+		throw std::exception("Tried to make a tilemap without a tileset");
+
+	if (width == 0 || height == 0)
+		throw std::exception("Tried to make a tilemap with no tiles");
+
+	// if the program wasn't specified
+	if (program == nullptr)
+	{
+		// all default tilemaps share the same program
+		this->shaderProgram = ResourceManager::GetShader(defaultProgramName);
+		// load it if this is the first default tilemap
+		if (this->shaderProgram == nullptr)
+			this->shaderProgram = ResourceManager::LoadShaderProgram(defaultProgramName, defaultVertPath, defaultFragPath);
+	}
+	else // else use given one
+		this->shaderProgram = program;
+
+	this->type = Entity::TilemapRenderer;
+	// tiles can have see through parts if the tileset has alpha
+	if (tileset->imageFormat == GL_RGBA)
+		this->hasTransprency = true;
+
+	_tileset = tileset;
+	_width = width;
+	_height = height;
+	_tileSize = tileSize;
+	_tiles.assign((size_t)width * height, EmptyTile);
+
+	// round up so the last chunks cover the edge
+	_chunksX = (width + ChunkSize - 1) / ChunkSize;
+	_chunksY = (height + ChunkSize - 1) / ChunkSize;
+	_chunks.resize((size_t)_chunksX * _chunksY);
+
+	// initialise the shared element buffer if this is the first tilemap
+	if (EBO == 0)
+		InitRenderData();
+
+	// the element buffer is remembered by the VAO so it only has to be bound here once
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBindVertexArray(0);
+
+	// enough for a few chunks to start with, a map that is mostly empty never needs many
+	GrowVertexBuffer(std::min((int)_chunks.size(), 16));
+
+	// -- per instance attributes (one instance per chunk), these are read from the scene's stream buffer when drawn --
+	_layout = new InstanceLayout(VAO, sizeof(InstanceData));
+	// chunk's corner after transform at location 3
+	_layout->AddAttribute(3, 4, offsetof(InstanceData, origin));
+	// tile's edges after transform at location 4
+	_layout->AddAttribute(4, 4, offsetof(InstanceData, axes));
+	// colour at location 5
+	_layout->AddAttribute(5, 4, offsetof(InstanceData, color));
+}
+
+TilemapRenderer::~TilemapRenderer()
+{
+	delete _layout;
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+}
+
+unsigned int TilemapRenderer::GetWidth()
+{
+	return _width;
+}
+
+unsigned int TilemapRenderer::GetHeight()
+{
+	return _height;
+}
+
+glm::vec2 TilemapRenderer::GetTileSize()
+{
+	return _tileSize;
+}
+
+void TilemapRenderer::SetTileSize(glm::vec2 newTileSize)
+{
+	if (newTileSize == _tileSize)
+		return;
+	// the vertices are in tiles so only the instance data changes
+	_tileSize = newTileSize;
+	_revision++;
+}
+
+TextureArray* TilemapRenderer::GetTileset()
+{
+	return _tileset;
+}
+
+uint16_t TilemapRenderer::GetTile(unsigned int x, unsigned int y)
+{
+	if (x >= _width || y >= _height)
+		throw std::exception("Tried to get a tile outside of the tilemap");
+
+	return _tiles[(size_t)y * _width + x];
+}
+
+void TilemapRenderer::SetTile(unsigned int x, unsigned int y, uint16_t tile)
+{
+	if (x >= _width || y >= _height)
+		throw std::exception("Tried to set a tile outside of the tilemap");
+
+	uint16_t& current = _tiles[(size_t)y * _width + x];
+	if (current == tile)
+		return;
+	current = tile;
+
+	// the chunk is rebuilt the next time it's drawn, so lots of changes to one chunk only build it once
+	_chunks[(size_t)(y / ChunkSize) * _chunksX + x / ChunkSize].isDirty = true;
+	_revision++;
+}
+
+void TilemapRenderer::Fill(unsigned int x, unsigned int y, unsigned int fillWidth, unsigned int fillHeight, uint16_t tile)
+{
+	// clip to the map
+	unsigned int endX = std::min(_width, x + fillWidth);
+	unsigned int endY = std::min(_height, y + fillHeight);
+	for (unsigned int tileY = y; tileY < endY; tileY++)
+		for (unsigned int tileX = x; tileX < endX; tileX++)
+			SetTile(tileX, tileY, tile);
+}
+
+void TilemapRenderer::SetTiles(const std::vector<uint16_t>& tiles)
+{
+	if (tiles.size() != _tiles.size())
+		throw std::exception("Tried to set a tilemap's tiles with the wrong amount of tiles");
+
+	_tiles = tiles;
+	for (Chunk& chunk : _chunks)
+		chunk.isDirty = true;
+	_revision++;
+}
+
+size_t TilemapRenderer::GetChunkCount()
+{
+	return _chunks.size();
+}
+
+size_t TilemapRenderer::GetVisibleChunkCount()
+{
+	return _visibleChunkCount;
+}
+
+void TilemapRenderer::Draw(std::shared_ptr<OrthoCamera> camera)
+{
+	if (parentEntity == nullptr)
+		throw std::exception("Tried to draw a tilemap which doesn't have a parent entity");
+
+	if (parentEntity->parentScene == nullptr)
+		throw std::exception("Tried to draw a tilemap which isn't in a scene");
+
+	_visibleChunkCount = 0;
+	if (_tileSize.x <= 0.0f || _tileSize.y <= 0.0f)
+		return;
+
+	DrawBatcher& drawBatcher = parentEntity->parentScene->drawBatcher;
+	glm::mat4 model = parentEntity->transform.ToMatrix(camera);
+
+	// -- work out which chunks the camera can see --
+	// The corners of the screen are taken back thru the projection, view and model into tiles. The batcher's matrices are used instead of
+	// the camera's so this is right when drawing into a render layer too
+	glm::mat4 screenToLocal = glm::inverse(drawBatcher.GetProjectionMatrix() * drawBatcher.GetViewMatrix() * model);
+	glm::vec2 visibleMin(1e30f);
+	glm::vec2 visibleMax(-1e30f);
+	for (int corner = 0; corner < 4; corner++)
+	{
+		glm::vec4 local = screenToLocal * glm::vec4(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, 0.0f, 1.0f);
+		// a point t (global coords) is at local coord (t - 1) * 2 like LineRenderer's points
+		glm::vec2 tile = (glm::vec2(local) / local.w * 0.5f + 1.0f) / _tileSize;
+		visibleMin = glm::min(visibleMin, tile);
+		visibleMax = glm::max(visibleMax, tile);
+	}
+
+	// to chunks, clipped to the map. Clipped as floats first so a camera miles away doesn't overflow the ints
+	float chunkSize = (float)ChunkSize;
+	glm::vec2 chunkLimit((float)_chunksX, (float)_chunksY);
+	glm::vec2 firstChunk = glm::clamp(glm::floor(visibleMin / chunkSize), glm::vec2(0.0f), chunkLimit);
+	glm::vec2 lastChunk = glm::clamp(glm::floor(visibleMax / chunkSize), glm::vec2(-1.0f), chunkLimit - 1.0f);
+	int firstChunkX = (int)firstChunk.x;
+	int firstChunkY = (int)firstChunk.y;
+	int lastChunkX = (int)lastChunk.x;
+	int lastChunkY = (int)lastChunk.y;
+
+	DrawBatcher::DrawState state;
+	state.program = shaderProgram;
+	state.layout = _layout;
+	state.textureTarget = GL_TEXTURE_2D_ARRAY;
+	state.texture = _tileset->ID;
+
+	// edges of one tile after the transform, the same for every chunk
+	glm::vec4 axisX = model * glm::vec4(_tileSize.x * 2.0f, 0.0f, 0.0f, 0.0f);
+	glm::vec4 axisY = model * glm::vec4(0.0f, _tileSize.y * 2.0f, 0.0f, 0.0f);
+
+	InstanceData instance;
+	instance.axes = glm::vec4(axisX.x, axisX.y, axisY.x, axisY.y);
+	instance.color = glm::vec4(color, 1.0f);
+
+	for (int chunkY = firstChunkY; chunkY <= lastChunkY; chunkY++)
+	{
+		for (int chunkX = firstChunkX; chunkX <= lastChunkX; chunkX++)
+		{
+			Chunk& chunk = _chunks[(size_t)chunkY * _chunksX + chunkX];
+			if (chunk.isDirty)
+				RebuildChunk(chunkX, chunkY);
+			if (chunk.tileCount == 0)
+				continue;
+
+			glm::vec2 chunkOrigin = glm::vec2((float)chunkX, (float)chunkY) * chunkSize * _tileSize;
+			instance.origin = glm::vec4(glm::vec3(model * glm::vec4((chunkOrigin - 1.0f) * 2.0f, 0.0f, 1.0f)), 0.0f);
+
+			// the chunk's slot, 6 indices per tile that isn't empty
+			DrawBatcher::MeshRange mesh;
+			mesh.indexCount = chunk.tileCount * 6;
+			mesh.baseVertex = chunk.slot * chunkVertexCount;
+
+			drawBatcher.AddInstance(state, mesh, &instance);
+			_visibleChunkCount++;
+		}
+	}
+}
+
+size_t TilemapRenderer::GetStateHash()
+{
+	size_t hash = 0;
+	Hash::Add(hash, _revision);
+	Hash::Add(hash, color);
+	Hash::Add(hash, _tileset->ID);
+	Hash::Add(hash, shaderProgram);
+	return hash;
+}
+
+void TilemapRenderer::GetLocalBounds(glm::vec2& min, glm::vec2& max)
+{
+	// same conversion as Draw, the map goes from 0 to its size
+	min = glm::vec2(-2.0f);
+	max = (glm::vec2((float)_width, (float)_height) * _tileSize - 1.0f) * 2.0f;
+}
+
+void TilemapRenderer::RebuildChunk(unsigned int chunkX, unsigned int chunkY)
+{
+	Chunk& chunk = _chunks[(size_t)chunkY * _chunksX + chunkX];
+	chunk.isDirty = false;
+
+	// -- one quad per tile that isn't empty, corners in the same order as the sprite rect --
+	std::vector<TileVertex> vertices;
+	vertices.reserve(chunkVertexCount);
+	unsigned int startX = chunkX * ChunkSize;
+	unsigned int startY = chunkY * ChunkSize;
+	unsigned int endX = std::min(startX + ChunkSize, _width);
+	unsigned int endY = std::min(startY + ChunkSize, _height);
+	for (unsigned int y = startY; y < endY; y++)
+	{
+		for (unsigned int x = startX; x < endX; x++)
+		{
+			uint16_t tile = _tiles[(size_t)y * _width + x];
+			if (tile == EmptyTile)
+				continue;
+
+			uint8_t localX = (uint8_t)(x - startX);
+			uint8_t localY = (uint8_t)(y - startY);
+			vertices.push_back(TileVertex{ (uint8_t)(localX + 1), (uint8_t)(localY + 1), 1, 1, tile, 0 }); // top right
+			vertices.push_back(TileVertex{ (uint8_t)(localX + 1), localY, 1, 0, tile, 0 }); // bottom right
+			vertices.push_back(TileVertex{ localX, localY, 0, 0, tile, 0 }); // bottom left
+			vertices.push_back(TileVertex{ localX, (uint8_t)(localY + 1), 0, 1, tile, 0 }); // top left
+		}
+	}
+	chunk.tileCount = (GLsizei)(vertices.size() / 4);
+
+	// nothing to draw, give the slot back
+	if (chunk.tileCount == 0)
+	{
+		if (chunk.slot >= 0)
+			_freeSlots.push_back(chunk.slot);
+		chunk.slot = -1;
+		return;
+	}
+
+	if (chunk.slot < 0)
+	{
+		if (_freeSlots.empty())
+			GrowVertexBuffer(_slotCapacity * 2);
+		chunk.slot = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+
+	// only the part of the slot that's used is uploaded
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)chunk.slot * chunkVertexCount * sizeof(TileVertex), vertices.size() * sizeof(TileVertex), vertices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TilemapRenderer::GrowVertexBuffer(int newCapacity)
+{
+	unsigned int newVBO;
+	glGenBuffers(1, &newVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, newVBO);
+	// static because a chunk only changes when its tiles do
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)newCapacity * chunkVertexCount * sizeof(TileVertex), nullptr, GL_STATIC_DRAW);
+
+	// copy the old chunks over on the gpu, every slot stays where it was
+	if (VBO != 0)
+	{
+		glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, 0, 0, (GLsizeiptr)_slotCapacity * chunkVertexCount * sizeof(TileVertex));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glDeleteBuffers(1, &VBO);
+	}
+
+	// point the vertex attributes at the new buffer
+	glBindVertexArray(VAO);
+	// position in the chunk at location 0, 2 bytes turned into floats (not normalised so they stay 0 to ChunkSize)
+	glVertexAttribPointer(0, 2, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(TileVertex), (void*)offsetof(TileVertex, x));
+	glEnableVertexAttribArray(0);
+	// texture coord at location 1
+	glVertexAttribPointer(1, 2, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(TileVertex), (void*)offsetof(TileVertex, u));
+	glEnableVertexAttribArray(1);
+	// tileset layer at location 2
+	glVertexAttribPointer(2, 1, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(TileVertex), (void*)offsetof(TileVertex, layer));
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// the new slots are free, highest first so the lowest get used first
+	for (int slot = newCapacity - 1; slot >= _slotCapacity; slot--)
+		_freeSlots.push_back(slot);
+
+	VBO = newVBO;
+	_slotCapacity = newCapacity;
+}
+
+void TilemapRenderer::InitRenderData()
+{
+	// indices for a full chunk of quads, a chunk with fewer tiles just draws fewer of them
+	std::vector<GLuint> indices;
+	indices.reserve(ChunkSize * ChunkSize * 6);
+	for (GLuint quad = 0; quad < ChunkSize * ChunkSize; quad++)
+	{
+		GLuint first = quad * 4;
+		// first triangle
+		indices.push_back(first);
+		indices.push_back(first + 1);
+		indices.push_back(first + 2);
+		// second triangle
+		indices.push_back(first + 2);
+		indices.push_back(first + 3);
+		indices.push_back(first);
+	}
+
+	glGenBuffers(1, &EBO);
+	// the element buffer binding belongs to whichever vertex array is bound, so fill it thru the array buffer binding instead
+	glBindBuffer(GL_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Component.h"
+#include "ShaderProgram.h"
+#include "OrthoCamera.h"
+#include "InstanceLayout.h"
+#include "TextureArray.h"
+
+// Renders a grid of tiles (e.g. a level map) as one component, instead of an entity and sprite per tile which doesn't work for millions of tiles.
+// Each tile is an index into a tileset, a texture array with one tile image per layer (so tiles never bleed into each other).
+// The grid is split into ChunkSize x ChunkSize chunks. Each chunk's tiles are built into vertices once and kept in a gpu buffer,
+// then every visible chunk is one command in a single batched draw. Changing a tile just marks its chunk, which is rebuilt next time it's drawn.
+// Chunks outside what the camera can see are skipped without looking at their tiles.
+// The map's bottom left corner is at (0,0) in the same coords as LineRenderer's points and like LineRenderer the transform's size just acts
+// as a scalar value, so for a normal size set offsetSize to (1,1,0)
+class TilemapRenderer :
+    public Component
+{
+public:
+    // tile index for a tile with nothing in it
+    static const uint16_t EmptyTile = 0xFFFF;
+    // width and height of a chunk in tiles
+    static const unsigned int ChunkSize = 32;
+
+    // Setup a new tilemap that is width x height tiles, all empty, drawn with a tileset and a shader program. tileSize is in global coords
+    // NOTE: If shader program is set to nullptr it will use the default tilemap shader. A custom shader has to take the same attributes as TilemapDefault.vert
+    TilemapRenderer(TextureArray* tileset, unsigned int width, unsigned int height, glm::vec2 tileSize = glm::vec2(32.0f), ShaderProgram* program = nullptr);
+    ~TilemapRenderer();
+
+    // the chunk buffer, VAO and instance layout belong to one renderer, a copy would delete them twice
+    TilemapRenderer(const TilemapRenderer&) = delete;
+    TilemapRenderer& operator=(const TilemapRenderer&) = delete;
+
+    // colour every tile is multiplied by
+    glm::vec3 color = glm::vec3(1.0f);
+
+    // width of the map in tiles
+    unsigned int GetWidth();
+    // height of the map in tiles
+    unsigned int GetHeight();
+
+    // get the size of one tile in global coords (before the transform's size)
+    glm::vec2 GetTileSize();
+    // set the size of one tile in global coords (before the transform's size). Nothing has to be rebuilt for this
+    void SetTileSize(glm::vec2 newTileSize);
+
+    // get the texture array the tiles come from
+    TextureArray* GetTileset();
+
+    // get the tile at x, y (0, 0 is the bottom left)
+    uint16_t GetTile(unsigned int x, unsigned int y);
+    // Set the tile at x, y to a layer of the tileset or EmptyTile. Only marks its chunk to be rebuilt, nothing is built until it's drawn
+    void SetTile(unsigned int x, unsigned int y, uint16_t tile);
+    // sets every tile in a rect of tiles, clipped to the map
+    void Fill(unsigned int x, unsigned int y, unsigned int fillWidth, unsigned int fillHeight, uint16_t tile);
+    // sets every tile from width * height indices, a row at a time starting from the bottom
+    void SetTiles(const std::vector<uint16_t>& tiles);
+
+    // how many chunks the map is split into
+    size_t GetChunkCount();
+    // how many chunks were visible (and not empty) the last time it was drawn
+    size_t GetVisibleChunkCount();
+
+    // Draw the chunks that the camera can see using reference to scene camera and parent entity's transform.
+    // Dirty chunks that are visible are rebuilt first, every chunk is then added to the scene's draw batcher as part of one draw
+    void Draw(std::shared_ptr<OrthoCamera> camera);
+
+    // returns a hash of everything about this renderer that changes how it looks. Used by render layers to tell when they need redrawing
+    size_t GetStateHash();
+
+    // gets the smallest and biggest local coords of the map (before the entity's transform is applied)
+    void GetLocalBounds(glm::vec2& min, glm::vec2& max);
+
+private:
+    // one corner of a tile. Small enough that a full chunk is 32KB
+    struct TileVertex {
+        // corner's position in the chunk, in tiles (0 to ChunkSize)
+        uint8_t x, y;
+        // which corner it is, also the texture coord (0 or 1)
+        uint8_t u, v;
+        // layer of the tileset
+        uint16_t layer;
+        // keeps each vertex 4 byte aligned
+        uint16_t padding;
+    };
+
+    // what gets sent to the gpu for each chunk
+    struct InstanceData {
+        // bottom left corner of the chunk after the entity's transform, w is unused
+        glm::vec4 origin;
+        // xy is one tile's bottom edge and zw its left edge, after the entity's transform
+        glm::vec4 axes;
+        // colour with alpha
+        glm::vec4 color;
+    };
+
+    struct Chunk {
+        // whether its tiles changed since it was last built
+        bool isDirty = true;
+        // which slot of the vertex buffer its vertices are in, -1 for none
+        int slot = -1;
+        // how many tiles weren't empty when it was last built
+        GLsizei tileCount = 0;
+    };
+
+    TextureArray* _tileset;
+    unsigned int _width;
+    unsigned int _height;
+    glm::vec2 _tileSize;
+    // every tile index, a row at a time from the bottom
+    std::vector<uint16_t> _tiles;
+
+    // chunks across and up, then every chunk a row at a time from the bottom
+    unsigned int _chunksX;
+    unsigned int _chunksY;
+    std::vector<Chunk> _chunks;
+    size_t _visibleChunkCount = 0;
+
+    // Every chunk gets a fixed size slot (enough for a full chunk) in the tilemap's own vertex buffer, so they all share one VAO
+    // and the batcher can draw them together. The buffer grows by doubling when it runs out of slots
+    unsigned int VAO = 0;
+    unsigned int VBO = 0;
+    InstanceLayout* _layout = nullptr;
+    int _slotCapacity = 0;
+    // slots that aren't used by a chunk
+    std::vector<int> _freeSlots;
+
+    // goes up by one whenever a tile or the tile size changes
+    size_t _revision = 0;
+
+    // shader program that the tilemap uses
+    ShaderProgram* shaderProgram;
+
+    // default shaders, the fragment shader is the same as texture array sprites
+    const char* defaultVertPath = "VertexShaders/TilemapDefault.vert";
+    const char* defaultFragPath = "FragmentShaders/SpriteArray.frag";
+    // name that the default program is stored under in the resource manager
+    const char* defaultProgramName = "defaultTilemapProgram";
+    // Every tilemap shares one element buffer, the indices of a full chunk of quads
+    static unsigned int EBO;
+    // Creates the shared element buffer
+    static void InitRenderData();
+
+    // builds a chunk's vertices and uploads them into its slot
+    void RebuildChunk(unsigned int chunkX, unsigned int chunkY);
+
+    // makes the vertex buffer hold newCapacity slots, copying the old ones over
+    void GrowVertexBuffer(int newCapacity);
+};
+
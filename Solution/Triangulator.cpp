@@ -0,0 +1,661 @@
+#include "Triangulator.h"
+#include <deque>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// one point in a ring. Every ring is a circular doubly linked list so points can be cut out as ears are clipped
+	struct Node {
+		// index of the point in the input
+		uint32_t index;
+		double x, y;
+		// neighbours in the ring
+		Node* prev = nullptr;
+		Node* next = nullptr;
+		// position along the z-order curve and neighbours in z-order, only used for big polygons
+		int32_t z = 0;
+		Node* prevZ = nullptr;
+		Node* nextZ = nullptr;
+		// whether it's a lone point that mustn't be filtered out
+		bool isSteiner = false;
+	};
+
+	// everything one triangulation needs, so more than one can run at once on different threads
+	class EarClipper
+	{
+	public:
+		std::vector<uint32_t> triangles;
+
+		void Run(const std::vector<glm::vec2>& outline, const std::vector<std::vector<glm::vec2>>& holes)
+		{
+			uint32_t nextIndex = 0;
+			Node* outerNode = LinkRing(outline, nextIndex, true);
+			// fewer than 3 points
+			if (outerNode == nullptr || outerNode->next == outerNode->prev)
+				return;
+
+			size_t pointCount = outline.size();
+			if (!holes.empty())
+			{
+				outerNode = EliminateHoles(holes, outerNode, nextIndex);
+				for (const std::vector<glm::vec2>& hole : holes)
+					pointCount += hole.size();
+			}
+
+			// big polygon, get ready to sort its points along the z-order curve
+			if (pointCount > Triangulator::hashThreshold)
+			{
+				_minX = _maxX = outline[0].x;
+				_minY = _maxY = outline[0].y;
+				for (const glm::vec2& point : outline)
+				{
+					_minX = std::min(_minX, (double)point.x);
+					_minY = std::min(_minY, (double)point.y);
+					_maxX = std::max(_maxX, (double)point.x);
+					_maxY = std::max(_maxY, (double)point.y);
+				}
+				// z-order codes are 15 bits per axis
+				double size = std::max(_maxX - _minX, _maxY - _minY);
+				_inverseSize = size != 0.0 ? 32767.0 / size : 0.0;
+			}
+
+			triangles.reserve((pointCount + holes.size() * 2) * 3);
+			ClipEars(outerNode, 0);
+		}
+
+	private:
+		// deque so nodes never move once they're made
+		std::deque<Node> _nodes;
+		double _minX = 0.0, _minY = 0.0, _maxX = 0.0, _maxY = 0.0;
+		// 0 when the z-order curve isn't used
+		double _inverseSize = 0.0;
+
+		Node* InsertNode(uint32_t index, double x, double y, Node* last)
+		{
+			_nodes.push_back(Node());
+			Node* node = &_nodes.back();
+			node->index = index;
+			node->x = x;
+			node->y = y;
+			if (last == nullptr)
+			{
+				node->prev = node;
+				node->next = node;
+			}
+			else
+			{
+				node->next = last->next;
+				node->prev = last;
+				last->next->prev = node;
+				last->next = node;
+			}
+			return node;
+		}
+
+		static void RemoveNode(Node* node)
+		{
+			node->next->prev = node->prev;
+			node->prev->next = node->next;
+			if (node->prevZ != nullptr)
+				node->prevZ->nextZ = node->nextZ;
+			if (node->nextZ != nullptr)
+				node->nextZ->prevZ = node->prevZ;
+		}
+
+		// Makes a ring out of points, going clockwise for the outline and anticlockwise for holes whichever way they were given.
+		// Returns the last node, nullptr if there were no points
+		Node* LinkRing(const std::vector<glm::vec2>& points, uint32_t& nextIndex, bool clockwise)
+		{
+			uint32_t firstIndex = nextIndex;
+			nextIndex += (uint32_t)points.size();
+			if (points.empty())
+				return nullptr;
+
+			// shoelace, positive when clockwise
+			double sum = 0.0;
+			for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+				sum += ((double)points[j].x - points[i].x) * ((double)points[i].y + points[j].y);
+
+			Node* last = nullptr;
+			if (clockwise == (sum > 0.0))
+				for (size_t i = 0; i < points.size(); i++)
+					last = InsertNode(firstIndex + (uint32_t)i, points[i].x, points[i].y, last);
+			else
+				for (size_t i = points.size(); i-- > 0;)
+					last = InsertNode(firstIndex + (uint32_t)i, points[i].x, points[i].y, last);
+
+			// the first and last point being the same would be a zero length edge
+			if (last != nullptr && Equals(last, last->next))
+			{
+				RemoveNode(last);
+				last = last->next;
+			}
+			return last;
+		}
+
+		// -- geometry --
+
+		// twice the signed area of a triangle, negative for a convex corner of the outline's ring
+		static double Area(const Node* p, const Node* q, const Node* r)
+		{
+			return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+		}
+
+		static bool Equals(const Node* a, const Node* b)
+		{
+			return a->x == b->x && a->y == b->y;
+		}
+
+		static bool PointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+		{
+			return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+				(ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+				(bx - px) * (cy - py) >= (cx - px) * (by - py);
+		}
+
+		static int Sign(double value)
+		{
+			return (value > 0.0) - (value < 0.0);
+		}
+
+		// whether q is on segment pr, assuming they're in a line
+		static bool OnSegment(const Node* p, const Node* q, const Node* r)
+		{
+			return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) && q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+		}
+
+		// whether segments p1q1 and p2q2 cross or touch
+		static bool Intersects(const Node* p1, const Node* q1, const Node* p2, const Node* q2)
+		{
+			int o1 = Sign(Area(p1, q1, p2));
+			int o2 = Sign(Area(p1, q1, q2));
+			int o3 = Sign(Area(p2, q2, p1));
+			int o4 = Sign(Area(p2, q2, q1));
+
+			if (o1 != o2 && o3 != o4)
+				return true;
+			// in a line and overlapping
+			return (o1 == 0 && OnSegment(p1, p2, q1)) || (o2 == 0 && OnSegment(p1, q2, q1)) ||
+				(o3 == 0 && OnSegment(p2, p1, q2)) || (o4 == 0 && OnSegment(p2, q1, q2));
+		}
+
+		// whether diagonal ab crosses any edge of the ring
+		static bool IntersectsPolygon(const Node* a, const Node* b)
+		{
+			const Node* p = a;
+			do
+			{
+				if (p->index != a->index && p->next->index != a->index && p->index != b->index && p->next->index != b->index &&
+					Intersects(p, p->next, a, b))
+					return true;
+				p = p->next;
+			} while (p != a);
+			return false;
+		}
+
+		// whether diagonal ab starts off inside the ring at a
+		static bool LocallyInside(const Node* a, const Node* b)
+		{
+			if (Area(a->prev, a, a->next) < 0.0)
+				return Area(a, b, a->next) >= 0.0 && Area(a, a->prev, b) >= 0.0;
+			return Area(a, b, a->prev) < 0.0 || Area(a, a->next, b) < 0.0;
+		}
+
+		// whether the middle of diagonal ab is inside the ring (even-odd)
+		static bool MiddleInside(const Node* a, const Node* b)
+		{
+			const Node* p = a;
+			bool inside = false;
+			double px = (a->x + b->x) / 2.0;
+			double py = (a->y + b->y) / 2.0;
+			do
+			{
+				if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+					(px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+					inside = !inside;
+				p = p->next;
+			} while (p != a);
+			return inside;
+		}
+
+		// whether ab can be used to split the ring in two
+		static bool IsValidDiagonal(const Node* a, const Node* b)
+		{
+			if (a->next->index == b->index || a->prev->index == b->index || IntersectsPolygon(a, b))
+				return false;
+			bool isInside = LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b) &&
+				(Area(a->prev, a, b->prev) != 0.0 || Area(a, b->prev, b) != 0.0);
+			// or a zero length diagonal between two convex corners
+			bool isZeroLength = Equals(a, b) && Area(a->prev, a, a->next) > 0.0 && Area(b->prev, b, b->next) > 0.0;
+			return isInside || isZeroLength;
+		}
+
+		// -- clipping --
+
+		// removes repeated points and points in a straight line between their neighbours
+		Node* FilterPoints(Node* start, Node* end = nullptr)
+		{
+			if (start == nullptr)
+				return start;
+			if (end == nullptr)
+				end = start;
+
+			Node* p = start;
+			bool again;
+			do
+			{
+				again = false;
+				if (!p->isSteiner && (Equals(p, p->next) || Area(p->prev, p, p->next) == 0.0))
+				{
+					RemoveNode(p);
+					p = end = p->prev;
+					if (p == p->next)
+						break;
+					again = true;
+				}
+				else
+					p = p->next;
+			} while (again || p != end);
+			return end;
+		}
+
+		// whether the corner at ear can be cut off without any other point being inside it
+		bool IsEar(const Node* ear)
+		{
+			const Node* a = ear->prev;
+			const Node* b = ear;
+			const Node* c = ear->next;
+			// concave corner
+			if (Area(a, b, c) >= 0.0)
+				return false;
+
+			double minX = std::min({ a->x, b->x, c->x });
+			double minY = std::min({ a->y, b->y, c->y });
+			double maxX = std::max({ a->x, b->x, c->x });
+			double maxY = std::max({ a->y, b->y, c->y });
+
+			for (const Node* p = c->next; p != a; p = p->next)
+				if (p->x >= minX && p->x <= maxX && p->y >= minY && p->y <= maxY &&
+					PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && Area(p->prev, p, p->next) >= 0.0)
+					return false;
+			return true;
+		}
+
+		// same as IsEar but only checks points whose z-order is within the ear's bounding box
+		bool IsEarHashed(const Node* ear)
+		{
+			const Node* a = ear->prev;
+			const Node* b = ear;
+			const Node* c = ear->next;
+			if (Area(a, b, c) >= 0.0)
+				return false;
+
+			double minX = std::min({ a->x, b->x, c->x });
+			double minY = std::min({ a->y, b->y, c->y });
+			double maxX = std::max({ a->x, b->x, c->x });
+			double maxY = std::max({ a->y, b->y, c->y });
+			int32_t minZ = ZOrder(minX, minY);
+			int32_t maxZ = ZOrder(maxX, maxY);
+
+			auto blocksEar = [&](const Node* p)
+				{
+					return p != a && p != c && p->x >= minX && p->x <= maxX && p->y >= minY && p->y <= maxY &&
+						PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && Area(p->prev, p, p->next) >= 0.0;
+				};
+
+			// look both ways along the curve at once
+			const Node* p = ear->prevZ;
+			const Node* n = ear->nextZ;
+			while (p != nullptr && p->z >= minZ && n != nullptr && n->z <= maxZ)
+			{
+				if (blocksEar(p))
+					return false;
+				p = p->prevZ;
+				if (blocksEar(n))
+					return false;
+				n = n->nextZ;
+			}
+			for (; p != nullptr && p->z >= minZ; p = p->prevZ)
+				if (blocksEar(p))
+					return false;
+			for (; n != nullptr && n->z <= maxZ; n = n->nextZ)
+				if (blocksEar(n))
+					return false;
+			return true;
+		}
+
+		// Goes round the ring cutting off ears until it's a triangle. If it goes all the way round without finding one it tries
+		// filtering points (pass 1), then fixing small self-intersections (pass 2), then splitting the ring in two
+		void ClipEars(Node* ear, int pass)
+		{
+			if (ear == nullptr)
+				return;
+
+			if (pass == 0 && _inverseSize != 0.0)
+				IndexCurve(ear);
+
+			Node* stop = ear;
+			while (ear->prev != ear->next)
+			{
+				Node* prev = ear->prev;
+				Node* next = ear->next;
+
+				if (_inverseSize != 0.0 ? IsEarHashed(ear) : IsEar(ear))
+				{
+					triangles.push_back(prev->index);
+					triangles.push_back(ear->index);
+					triangles.push_back(next->index);
+					RemoveNode(ear);
+
+					// skipping the next point leaves fewer thin triangles
+					ear = next->next;
+					stop = next->next;
+					continue;
+				}
+
+				ear = next;
+
+				// been all the way round without clipping anything
+				if (ear == stop)
+				{
+					if (pass == 0)
+						ClipEars(FilterPoints(ear), 1);
+					else if (pass == 1)
+						ClipEars(CureLocalIntersections(FilterPoints(ear)), 2);
+					else
+						SplitAndClip(ear);
+					break;
+				}
+			}
+		}
+
+		// cuts off corners where two edges next to each other cross
+		Node* CureLocalIntersections(Node* start)
+		{
+			Node* p = start;
+			do
+			{
+				Node* a = p->prev;
+				Node* b = p->next->next;
+				if (!Equals(a, b) && Intersects(a, p, p->next, b) && LocallyInside(a, b) && LocallyInside(b, a))
+				{
+					triangles.push_back(a->index);
+					triangles.push_back(p->index);
+					triangles.push_back(b->index);
+					RemoveNode(p);
+					RemoveNode(p->next);
+					p = start = b;
+				}
+				p = p->next;
+			} while (p != start);
+			return FilterPoints(p);
+		}
+
+		// finds a valid diagonal, splits the ring along it and clips both halves
+		void SplitAndClip(Node* start)
+		{
+			Node* a = start;
+			do
+			{
+				for (Node* b = a->next->next; b != a->prev; b = b->next)
+				{
+					if (a->index != b->index && IsValidDiagonal(a, b))
+					{
+						Node* c = SplitRing(a, b);
+						a = FilterPoints(a, a->next);
+						c = FilterPoints(c, c->next);
+						ClipEars(a, 0);
+						ClipEars(c, 0);
+						return;
+					}
+				}
+				a = a->next;
+			} while (a != start);
+		}
+
+		// Joins a and b with two edges (one each way), which splits one ring into two or joins two rings (a hole) into one.
+		// Returns the copy of b that's in the second ring
+		Node* SplitRing(Node* a, Node* b)
+		{
+			Node* a2 = InsertNode(a->index, a->x, a->y, nullptr);
+			Node* b2 = InsertNode(b->index, b->x, b->y, nullptr);
+			Node* an = a->next;
+			Node* bp = b->prev;
+
+			a->next = b;
+			b->prev = a;
+
+			a2->next = an;
+			an->prev = a2;
+
+			b2->next = a2;
+			a2->prev = b2;
+
+			bp->next = b2;
+			b2->prev = bp;
+
+			return b2;
+		}
+
+		// -- holes --
+
+		// joins every hole onto the outline, left to right
+		Node* EliminateHoles(const std::vector<std::vector<glm::vec2>>& holes, Node* outerNode, uint32_t& nextIndex)
+		{
+			std::vector<Node*> queue;
+			for (const std::vector<glm::vec2>& hole : holes)
+			{
+				Node* list = LinkRing(hole, nextIndex, false);
+				if (list == nullptr)
+					continue;
+				if (list == list->next)
+					list->isSteiner = true;
+				queue.push_back(GetLeftmost(list));
+			}
+
+			std::sort(queue.begin(), queue.end(), [](const Node* a, const Node* b)
+				{
+					return a->x != b->x ? a->x < b->x : a->y < b->y;
+				});
+
+			for (Node* hole : queue)
+				outerNode = EliminateHole(hole, outerNode);
+			return outerNode;
+		}
+
+		Node* EliminateHole(Node* hole, Node* outerNode)
+		{
+			Node* bridge = FindHoleBridge(hole, outerNode);
+			if (bridge == nullptr)
+				return outerNode;
+
+			Node* bridgeReverse = SplitRing(bridge, hole);
+			// filter the collinear points around the cut
+			FilterPoints(bridgeReverse, bridgeReverse->next);
+			return FilterPoints(bridge, bridge->next);
+		}
+
+		// Finds a point on the outline that can be joined to the hole's leftmost point without crossing anything
+		// (David Eberly's method): cast a ray left from the hole, then pick the best point in the triangle it makes
+		Node* FindHoleBridge(Node* hole, Node* outerNode)
+		{
+			Node* p = outerNode;
+			double hx = hole->x;
+			double hy = hole->y;
+			double qx = -INFINITY;
+			Node* m = nullptr;
+
+			// closest edge to the left of the hole that the ray hits
+			do
+			{
+				if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+				{
+					double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+					if (x <= hx && x > qx)
+					{
+						qx = x;
+						m = p->x < p->next->x ? p : p->next;
+						// hit a point exactly
+						if (x == hx)
+							return m;
+					}
+				}
+				p = p->next;
+			} while (p != outerNode);
+
+			if (m == nullptr)
+				return nullptr;
+
+			// Any point of the outline inside the triangle between the hole, the hit and m could block the bridge,
+			// the one at the smallest angle to the ray is safe
+			Node* stop = m;
+			double mx = m->x;
+			double my = m->y;
+			double tanMin = INFINITY;
+			p = m;
+			do
+			{
+				if (hx >= p->x && p->x >= mx && hx != p->x &&
+					PointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+				{
+					double tan = std::abs(hy - p->y) / (hx - p->x);
+					if (LocallyInside(p, hole) &&
+						(tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && SectorContainsSector(m, p))))))
+					{
+						m = p;
+						tanMin = tan;
+					}
+				}
+				p = p->next;
+			} while (p != stop);
+
+			return m;
+		}
+
+		// whether the corner at p fits inside the corner at m
+		static bool SectorContainsSector(const Node* m, const Node* p)
+		{
+			return Area(m->prev, m, p->prev) < 0.0 && Area(p->next, m, m->next) < 0.0;
+		}
+
+		static Node* GetLeftmost(Node* start)
+		{
+			Node* p = start;
+			Node* leftmost = start;
+			do
+			{
+				if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+					leftmost = p;
+				p = p->next;
+			} while (p != start);
+			return leftmost;
+		}
+
+		// -- z-order curve --
+
+		// interleaves the bits of x and y (15 bits each) so points close together have close values
+		int32_t ZOrder(double px, double py)
+		{
+			int32_t x = (int32_t)((px - _minX) * _inverseSize);
+			int32_t y = (int32_t)((py - _minY) * _inverseSize);
+
+			x = (x | (x << 8)) & 0x00FF00FF;
+			x = (x | (x << 4)) & 0x0F0F0F0F;
+			x = (x | (x << 2)) & 0x33333333;
+			x = (x | (x << 1)) & 0x55555555;
+
+			y = (y | (y << 8)) & 0x00FF00FF;
+			y = (y | (y << 4)) & 0x0F0F0F0F;
+			y = (y | (y << 2)) & 0x33333333;
+			y = (y | (y << 1)) & 0x55555555;
+
+			return x | (y << 1);
+		}
+
+		// gives every point in the ring its z-order and links them up in z-order
+		void IndexCurve(Node* start)
+		{
+			Node* p = start;
+			do
+			{
+				if (p->z == 0)
+					p->z = ZOrder(p->x, p->y);
+				p->prevZ = p->prev;
+				p->nextZ = p->next;
+				p = p->next;
+			} while (p != start);
+
+			p->prevZ->nextZ = nullptr;
+			p->prevZ = nullptr;
+
+			SortLinked(p);
+		}
+
+		// merge sort of the z-order list (Simon Tatham's linked list sort), no extra memory needed
+		static Node* SortLinked(Node* list)
+		{
+			int inSize = 1;
+			int mergeCount;
+			do
+			{
+				Node* p = list;
+				list = nullptr;
+				Node* tail = nullptr;
+				mergeCount = 0;
+
+				while (p != nullptr)
+				{
+					mergeCount++;
+					Node* q = p;
+					int pSize = 0;
+					for (int i = 0; i < inSize; i++)
+					{
+						pSize++;
+						q = q->nextZ;
+						if (q == nullptr)
+							break;
+					}
+					int qSize = inSize;
+
+					while (pSize > 0 || (qSize > 0 && q != nullptr))
+					{
+						Node* e;
+						if (pSize != 0 && (qSize == 0 || q == nullptr || p->z <= q->z))
+						{
+							e = p;
+							p = p->nextZ;
+							pSize--;
+						}
+						else
+						{
+							e = q;
+							q = q->nextZ;
+							qSize--;
+						}
+
+						if (tail != nullptr)
+							tail->nextZ = e;
+						else
+							list = e;
+						e->prevZ = tail;
+						tail = e;
+					}
+					p = q;
+				}
+
+				tail->nextZ = nullptr;
+				inSize *= 2;
+			} while (mergeCount > 1);
+
+			return list;
+		}
+	};
+}
+
+std::vector<uint32_t> Triangulator::Triangulate(const std::vector<glm::vec2>& outline, const std::vector<std::vector<glm::vec2>>& holes)
+{
+	EarClipper clipper;
+	clipper.Run(outline, holes);
+	return std::move(clipper.triangles);
+}
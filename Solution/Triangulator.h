@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Turns polygons (with or without holes) into triangles by ear clipping. Holes are joined onto the outside with a bridge so the
+// whole thing becomes one ring that is clipped like a simple polygon.
+// Big polygons keep their points sorted along a z-order curve so checking whether an ear has another point inside it only looks
+// at nearby points, which keeps 100k point polygons fast instead of every ear checking every point.
+// Self-intersecting or otherwise broken polygons still give triangles (it falls back to cutting them up more roughly) but they might not be right.
+// Doesn't touch GL so it can run on a worker thread.
+// Static class like the resource manager
+class Triangulator
+{
+public:
+	// Triangulates the polygon outline with any holes inside it. Points can go either way round.
+	// Returns 3 indices per triangle, counting through outline's points first and then each hole's in order
+	static std::vector<uint32_t> Triangulate(const std::vector<glm::vec2>& outline, const std::vector<std::vector<glm::vec2>>& holes = {});
+
+	// polygons with more points than this are sorted along the z-order curve, smaller ones are quicker to just check every point
+	static const size_t hashThreshold = 80;
+
+private:
+	// private constructor, only static functions
+	Triangulator();
+};
+
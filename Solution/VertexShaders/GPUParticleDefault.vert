@@ -0,0 +1,47 @@
+#version 330 core
+// corner of the particle's quad from -1 to 1
+layout (location = 0) in vec2 aCorner;
+
+// -- per instance values, read straight from the particle buffer the simulation wrote --
+// xy: position, zw: velocity. Global coords relative to the entity
+layout (location = 1) in vec4 aPositionVelocity;
+// x: seconds left to live, y: lifetime, z: diameter, w: where its colour is between minColor and maxColor
+layout (location = 2) in vec4 aLife;
+
+out vec2 corner;
+out vec4 particleColor;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+// where a particle at (0,0) ends up in the coords the model matrix outputs (2 per global unit)
+uniform vec2 origin;
+// the entity's size, which acts as a scalar
+uniform float scale;
+// depth of the entity's zIndex
+uniform float depth;
+uniform vec4 minColor;
+uniform vec4 maxColor;
+uniform bool fadeOut;
+
+void main()
+{
+    corner = aCorner;
+
+    // every slot that could still be alive is drawn, ones that died early are put outside the screen so nothing gets rasterised
+    if (aLife.x <= 0.0)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        particleColor = vec4(0.0);
+        return;
+    }
+
+    // same maths as ParticleSystem::Draw
+    vec2 centre = origin + aPositionVelocity.xy * scale * 2.0;
+    float radius = aLife.z * scale;
+    gl_Position = projection * view * vec4(centre + aCorner * radius, depth, 1.0);
+
+    particleColor = mix(minColor, maxColor, aLife.w);
+    if (fadeOut)
+        particleColor.a *= clamp(aLife.x / aLife.y, 0.0, 1.0);
+}
@@ -1,8 +1,12 @@
 #version 330 core
 // vertex position
 layout (location = 0) in vec3 aPos;
+// texture coordinate
+layout (location = 1) in vec2 aTexCoord;
 
-uniform mat4 modelTransform; // transformation to apply to each vertex
+out vec2 texCoord;
+
+uniform mat4 modelTransform; // covers the layer's cached area
 uniform mat4 view; 
 uniform mat4 projection; 
 
@@ -11,4 +15,5 @@ void main()
 {
     // note that you read the multiplication from right to left
     gl_Position = projection * view * modelTransform * vec4(aPos, 1.0);
+    texCoord = aTexCoord;
 }
\ No newline at end of file
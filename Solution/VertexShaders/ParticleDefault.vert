@@ -0,0 +1,23 @@
+#version 330 core
+// corner of the particle's quad from -1 to 1
+layout (location = 0) in vec2 aCorner;
+
+// -- per instance values, every particle has its own --
+// xy: centre, z: depth, w: radius. Already in the same coords the model matrix would output
+layout (location = 1) in vec4 aPositionSize;
+// colour of the particle with alpha
+layout (location = 2) in vec4 aColor;
+
+out vec2 corner;
+out vec4 particleColor;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+void main()
+{
+    gl_Position = projection * view * vec4(aPositionSize.xy + aCorner * aPositionSize.w, aPositionSize.z, 1.0);
+
+    corner = aCorner;
+    particleColor = aColor;
+}
@@ -0,0 +1,91 @@
+#version 330 core
+// Steps one particle forward. Nothing is drawn, the outputs are written into the other particle buffer with transform feedback
+
+// -- the particle's state from last update --
+// xy: position, zw: velocity. Global coords relative to the entity
+layout (location = 0) in vec4 aPositionVelocity;
+// x: seconds left to live (dead if 0 or less), y: lifetime, z: diameter, w: where its colour is between the min and max colour
+layout (location = 1) in vec4 aLife;
+
+// -- the particle's new state, same layout as the inputs --
+out vec4 positionVelocity;
+out vec4 life;
+
+uniform float deltaTime;
+// what velocity is multiplied by this update (e^-drag*deltaTime)
+uniform float dragFactor;
+// added to velocity this update (gravity*deltaTime)
+uniform vec2 gravityStep;
+
+// -- emission, particles emitCount slots on from emitStart (wrapping around) are respawned --
+uniform int capacity;
+uniform int emitStart;
+uniform int emitCount;
+// different every update so particles get new random values
+uniform int seed;
+
+// -- emitter --
+uniform vec2 emitPosition;
+uniform vec2 emitArea;
+// radians
+uniform float direction;
+uniform float spread;
+uniform vec2 speedRange;
+uniform vec2 lifetimeRange;
+uniform vec2 sizeRange;
+
+// integer hash, turns any number into a random looking one
+uint Hash(uint x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// random number from 0 to 1, state is moved on so the next call gives a different one
+float Random(inout uint state)
+{
+    state = Hash(state);
+    // top 24 bits into a float
+    return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+float RandomRange(inout uint state, vec2 range)
+{
+    return mix(range.x, range.y, Random(state));
+}
+
+void main()
+{
+    // how far this slot is after the first one being emitted into
+    int emitIndex = (gl_VertexID + capacity - emitStart) % capacity;
+
+    if (emitIndex < emitCount)
+    {
+        // -- spawn a new particle here --
+        uint state = Hash(uint(gl_VertexID) ^ Hash(uint(seed)));
+        vec2 position = emitPosition + vec2(Random(state) * 2.0 - 1.0, Random(state) * 2.0 - 1.0) * emitArea;
+        float angle = direction + (Random(state) * 2.0 - 1.0) * spread;
+        float speed = RandomRange(state, speedRange);
+        float lifetime = max(RandomRange(state, lifetimeRange), 0.0001);
+
+        positionVelocity = vec4(position, vec2(cos(angle), sin(angle)) * speed);
+        life = vec4(lifetime, lifetime, RandomRange(state, sizeRange), Random(state));
+    }
+    else if (aLife.x > 0.0)
+    {
+        // -- move it, same as ParticleSystem's update --
+        vec2 velocity = aPositionVelocity.zw * dragFactor + gravityStep;
+        positionVelocity = vec4(aPositionVelocity.xy + velocity * deltaTime, velocity);
+        life = vec4(aLife.x - deltaTime, aLife.yzw);
+    }
+    else
+    {
+        // dead, leave it
+        positionVelocity = aPositionVelocity;
+        life = aLife;
+    }
+}
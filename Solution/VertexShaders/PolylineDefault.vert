@@ -0,0 +1,23 @@
+#version 330 core
+// vertex position, already in the polyline's local coords (the joins and caps are worked out on the cpu)
+layout (location = 0) in vec2 aPos;
+
+// -- per instance values, every polyline in a batch has its own --
+// transformation to apply to each vertex. A mat4 takes up locations 1 to 4
+layout (location = 1) in mat4 aModelTransform;
+// colour with alpha
+layout (location = 5) in vec4 aColor;
+
+// flat because it's the same for the whole polyline
+flat out vec4 lineColor;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+
+void main()
+{
+    // note that you read the multiplication from right to left
+    gl_Position = projection * view * aModelTransform * vec4(aPos, 0.0, 1.0);
+    lineColor = aColor;
+}
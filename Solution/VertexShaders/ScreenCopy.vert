@@ -0,0 +1,13 @@
+#version 330 core
+// No vertex buffer, a triangle big enough to cover the whole screen is made from the vertex id
+// id 0 -> (-1,-1), 1 -> (3,-1), 2 -> (-1,3)
+
+out vec2 texCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID == 1) ? 3.0 : -1.0, (gl_VertexID == 2) ? 3.0 : -1.0);
+    // -1 to 1 becomes 0 to 1
+    texCoord = position * 0.5 + 0.5;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
\ No newline at end of file
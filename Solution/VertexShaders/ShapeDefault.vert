@@ -0,0 +1,75 @@
+#version 330 core
+// vertex position
+layout (location = 0) in vec3 aPos;
+
+// -- per instance values, every shape in a batch has its own --
+// transformation to apply to each vertex. A mat4 takes up locations 1 to 4
+layout (location = 1) in mat4 aModelTransform;
+// colour inside the border with alpha
+layout (location = 5) in vec4 aFillColor;
+// colour of the border with alpha
+layout (location = 6) in vec4 aStrokeColor;
+// x: shape type, y: corner radius (rounded rect) or round caps (line), z: border width
+layout (location = 7) in vec4 aShapeParams;
+// half the width and height of the shape (global units)
+layout (location = 8) in vec2 aHalfSize;
+// lines only: both points of the line (global units), xy is point 1 and zw is point 2
+layout (location = 9) in vec4 aLinePoints;
+
+// flat because they are the same for every pixel of the shape, no point interpolating them
+flat out vec4 fillColor;
+flat out vec4 strokeColor;
+flat out int shapeType;
+flat out float shapeParam;
+flat out float borderWidth;
+flat out vec2 halfSize;
+// where the pixel is on the shape, from -halfSize to halfSize. Gets interpolated so each pixel knows where it is
+out vec2 shapePos;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+
+/*
+    Lines are just the quad stretched between their two points, which used to be worked out on the cpu whenever a point moved.
+    Now the points and thickness are sent with the instance and it happens here, so moving a point is only a change to the instance data.
+    It's the same maths as LineRenderer::CalculateLineCorners (look there for the full explanation):
+        - the quad's x axis goes along the line (point 1 to point 2) and its y axis goes along the left side vector (-y, x)
+        - it's scaled to half the length by the thickness, with round caps sticking out by the thickness on each end
+        - the - 1 and * 2 turn global coords into local coords
+*/
+vec3 LinePosition(vec2 point1, vec2 point2, float thickness, bool roundCaps, out vec2 lineHalfSize)
+{
+    vec2 difference = point2 - point1;
+    float lineLength = length(difference);
+    // both points are in the same spot, just point it along the x axis so normalising doesn't divide by 0
+    vec2 direction = (lineLength > 0.0) ? difference / lineLength : vec2(1.0, 0.0);
+    vec2 leftVector = vec2(-direction.y, direction.x);
+
+    lineHalfSize = vec2(lineLength / 2.0 + (roundCaps ? thickness : 0.0), thickness);
+
+    vec2 middle = ((point1 + point2) / 2.0 - 1.0) * 2.0;
+    return vec3(middle + direction * aPos.x * lineHalfSize.x * 2.0 + leftVector * aPos.y * lineHalfSize.y * 2.0, 0.0);
+}
+
+void main()
+{
+    // it's sent as a float, round it in case it isn't exactly a whole number
+    shapeType = int(aShapeParams.x + 0.5);
+
+    vec3 localPosition = aPos;
+    halfSize = aHalfSize;
+    if (shapeType == 3)
+        localPosition = LinePosition(aLinePoints.xy, aLinePoints.zw, aShapeParams.w, aShapeParams.y > 0.5, halfSize);
+
+    // note that you read the multiplication from right to left
+    gl_Position = projection * view * aModelTransform * vec4(localPosition, 1.0);
+
+    // pass everything the fragment shader needs along
+    fillColor = aFillColor;
+    strokeColor = aStrokeColor;
+    shapeParam = aShapeParams.y;
+    borderWidth = aShapeParams.z;
+    // the quad goes from -1 to 1 so this scales it to the shape's actual size
+    shapePos = aPos.xy * halfSize;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#version 330 core
+// vertex position
+layout (location = 0) in vec3 aPos;
+// texture coordinate
+layout (location = 1) in vec2 aTexCoord;
+// which way the borders move the vertex in (nine-slice grid only, 0 for the plain rect)
+layout (location = 9) in vec2 aSliceOffset;
+
+// -- per instance values, every sprite in a batch has its own --
+// transformation to apply to each vertex. A mat4 takes up locations 2 to 5
+layout (location = 2) in mat4 aModelTransform;
+// colour of the sprite with alpha
+layout (location = 6) in vec4 aColor;
+// part of the layer to draw (see SpriteRenderer::sourceRect), xy is the bottom left corner and zw is the size
+layout (location = 7) in vec4 aUVRect;
+// which layer of the texture array to draw
+layout (location = 8) in float aLayer;
+// nine-slice borders in global units (left, right, bottom, top), all 0 if the sprite isn't sliced
+layout (location = 10) in vec4 aSliceBorders;
+// nine-slice borders in uvs of the drawn part of the texture
+layout (location = 11) in vec4 aSliceUVs;
+
+out vec2 texCoord;
+out vec4 spriteColor;
+// flat because the whole sprite uses one layer
+flat out float layer;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+
+/*
+    Nine-slice sprites are drawn with the 4x4 grid part of the sprite mesh. The inner columns/rows of the grid start on the edges and get moved in
+    by the borders here, so the corners stay the same size however big the sprite is. The size is read from the model transform's scale
+    (the length of its x and y columns), the quad is 2 local units across the whole size so a border of b global units is 2b / size local units.
+    Borders that add up to more than the sprite are shrunk so they meet in the middle instead of crossing over
+*/
+void NineSlice(inout vec3 position, inout vec2 sliceTexCoord)
+{
+    vec2 size = max(vec2(length(aModelTransform[0].xyz), length(aModelTransform[1].xyz)), vec2(0.0001));
+    vec4 localBorders = aSliceBorders * 2.0 / size.xxyy;
+    localBorders.xy *= min(1.0, 2.0 / max(localBorders.x + localBorders.y, 0.0001));
+    localBorders.zw *= min(1.0, 2.0 / max(localBorders.z + localBorders.w, 0.0001));
+
+    // a positive offset is moved in by the left/bottom border and a negative one by the right/top border
+    position.x += aSliceOffset.x * ((aSliceOffset.x > 0.0) ? localBorders.x : localBorders.y);
+    position.y += aSliceOffset.y * ((aSliceOffset.y > 0.0) ? localBorders.z : localBorders.w);
+    sliceTexCoord.x += aSliceOffset.x * ((aSliceOffset.x > 0.0) ? aSliceUVs.x : aSliceUVs.y);
+    sliceTexCoord.y += aSliceOffset.y * ((aSliceOffset.y > 0.0) ? aSliceUVs.z : aSliceUVs.w);
+}
+
+void main()
+{
+    vec3 position = aPos;
+    vec2 sliceTexCoord = aTexCoord;
+    if (aSliceOffset != vec2(0.0))
+        NineSlice(position, sliceTexCoord);
+
+    // note that you read the multiplication from right to left
+    gl_Position = projection * view * aModelTransform * vec4(position, 1.0);
+
+    // squash the 0 to 1 coords down into the part of the layer being drawn
+    texCoord = aUVRect.xy + sliceTexCoord * aUVRect.zw;
+    spriteColor = aColor;
+    layer = aLayer;
+}
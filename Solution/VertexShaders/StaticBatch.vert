@@ -0,0 +1,26 @@
+#version 330 core
+// vertex position, already put through the entity's transform when it was baked
+layout (location = 0) in vec3 aPos;
+// colour of the quad with alpha
+layout (location = 1) in vec4 aColor;
+// xy: texture coordinate, z: layer of the texture array
+layout (location = 2) in vec3 aTexCoord;
+
+// same outputs as SpriteDefault.vert/SpriteArray.vert so the sprite fragment shaders can be used
+out vec2 texCoord;
+out vec4 spriteColor;
+flat out float layer;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+
+void main()
+{
+    // no model transform, the cpu did that once when it was baked
+    gl_Position = projection * view * vec4(aPos, 1.0);
+
+    texCoord = aTexCoord.xy;
+    spriteColor = aColor;
+    layer = aTexCoord.z;
+}
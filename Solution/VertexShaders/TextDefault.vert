@@ -0,0 +1,28 @@
+#version 330 core
+// corner of the glyph's quad from 0 to 1
+layout (location = 0) in vec2 aCorner;
+
+// -- per instance values, every glyph in a batch has its own --
+// bottom left corner of the glyph, already thru the entity's transform
+layout (location = 1) in vec4 aOrigin;
+// xy is the quad's bottom edge and zw its left edge, also already transformed
+layout (location = 2) in vec4 aAxes;
+// part of the font atlas the glyph is in, xy is the bottom left corner and zw is the size
+layout (location = 3) in vec4 aUVRect;
+// colour of the text with alpha
+layout (location = 4) in vec4 aColor;
+
+out vec2 texCoord;
+out vec4 textColor;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+void main()
+{
+    vec2 position = aOrigin.xy + aCorner.x * aAxes.xy + aCorner.y * aAxes.zw;
+    gl_Position = projection * view * vec4(position, aOrigin.z, 1.0);
+
+    texCoord = aUVRect.xy + aCorner * aUVRect.zw;
+    textColor = aColor;
+}
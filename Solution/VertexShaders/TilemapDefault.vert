@@ -0,0 +1,33 @@
+#version 330 core
+// corner's position in the chunk, in tiles
+layout (location = 0) in vec2 aPos;
+// texture coordinate
+layout (location = 1) in vec2 aTexCoord;
+// which layer of the tileset the tile is
+layout (location = 2) in float aLayer;
+
+// -- per instance values, every chunk has its own --
+// bottom left corner of the chunk after the entity's transform, w is unused
+layout (location = 3) in vec4 aOrigin;
+// xy is one tile's bottom edge and zw its left edge, after the entity's transform
+layout (location = 4) in vec4 aAxes;
+// colour with alpha
+layout (location = 5) in vec4 aColor;
+
+out vec2 texCoord;
+out vec4 spriteColor;
+// flat because the whole tile uses one layer
+flat out float layer;
+
+uniform mat4 view; 
+uniform mat4 projection; 
+
+void main()
+{
+    vec2 position = aOrigin.xy + aPos.x * aAxes.xy + aPos.y * aAxes.zw;
+    gl_Position = projection * view * vec4(position, aOrigin.z, 1.0);
+
+    texCoord = aTexCoord;
+    spriteColor = aColor;
+    layer = aLayer;
+}
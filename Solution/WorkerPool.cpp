@@ -0,0 +1,64 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		// hardware_concurrency can be 0 if it doesn't know
+		unsigned int cores = std::thread::hardware_concurrency();
+		threadCount = (cores > 1) ? cores - 1 : 1;
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+		_threads.push_back(std::thread(&WorkerPool::WorkerLoop, this));
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_wakeUp.notify_all();
+
+	// wait for every thread to finish what is left
+	for (std::thread& thread : _threads)
+		thread.join();
+}
+
+void WorkerPool::Submit(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_jobs.push_back(job);
+	}
+	_wakeUp.notify_one();
+}
+
+size_t WorkerPool::GetThreadCount()
+{
+	return _threads.size();
+}
+
+void WorkerPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			// sleep until there's something to do
+			_wakeUp.wait(lock, [this] { return _isStopping || !_jobs.empty(); });
+
+			// only stop once the queue is empty
+			if (_jobs.empty())
+				return;
+
+			job = _jobs.front();
+			_jobs.pop_front();
+		}
+
+		// run it without holding the lock so other threads can take jobs
+		job();
+	}
+}
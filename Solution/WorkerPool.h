@@ -0,0 +1,42 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// A few threads that run jobs in the background, in the order they were given. Used for work that doesn't need GL (decoding images etc.)
+// so it doesn't hold up the render thread. Results that need GL have to be handed back to the render thread by the job itself
+class WorkerPool
+{
+public:
+	// starts threadCount threads. 0 means one less than the amount of cores (at least 1) so the render thread keeps a core to itself
+	WorkerPool(unsigned int threadCount = 0);
+	// finishes any jobs that are already queued then stops the threads
+	~WorkerPool();
+
+	// a pool owns threads so it can't be copied
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// queues a job to run on one of the threads
+	void Submit(std::function<void()> job);
+
+	// how many threads there are
+	size_t GetThreadCount();
+
+private:
+	std::vector<std::thread> _threads;
+	// jobs waiting for a thread
+	std::deque<std::function<void()>> _jobs;
+	// guards _jobs and _isStopping
+	std::mutex _mutex;
+	// wakes threads up when there is a job or the pool is stopping
+	std::condition_variable _wakeUp;
+	bool _isStopping = false;
+
+	// what each thread runs, takes jobs until the pool stops
+	void WorkerLoop();
+};
+
@@ -0,0 +1,146 @@
+// Batch converts images (png, jpg, anything stb_image reads) into QOI files that ResourceManager::LoadTexture decodes with QOIImage,
+// and benchmarks decoding the originals with stb_image against decoding the QOI versions.
+//
+// It's its own program, not part of the renderer. Build it from the repo folder with
+//   cl /std:c++17 /O2 /EHsc /I libraries/include /I Solution Tools/QOIConverter.cpp Solution/QOIImage.cpp
+// or
+//   g++ -std=c++17 -O2 -I libraries/include -I Solution Tools/QOIConverter.cpp Solution/QOIImage.cpp -o QOIConverter
+//
+// Usage: QOIConverter [--benchmark] [--iterations N] file or folder...
+// Folders are searched (not recursively) for png/jpg/jpeg/bmp/tga files. Each image is saved next to itself as .qoi.
+// With --benchmark each image is decoded N times (5 by default) from memory both ways, so disk speed doesn't count,
+// and the throughput of each is printed in megapixels a second.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include "QOIImage.h"
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <filesystem>
+
+static std::vector<unsigned char> ReadFile(const std::filesystem::path& path)
+{
+	std::ifstream fileStream(path, std::ios::binary);
+	return std::vector<unsigned char>((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+}
+
+static bool IsImage(const std::filesystem::path& path)
+{
+	std::string extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga";
+}
+
+int main(int argc, char** argv)
+{
+	bool benchmark = false;
+	int iterations = 5;
+	std::vector<std::filesystem::path> inputs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--benchmark")
+			benchmark = true;
+		else if (argument == "--iterations" && i + 1 < argc)
+			iterations = std::max(1, std::atoi(argv[++i]));
+		else if (std::filesystem::is_directory(argument))
+		{
+			// sorted so runs are comparable
+			std::vector<std::filesystem::path> files;
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(argument))
+				if (entry.is_regular_file() && IsImage(entry.path()))
+					files.push_back(entry.path());
+			std::sort(files.begin(), files.end());
+			inputs.insert(inputs.end(), files.begin(), files.end());
+		}
+		else
+			inputs.push_back(argument);
+	}
+
+	if (inputs.empty())
+	{
+		std::cout << "Usage: QOIConverter [--benchmark] [--iterations N] file or folder..." << std::endl;
+		return 1;
+	}
+
+	int failed = 0;
+	// totals for the benchmark
+	double totalPixels = 0.0;
+	double stbSeconds = 0.0;
+	double qoiSeconds = 0.0;
+	size_t totalSourceBytes = 0;
+	size_t totalQOIBytes = 0;
+
+	for (const std::filesystem::path& input : inputs)
+	{
+		std::vector<unsigned char> source = ReadFile(input);
+		int width, height, channels;
+		// top row first, which is what QOI stores. Keep 3 channels if there's no alpha, QOI only does 3 or 4
+		stbi_info_from_memory(source.data(), (int)source.size(), &width, &height, &channels);
+		int qoiChannels = (channels == 2 || channels == 4) ? 4 : 3;
+		unsigned char* pixels = stbi_load_from_memory(source.data(), (int)source.size(), &width, &height, &channels, qoiChannels);
+		if (!pixels)
+		{
+			std::cout << "Couldn't load " << input.string() << std::endl;
+			failed++;
+			continue;
+		}
+
+		std::vector<unsigned char> qoi = QOIImage::Encode(pixels, width, height, qoiChannels);
+		stbi_image_free(pixels);
+
+		std::filesystem::path output = std::filesystem::path(input).replace_extension(".qoi");
+		std::ofstream outputStream(output, std::ios::binary);
+		outputStream.write((const char*)qoi.data(), qoi.size());
+		if (!outputStream)
+		{
+			std::cout << "Couldn't write " << output.string() << std::endl;
+			failed++;
+			continue;
+		}
+		std::cout << input.string() << " -> " << output.string() << " (" << source.size() << " -> " << qoi.size() << " bytes)" << std::endl;
+
+		if (!benchmark)
+			continue;
+
+		// -- decode both from memory a few times, with flipping on like the resource manager does --
+		stbi_set_flip_vertically_on_load(true);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			stbi_image_free(stbi_load_from_memory(source.data(), (int)source.size(), &width, &height, &channels, qoiChannels));
+		auto middle = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			free(QOIImage::Decode(qoi.data(), qoi.size(), width, height, channels, qoiChannels, true));
+		auto end = std::chrono::steady_clock::now();
+		// the next image gets encoded top row first again
+		stbi_set_flip_vertically_on_load(false);
+
+		double stbTime = std::chrono::duration<double>(middle - start).count();
+		double qoiTime = std::chrono::duration<double>(end - middle).count();
+		double megapixels = (double)width * height * iterations / 1000000.0;
+		std::cout << "   stb_image " << megapixels / stbTime << " MP/s, QOI " << megapixels / qoiTime << " MP/s (" << stbTime / qoiTime << "x)" << std::endl;
+
+		totalPixels += megapixels;
+		stbSeconds += stbTime;
+		qoiSeconds += qoiTime;
+		totalSourceBytes += source.size();
+		totalQOIBytes += qoi.size();
+	}
+
+	if (benchmark && totalPixels > 0.0)
+	{
+		std::cout << "Total: stb_image " << totalPixels / stbSeconds << " MP/s, QOI " << totalPixels / qoiSeconds << " MP/s ("
+			<< stbSeconds / qoiSeconds << "x faster). Files " << totalSourceBytes << " -> " << totalQOIBytes << " bytes" << std::endl;
+	}
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,494 @@
+// Converts images (png, jpg, anything stb_image reads) into block compressed KTX2 or DDS files that ResourceManager::LoadTexture loads
+// straight onto the gpu with CompressedTexture. Mipmaps are made with a box filter and stored in the file too.
+// Encodes BC1 (rgb), BC3 (rgba), BC4 (one channel) and BC5 (two channels). The loader can also read BC2, BC7 and ETC2 files made by other tools.
+// The blocks are encoded with a simple "range fit" (end points from the main axis of the block's colours) so it's fast but not the best quality.
+//
+// It's its own program, not part of the renderer. Build it from the repo folder with
+//   cl /std:c++17 /O2 /EHsc /I libraries/include Tools/TextureConverter.cpp
+// or
+//   g++ -std=c++17 -O2 -I libraries/include Tools/TextureConverter.cpp -o TextureConverter
+//
+// Usage: TextureConverter [--format bc1|bc3|bc4|bc5] [--container ktx2|dds] [--no-mips] image...
+// Each image is saved next to itself with the container's extension. Without --format images with any see through pixels use BC3, otherwise BC1
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <climits>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+
+enum class Format { BC1, BC3, BC4, BC5 };
+
+// one mipmap level, rgba
+struct Image {
+	int width = 0;
+	int height = 0;
+	std::vector<unsigned char> pixels;
+};
+
+static int GetBlockSize(Format format)
+{
+	return (format == Format::BC1 || format == Format::BC4) ? 8 : 16;
+}
+
+// -- mipmaps --
+
+// halves the image by averaging 2x2 pixels. Odd sizes just reuse the last row/column
+static Image Downsample(const Image& image)
+{
+	Image half;
+	half.width = std::max(1, image.width / 2);
+	half.height = std::max(1, image.height / 2);
+	half.pixels.resize((size_t)half.width * half.height * 4);
+
+	for (int y = 0; y < half.height; y++)
+	{
+		for (int x = 0; x < half.width; x++)
+		{
+			for (int channel = 0; channel < 4; channel++)
+			{
+				int total = 0;
+				for (int offsetY = 0; offsetY < 2; offsetY++)
+					for (int offsetX = 0; offsetX < 2; offsetX++)
+					{
+						int sourceX = std::min(x * 2 + offsetX, image.width - 1);
+						int sourceY = std::min(y * 2 + offsetY, image.height - 1);
+						total += image.pixels[((size_t)sourceY * image.width + sourceX) * 4 + channel];
+					}
+				half.pixels[((size_t)y * half.width + x) * 4 + channel] = (unsigned char)((total + 2) / 4);
+			}
+		}
+	}
+	return half;
+}
+
+// -- block encoders --
+
+static unsigned short ToRGB565(const float* colour)
+{
+	int red = (int)std::lround(std::min(std::max(colour[0], 0.0f), 255.0f) * 31.0f / 255.0f);
+	int green = (int)std::lround(std::min(std::max(colour[1], 0.0f), 255.0f) * 63.0f / 255.0f);
+	int blue = (int)std::lround(std::min(std::max(colour[2], 0.0f), 255.0f) * 31.0f / 255.0f);
+	return (unsigned short)((red << 11) | (green << 5) | blue);
+}
+
+static void FromRGB565(unsigned short colour, int* rgb)
+{
+	int red = (colour >> 11) & 31, green = (colour >> 5) & 63, blue = colour & 31;
+	rgb[0] = (red << 3) | (red >> 2);
+	rgb[1] = (green << 2) | (green >> 4);
+	rgb[2] = (blue << 3) | (blue >> 2);
+}
+
+// BC1 colour block (always the 4 colour version) from 16 rgba pixels
+static void EncodeBC1Colour(const unsigned char* pixels, unsigned char* block)
+{
+	// -- find the direction the colours are spread along the most (main axis of their covariance) --
+	float mean[3] = {};
+	for (int i = 0; i < 16; i++)
+		for (int channel = 0; channel < 3; channel++)
+			mean[channel] += pixels[i * 4 + channel] / 16.0f;
+
+	float covariance[6] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		float r = pixels[i * 4] - mean[0], g = pixels[i * 4 + 1] - mean[1], b = pixels[i * 4 + 2] - mean[2];
+		covariance[0] += r * r; covariance[1] += r * g; covariance[2] += r * b;
+		covariance[3] += g * g; covariance[4] += g * b; covariance[5] += b * b;
+	}
+
+	// power iteration, a few steps is plenty for 3x3
+	float axis[3] = { 1.0f, 1.0f, 1.0f };
+	for (int step = 0; step < 8; step++)
+	{
+		float next[3] = {
+			covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+			covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+			covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2] };
+		float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+		// every pixel is the same colour
+		if (length < 1e-6f)
+			break;
+		for (int channel = 0; channel < 3; channel++)
+			axis[channel] = next[channel] / length;
+	}
+
+	// -- end points are the furthest colours along the axis --
+	float minProjection = 1e9f, maxProjection = -1e9f;
+	for (int i = 0; i < 16; i++)
+	{
+		float projection = 0.0f;
+		for (int channel = 0; channel < 3; channel++)
+			projection += (pixels[i * 4 + channel] - mean[channel]) * axis[channel];
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+	float maxColour[3], minColour[3];
+	for (int channel = 0; channel < 3; channel++)
+	{
+		maxColour[channel] = mean[channel] + axis[channel] * maxProjection;
+		minColour[channel] = mean[channel] + axis[channel] * minProjection;
+	}
+
+	unsigned short colour0 = ToRGB565(maxColour);
+	unsigned short colour1 = ToRGB565(minColour);
+	// the first colour has to be bigger for the 4 colour version, if they're the same every index is 0 anyway
+	if (colour0 < colour1)
+		std::swap(colour0, colour1);
+
+	int palette[4][3];
+	FromRGB565(colour0, palette[0]);
+	FromRGB565(colour1, palette[1]);
+	for (int channel = 0; channel < 3; channel++)
+	{
+		palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+		palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+	}
+
+	// -- closest palette colour for each pixel --
+	unsigned int indices = 0;
+	for (int i = 0; i < 16 && colour0 != colour1; i++)
+	{
+		int bestIndex = 0, bestDistance = INT_MAX;
+		for (int index = 0; index < 4; index++)
+		{
+			int distance = 0;
+			for (int channel = 0; channel < 3; channel++)
+			{
+				int difference = pixels[i * 4 + channel] - palette[index][channel];
+				distance += difference * difference;
+			}
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				bestIndex = index;
+			}
+		}
+		indices |= (unsigned int)bestIndex << (i * 2);
+	}
+
+	block[0] = colour0 & 0xFF; block[1] = colour0 >> 8;
+	block[2] = colour1 & 0xFF; block[3] = colour1 >> 8;
+	for (int i = 0; i < 4; i++)
+		block[4 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+// BC4 block (also BC3's alpha) from one channel of 16 pixels, every stride bytes
+static void EncodeBC4Channel(const unsigned char* pixels, int stride, unsigned char* block)
+{
+	int minValue = 255, maxValue = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		minValue = std::min(minValue, (int)pixels[i * stride]);
+		maxValue = std::max(maxValue, (int)pixels[i * stride]);
+	}
+
+	// first value bigger means 8 values spread evenly between them
+	int palette[8] = { maxValue, minValue };
+	for (int i = 1; i <= 6; i++)
+		palette[i + 1] = ((7 - i) * maxValue + i * minValue) / 7;
+
+	unsigned long long indices = 0;
+	for (int i = 0; i < 16 && maxValue != minValue; i++)
+	{
+		int bestIndex = 0, bestDistance = INT_MAX;
+		for (int index = 0; index < 8; index++)
+		{
+			int distance = std::abs(pixels[i * stride] - palette[index]);
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				bestIndex = index;
+			}
+		}
+		indices |= (unsigned long long)bestIndex << (i * 3);
+	}
+
+	block[0] = (unsigned char)maxValue;
+	block[1] = (unsigned char)minValue;
+	for (int i = 0; i < 6; i++)
+		block[2 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+// compresses a whole level
+static std::vector<unsigned char> Encode(const Image& image, Format format)
+{
+	int blocksWide = (image.width + 3) / 4;
+	int blocksHigh = (image.height + 3) / 4;
+	int blockSize = GetBlockSize(format);
+	std::vector<unsigned char> data((size_t)blocksWide * blocksHigh * blockSize);
+
+	unsigned char blockPixels[16 * 4];
+	for (int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			// blocks hanging off the edge repeat the edge pixels
+			for (int y = 0; y < 4; y++)
+				for (int x = 0; x < 4; x++)
+				{
+					int sourceX = std::min(blockX * 4 + x, image.width - 1);
+					int sourceY = std::min(blockY * 4 + y, image.height - 1);
+					memcpy(&blockPixels[(y * 4 + x) * 4], &image.pixels[((size_t)sourceY * image.width + sourceX) * 4], 4);
+				}
+
+			unsigned char* block = &data[((size_t)blockY * blocksWide + blockX) * blockSize];
+			switch (format)
+			{
+			case Format::BC1:
+				EncodeBC1Colour(blockPixels, block);
+				break;
+			case Format::BC3:
+				EncodeBC4Channel(blockPixels + 3, 4, block);
+				EncodeBC1Colour(blockPixels, block + 8);
+				break;
+			case Format::BC4:
+				EncodeBC4Channel(blockPixels, 4, block);
+				break;
+			case Format::BC5:
+				EncodeBC4Channel(blockPixels, 4, block);
+				EncodeBC4Channel(blockPixels + 1, 4, block + 8);
+				break;
+			}
+		}
+	}
+	return data;
+}
+
+// -- file writers --
+
+static void WriteUInt32(std::vector<unsigned char>& file, unsigned int value)
+{
+	for (int i = 0; i < 4; i++)
+		file.push_back((value >> (i * 8)) & 0xFF);
+}
+
+static void SetUInt32(std::vector<unsigned char>& file, size_t offset, unsigned int value)
+{
+	for (int i = 0; i < 4; i++)
+		file[offset + i] = (value >> (i * 8)) & 0xFF;
+}
+
+static void SetUInt64(std::vector<unsigned char>& file, size_t offset, unsigned long long value)
+{
+	SetUInt32(file, offset, (unsigned int)value);
+	SetUInt32(file, offset + 4, (unsigned int)(value >> 32));
+}
+
+static std::vector<unsigned char> WriteDDS(const std::vector<std::vector<unsigned char>>& levels, int width, int height, Format format)
+{
+	std::vector<unsigned char> file;
+	file.insert(file.end(), { 'D', 'D', 'S', ' ' });
+
+	// header
+	WriteUInt32(file, 124);
+	// caps, height, width, pixel format, linear size and mipmap count are filled in
+	WriteUInt32(file, 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000 | 0x20000);
+	WriteUInt32(file, height);
+	WriteUInt32(file, width);
+	// size of the first level
+	WriteUInt32(file, (unsigned int)levels[0].size());
+	WriteUInt32(file, 0);
+	WriteUInt32(file, (unsigned int)levels.size());
+	for (int i = 0; i < 11; i++)
+		WriteUInt32(file, 0);
+
+	// pixel format, just a four character code
+	const char* fourCC = format == Format::BC1 ? "DXT1" : format == Format::BC3 ? "DXT5" : format == Format::BC4 ? "ATI1" : "ATI2";
+	WriteUInt32(file, 32);
+	WriteUInt32(file, 0x4);
+	file.insert(file.end(), fourCC, fourCC + 4);
+	for (int i = 0; i < 5; i++)
+		WriteUInt32(file, 0);
+
+	// texture, has mipmaps, complex (because of the mipmaps)
+	WriteUInt32(file, 0x1000 | (levels.size() > 1 ? 0x400000 | 0x8 : 0));
+	for (int i = 0; i < 4; i++)
+		WriteUInt32(file, 0);
+
+	// biggest level first
+	for (const std::vector<unsigned char>& level : levels)
+		file.insert(file.end(), level.begin(), level.end());
+	return file;
+}
+
+static std::vector<unsigned char> WriteKTX2(const std::vector<std::vector<unsigned char>>& levels, int width, int height, Format format)
+{
+	static const unsigned char identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+	int blockSize = GetBlockSize(format);
+
+	// vulkan format, data format descriptor colour model and the channels of each sample (BC3's alpha comes first)
+	unsigned int vkFormat = 0, colourModel = 0;
+	std::vector<unsigned int> sampleChannels;
+	switch (format)
+	{
+	case Format::BC1: vkFormat = 131; colourModel = 128; sampleChannels = { 0 }; break;
+	case Format::BC3: vkFormat = 137; colourModel = 130; sampleChannels = { 15, 0 }; break;
+	case Format::BC4: vkFormat = 139; colourModel = 131; sampleChannels = { 0 }; break;
+	case Format::BC5: vkFormat = 141; colourModel = 132; sampleChannels = { 0, 1 }; break;
+	}
+
+	std::vector<unsigned char> file(identifier, identifier + 12);
+	WriteUInt32(file, vkFormat);
+	// type size is 1 for block compressed formats
+	WriteUInt32(file, 1);
+	WriteUInt32(file, width);
+	WriteUInt32(file, height);
+	// depth, layers, faces, levels, no supercompression
+	WriteUInt32(file, 0);
+	WriteUInt32(file, 0);
+	WriteUInt32(file, 1);
+	WriteUInt32(file, (unsigned int)levels.size());
+	WriteUInt32(file, 0);
+
+	// index of where everything is, filled in once it's known
+	size_t indexOffset = file.size();
+	file.resize(file.size() + 4 * 4 + 2 * 8);
+	size_t levelIndexOffset = file.size();
+	file.resize(file.size() + levels.size() * 24);
+
+	// -- data format descriptor, describes the format for tools that don't know vulkan formats --
+	size_t dfdOffset = file.size();
+	unsigned int descriptorBlockSize = 24 + 16 * (unsigned int)sampleChannels.size();
+	WriteUInt32(file, 4 + descriptorBlockSize);
+	// Khronos basic descriptor block, version 2
+	WriteUInt32(file, 0);
+	WriteUInt32(file, 2 | (descriptorBlockSize << 16));
+	// colour model, BT709 primaries, linear transfer (the renderer doesn't do sRGB), straight alpha
+	WriteUInt32(file, colourModel | (1 << 8) | (1 << 16));
+	// 4x4 blocks
+	WriteUInt32(file, 3 | (3 << 8));
+	WriteUInt32(file, blockSize);
+	WriteUInt32(file, 0);
+	for (size_t i = 0; i < sampleChannels.size(); i++)
+	{
+		// 64 bits each
+		WriteUInt32(file, (unsigned int)(i * 64) | (63 << 16) | (sampleChannels[i] << 24));
+		WriteUInt32(file, 0);
+		WriteUInt32(file, 0);
+		WriteUInt32(file, 0xFFFFFFFF);
+	}
+	unsigned int dfdLength = (unsigned int)(file.size() - dfdOffset);
+
+	SetUInt32(file, indexOffset, (unsigned int)dfdOffset);
+	SetUInt32(file, indexOffset + 4, dfdLength);
+
+	// -- levels go smallest first, each lined up to the block size --
+	std::vector<size_t> levelOffsets(levels.size());
+	for (size_t i = levels.size(); i-- > 0;)
+	{
+		while (file.size() % blockSize != 0)
+			file.push_back(0);
+		levelOffsets[i] = file.size();
+		file.insert(file.end(), levels[i].begin(), levels[i].end());
+	}
+
+	// but the index is level 0 first
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		SetUInt64(file, levelIndexOffset + i * 24, levelOffsets[i]);
+		SetUInt64(file, levelIndexOffset + i * 24 + 8, levels[i].size());
+		SetUInt64(file, levelIndexOffset + i * 24 + 16, levels[i].size());
+	}
+	return file;
+}
+
+int main(int argc, char** argv)
+{
+	bool hasFormat = false;
+	Format format = Format::BC1;
+	bool useKTX2 = true;
+	bool makeMips = true;
+	std::vector<std::string> inputs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--format" && i + 1 < argc)
+		{
+			std::string name = argv[++i];
+			hasFormat = true;
+			if (name == "bc1") format = Format::BC1;
+			else if (name == "bc3") format = Format::BC3;
+			else if (name == "bc4") format = Format::BC4;
+			else if (name == "bc5") format = Format::BC5;
+			else
+			{
+				std::cout << "Unknown format " << name << std::endl;
+				return 1;
+			}
+		}
+		else if (argument == "--container" && i + 1 < argc)
+			useKTX2 = std::string(argv[++i]) != "dds";
+		else if (argument == "--no-mips")
+			makeMips = false;
+		else
+			inputs.push_back(argument);
+	}
+
+	if (inputs.empty())
+	{
+		std::cout << "Usage: TextureConverter [--format bc1|bc3|bc4|bc5] [--container ktx2|dds] [--no-mips] image..." << std::endl;
+		return 1;
+	}
+
+	int failed = 0;
+	for (const std::string& input : inputs)
+	{
+		// top row first, which is what both containers expect
+		Image image;
+		int channels;
+		unsigned char* data = stbi_load(input.c_str(), &image.width, &image.height, &channels, 4);
+		if (!data)
+		{
+			std::cout << "Couldn't load " << input << std::endl;
+			failed++;
+			continue;
+		}
+		image.pixels.assign(data, data + (size_t)image.width * image.height * 4);
+		stbi_image_free(data);
+
+		Format imageFormat = format;
+		if (!hasFormat)
+		{
+			bool hasAlpha = false;
+			for (size_t i = 3; i < image.pixels.size() && !hasAlpha; i += 4)
+				hasAlpha = image.pixels[i] != 255;
+			imageFormat = hasAlpha ? Format::BC3 : Format::BC1;
+		}
+
+		int width = image.width;
+		int height = image.height;
+
+		// -- encode every level down to 1x1 --
+		std::vector<std::vector<unsigned char>> levels;
+		levels.push_back(Encode(image, imageFormat));
+		while (makeMips && (image.width > 1 || image.height > 1))
+		{
+			image = Downsample(image);
+			levels.push_back(Encode(image, imageFormat));
+		}
+
+		std::vector<unsigned char> file = useKTX2 ? WriteKTX2(levels, width, height, imageFormat) : WriteDDS(levels, width, height, imageFormat);
+
+		std::filesystem::path output = std::filesystem::path(input).replace_extension(useKTX2 ? ".ktx2" : ".dds");
+		std::ofstream outputStream(output, std::ios::binary);
+		outputStream.write((const char*)file.data(), file.size());
+		if (!outputStream)
+		{
+			std::cout << "Couldn't write " << output.string() << std::endl;
+			failed++;
+			continue;
+		}
+		std::cout << input << " -> " << output.string() << " (" << levels.size() << " levels, " << file.size() << " bytes)" << std::endl;
+	}
+
+	return failed == 0 ? 0 : 1;
+}